@@ -5,6 +5,9 @@
 #include <sihd/core/ACoreObject.hpp>
 #include <sihd/core/ACoreService.hpp>
 #include <sihd/core/Channel.hpp>
+#include <sihd/core/ChannelBuffer.hpp>
+#include <sihd/core/ChannelDelivery.hpp>
+#include <sihd/core/ChannelTransaction.hpp>
 #include <sihd/core/ChannelWaiter.hpp>
 #include <sihd/core/Core.hpp>
 #include <sihd/core/DevFilter.hpp>
@@ -14,7 +17,11 @@
 #include <sihd/core/DevRecorder.hpp>
 #include <sihd/core/DevSampler.hpp>
 #include <sihd/core/Device.hpp>
+#include <sihd/core/FileRecordReader.hpp>
+#include <sihd/core/FileRecorder.hpp>
 #include <sihd/core/MemRecorder.hpp>
+#include <sihd/core/RecordFile.hpp>
 #include <sihd/core/Records.hpp>
+#include <sihd/core/RuntimeStats.hpp>
 
 #endif
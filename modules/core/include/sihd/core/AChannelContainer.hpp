@@ -1,6 +1,8 @@
 #ifndef __SIHD_CORE_ACHANNELCONTAINER_HPP__
 #define __SIHD_CORE_ACHANNELCONTAINER_HPP__
 
+#include <list>
+
 #include <sihd/util/Configurable.hpp>
 #include <sihd/util/IHandler.hpp>
 #include <sihd/util/Node.hpp>
@@ -2,7 +2,11 @@
 #define __SIHD_CORE_CHANNEL_HPP__
 
 #include <atomic>
+#include <memory>
 #include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
 
 #include <sihd/util/ArrayView.hpp>
 #include <sihd/util/Clocks.hpp>
@@ -12,6 +16,10 @@
 #include <sihd/util/Timestamp.hpp>
 #include <sihd/util/array_utils.hpp>
 
+#include <sihd/core/ChannelBuffer.hpp>
+#include <sihd/core/ChannelDelivery.hpp>
+#include <sihd/core/RuntimeStats.hpp>
+
 namespace sihd::core
 {
 
@@ -19,6 +27,12 @@ class Channel: public sihd::util::Named,
                public sihd::util::Observable<Channel>
 {
     public:
+        struct Write
+        {
+                sihd::util::ArrByteView data;
+                size_t byte_offset;
+        };
+
         Channel(const std::string & name, sihd::util::Type type, size_t size, sihd::util::Node *parent = nullptr);
         Channel(const std::string & name, sihd::util::Type type, sihd::util::Node *parent = nullptr);
         Channel(const std::string & name, std::string_view type, size_t size, sihd::util::Node *parent = nullptr);
@@ -28,13 +42,51 @@ class Channel: public sihd::util::Named,
         static sihd::util::IClock *default_clock() { return _default_channel_clock_ptr; }
 
         // "name=CHANNEL_NAME;type=CHANNEL_TYPE;size=CHANNEL_SIZE"
+        // optional: "capacity=CHANNEL_CAPACITY" (resizable), "seqlock=true" or "shared=true"
         static Channel *build(std::string_view configuration);
 
         // write and notify only if a change happened
         void set_write_on_change(bool activate) { _write_change_only = activate; }
-        void set_resizable(bool activate) { _resizable = activate; }
+        // cannot be resizable while in seqlock or shared buffers mode
+        void set_resizable(bool activate);
         void set_clock(sihd::util::IClock *clock);
 
+        /**
+         * Seqlock mode for fixed size channels: readers copy data and timestamp without taking the channel's
+         * mutex and retry if a write happened meanwhile, writers never wait for readers.
+         * Must be set before the channel is shared between threads. Fails if the channel is resizable or in shared
+         * buffers mode.
+         */
+        bool set_seqlock(bool activate);
+        bool seqlock() const { return _seqlock; }
+
+        /**
+         * Shared buffers mode for fixed size channels: the channel holds a reference counted immutable buffer and
+         * each write publishes a new one taken from the channel's pool. Writing a channel from another one in this
+         * mode publishes a reference to its buffer instead of copying it.
+         * The array of the channel is only valid until the next write: use buffer() to keep it.
+         * Must be set before the channel is shared between threads. Fails if the channel is resizable or in
+         * seqlock mode.
+         */
+        bool set_shared_buffers(bool activate, size_t max_cached = 8);
+        bool shared_buffers() const { return _shared_buffers; }
+        // current buffer - empty if not in shared buffers mode
+        ChannelBuffer::Ref buffer() const;
+        // buffer to fill and publish - empty if not in shared buffers mode
+        ChannelBuffer::Ref acquire_buffer();
+        // publishes a buffer of the channel's type and size - copied if not in shared buffers mode
+        bool publish(ChannelBuffer::Ref buffer);
+
+        /**
+         * Counts writes and notifications, and measures lock waits and the time each observer takes to handle the
+         * notifications. Disabled channels only pay a relaxed load per write.
+         */
+        void set_stats(bool activate);
+        bool stats_enabled() const { return _stats_ptr.load(std::memory_order_relaxed) != nullptr; }
+        // zeroed if never enabled
+        ChannelStats stats() const;
+        void clear_stats();
+
         // Named
         virtual std::string description() const override;
 
@@ -71,6 +123,18 @@ class Channel: public sihd::util::Named,
         // notifies all observers and prevent writing inside notification thread
         void notify();
 
+        /**
+         * Notifies handler from an executor with snapshots of the channel, queued as described by options.
+         * Once a channel has asynchronous observers, writes from other threads wait for the notification in
+         * progress instead of failing.
+         */
+        bool add_async_observer(sihd::util::IHandler<const ChannelUpdate &> *handler,
+                                const ChannelDelivery::Options & options = {});
+        // drops the updates not yet delivered - cannot be called from the handler itself
+        bool remove_async_observer(sihd::util::IHandler<const ChannelUpdate &> *handler);
+        // queue of an asynchronous observer or nullptr
+        const ChannelDelivery *async_observer(sihd::util::IHandler<const ChannelUpdate &> *handler) const;
+
         // copy internal array into arr
         bool copy_to(sihd::util::IArray & arr, sihd::util::Timestamp *timestamp = nullptr) const;
         bool copy_to(sihd::util::IArray & arr, sihd::util::Slice slice, sihd::util::Timestamp *timestamp = nullptr) const;
@@ -81,20 +145,23 @@ class Channel: public sihd::util::Named,
         template <typename T>
         bool read_into(size_t idx, T & val) const
         {
-            std::lock_guard lock(_arr_mutex);
-            return sihd::util::array_utils::read_into<T>(_array_ptr, idx, val);
+            return this->_read_consistent(
+                [this, idx, &val] { return sihd::util::array_utils::read_into<T>(_array_ptr, idx, val); });
         }
 
         template <typename T>
         T read(size_t idx) const
         {
-            std::lock_guard lock(_arr_mutex);
-            return sihd::util::array_utils::read<T>(_array_ptr, idx);
+            return this->_read_consistent([this, idx] { return sihd::util::array_utils::read<T>(_array_ptr, idx); });
         }
 
         // copy arr to internal array
         bool write(const sihd::util::ArrByteView & arr, size_t byte_offset = 0);
         bool write(const Channel & other);
+        // writes applied at once under a single lock with one timestamp and one notification - none if one does not fit
+        bool write_batch(std::span<const Write> writes);
+        // timestamped with the time of the data, such as a kernel receive time, instead of the channel's clock
+        bool write_batch(std::span<const Write> writes, sihd::util::Timestamp timestamp);
 
         // utility for writing
         template <typename T>
@@ -108,6 +175,53 @@ class Channel: public sihd::util::Named,
         static sihd::util::IClock *_default_channel_clock_ptr;
 
     private:
+        friend class ChannelTransaction;
+
+        // false if another thread is notifying - waits for it with asynchronous observers
+        bool _lock_notify(std::unique_lock<std::mutex> & notify_lock);
+        // writes from the notifying thread fail in between
+        void _begin_notify();
+        void _end_notify();
+        void _notify_write();
+        // timestamp is nullptr to use the clock
+        bool _write_batch(std::span<const Write> writes, const sihd::util::Timestamp *timestamp);
+        // called between begin and end notify
+        void _notify_observers();
+        // called locked - false if a write does not fit
+        bool _fit(std::span<const Write> writes) const;
+        // called locked - changed is false if nothing was written in write on change mode
+        bool _apply(std::span<const Write> writes,
+                    const sihd::util::Timestamp *timestamp,
+                    bool & changed,
+                    ChannelBuffer::Ref & old);
+        // called locked in shared buffers mode
+        bool _write_buffer(std::span<const Write> writes, ChannelBuffer::Ref & old);
+
+        // calls function locked or, in seqlock mode, until it ran without a write happening meanwhile
+        template <typename Function>
+        auto _read_consistent(Function && function) const
+        {
+            if (!_seqlock)
+            {
+                std::lock_guard lock(_arr_mutex);
+                return function();
+            }
+            while (true)
+            {
+                const uint32_t sequence = _sequence.load(std::memory_order_acquire);
+                // odd while a write is in progress
+                if (sequence & 1)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                auto ret = function();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (_sequence.load(std::memory_order_relaxed) == sequence)
+                    return ret;
+            }
+        }
+
         sihd::util::IClock *_clock_ptr;
         sihd::util::Timestamp _timestamp;
 
@@ -115,10 +229,25 @@ class Channel: public sihd::util::Named,
         mutable std::mutex _arr_mutex;
 
         std::atomic<bool> _notifying;
+        std::atomic<std::thread::id> _notifying_thread;
         mutable std::mutex _notify_mutex;
 
+        std::atomic<size_t> _async_observers;
+        mutable std::mutex _deliveries_mutex;
+        std::vector<std::unique_ptr<ChannelDelivery>> _deliveries;
+
         bool _write_change_only;
         bool _resizable;
+        bool _seqlock;
+        bool _shared_buffers;
+        // array of the channel in shared buffers mode
+        ChannelBuffer::Ref _buffer;
+        std::shared_ptr<ChannelBufferPool> _pool_ptr;
+        // kept once created - nullptr while disabled
+        std::unique_ptr<ChannelCounters> _counters;
+        std::atomic<ChannelCounters *> _stats_ptr;
+        // incremented before and after each write in seqlock mode
+        std::atomic<uint32_t> _sequence;
 };
 
 } // namespace sihd::core
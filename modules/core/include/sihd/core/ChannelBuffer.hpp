@@ -0,0 +1,108 @@
+#ifndef __SIHD_CORE_CHANNELBUFFER_HPP__
+#define __SIHD_CORE_CHANNELBUFFER_HPP__
+
+#include <atomic>
+#include <memory>
+
+#include <sihd/util/IArray.hpp>
+#include <sihd/util/RingQueue.hpp>
+
+namespace sihd::core
+{
+
+class ChannelBufferPool;
+
+/**
+ * Reference counted array published by channels in shared buffers mode.
+ *
+ * A buffer is filled by its writer while it holds the only reference, then it is immutable: channels
+ * forwarding it to each other publish a reference instead of copying the array. The last reference gives the
+ * buffer back to the free list of the pool it comes from.
+ */
+class ChannelBuffer
+{
+    public:
+        class Ref
+        {
+            public:
+                Ref(): _buffer_ptr(nullptr) {}
+                Ref(const Ref & other);
+                Ref(Ref && other): _buffer_ptr(other._buffer_ptr) { other._buffer_ptr = nullptr; }
+                ~Ref() { this->reset(); }
+
+                Ref & operator=(const Ref & other);
+                Ref & operator=(Ref && other);
+
+                void reset();
+
+                ChannelBuffer *get() const { return _buffer_ptr; }
+                ChannelBuffer *operator->() const { return _buffer_ptr; }
+                explicit operator bool() const { return _buffer_ptr != nullptr; }
+
+            private:
+                friend class ChannelBufferPool;
+
+                // adopts the reference held by the pool
+                explicit Ref(ChannelBuffer *buffer): _buffer_ptr(buffer) {}
+
+                ChannelBuffer *_buffer_ptr;
+        };
+
+        ~ChannelBuffer();
+
+        const sihd::util::IArray *array() const { return _array_ptr.get(); }
+        // nullptr once the buffer is shared: published buffers are never written
+        sihd::util::IArray *writable_array();
+
+        size_t refs() const { return _refs.load(std::memory_order_acquire); }
+
+    protected:
+
+    private:
+        friend class ChannelBufferPool;
+
+        ChannelBuffer(sihd::util::IArray *array);
+
+        std::atomic<size_t> _refs;
+        std::unique_ptr<sihd::util::IArray> _array_ptr;
+        // set while the buffer is out of the pool's free list
+        std::shared_ptr<ChannelBufferPool> _pool_ptr;
+};
+
+/**
+ * Free list of buffers of a channel's type and size.
+ *
+ * Outstanding buffers keep their pool alive, they can outlive the channel which created it. Once warm,
+ * acquiring and releasing a buffer does not allocate.
+ */
+class ChannelBufferPool: public std::enable_shared_from_this<ChannelBufferPool>
+{
+    public:
+        ChannelBufferPool(sihd::util::Type type, size_t size, size_t max_cached = 8);
+        ~ChannelBufferPool();
+
+        ChannelBufferPool(const ChannelBufferPool &) = delete;
+        ChannelBufferPool & operator=(const ChannelBufferPool &) = delete;
+
+        // buffer only referenced by the caller - the content of a recycled buffer is unspecified
+        ChannelBuffer::Ref acquire();
+
+        sihd::util::Type data_type() const { return _type; }
+        size_t size() const { return _size; }
+        size_t cached() const { return _free_buffers.size(); }
+
+    protected:
+
+    private:
+        friend class ChannelBuffer::Ref;
+
+        void _release(ChannelBuffer *buffer);
+
+        sihd::util::Type _type;
+        size_t _size;
+        sihd::util::MpmcQueue<ChannelBuffer *> _free_buffers;
+};
+
+} // namespace sihd::core
+
+#endif
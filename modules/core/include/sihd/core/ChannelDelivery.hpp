@@ -0,0 +1,140 @@
+#ifndef __SIHD_CORE_CHANNELDELIVERY_HPP__
+#define __SIHD_CORE_CHANNELDELIVERY_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <sihd/util/IArray.hpp>
+#include <sihd/util/IHandler.hpp>
+#include <sihd/util/ThreadPool.hpp>
+#include <sihd/util/Timestamp.hpp>
+
+namespace sihd::core
+{
+
+class Channel;
+
+// state of a channel at a write, valid during the handler call
+struct ChannelUpdate
+{
+        const Channel *channel;
+        sihd::util::Timestamp timestamp;
+        const sihd::util::IArray *array;
+};
+
+/**
+ * Asynchronous delivery of a channel's updates to one observer.
+ *
+ * Observes the channel like any other observer: on notification the channel is copied into a bounded queue
+ * of snapshots, which is drained on an executor calling handler->handle(update) in order. A single drain runs
+ * at a time. Snapshots are preallocated buffers swapped in and out of the queue: once warm, queueing an update
+ * of the same size does not allocate.
+ */
+class ChannelDelivery: public sihd::util::IHandler<Channel *>
+{
+    public:
+        // what to do with an update when the queue is full
+        enum class Overflow
+        {
+            DropOldest,
+            DropNewest,
+            // the update replaces the newest queued one
+            Coalesce,
+            // the writer waits for room in the queue
+            Block
+        };
+
+        struct Options
+        {
+                size_t capacity = 64;
+                Overflow overflow = Overflow::DropOldest;
+                // nullptr for the default executor
+                sihd::util::ThreadPool *executor = nullptr;
+        };
+
+        struct Stats
+        {
+                size_t queued;
+                size_t delivered;
+                size_t dropped;
+                size_t coalesced;
+        };
+
+        ChannelDelivery(sihd::util::IHandler<const ChannelUpdate &> *handler, const Options & options);
+        virtual ~ChannelDelivery();
+
+        // shared executor of deliveries without one
+        static sihd::util::ThreadPool & default_executor();
+
+        // snapshots the channel into the queue
+        void handle(Channel *channel) override;
+
+        // drops the pending updates and waits for the current delivery - cannot be called from the handler
+        void close();
+
+        sihd::util::IHandler<const ChannelUpdate &> *handler() const { return _handler_ptr; }
+        const Options & options() const { return _options; }
+        // true if called from the handler
+        bool is_delivering() const;
+        // updates waiting for delivery
+        size_t pending() const;
+        Stats stats() const;
+
+    protected:
+
+    private:
+        struct Snapshot
+        {
+                const Channel *channel = nullptr;
+                sihd::util::Timestamp timestamp = 0;
+                std::unique_ptr<sihd::util::IArray> array;
+        };
+
+        // job posted to the executor - unschedules the delivery if destroyed without running
+        class DrainJob
+        {
+            public:
+                DrainJob(ChannelDelivery *delivery): _delivery_ptr(delivery) {}
+                DrainJob(DrainJob && other) noexcept;
+                ~DrainJob();
+
+                void operator()();
+
+            private:
+                ChannelDelivery *_delivery_ptr;
+        };
+
+        Snapshot & _slot(size_t index) { return _queue[(_head + index) % _queue.size()]; }
+        void _drain();
+        // the executor dropped the drain job
+        void _unschedule();
+
+        sihd::util::IHandler<const ChannelUpdate &> *_handler_ptr;
+        Options _options;
+        sihd::util::ThreadPool *_executor_ptr;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _cv;
+        std::vector<Snapshot> _queue;
+        size_t _head;
+        size_t _count;
+        // a drain is posted or running
+        bool _scheduled;
+        bool _closed;
+        // filled by the writer outside the lock then swapped into the queue
+        Snapshot _spare;
+        // swapped out of the queue by the drain
+        Snapshot _delivering;
+
+        std::atomic<size_t> _queued;
+        std::atomic<size_t> _delivered;
+        std::atomic<size_t> _dropped;
+        std::atomic<size_t> _coalesced;
+};
+
+} // namespace sihd::core
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef __SIHD_CORE_CHANNELTRANSACTION_HPP__
+#define __SIHD_CORE_CHANNELTRANSACTION_HPP__
+
+#include <vector>
+
+#include <sihd/util/ArrayView.hpp>
+#include <sihd/util/Timestamp.hpp>
+
+#include <sihd/core/Channel.hpp>
+
+namespace sihd::core
+{
+
+/**
+ * Writes to several channels published together.
+ *
+ * On commit the writes of each channel are applied under a single lock, all channels take the same timestamp
+ * and none of them is notified before every change is visible. Each channel changed then notifies its observers
+ * once, in the order the channels were first written in the transaction. Observers cannot write the channels of
+ * the transaction while it notifies.
+ *
+ * Staged data is kept by the transaction: reusing it does not allocate once warm.
+ */
+class ChannelTransaction
+{
+    public:
+        ChannelTransaction();
+        ~ChannelTransaction();
+
+        // copies data to write at commit
+        bool write(Channel *channel, const sihd::util::ArrByteView & data, size_t byte_offset = 0);
+
+        template <typename T>
+        bool write(Channel *channel, size_t idx, T value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return this->write(channel, {(const int8_t *)&value, sizeof(T)}, channel->byte_index(idx));
+        }
+
+        // memory to fill before commit, valid until the next write or stage - nullptr on error
+        void *stage(Channel *channel, size_t byte_size, size_t byte_offset = 0);
+
+        /**
+         * Nothing is written if a channel is notifying another thread or if a write does not fit. If applying the
+         * writes of a channel fails afterwards, the other channels are still written and notified.
+         */
+        bool commit();
+        // channels take the time of the data, such as a kernel receive time, instead of the first channel's clock
+        bool commit(sihd::util::Timestamp timestamp);
+        // drops the staged writes
+        void clear();
+
+        bool empty() const { return _writes.empty(); }
+        // timestamp of the channels changed by the last commit
+        sihd::util::Timestamp timestamp() const { return _timestamp; }
+
+    protected:
+
+    private:
+        struct Staged
+        {
+                Channel *channel;
+                // in the staged data
+                size_t offset;
+                size_t byte_size;
+                size_t byte_offset;
+        };
+
+        // writes of a channel in the channel writes
+        struct Group
+        {
+                Channel *channel;
+                size_t begin;
+                size_t end;
+                // first write of the channel in the transaction
+                size_t first;
+                bool changed;
+        };
+
+        // timestamp is nullptr to use the clock
+        bool _commit(const sihd::util::Timestamp *timestamp);
+        void _make_groups();
+        void _notify();
+
+        std::vector<int8_t> _data;
+        std::vector<Staged> _writes;
+        sihd::util::Timestamp _timestamp;
+
+        // reused at commit - channels are locked in the order of their address
+        std::vector<size_t> _order;
+        std::vector<Channel::Write> _channel_writes;
+        std::vector<Group> _groups;
+        std::vector<std::unique_lock<std::mutex>> _notify_locks;
+        std::vector<std::unique_lock<std::mutex>> _array_locks;
+        std::vector<ChannelBuffer::Ref> _old_buffers;
+};
+
+} // namespace sihd::core
+
+#endif
@@ -1,13 +1,32 @@
 #ifndef __SIHD_CORE_CORE_HPP__
 #define __SIHD_CORE_CORE_HPP__
 
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include <sihd/core/Device.hpp>
+#include <sihd/util/ThreadPool.hpp>
 
 namespace sihd::core
 {
 
-// Only purpose is to be a container and cascade service states to children
-
+/**
+ * Container cascading service states to its children.
+ *
+ * A child depends on the children owning the targets of its links - and of its descendants' links - or on
+ * the dependencies added by configuration. With startup threads, children setup, init and start in parallel,
+ * each one once its dependencies are done. Children stop and reset sequentially, dependents first, then the
+ * services linked to the core.
+ *
+ * Children connected by dependencies form a pipeline. With pipeline executors, each pipeline gets its own
+ * single threaded executor while the core runs, for the asynchronous work of its devices such as
+ * ChannelDelivery: unrelated pipelines never share a thread.
+ *
+ * With stats, every channel and device of the core counts its activity: runtime_stats() snapshots them to find
+ * the hot channels and the slow devices of a running core.
+ */
 class Core: public sihd::core::Device
 {
     public:
@@ -16,16 +35,75 @@ class Core: public sihd::core::Device
 
         bool is_running() const override { return _running; }
 
+        /**
+         * 0 setup, init and start children one after the other in their order. Otherwise siblings without
+         * dependencies between them run concurrently on a tree which is not synchronized: a child looking up a
+         * sibling by path in on_init or on_start must declare it as a dependency.
+         */
+        bool set_startup_threads(size_t threads);
+        // CHILD=DEPENDENCY - for channels found by path instead of links
+        bool add_dependency(std::string_view conf);
+        bool set_pipeline_executors(bool active);
+        // of the channels and devices of the core - applied again at start for the ones created at init
+        bool set_runtime_stats(bool active);
+
+        // names of the children connected by dependencies
+        std::vector<std::vector<std::string>> pipelines();
+        // executor of a descendant's pipeline - nullptr without pipeline executors or outside of the core
+        sihd::util::ThreadPool *executor(const sihd::util::Named *descendant) const;
+        // channels and devices with stats
+        CoreStats runtime_stats();
+        void clear_runtime_stats();
+
         bool on_init() override;
         bool on_start() override;
         bool on_stop() override;
         bool on_reset() override;
 
+    protected:
+        bool do_setup() override;
+        bool do_init() override;
+        bool do_start() override;
+        bool do_stop() override;
+        bool do_reset() override;
+
     private:
+        struct GraphNode
+        {
+                sihd::util::AService *service;
+                std::string name;
+                size_t dependencies;
+                std::vector<size_t> dependents;
+        };
+
+        using ServiceAction = std::function<bool(sihd::util::AService *)>;
+
+        bool _make_graph(std::vector<GraphNode> & graph);
+        // in children order when they do not depend on each other - shorter if dependencies are circular
+        static std::vector<size_t> _dependents_first(const std::vector<GraphNode> & graph);
+        // child of the core containing the target of a link
+        const sihd::util::Named *_link_owner(sihd::util::Node *node, const std::string & path);
+        void _add_links_owners(sihd::util::Node *node, std::vector<const sihd::util::Named *> & owners);
+        // services done are filled in the order they succeed
+        bool _run_graph(const char *action,
+                        const std::vector<GraphNode> & graph,
+                        const ServiceAction & fn,
+                        std::vector<sihd::util::AService *> & done);
+        static std::vector<std::vector<std::string>> _pipelines(const std::vector<GraphNode> & graph);
+        bool _make_executors();
+        void _apply_runtime_stats();
+
         bool _running;
         bool _is_reset;
+        size_t _startup_threads;
+        bool _pipeline_executors;
+        bool _runtime_stats;
+        std::vector<std::pair<std::string, std::string>> _dependencies;
+        std::vector<std::unique_ptr<sihd::util::ThreadPool>> _executors;
+        // children of the core to the executor of their pipeline
+        std::unordered_map<const sihd::util::Named *, sihd::util::ThreadPool *> _executors_map;
 };
 
 } // namespace sihd::core
 
-#endif
\ No newline at end of file
+#endif
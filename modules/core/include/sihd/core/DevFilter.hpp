@@ -4,9 +4,11 @@
 #include <atomic>
 
 #include <sihd/core/Device.hpp>
+#include <sihd/util/ObjectPool.hpp>
 #include <sihd/util/Scheduler.hpp>
 #include <sihd/util/Task.hpp>
 #include <sihd/util/Value.hpp>
+#include <sihd/util/array_reduce.hpp>
 
 namespace sihd::core
 {
@@ -80,6 +82,59 @@ class DevFilter: public sihd::core::Device
                 sihd::util::Duration nano_delay;
         };
 
+        // reductions of an input channel's elements, written as a single value in the output channel
+        enum ArrayOperation
+        {
+            // 1 if one element compares, 0 otherwise
+            Any,
+            // 1 if every element compares, 0 otherwise
+            All,
+            // number of elements comparing
+            Count,
+            Min,
+            Max,
+            Mean,
+            // index of the first element comparing, -1 if there is none
+            First,
+        };
+
+        class ArrayRule
+        {
+            public:
+                ArrayRule(ArrayOperation operation);
+                ~ArrayRule();
+
+                bool parse(std::string_view conf);
+                ArrayRule & in(std::string_view channel_name);
+                ArrayRule & out(std::string_view channel_name);
+                // reduce elements [from, to) - a 'to' of 0 is the end of the input channel
+                ArrayRule & slice(size_t from, size_t to = 0);
+                // write the result at channel's output idx
+                ArrayRule & write(size_t idx);
+
+                // comparison for Any, All, Count and First
+                template <typename T>
+                ArrayRule & compare(sihd::util::array_reduce::Compare type, T val)
+                {
+                    this->compare_type = type;
+                    this->compare_value = val;
+                    return *this;
+                }
+
+                ArrayOperation operation;
+                // channels name
+                std::string channel_in;
+                std::string channel_out;
+                // compare
+                sihd::util::array_reduce::Compare compare_type;
+                sihd::util::Value compare_value;
+                // slice
+                size_t slice_from;
+                size_t slice_to;
+                // write
+                size_t write_idx;
+        };
+
         DevFilter(const std::string & name, sihd::util::Node *parent = nullptr);
         virtual ~DevFilter();
 
@@ -91,8 +146,16 @@ class DevFilter: public sihd::core::Device
         bool set_filter_byte_and(std::string_view rule_str);
         bool set_filter_byte_or(std::string_view rule_str);
         bool set_filter_byte_xor(std::string_view rule_str);
+        bool set_filter_any(std::string_view rule_str);
+        bool set_filter_all(std::string_view rule_str);
+        bool set_filter_count(std::string_view rule_str);
+        bool set_filter_min(std::string_view rule_str);
+        bool set_filter_max(std::string_view rule_str);
+        bool set_filter_mean(std::string_view rule_str);
+        bool set_filter_first(std::string_view rule_str);
 
         void set_filter(const Rule & rule);
+        void set_array_filter(const ArrayRule & rule);
 
         bool is_running() const override;
 
@@ -107,43 +170,119 @@ class DevFilter: public sihd::core::Device
         bool on_stop() override;
         bool on_reset() override;
 
-        void _rule_match(Channel *channel_out, const Rule *rule_ptr, int64_t out_val);
-
     private:
+        struct CompiledRule;
+
+        // compiled for the type of the input channel
+        using Predicate = bool (*)(const uint8_t *element, const CompiledRule & rule);
+
+        struct CompiledRule
+        {
+                Predicate predicate;
+                size_t trigger_offset;
+                size_t trigger_size;
+                // trigger value converted once for the predicates
+                int64_t trigger_integer;
+                uint64_t trigger_bits;
+                double trigger_float;
+                double epsilon;
+                bool should_match;
+                // write
+                Channel *channel_out;
+                size_t write_offset;
+                size_t write_size;
+                bool write_same_value;
+                int64_t write_value;
+                sihd::util::Duration nano_delay;
+        };
+
+        struct CompiledArrayRule;
+
+        // compiled for the type of the input channel and the operation
+        using Reducer = void (*)(const uint8_t *buf, const CompiledArrayRule & rule);
+
+        struct CompiledArrayRule
+        {
+                Reducer reducer;
+                // slice
+                size_t offset;
+                size_t size;
+                // compare
+                sihd::util::array_reduce::Compare compare_type;
+                int64_t compare_integer;
+                double compare_float;
+                // write
+                Channel *channel_out;
+                size_t write_idx;
+        };
+
+        // rules of an input channel are contiguous in the compiled rules
+        struct ChannelRules
+        {
+                Channel *channel_in;
+                size_t begin;
+                size_t end;
+                size_t array_begin;
+                size_t array_end;
+        };
+
         class DelayWriter: public sihd::util::Task
         {
             public:
-                DelayWriter(DevFilter *dev, Channel *channel_out, const Rule *rule_ptr, int64_t out_val);
+                DelayWriter(Channel *channel_out,
+                            size_t offset,
+                            size_t size,
+                            int64_t value,
+                            sihd::util::Duration delay);
                 ~DelayWriter();
 
                 bool run();
 
-                DevFilter *dev;
+                // scheduler deletes tasks once played: recycle their storage instead of allocating each write
+                static void *operator new(size_t size);
+                static void operator delete(void *ptr, size_t size);
+
                 Channel *channel_out;
-                const Rule *rule_ptr;
-                int64_t out_val;
+                size_t offset;
+                size_t size;
+                int64_t value;
+
+            private:
+                static sihd::util::ObjectPool<DelayWriter> & _pool();
         };
 
-        struct InternalRule
-        {
-                InternalRule();
-                ~InternalRule();
+        template <typename T, RuleType R>
+        static bool _evaluate(const uint8_t *element, const CompiledRule & rule);
+        template <typename T>
+        static Predicate _predicate(RuleType type);
+        static Predicate _predicate(sihd::util::Type data_type, RuleType type);
 
-                bool set(const Rule *conf, Channel *in, Channel *out);
-                bool verify();
+        static void _write(Channel *channel_out, size_t offset, size_t size, int64_t value);
+        static bool _verify(const Rule & rule, const Channel *in, const Channel *out);
+        static bool _compile(const Rule & rule, Channel *in, Channel *out, CompiledRule & compiled);
 
-                Channel *channel_in_ptr;
-                Channel *channel_out_ptr;
-                const Rule *rule_ptr;
-        };
+        template <typename T, ArrayOperation O>
+        static void _reduce(const uint8_t *buf, const CompiledArrayRule & rule);
+        template <typename T>
+        static Reducer _reducer(ArrayOperation operation);
+        static Reducer _reducer(sihd::util::Type data_type, ArrayOperation operation);
+
+        template <typename T>
+        static void _write_result(Channel *channel_out, size_t idx, T result);
+        static bool _verify(const ArrayRule & rule, const Channel *in, const Channel *out);
+        static bool _compile(const ArrayRule & rule, Channel *in, Channel *out, CompiledArrayRule & compiled);
 
         bool _parse_conf(std::string_view conf, RuleType type);
-        void _apply_rule(const Channel *channel_in, Channel *channel_out, const Rule *rule_ptr);
+        bool _parse_array_conf(std::string_view conf, ArrayOperation operation);
 
         std::atomic<bool> _running;
         std::mutex _run_mutex;
         std::vector<Rule> _rules_lst;
-        std::map<Channel *, std::vector<std::unique_ptr<InternalRule>>> _rules_map;
+        std::vector<ArrayRule> _array_rules_lst;
+        std::vector<CompiledRule> _compiled_rules;
+        std::vector<CompiledArrayRule> _compiled_array_rules;
+        // sorted by input channel
+        std::vector<ChannelRules> _channel_rules;
         sihd::util::Scheduler *_scheduler_ptr;
         bool _rule_with_delay;
 };
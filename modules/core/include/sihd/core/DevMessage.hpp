@@ -3,6 +3,7 @@
 
 #include <sihd/util/IMessageField.hpp>
 
+#include <sihd/core/ChannelTransaction.hpp>
 #include <sihd/core/Device.hpp>
 
 namespace sihd::core
@@ -31,8 +32,12 @@ class DevMessage: public sihd::core::Device
         bool on_reset() override;
 
     private:
-        void _fill_channels_out();
-        void _compute_output();
+        // stage the outputs into the transaction
+        bool _fill_channel_out(sihd::util::IMessageField *field, Channel *ch_out);
+        bool _fill_channels_out();
+        bool _compute_output();
+        // commits the transaction if everything was staged
+        void _commit(bool staged);
 
         bool _running;
         bool _trigger_mode;
@@ -45,6 +50,7 @@ class DevMessage: public sihd::core::Device
         Channel *_channel_msg_in;
         Channel *_channel_msg_out;
         Channel *_channel_trigger;
+        ChannelTransaction _transaction;
 };
 
 } // namespace sihd::core
@@ -1,27 +1,44 @@
 #ifndef __SIHD_CORE_DEVPLAYER_HPP__
 #define __SIHD_CORE_DEVPLAYER_HPP__
 
-#include <queue>
+#include <atomic>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
-#include <sihd/core/DevRecorder.hpp>
 #include <sihd/core/Device.hpp>
 #include <sihd/core/Records.hpp>
-#include <sihd/util/Collector.hpp>
-#include <sihd/util/IHandler.hpp>
+#include <sihd/util/Clocks.hpp>
 #include <sihd/util/IProvider.hpp>
-#include <sihd/util/Runnable.hpp>
-#include <sihd/util/SafeQueue.hpp>
-#include <sihd/util/Scheduler.hpp>
+#include <sihd/util/Waitable.hpp>
 #include <sihd/util/Worker.hpp>
 
 namespace sihd::core
 {
 
-class DevPlayer: public sihd::core::Device,
-                 public sihd::util::IHandler<sihd::util::Collector<PlayableRecord> *>,
-                 public sihd::util::IRunnable
+class FileRecordReader;
+
+/**
+ * Plays the records of a provider into channels, spaced as they were recorded.
+ *
+ * A single playback thread reads the provider ahead into a batch of records whose channel is resolved once,
+ * then sleeps until the deadline of the next timestamp and writes every record of that timestamp at once.
+ * The speed factor scales the time between records, a speed of 0 plays as fast as possible.
+ */
+class DevPlayer: public sihd::core::Device
 {
     public:
+        struct Stats
+        {
+                size_t played;
+                // played after their deadline plus the late threshold
+                size_t late;
+                // records of the provider passed by a seek
+                size_t skipped;
+                sihd::util::Duration max_lateness;
+                sihd::util::Duration total_lateness;
+        };
+
         DevPlayer(const std::string & name, sihd::util::Node *parent = nullptr);
         virtual ~DevPlayer();
 
@@ -30,15 +47,22 @@ class DevPlayer: public sihd::core::Device,
         bool set_provider(std::string_view path);
         bool set_provider_wait_time(sihd::util::time::UnixTime milliseconds);
         bool add_alias(std::string_view alias_conf);
-        bool set_scheduler_queue_size(size_t limit);
+        // records read ahead of the playback
+        bool set_queue_size(size_t limit);
+        // 0.5 plays twice slower, 2 twice faster, 0 as fast as possible - can be changed while playing
+        bool set_speed(double speed);
+        bool set_late_threshold(sihd::util::time::UnixTime milliseconds);
+
+        // the next record played is the first one at or after timestamp - going back needs a FileRecordReader
+        void seek(sihd::util::Timestamp timestamp);
+
+        double speed() const { return _speed; }
+        Stats stats() const;
 
     protected:
         using Device::handle;
 
         void handle(sihd::core::Channel *c) override;
-        void handle(sihd::util::Collector<PlayableRecord> *collector) override;
-
-        bool run() override;
 
         bool on_init() override;
         bool on_start() override;
@@ -46,38 +70,65 @@ class DevPlayer: public sihd::core::Device,
         bool on_reset() override;
 
     private:
+        struct Playable
+        {
+                Channel *channel;
+                sihd::util::Timestamp timestamp;
+                sihd::util::IArrayShared value;
+        };
+
         bool _main_loop();
-        void _provider_ended();
+        // reads the provider until the queue is full - returns false if the provider ended
+        bool _fill_queue();
+        void _play_next_timestamp();
+        void _apply_seek(sihd::util::Timestamp timestamp);
+        // called with the waitable locked
+        bool _interrupted() const;
 
         std::atomic<bool> _running;
-        std::atomic<bool> _last_record;
-        std::atomic<bool> _end_notified;
-        size_t _records_queue_limit;
+        std::atomic<bool> _playing;
+        std::atomic<double> _speed;
+        std::atomic<bool> _reanchor;
+        size_t _queue_limit;
+        sihd::util::Duration _provider_wait_time;
+        sihd::util::Duration _late_threshold;
         std::string _provider_path;
 
         Channel *_channel_play_ptr;
         Channel *_channel_end_ptr;
-        sihd::util::Scheduler *_scheduler_ptr;
+        sihd::util::IProvider<PlayableRecord> *_provider_ptr;
+        // can go back in time
+        FileRecordReader *_reader_ptr;
 
         // channels to write records to
-        std::map<std::string, Channel *> _map_channels;
+        std::unordered_map<std::string, Channel *> _map_channels;
         // channels to write configuration
         std::map<std::string, std::string> _map_channels_alias;
 
-        std::optional<sihd::util::Timestamp> _first_timestamp;
-
-        // queue to pass data between scheduler thread and worker thread
-        sihd::util::SafeQueue<PlayableRecord> _safe_queue;
-        // notifies scheduler task has played
+        // playback thread only
+        std::vector<Playable> _queue;
+        size_t _queue_pos;
+        std::optional<sihd::util::Timestamp> _skip_until;
+        // record timestamp played at the steady time, at a speed
+        int64_t _anchor_record;
+        int64_t _anchor_time;
+        double _anchor_speed;
+
+        // guarded by the waitable
+        std::optional<sihd::util::Timestamp> _seek_timestamp;
+
+        std::atomic<size_t> _played;
+        std::atomic<size_t> _late;
+        std::atomic<size_t> _skipped;
+        std::atomic<int64_t> _max_lateness;
+        std::atomic<int64_t> _total_lateness;
+
+        sihd::util::SteadyClock _clock;
+        // wakes the playback thread
         sihd::util::Waitable _waitable;
-        // provider reading thread
         sihd::util::Worker _worker;
-        // collects records from provider
-        sihd::util::Collector<PlayableRecord> _collector;
-
-        sihd::util::Runnable _runnable;
 };
 
 } // namespace sihd::core
 
-#endif
\ No newline at end of file
+#endif
@@ -1,7 +1,8 @@
 #ifndef __SIHD_CORE_DEVSAMPLER_HPP__
 #define __SIHD_CORE_DEVSAMPLER_HPP__
 
-#include <set>
+#include <memory>
+#include <vector>
 
 #include <sihd/util/IRunnable.hpp>
 #include <sihd/util/StepWorker.hpp>
@@ -11,14 +12,40 @@
 namespace sihd::core
 {
 
+/**
+ * Writes input channels into output channels at a frequency, only if the input was written since the last tick.
+ *
+ * Aggregating modes are computed element-wise on each input write into the window of the tick, then written
+ * once converted to the output type: a high rate input is decimated without keeping any of its frames.
+ */
 class DevSampler: public sihd::core::Device,
                   public sihd::util::IRunnable
 {
     public:
+        enum Mode
+        {
+            // copy of the input at the tick
+            Last,
+            Mean,
+            Min,
+            Max,
+            Sum,
+            // number of writes, at the output index 0
+            Count,
+        };
+
         DevSampler(const std::string & name, sihd::util::Node *parent = nullptr);
         virtual ~DevSampler();
 
+        // CHANNEL_PATH_SAMPLE_OUT=CHANNEL_PATH_SAMPLE_IN
         bool set_sample(std::string_view conf);
+        bool set_sample_mean(std::string_view conf);
+        bool set_sample_min(std::string_view conf);
+        bool set_sample_max(std::string_view conf);
+        bool set_sample_sum(std::string_view conf);
+        bool set_sample_count(std::string_view conf);
+        // replaces the sampling of channel_out
+        bool add_sample(std::string_view channel_out, std::string_view channel_in, Mode mode = Last);
         bool set_frequency(double freq);
 
         bool is_running() const override;
@@ -36,14 +63,67 @@ class DevSampler: public sihd::core::Device,
         bool on_reset() override;
 
     private:
-        std::mutex _set_mutex;
+        struct SampleConf
+        {
+                std::string channel_out;
+                std::string channel_in;
+                Mode mode;
+        };
+
+        struct Sample;
+
+        // compiled for the type of the input channel and the mode
+        using Accumulator = void (*)(const uint8_t *buf, Sample & sample);
+
+        struct Sample
+        {
+                Channel *channel_in;
+                Channel *channel_out;
+                Mode mode;
+                // nullptr for modes without values
+                Accumulator accumulator;
+                // window of the current tick - guarded by the window mutex
+                size_t writes;
+                std::vector<double> values;
+                // window of the last tick - swapped with the current one at the tick
+                size_t tick_writes;
+                std::vector<double> tick_values;
+                // output written from
+                std::unique_ptr<sihd::util::IArray> buffer;
+        };
+
+        // samples of an input channel are contiguous in the samples
+        struct Input
+        {
+                Channel *channel;
+                size_t begin;
+                size_t end;
+        };
+
+        template <typename T, Mode M>
+        static void _accumulate(const uint8_t *buf, Sample & sample);
+        template <typename T>
+        static Accumulator _accumulator(Mode mode);
+        static Accumulator _accumulator(sihd::util::Type data_type, Mode mode);
+        static void _clear_window(Sample & sample);
+        static void _store(const std::vector<double> & values, sihd::util::IArray *array);
+
+        bool _parse_conf(std::string_view conf, Mode mode);
+        bool _make_sample(const SampleConf & conf, Sample & sample);
+        void _write_sample(Sample & sample);
+
+        std::mutex _window_mutex;
         sihd::util::StepWorker _step_worker;
         Channel *_channel_sample;
-        std::map<Channel *, Channel *> _channels_map;
-        std::map<std::string, std::string> _conf_map;
-        std::set<Channel *> _channels_sample_set;
+        std::vector<SampleConf> _confs;
+        // sorted by input channel
+        std::vector<Sample> _samples;
+        std::vector<Input> _inputs;
+        // one bit per sample written in the window of the current tick
+        std::vector<uint64_t> _written;
+        std::vector<uint64_t> _tick_written;
 };
 
 } // namespace sihd::core
 
-#endif
\ No newline at end of file
+#endif
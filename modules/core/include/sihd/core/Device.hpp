@@ -1,8 +1,12 @@
 #ifndef __SIHD_CORE_DEVICE_HPP__
 #define __SIHD_CORE_DEVICE_HPP__
 
+#include <atomic>
+#include <memory>
+
 #include <sihd/core/AChannelContainer.hpp>
 #include <sihd/core/ACoreService.hpp>
+#include <sihd/core/RuntimeStats.hpp>
 
 namespace sihd::core
 {
@@ -24,6 +28,14 @@ class Device: public AChannelContainer,
         virtual sihd::util::ServiceController::State device_state() const;
         virtual const char *device_state_str() const;
 
+        // time spent handling the notifications of observed channels with stats
+        void set_stats(bool activate);
+        bool stats_enabled() const { return _stats_ptr.load(std::memory_order_relaxed) != nullptr; }
+        DeviceStats stats() const;
+        void clear_stats();
+        // nullptr while disabled
+        DeviceCounters *stats_counters() const { return _stats_ptr.load(std::memory_order_acquire); }
+
     protected:
         virtual void handle([[maybe_unused]] Channel *c) override {}
         virtual void handle([[maybe_unused]] sihd::util::ServiceController *ctrl) override {}
@@ -44,6 +56,9 @@ class Device: public AChannelContainer,
         sihd::util::ServiceController _service_controller;
 
     private:
+        // kept once created
+        std::unique_ptr<DeviceCounters> _counters;
+        std::atomic<DeviceCounters *> _stats_ptr;
 };
 
 } // namespace sihd::core
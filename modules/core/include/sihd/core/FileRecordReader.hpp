@@ -0,0 +1,108 @@
+#ifndef __SIHD_CORE_FILERECORDREADER_HPP__
+#define __SIHD_CORE_FILERECORDREADER_HPP__
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <sihd/sys/MappedFile.hpp>
+#include <sihd/util/IProvider.hpp>
+
+#include <sihd/core/ACoreObject.hpp>
+#include <sihd/core/RecordFile.hpp>
+#include <sihd/core/Records.hpp>
+
+namespace sihd::core
+{
+
+/**
+ * Provides the records of a FileRecorder directory in the order they were recorded - DevPlayer's provider.
+ *
+ * Segments are mapped one at a time and records are not copied: the value of a provided record is a read only
+ * array pointing into the mapping, which stays mapped as long as one of its records is alive.
+ */
+class FileRecordReader: public ACoreObject,
+                        public sihd::util::IProvider<PlayableRecord>
+{
+    public:
+        using ACoreObject::handle;
+
+        FileRecordReader(const std::string & name, sihd::util::Node *parent = nullptr);
+        virtual ~FileRecordReader();
+
+        bool set_path(std::string_view path);
+        bool set_stop_providing_when_empty(bool active);
+
+        // lists the segments of the directory - done at start if not opened
+        bool open();
+        void close();
+        bool is_open() const;
+
+        bool do_start() override;
+        bool do_stop() override;
+        bool do_reset() override;
+
+        bool is_running() const override;
+
+        bool providing() const override;
+        bool provide(PlayableRecord *record) override;
+
+        // the next provided record is the first one recorded at or after timestamp
+        bool seek(sihd::util::Timestamp timestamp);
+
+        const std::string & path() const { return _path; }
+        size_t segments() const;
+
+    protected:
+
+    private:
+        struct ChannelDef
+        {
+                std::string name;
+                sihd::util::Type type;
+        };
+
+        struct Segment
+        {
+                std::shared_ptr<sihd::sys::MappedFile> file;
+                std::map<uint32_t, ChannelDef> channels;
+                const record_file::IndexEntry *index = nullptr;
+                size_t index_size = 0;
+                // offset of the first record
+                size_t begin = 0;
+                // offset after the last record
+                size_t end = 0;
+                // definition records are known up to this offset
+                size_t defined = 0;
+        };
+
+        // called locked
+        bool _map_segment(size_t index);
+        bool _next_segment();
+        // nullptr at the end of the records
+        const record_file::RecordHeader *_header_at(size_t offset) const;
+        // returns the offset after the record, reads it if it is a definition
+        size_t _pass(size_t offset, const record_file::RecordHeader *header);
+        // reads the definitions before offset
+        void _define_until(size_t offset);
+        std::optional<sihd::util::Timestamp> _first_timestamp() const;
+
+        std::string _path;
+        bool _stop_providing_when_empty;
+        std::atomic<bool> _providing;
+        std::atomic<bool> _running;
+
+        mutable std::mutex _mutex;
+        std::vector<std::string> _segments_path;
+        Segment _segment;
+        size_t _next_segment_index;
+        // offset of the next record in the mapped segment
+        size_t _offset;
+};
+
+} // namespace sihd::core
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef __SIHD_CORE_FILERECORDER_HPP__
+#define __SIHD_CORE_FILERECORDER_HPP__
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <sihd/sys/File.hpp>
+#include <sihd/util/IHandler.hpp>
+
+#include <sihd/core/ACoreObject.hpp>
+#include <sihd/core/Channel.hpp>
+#include <sihd/core/RecordFile.hpp>
+
+namespace sihd::core
+{
+
+/**
+ * Records channels into a directory of segments (see RecordFile.hpp) - DevRecorder's handler.
+ *
+ * Records are batched in memory and written once the batch is full, a new segment is started when the current
+ * one would grow past the segment size (the index may still overflow it). An index entry is kept every
+ * 'index_interval' of recorded time and written at the end of the segment.
+ */
+class FileRecorder: public ACoreObject,
+                    public sihd::util::IHandler<const std::string &, const Channel *>
+{
+    public:
+        using ACoreObject::handle;
+
+        FileRecorder(const std::string & name, sihd::util::Node *parent = nullptr);
+        virtual ~FileRecorder();
+
+        // directory of the segments, created at start if missing
+        bool set_path(std::string_view path);
+        bool set_segment_size(size_t bytes);
+        bool set_batch_size(size_t bytes);
+        bool set_index_interval(sihd::util::time::UnixTime milliseconds);
+
+        bool do_start() override;
+        bool do_stop() override;
+        bool do_reset() override;
+
+        bool is_running() const override;
+
+        void add_record(const std::string & name, sihd::util::Timestamp timestamp, const sihd::util::IArray *array);
+        // writes the batched records
+        bool flush();
+
+        const std::string & path() const { return _path; }
+        // segments written since start
+        size_t segments() const;
+        size_t records() const;
+
+    protected:
+        void handle(const std::string & name, const Channel *channel) override;
+
+    private:
+        struct ChannelDef
+        {
+                uint32_t id;
+                sihd::util::Type type;
+        };
+
+        // called locked
+        bool _open_segment();
+        bool _close_segment();
+        bool _write_batch();
+        void _append(const void *data, size_t size);
+        void _append_entry(const std::string & name, const ChannelDef & def);
+        const ChannelDef *_channel(const std::string & name, sihd::util::Type type);
+
+        std::string _path;
+        size_t _segment_size;
+        size_t _batch_size;
+        sihd::util::Duration _index_interval;
+
+        std::atomic<bool> _running;
+        mutable std::mutex _mutex;
+        sihd::sys::File _file;
+        std::map<std::string, ChannelDef, std::less<>> _channels;
+        std::vector<uint8_t> _batch;
+        std::vector<record_file::IndexEntry> _index;
+        // bytes of the segment: written and batched
+        size_t _segment_offset;
+        // name of the next segment
+        size_t _segment_index;
+        size_t _segments;
+        size_t _records;
+};
+
+} // namespace sihd::core
+
+#endif
@@ -1,6 +1,10 @@
 #ifndef __SIHD_CORE_MEMRECORDER_HPP__
 #define __SIHD_CORE_MEMRECORDER_HPP__
 
+#include <list>
+#include <map>
+#include <vector>
+
 #include <sihd/util/IHandler.hpp>
 #include <sihd/util/IProvider.hpp>
 
@@ -11,6 +15,15 @@
 namespace sihd::core
 {
 
+/**
+ * Records channels in memory and provides them back in timestamp order.
+ *
+ * Channel names are interned to small ids and each channel is stored in columns: one column per channel and
+ * array layout (type and byte size) holding a timestamps vector and a contiguous payload vector of fixed stride.
+ * Recording a sample is an amortized append without allocation, the playback order is a merge of the columns
+ * at provide time. Samples of equal timestamps are provided in recording order within a channel, and by
+ * channel first recorded across channels.
+ */
 class MemRecorder: public ACoreObject,
                    public sihd::util::IProvider<PlayableRecord>,
                    public sihd::util::IHandler<const std::string &, const Channel *>
@@ -38,7 +51,12 @@ class MemRecorder: public ACoreObject,
 
         bool is_running() const override;
 
-        const SortedRecordedValues & sorted_recorded_values() const { return _map_sorted_records; }
+        // samples not provided yet
+        size_t samples() const;
+        // bytes reserved by the columns
+        size_t memory_usage() const;
+
+        SortedRecordedValues sorted_recorded_values() const;
         std::string hexdump_records(std::string_view separation_cols = " ", char separation_data = ' ');
 
         MapListRecordedValues make_recorded_values() const;
@@ -50,13 +68,39 @@ class MemRecorder: public ACoreObject,
         void handle(const std::string & name, const Channel *array) override;
 
     private:
+        struct Column
+        {
+                uint32_t id;
+                sihd::util::Type type;
+                // bytes of a sample
+                size_t stride;
+                std::vector<sihd::util::Timestamp> timestamps;
+                std::vector<uint8_t> payloads;
+        };
+
+        static constexpr size_t npos = (size_t)-1;
+
+        // called locked
+        size_t _column(const std::string & name, const sihd::util::IArray *array);
+        // column of the earliest sample not provided according to cursors, npos if none
+        size_t _earliest(const std::vector<size_t> & cursors) const;
+        sihd::util::IArrayShared _make_array(const Column & column, size_t index) const;
+
         bool _stop_providing_when_empty;
         std::atomic<bool> _providing;
         std::atomic<bool> _running;
         mutable std::mutex _mutex;
-        SortedRecordedValues _map_sorted_records;
+        // interned channel names
+        std::map<std::string, uint32_t, std::less<>> _ids;
+        std::vector<std::string> _names;
+        std::vector<Column> _columns;
+        // last column recorded into of each channel id
+        std::vector<size_t> _id_columns;
+        // next sample to provide of each column
+        std::vector<size_t> _cursors;
+        size_t _samples;
 };
 
 } // namespace sihd::core
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,85 @@
+#ifndef __SIHD_CORE_RECORDFILE_HPP__
+#define __SIHD_CORE_RECORDFILE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * On disk format of recorded channels, written by FileRecorder and read by FileRecordReader.
+ *
+ * A recording is a directory of append only segments named by their order (000000.rec, 000001.rec...).
+ * Values are stored in host byte order and every structure is 8 bytes aligned so payloads can be used in place
+ * from a mapping of the file:
+ *
+ *   SegmentHeader
+ *   ChannelEntry + name (+ padding) per channel known when the segment was opened
+ *   RecordHeader + payload (+ padding) per record
+ *   RecordHeader(index_id) + IndexEntry[] and SegmentFooter once the segment is closed
+ *
+ * A channel first recorded inside a segment is defined by a record of id 'definition_id' holding its entry.
+ * A segment without footer (interrupted recording) is read until its last complete record.
+ */
+namespace sihd::core::record_file
+{
+
+constexpr char magic[8] = {'S', 'I', 'H', 'D', 'R', 'E', 'C', '\0'};
+constexpr uint32_t version = 1;
+constexpr uint64_t footer_magic = 0x5844494345524453; // "SDRECIDX"
+constexpr std::string_view segment_extension = ".rec";
+
+// reserved channel ids
+constexpr uint32_t definition_id = 0xFFFFFFFF;
+constexpr uint32_t index_id = 0xFFFFFFFE;
+
+struct SegmentHeader
+{
+        char magic[8];
+        uint32_t version;
+        uint32_t channels;
+};
+
+struct ChannelEntry
+{
+        uint32_t id;
+        // sihd::util::Type
+        uint32_t type;
+        uint32_t name_size;
+        uint32_t reserved;
+};
+
+struct RecordHeader
+{
+        uint32_t channel;
+        uint32_t size;
+        int64_t timestamp;
+};
+
+// first record at or after a timestamp
+struct IndexEntry
+{
+        int64_t timestamp;
+        uint64_t offset;
+};
+
+struct SegmentFooter
+{
+        uint64_t index_offset;
+        uint64_t magic;
+};
+
+static_assert(sizeof(SegmentHeader) == 16 && sizeof(ChannelEntry) == 16 && sizeof(RecordHeader) == 16
+              && sizeof(IndexEntry) == 16 && sizeof(SegmentFooter) == 16);
+
+constexpr size_t align(size_t size)
+{
+    return (size + 7) & ~size_t(7);
+}
+
+// name of the segment at 'index' in a recording directory
+std::string segment_name(size_t index);
+
+} // namespace sihd::core::record_file
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef __SIHD_CORE_RUNTIMESTATS_HPP__
+#define __SIHD_CORE_RUNTIMESTATS_HPP__
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sihd/util/IHandler.hpp>
+#include <sihd/util/Stat.hpp>
+
+namespace sihd::core
+{
+
+class Channel;
+class Device;
+
+// durations in nanoseconds
+struct LatencyStats
+{
+        size_t samples;
+        double min;
+        double average;
+        double max;
+        double median;
+        double p95;
+        double p99;
+};
+
+struct ObserverStats
+{
+        std::string name;
+        LatencyStats handle;
+};
+
+struct ChannelStats
+{
+        std::string path;
+        // written and notified
+        size_t writes;
+        size_t bytes_written;
+        // identical in write on change mode
+        size_t unchanged_writes;
+        // refused while notifying or not fitting
+        size_t rejected_writes;
+        size_t notifications;
+        LatencyStats lock_wait;
+        // all observers
+        LatencyStats notify;
+        std::vector<ObserverStats> observers;
+};
+
+struct DeviceStats
+{
+        std::string path;
+        // notifications of observed channels with stats
+        size_t handled;
+        LatencyStats handle;
+};
+
+struct CoreStats
+{
+        std::vector<ChannelStats> channels;
+        std::vector<DeviceStats> devices;
+};
+
+// thread safe streaming quantiles of durations
+class LatencyStat
+{
+    public:
+        LatencyStat();
+        ~LatencyStat();
+
+        void add(int64_t nanoseconds);
+        LatencyStats snapshot() const;
+        void clear();
+
+    private:
+        mutable std::mutex _mutex;
+        sihd::util::PSquareStat<double> _stat;
+};
+
+// updated by a device with stats
+struct DeviceCounters
+{
+        std::atomic<size_t> handled {0};
+        LatencyStat handle;
+
+        void clear();
+};
+
+/**
+ * Updated by a channel with stats: counters are relaxed atomics, durations are only measured with stats.
+ * Observers which are devices with stats get their handling durations too.
+ */
+struct ChannelCounters
+{
+        struct Observer
+        {
+                sihd::util::IHandler<Channel *> *handler;
+                Device *device;
+                std::string name;
+                LatencyStat handle;
+        };
+
+        std::atomic<size_t> writes {0};
+        std::atomic<size_t> bytes_written {0};
+        std::atomic<size_t> unchanged_writes {0};
+        std::atomic<size_t> rejected_writes {0};
+        std::atomic<size_t> notifications {0};
+        LatencyStat lock_wait;
+        LatencyStat notify;
+
+        void add_observer_time(sihd::util::IHandler<Channel *> *handler, int64_t nanoseconds);
+        std::vector<ObserverStats> observers() const;
+        void clear();
+
+    private:
+        mutable std::mutex _observers_mutex;
+        std::vector<std::unique_ptr<Observer>> _observers;
+};
+
+} // namespace sihd::core
+
+#endif
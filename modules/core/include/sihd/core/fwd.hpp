@@ -8,6 +8,9 @@ class AChannelContainer;
 class ACoreObject;
 class ACoreService;
 class Channel;
+class ChannelBuffer;
+class ChannelBufferPool;
+class ChannelTransaction;
 class Core;
 class DevFilter;
 class DevMessage;
@@ -16,6 +19,9 @@ class DevPulsation;
 class DevRecorder;
 class DevSampler;
 class Device;
+class FileRecordReader;
+class FileRecorder;
+class LatencyStat;
 class MemRecorder;
 
 } // namespace sihd::core
@@ -1,8 +1,12 @@
+#include <algorithm>
+#include <chrono>
+
 #include <sihd/core/Channel.hpp>
 #include <sihd/util/Array.hpp>
 #include <sihd/util/Logger.hpp>
 #include <sihd/util/StrConfiguration.hpp>
 #include <sihd/util/array_utils.hpp>
+#include <sihd/util/str.hpp>
 
 namespace sihd::core
 {
@@ -11,6 +15,18 @@ using namespace sihd::util;
 
 SIHD_NEW_LOGGER("sihd::core");
 
+namespace
+{
+
+using StatsClock = std::chrono::steady_clock;
+
+int64_t nanoseconds_since(StatsClock::time_point begin)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(StatsClock::now() - begin).count();
+}
+
+} // namespace
+
 sihd::util::IClock *Channel::_default_channel_clock_ptr = &sihd::util::Clock::default_clock;
 
 Channel::Channel(const std::string & name, Type type, size_t size, Node *parent): Named(name, parent)
@@ -23,8 +39,13 @@ Channel::Channel(const std::string & name, Type type, size_t size, Node *parent)
     }
     _array_ptr->resize(size);
     _notifying = false;
+    _async_observers = 0;
     _write_change_only = true;
     _resizable = false;
+    _seqlock = false;
+    _shared_buffers = false;
+    _stats_ptr = nullptr;
+    _sequence = 0;
     _timestamp = 0;
     _clock_ptr = Channel::default_clock();
 }
@@ -43,7 +64,17 @@ Channel::Channel(const std::string & name, std::string_view type, Node *parent):
 
 Channel::~Channel()
 {
-    if (_array_ptr != nullptr)
+    {
+        std::lock_guard l(_deliveries_mutex);
+        for (auto & delivery : _deliveries)
+        {
+            delivery->close();
+            this->remove_observer(delivery.get());
+        }
+        _deliveries.clear();
+    }
+    // in shared buffers mode the array belongs to the buffer
+    if (_array_ptr != nullptr && !_shared_buffers)
         delete _array_ptr;
 }
 
@@ -86,13 +117,142 @@ Channel *Channel::build(std::string_view configuration)
         }
     }
 
+    auto seqlock = conf.find("seqlock");
+    if (seqlock.has_value())
+    {
+        bool activate = false;
+        if (!str::to_bool(*seqlock, activate) || (activate && !channel->set_seqlock(true)))
+        {
+            SIHD_LOG(error, "Channel: cannot build from configuration '{}' invalid seqlock", configuration);
+            delete channel;
+            return nullptr;
+        }
+    }
+
+    auto shared = conf.find("shared");
+    if (shared.has_value())
+    {
+        bool activate = false;
+        if (!str::to_bool(*shared, activate) || (activate && !channel->set_shared_buffers(true)))
+        {
+            SIHD_LOG(error, "Channel: cannot build from configuration '{}' invalid shared buffers", configuration);
+            delete channel;
+            return nullptr;
+        }
+    }
+
     return channel;
 }
 
-Timestamp Channel::timestamp() const
+void Channel::set_clock(IClock *clock)
+{
+    _clock_ptr = clock != nullptr ? clock : Channel::default_clock();
+}
+
+void Channel::set_resizable(bool activate)
+{
+    if (activate && (_seqlock || _shared_buffers))
+    {
+        SIHD_LOG(error, "Channel: '{}' cannot be resizable in seqlock or shared buffers mode", this->name());
+        return;
+    }
+    _resizable = activate;
+}
+
+bool Channel::set_seqlock(bool activate)
+{
+    if (activate && _resizable)
+    {
+        SIHD_LOG(error, "Channel: '{}' cannot use seqlock mode while resizable", this->name());
+        return false;
+    }
+    if (activate && _shared_buffers)
+    {
+        SIHD_LOG(error, "Channel: '{}' cannot use seqlock mode with shared buffers", this->name());
+        return false;
+    }
+    _seqlock = activate;
+    return true;
+}
+
+bool Channel::set_shared_buffers(bool activate, size_t max_cached)
+{
+    if (activate == _shared_buffers)
+        return true;
+    if (activate && (_resizable || _seqlock))
+    {
+        SIHD_LOG(error, "Channel: '{}' cannot use shared buffers while resizable or in seqlock mode", this->name());
+        return false;
+    }
+    std::lock_guard lock(_arr_mutex);
+    if (activate)
+    {
+        auto pool = std::make_shared<ChannelBufferPool>(_array_ptr->data_type(), _array_ptr->size(), max_cached);
+        ChannelBuffer::Ref buffer = pool->acquire();
+        if (!buffer || !buffer->writable_array()->copy_from_bytes(*_array_ptr))
+        {
+            SIHD_LOG(error, "Channel: '{}' cannot create shared buffers", this->name());
+            return false;
+        }
+        delete _array_ptr;
+        _array_ptr = buffer->writable_array();
+        _buffer = std::move(buffer);
+        _pool_ptr = std::move(pool);
+    }
+    else
+    {
+        _array_ptr = _buffer->array()->clone_array();
+        _buffer.reset();
+        _pool_ptr.reset();
+    }
+    _shared_buffers = activate;
+    return true;
+}
+
+void Channel::set_stats(bool activate)
+{
+    if (activate && _counters == nullptr)
+        _counters = std::make_unique<ChannelCounters>();
+    _stats_ptr.store(activate ? _counters.get() : nullptr, std::memory_order_release);
+}
+
+ChannelStats Channel::stats() const
+{
+    ChannelStats stats {};
+    stats.path = this->full_name();
+    if (_counters == nullptr)
+        return stats;
+    stats.writes = _counters->writes.load(std::memory_order_relaxed);
+    stats.bytes_written = _counters->bytes_written.load(std::memory_order_relaxed);
+    stats.unchanged_writes = _counters->unchanged_writes.load(std::memory_order_relaxed);
+    stats.rejected_writes = _counters->rejected_writes.load(std::memory_order_relaxed);
+    stats.notifications = _counters->notifications.load(std::memory_order_relaxed);
+    stats.lock_wait = _counters->lock_wait.snapshot();
+    stats.notify = _counters->notify.snapshot();
+    stats.observers = _counters->observers();
+    return stats;
+}
+
+void Channel::clear_stats()
+{
+    if (_counters != nullptr)
+        _counters->clear();
+}
+
+ChannelBuffer::Ref Channel::buffer() const
 {
     std::lock_guard lock(_arr_mutex);
-    return _timestamp;
+    return _buffer;
+}
+
+ChannelBuffer::Ref Channel::acquire_buffer()
+{
+    return _pool_ptr != nullptr ? _pool_ptr->acquire() : ChannelBuffer::Ref();
+}
+
+Timestamp Channel::timestamp() const
+{
+    return this->_read_consistent([this] { return _timestamp; });
 }
 
 void Channel::do_timestamp()
@@ -107,84 +267,337 @@ bool Channel::copy_to(IArray & arr, Timestamp *timestamp) const
 
 bool Channel::copy_to_bytes(IArray & arr, Slice byte_slice, Timestamp *timestamp) const
 {
-    std::lock_guard lock(_arr_mutex);
-    if (timestamp != nullptr)
-        *timestamp = _timestamp;
-    auto range = byte_slice.resolve(_array_ptr->byte_size());
-    if (range.empty())
-        return false;
-    return arr.copy_from_bytes(_array_ptr->buf() + range.from, range.size());
+    return this->_read_consistent([&] {
+        if (timestamp != nullptr)
+            *timestamp = _timestamp;
+        auto range = byte_slice.resolve(_array_ptr->byte_size());
+        if (range.empty())
+            return false;
+        return arr.copy_from_bytes(_array_ptr->buf() + range.from, range.size());
+    });
 }
 
 bool Channel::copy_to(IArray & arr, Slice slice, Timestamp *timestamp) const
 {
-    std::lock_guard lock(_arr_mutex);
-    if (timestamp != nullptr)
-        *timestamp = _timestamp;
-    auto range = slice.resolve(_array_ptr->size());
-    if (range.empty())
-        return false;
-    return arr.copy_from_bytes(_array_ptr->buf_at(range.from), range.size() * _array_ptr->data_size());
+    return this->_read_consistent([&] {
+        if (timestamp != nullptr)
+            *timestamp = _timestamp;
+        auto range = slice.resolve(_array_ptr->size());
+        if (range.empty())
+            return false;
+        return arr.copy_from_bytes(_array_ptr->buf_at(range.from), range.size() * _array_ptr->data_size());
+    });
 }
 
 bool Channel::write(const Channel & other)
 {
-    std::unique_ptr<IArray> copy;
-    {
-        std::lock_guard lock(other._arr_mutex);
-        const IArray *other_array = other.array();
-        if (other_array == nullptr)
-            return false;
-        copy.reset(other_array->clone_array());
-    }
+    if (other._shared_buffers)
+        return this->publish(other.buffer());
+    const IArray *other_array = other.array();
+    if (other_array == nullptr)
+        return false;
+    // copies from torn reads are destroyed on retry
+    std::unique_ptr<IArray> copy
+        = other._read_consistent([other_array] { return std::unique_ptr<IArray>(other_array->clone_array()); });
     return this->write(*copy);
 }
 
-bool Channel::write(const sihd::util::ArrByteView & arr_view, size_t byte_offset)
+bool Channel::_lock_notify(std::unique_lock<std::mutex> & notify_lock)
 {
-    std::unique_lock notify_lock(_notify_mutex, std::try_to_lock);
-    if (!notify_lock.owns_lock())
+    // asynchronous observers keep notifications short: other threads wait for their turn
+    if (_async_observers.load() > 0 && _notifying_thread.load() != std::this_thread::get_id())
+        notify_lock.lock();
+    else if (!notify_lock.try_lock())
     {
         SIHD_LOG(warning, "Channel: cannot write while notifying");
+        ChannelCounters *stats = _stats_ptr.load(std::memory_order_acquire);
+        if (stats != nullptr)
+            stats->rejected_writes.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
+    return true;
+}
+
+void Channel::_begin_notify()
+{
+    _notifying = true;
+    _notifying_thread = std::this_thread::get_id();
+}
 
-    bool ret = false;
+void Channel::_end_notify()
+{
+    _notifying_thread = std::thread::id();
+    _notifying = false;
+}
+
+void Channel::_notify_write()
+{
+    this->_begin_notify();
+    this->_notify_observers();
+    this->_end_notify();
+}
+
+void Channel::_notify_observers()
+{
+    ChannelCounters *stats = _stats_ptr.load(std::memory_order_acquire);
+    if (stats == nullptr)
+    {
+        this->notify_observers(this);
+        return;
+    }
+    stats->notifications.fetch_add(1, std::memory_order_relaxed);
+    const StatsClock::time_point begin = StatsClock::now();
+    StatsClock::time_point previous = begin;
+    this->notify_observers_with([this, stats, &previous](IHandler<Channel *> *observer) {
+        observer->handle(this);
+        const StatsClock::time_point now = StatsClock::now();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - previous);
+        stats->add_observer_time(observer, elapsed.count());
+        previous = now;
+    });
+    stats->notify.add(nanoseconds_since(begin));
+}
+
+bool Channel::publish(ChannelBuffer::Ref buffer)
+{
+    if (!buffer)
+        return false;
+    const IArray *array = buffer->array();
+    if (!_shared_buffers)
+        return this->write(*array);
+    if (!array->is_same_type(*_array_ptr) || array->size() != _array_ptr->size())
+    {
+        SIHD_LOG_ERROR("Channel: cannot publish a buffer of {}[{}] into {}[{}]",
+                       array->data_type_str(),
+                       array->size(),
+                       _array_ptr->data_type_str(),
+                       _array_ptr->size());
+        return false;
+    }
+
+    ChannelCounters *stats = _stats_ptr.load(std::memory_order_acquire);
+    const StatsClock::time_point begin = stats != nullptr ? StatsClock::now() : StatsClock::time_point();
+    std::unique_lock notify_lock(_notify_mutex, std::defer_lock);
+    if (!this->_lock_notify(notify_lock))
+        return false;
     {
         std::lock_guard lock(_arr_mutex);
-        const size_t needed = arr_view.byte_size() + byte_offset;
-        if (needed > _array_ptr->byte_size())
+        if (stats != nullptr)
+            stats->lock_wait.add(nanoseconds_since(begin));
+        if (_write_change_only && (buffer.get() == _buffer.get() || _array_ptr->is_bytes_equal(*array)))
         {
-            if (!_resizable || needed > _array_ptr->byte_capacity())
-            {
-                SIHD_LOG_ERROR("Channel: cannot write {} bytes at {} offset into {} bytes",
-                               arr_view.byte_size(),
-                               byte_offset,
-                               _array_ptr->byte_size());
-                return false;
-            }
-            _array_ptr->byte_resize(needed);
-        }
-        if (_write_change_only && _array_ptr->is_bytes_equal(arr_view, {(ssize_t)byte_offset}))
+            if (stats != nullptr)
+                stats->unchanged_writes.fetch_add(1, std::memory_order_relaxed);
             return true;
-        if ((ret = _array_ptr->copy_from_bytes(arr_view, {(ssize_t)byte_offset})))
-            this->do_timestamp();
+        }
+        // the previous buffer is released out of the lock
+        std::swap(_buffer, buffer);
+        _array_ptr = const_cast<IArray *>(array);
+        this->do_timestamp();
+        if (stats != nullptr)
+        {
+            stats->writes.fetch_add(1, std::memory_order_relaxed);
+            stats->bytes_written.fetch_add(array->byte_size(), std::memory_order_relaxed);
+        }
+    }
+    this->_notify_write();
+    return true;
+}
+
+bool Channel::_write_buffer(std::span<const Write> writes, ChannelBuffer::Ref & old)
+{
+    ChannelBuffer::Ref buffer = _pool_ptr->acquire();
+    if (!buffer)
+        return false;
+    IArray *array = buffer->writable_array();
+    // published buffers are immutable: a partial write copies the rest of the previous one
+    if (writes.size() != 1 || writes[0].byte_offset > 0 || writes[0].data.byte_size() < _array_ptr->byte_size())
+        array->copy_from_bytes(*_array_ptr);
+    for (const Write & write : writes)
+    {
+        if (!array->copy_from_bytes(write.data, {(ssize_t)write.byte_offset}))
+            return false;
+    }
+    old = std::move(_buffer);
+    _buffer = std::move(buffer);
+    _array_ptr = array;
+    return true;
+}
+
+bool Channel::_fit(std::span<const Write> writes) const
+{
+    for (const Write & write : writes)
+    {
+        const size_t needed = write.data.byte_size() + write.byte_offset;
+        if (needed > _array_ptr->byte_size() && (!_resizable || needed > _array_ptr->byte_capacity()))
+        {
+            SIHD_LOG_ERROR("Channel: cannot write {} bytes at {} offset into {} bytes",
+                           write.data.byte_size(),
+                           write.byte_offset,
+                           _array_ptr->byte_size());
+            ChannelCounters *stats = _stats_ptr.load(std::memory_order_acquire);
+            if (stats != nullptr)
+                stats->rejected_writes.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Channel::_apply(std::span<const Write> writes,
+                     const Timestamp *timestamp,
+                     bool & changed,
+                     ChannelBuffer::Ref & old)
+{
+    changed = false;
+    // nothing is written unless every write fits
+    if (!this->_fit(writes))
+        return false;
+    size_t byte_size = _array_ptr->byte_size();
+    for (const Write & write : writes)
+        byte_size = std::max(byte_size, write.data.byte_size() + write.byte_offset);
+    if (byte_size > _array_ptr->byte_size())
+        _array_ptr->byte_resize(byte_size);
+    ChannelCounters *stats = _stats_ptr.load(std::memory_order_acquire);
+    if (_write_change_only && std::all_of(writes.begin(), writes.end(), [this](const Write & write) {
+            return _array_ptr->is_bytes_equal(write.data, {(ssize_t)write.byte_offset});
+        }))
+    {
+        if (stats != nullptr)
+            stats->unchanged_writes.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool ret = true;
+    // readers retry while the sequence is odd or changed
+    const uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+    if (_seqlock)
+    {
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    if (_shared_buffers)
+        ret = this->_write_buffer(writes, old);
+    else
+    {
+        for (const Write & write : writes)
+            ret = ret && _array_ptr->copy_from_bytes(write.data, {(ssize_t)write.byte_offset});
     }
     if (ret)
     {
-        _notifying = true;
-        this->notify_observers(this);
-        _notifying = false;
+        if (timestamp != nullptr)
+            _timestamp = *timestamp;
+        else
+            this->do_timestamp();
+        changed = true;
+        if (stats != nullptr)
+        {
+            size_t bytes = 0;
+            for (const Write & write : writes)
+                bytes += write.data.byte_size();
+            stats->writes.fetch_add(1, std::memory_order_relaxed);
+            stats->bytes_written.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+    if (_seqlock)
+        _sequence.store(sequence + 2, std::memory_order_release);
+    return ret;
+}
+
+bool Channel::write(const sihd::util::ArrByteView & arr_view, size_t byte_offset)
+{
+    const Write write {arr_view, byte_offset};
+    return this->write_batch({&write, 1});
+}
+
+bool Channel::write_batch(std::span<const Write> writes)
+{
+    return this->_write_batch(writes, nullptr);
+}
+
+bool Channel::write_batch(std::span<const Write> writes, Timestamp timestamp)
+{
+    return this->_write_batch(writes, &timestamp);
+}
+
+bool Channel::_write_batch(std::span<const Write> writes, const Timestamp *timestamp)
+{
+    ChannelCounters *stats = _stats_ptr.load(std::memory_order_acquire);
+    const StatsClock::time_point begin = stats != nullptr ? StatsClock::now() : StatsClock::time_point();
+    std::unique_lock notify_lock(_notify_mutex, std::defer_lock);
+    if (!this->_lock_notify(notify_lock))
+        return false;
+
+    bool ret;
+    bool changed;
+    // the previous buffer is released out of the lock
+    ChannelBuffer::Ref old_buffer;
+    {
+        std::lock_guard lock(_arr_mutex);
+        if (stats != nullptr)
+            stats->lock_wait.add(nanoseconds_since(begin));
+        ret = this->_apply(writes, timestamp, changed, old_buffer);
     }
+    if (changed)
+        this->_notify_write();
     return ret;
 }
 
 void Channel::notify()
 {
     std::lock_guard lock(_notify_mutex);
-    _notifying = true;
-    this->notify_observers(this);
-    _notifying = false;
+    this->_notify_write();
+}
+
+bool Channel::add_async_observer(IHandler<const ChannelUpdate &> *handler, const ChannelDelivery::Options & options)
+{
+    std::lock_guard l(_deliveries_mutex);
+    for (const auto & delivery : _deliveries)
+    {
+        if (delivery->handler() == handler)
+            return false;
+    }
+    auto delivery = std::make_unique<ChannelDelivery>(handler, options);
+    this->add_observer(delivery.get());
+    _deliveries.emplace_back(std::move(delivery));
+    _async_observers = _deliveries.size();
+    return true;
+}
+
+bool Channel::remove_async_observer(IHandler<const ChannelUpdate &> *handler)
+{
+    std::unique_ptr<ChannelDelivery> delivery;
+    {
+        std::lock_guard l(_deliveries_mutex);
+        auto it = std::find_if(_deliveries.begin(), _deliveries.end(), [handler](const auto & delivery) {
+            return delivery->handler() == handler;
+        });
+        if (it == _deliveries.end())
+            return false;
+        if ((*it)->is_delivering())
+        {
+            SIHD_LOG(error, "Channel: cannot remove an asynchronous observer from its handler");
+            return false;
+        }
+        delivery = std::move(*it);
+        _deliveries.erase(it);
+        _async_observers = _deliveries.size();
+    }
+    // the handler may use the channel while its last delivery ends
+    delivery->close();
+    this->remove_observer(delivery.get());
+    return true;
+}
+
+const ChannelDelivery *Channel::async_observer(IHandler<const ChannelUpdate &> *handler) const
+{
+    std::lock_guard l(_deliveries_mutex);
+    for (const auto & delivery : _deliveries)
+    {
+        if (delivery->handler() == handler)
+            return delivery.get();
+    }
+    return nullptr;
 }
 
 std::string Channel::description() const
@@ -0,0 +1,93 @@
+#include <sihd/util/array_utils.hpp>
+
+#include <sihd/core/ChannelBuffer.hpp>
+
+namespace sihd::core
+{
+
+using namespace sihd::util;
+
+ChannelBuffer::ChannelBuffer(IArray *array): _refs(0), _array_ptr(array) {}
+
+ChannelBuffer::~ChannelBuffer() = default;
+
+IArray *ChannelBuffer::writable_array()
+{
+    return _refs.load(std::memory_order_acquire) == 1 ? _array_ptr.get() : nullptr;
+}
+
+ChannelBuffer::Ref::Ref(const Ref & other): _buffer_ptr(other._buffer_ptr)
+{
+    if (_buffer_ptr != nullptr)
+        _buffer_ptr->_refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+ChannelBuffer::Ref & ChannelBuffer::Ref::operator=(const Ref & other)
+{
+    if (other._buffer_ptr != nullptr)
+        other._buffer_ptr->_refs.fetch_add(1, std::memory_order_relaxed);
+    this->reset();
+    _buffer_ptr = other._buffer_ptr;
+    return *this;
+}
+
+ChannelBuffer::Ref & ChannelBuffer::Ref::operator=(Ref && other)
+{
+    if (this != &other)
+    {
+        this->reset();
+        _buffer_ptr = other._buffer_ptr;
+        other._buffer_ptr = nullptr;
+    }
+    return *this;
+}
+
+void ChannelBuffer::Ref::reset()
+{
+    ChannelBuffer *buffer = _buffer_ptr;
+    _buffer_ptr = nullptr;
+    if (buffer != nullptr && buffer->_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        buffer->_pool_ptr->_release(buffer);
+}
+
+ChannelBufferPool::ChannelBufferPool(Type type, size_t size, size_t max_cached):
+    _type(type),
+    _size(size),
+    _free_buffers(max_cached)
+{
+}
+
+ChannelBufferPool::~ChannelBufferPool()
+{
+    while (std::optional<ChannelBuffer *> buffer = _free_buffers.try_pop())
+        delete *buffer;
+}
+
+ChannelBuffer::Ref ChannelBufferPool::acquire()
+{
+    ChannelBuffer *buffer;
+    std::optional<ChannelBuffer *> cached = _free_buffers.try_pop();
+    if (cached.has_value())
+        buffer = *cached;
+    else
+    {
+        IArray *array = array_utils::create_from_type(_type, _size);
+        if (array == nullptr)
+            return ChannelBuffer::Ref();
+        array->resize(_size);
+        buffer = new ChannelBuffer(array);
+    }
+    buffer->_refs.store(1, std::memory_order_relaxed);
+    buffer->_pool_ptr = this->shared_from_this();
+    return ChannelBuffer::Ref(buffer);
+}
+
+void ChannelBufferPool::_release(ChannelBuffer *buffer)
+{
+    // may be the last owner of the pool: destroyed once the buffer is back in the free list
+    std::shared_ptr<ChannelBufferPool> keep = std::move(buffer->_pool_ptr);
+    if (!_free_buffers.push(buffer))
+        delete buffer;
+}
+
+} // namespace sihd::core
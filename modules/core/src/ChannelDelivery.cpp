@@ -0,0 +1,209 @@
+#include <stdexcept>
+#include <utility>
+
+#include <sihd/util/Logger.hpp>
+
+#include <sihd/core/Channel.hpp>
+#include <sihd/core/ChannelDelivery.hpp>
+
+namespace sihd::core
+{
+
+using namespace sihd::util;
+
+SIHD_NEW_LOGGER("sihd::core");
+
+namespace
+{
+
+// delivery being drained on the current thread
+thread_local const ChannelDelivery *g_draining = nullptr;
+
+} // namespace
+
+ChannelDelivery::ChannelDelivery(IHandler<const ChannelUpdate &> *handler, const Options & options):
+    _handler_ptr(handler),
+    _options(options),
+    _executor_ptr(options.executor != nullptr ? options.executor : &ChannelDelivery::default_executor()),
+    _head(0),
+    _count(0),
+    _scheduled(false),
+    _closed(false),
+    _queued(0),
+    _delivered(0),
+    _dropped(0),
+    _coalesced(0)
+{
+    if (_handler_ptr == nullptr)
+        throw std::invalid_argument("ChannelDelivery: no handler");
+    if (_options.capacity == 0)
+        throw std::invalid_argument("ChannelDelivery: capacity must not be 0");
+    _queue.resize(_options.capacity);
+}
+
+ChannelDelivery::~ChannelDelivery()
+{
+    this->close();
+}
+
+ThreadPool & ChannelDelivery::default_executor()
+{
+    static ThreadPool pool("delivery", 2);
+    return pool;
+}
+
+void ChannelDelivery::handle(Channel *channel)
+{
+    // notifications of a channel are serialized: the spare snapshot is only used by one writer at a time
+    if (_spare.array == nullptr)
+        _spare.array.reset(channel->array()->clone_array());
+    else
+        _spare.array->resize(channel->size());
+    channel->copy_to(*_spare.array, &_spare.timestamp);
+    _spare.channel = channel;
+
+    bool schedule = false;
+    {
+        std::unique_lock l(_mutex);
+        if (_closed)
+            return;
+
+        if (_count == _queue.size())
+        {
+            switch (_options.overflow)
+            {
+                case Overflow::DropOldest:
+                    // the oldest slot becomes the newest one
+                    _head = (_head + 1) % _queue.size();
+                    --_count;
+                    _dropped.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                case Overflow::DropNewest:
+                    _dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                case Overflow::Coalesce:
+                    std::swap(_spare, _slot(_count - 1));
+                    _coalesced.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                case Overflow::Block:
+                    // the drain of the current thread would never make room
+                    if (this->is_delivering())
+                    {
+                        _dropped.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    _cv.wait(l, [this] { return _closed || _count < _queue.size(); });
+                    if (_closed)
+                        return;
+                    break;
+            }
+        }
+
+        std::swap(_spare, _slot(_count));
+        ++_count;
+        _queued.fetch_add(1, std::memory_order_relaxed);
+
+        if (!_scheduled)
+        {
+            _scheduled = true;
+            schedule = true;
+        }
+    }
+
+    if (schedule)
+        _executor_ptr->post_job(DrainJob(this));
+}
+
+ChannelDelivery::DrainJob::DrainJob(DrainJob && other) noexcept: _delivery_ptr(other._delivery_ptr)
+{
+    other._delivery_ptr = nullptr;
+}
+
+ChannelDelivery::DrainJob::~DrainJob()
+{
+    // a stopped executor discards its jobs without running them
+    if (_delivery_ptr != nullptr)
+        _delivery_ptr->_unschedule();
+}
+
+void ChannelDelivery::DrainJob::operator()()
+{
+    // the delivery may be destroyed as soon as the drain is done
+    ChannelDelivery *delivery = _delivery_ptr;
+    _delivery_ptr = nullptr;
+    delivery->_drain();
+}
+
+void ChannelDelivery::_drain()
+{
+    g_draining = this;
+    std::unique_lock l(_mutex);
+    while (!_closed && _count > 0)
+    {
+        std::swap(_delivering, _slot(0));
+        _head = (_head + 1) % _queue.size();
+        --_count;
+        // room for a blocked writer
+        _cv.notify_all();
+
+        l.unlock();
+        try
+        {
+            _handler_ptr->handle({_delivering.channel, _delivering.timestamp, _delivering.array.get()});
+        }
+        catch (const std::exception & e)
+        {
+            SIHD_LOG(error, "ChannelDelivery: handler error: {}", e.what());
+        }
+        _delivered.fetch_add(1, std::memory_order_relaxed);
+        l.lock();
+    }
+    _scheduled = false;
+    g_draining = nullptr;
+    // last access to this object when closing
+    _cv.notify_all();
+}
+
+void ChannelDelivery::_unschedule()
+{
+    std::lock_guard l(_mutex);
+    _scheduled = false;
+    // last access to this object when closing
+    _cv.notify_all();
+}
+
+void ChannelDelivery::close()
+{
+    if (this->is_delivering())
+        throw std::logic_error("ChannelDelivery: cannot close from its own handler");
+
+    std::unique_lock l(_mutex);
+    _closed = true;
+    _head = 0;
+    _count = 0;
+    _cv.notify_all();
+    _cv.wait(l, [this] { return !_scheduled; });
+}
+
+bool ChannelDelivery::is_delivering() const
+{
+    return g_draining == this;
+}
+
+size_t ChannelDelivery::pending() const
+{
+    std::lock_guard l(_mutex);
+    return _count;
+}
+
+ChannelDelivery::Stats ChannelDelivery::stats() const
+{
+    return {
+        .queued = _queued.load(std::memory_order_relaxed),
+        .delivered = _delivered.load(std::memory_order_relaxed),
+        .dropped = _dropped.load(std::memory_order_relaxed),
+        .coalesced = _coalesced.load(std::memory_order_relaxed),
+    };
+}
+
+} // namespace sihd::core
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include <sihd/util/Logger.hpp>
+
+#include <sihd/core/ChannelTransaction.hpp>
+
+namespace sihd::core
+{
+
+using namespace sihd::util;
+
+SIHD_NEW_LOGGER("sihd::core");
+
+ChannelTransaction::ChannelTransaction(): _timestamp(0) {}
+
+ChannelTransaction::~ChannelTransaction() = default;
+
+void *ChannelTransaction::stage(Channel *channel, size_t byte_size, size_t byte_offset)
+{
+    if (channel == nullptr)
+    {
+        SIHD_LOG_ERROR("ChannelTransaction: cannot write into no channel");
+        return nullptr;
+    }
+    const size_t offset = _data.size();
+    _data.resize(offset + byte_size);
+    _writes.emplace_back(Staged {channel, offset, byte_size, byte_offset});
+    return _data.data() + offset;
+}
+
+bool ChannelTransaction::write(Channel *channel, const ArrByteView & data, size_t byte_offset)
+{
+    void *buf = this->stage(channel, data.byte_size(), byte_offset);
+    if (buf == nullptr)
+        return false;
+    if (data.byte_size() > 0)
+        memcpy(buf, data.buf(), data.byte_size());
+    return true;
+}
+
+void ChannelTransaction::clear()
+{
+    _data.clear();
+    _writes.clear();
+}
+
+void ChannelTransaction::_make_groups()
+{
+    _order.resize(_writes.size());
+    std::iota(_order.begin(), _order.end(), 0);
+    std::stable_sort(_order.begin(), _order.end(), [this](size_t a, size_t b) {
+        return _writes[a].channel < _writes[b].channel;
+    });
+
+    _channel_writes.clear();
+    _groups.clear();
+    for (size_t idx : _order)
+    {
+        const Staged & staged = _writes[idx];
+        if (_groups.empty() || _groups.back().channel != staged.channel)
+            _groups.emplace_back(Group {staged.channel, _channel_writes.size(), _channel_writes.size(), idx, false});
+        Group & group = _groups.back();
+        group.first = std::min(group.first, idx);
+        ++group.end;
+        _channel_writes.emplace_back(
+            Channel::Write {ArrByteView(_data.data() + staged.offset, staged.byte_size), staged.byte_offset});
+    }
+}
+
+void ChannelTransaction::_notify()
+{
+    for (Group & group : _groups)
+        group.channel->_begin_notify();
+    // in the order of the transaction
+    std::sort(_groups.begin(), _groups.end(), [](const Group & a, const Group & b) { return a.first < b.first; });
+    for (const Group & group : _groups)
+    {
+        if (group.changed)
+            group.channel->_notify_observers();
+    }
+    for (Group & group : _groups)
+        group.channel->_end_notify();
+}
+
+bool ChannelTransaction::commit()
+{
+    return this->_commit(nullptr);
+}
+
+bool ChannelTransaction::commit(Timestamp timestamp)
+{
+    return this->_commit(&timestamp);
+}
+
+bool ChannelTransaction::_commit(const Timestamp *timestamp)
+{
+    if (_writes.empty())
+        return true;
+
+    this->_make_groups();
+    for (const Group & group : _groups)
+    {
+        std::unique_lock<std::mutex> & lock
+            = _notify_locks.emplace_back(group.channel->_notify_mutex, std::defer_lock);
+        if (!group.channel->_lock_notify(lock))
+        {
+            _notify_locks.clear();
+            return false;
+        }
+    }
+
+    bool ret = true;
+    {
+        for (const Group & group : _groups)
+            _array_locks.emplace_back(group.channel->_arr_mutex);
+        for (const Group & group : _groups)
+        {
+            const std::span<const Channel::Write> writes(&_channel_writes[group.begin], group.end - group.begin);
+            ret = ret && group.channel->_fit(writes);
+        }
+        if (ret)
+        {
+            _timestamp = timestamp != nullptr ? *timestamp : _writes.front().channel->_clock_ptr->now();
+            for (Group & group : _groups)
+            {
+                const std::span<const Channel::Write> writes(&_channel_writes[group.begin], group.end - group.begin);
+                ret = group.channel->_apply(writes, &_timestamp, group.changed, _old_buffers.emplace_back()) && ret;
+            }
+        }
+        _array_locks.clear();
+    }
+    // every write fits but applying one can still fail: the channels already changed are notified anyway
+    this->_notify();
+    _notify_locks.clear();
+    // previous buffers are released out of the locks
+    _old_buffers.clear();
+    if (ret)
+        this->clear();
+    return ret;
+}
+
+} // namespace sihd::core
@@ -1,5 +1,10 @@
+#include <numeric>
+#include <set>
+
 #include <sihd/core/Core.hpp>
 #include <sihd/util/Logger.hpp>
+#include <sihd/util/Splitter.hpp>
+#include <sihd/util/Waitable.hpp>
 #include <sihd/sys/NamedFactory.hpp>
 
 namespace sihd::core
@@ -9,10 +14,55 @@ SIHD_REGISTER_FACTORY(Core)
 
 SIHD_LOGGER;
 
+using namespace sihd::util;
+
+namespace
+{
+
+// descendants owned by node - resolved links belong to other nodes
+template <typename Callable>
+void for_each_descendant(Node *node, Callable && fn)
+{
+    for (const std::string & child_name : node->children_keys())
+    {
+        Named *child = node->get_child(child_name);
+        if (child == nullptr || child->parent() != node)
+            continue;
+        fn(child);
+        Node *child_node = dynamic_cast<Node *>(child);
+        if (child_node != nullptr)
+            for_each_descendant(child_node, fn);
+    }
+}
+
+// resolved links to services owned by other nodes
+template <typename Callable>
+bool for_each_linked_service(Node *node, Callable && fn)
+{
+    bool ret = true;
+    for (const std::string & child_name : node->children_keys())
+    {
+        Named *child = node->get_child(child_name);
+        AService *service = dynamic_cast<AService *>(child);
+        if (service != nullptr && child->parent() != node && fn(service, child_name) == false)
+            ret = false;
+    }
+    return ret;
+}
+
+} // namespace
+
 Core::Core(const std::string & name, sihd::util::Node *parent): sihd::core::Device(name, parent)
 {
     _running = false;
     _is_reset = true;
+    _startup_threads = 0;
+    _pipeline_executors = false;
+    _runtime_stats = false;
+    this->add_conf("startup_threads", &Core::set_startup_threads);
+    this->add_conf("dependency", &Core::add_dependency);
+    this->add_conf("pipeline_executors", &Core::set_pipeline_executors);
+    this->add_conf("runtime_stats", &Core::set_runtime_stats);
 }
 
 Core::~Core()
@@ -23,6 +73,449 @@ Core::~Core()
         this->reset();
 }
 
+bool Core::set_startup_threads(size_t threads)
+{
+    _startup_threads = threads;
+    return true;
+}
+
+bool Core::add_dependency(std::string_view conf)
+{
+    Splitter splitter("=");
+    std::vector<std::string> split = splitter.split(conf);
+    if (split.size() != 2)
+    {
+        SIHD_LOG(error, "Core: wrong dependency configuration: '{}' - expected CHILD=DEPENDENCY", conf);
+        return false;
+    }
+    _dependencies.emplace_back(split[0], split[1]);
+    return true;
+}
+
+bool Core::set_pipeline_executors(bool active)
+{
+    _pipeline_executors = active;
+    return true;
+}
+
+bool Core::set_runtime_stats(bool active)
+{
+    _runtime_stats = active;
+    this->_apply_runtime_stats();
+    return true;
+}
+
+void Core::_apply_runtime_stats()
+{
+    this->set_stats(_runtime_stats);
+    for_each_descendant(this, [this](Named *named) {
+        if (Channel *channel = dynamic_cast<Channel *>(named))
+            channel->set_stats(_runtime_stats);
+        else if (Device *device = dynamic_cast<Device *>(named))
+            device->set_stats(_runtime_stats);
+    });
+}
+
+CoreStats Core::runtime_stats()
+{
+    CoreStats stats;
+    if (this->stats_enabled())
+        stats.devices.emplace_back(this->stats());
+    for_each_descendant(this, [&stats](Named *named) {
+        if (Channel *channel = dynamic_cast<Channel *>(named))
+        {
+            if (channel->stats_enabled())
+                stats.channels.emplace_back(channel->stats());
+        }
+        else if (Device *device = dynamic_cast<Device *>(named))
+        {
+            if (device->stats_enabled())
+                stats.devices.emplace_back(device->stats());
+        }
+    });
+    return stats;
+}
+
+void Core::clear_runtime_stats()
+{
+    this->clear_stats();
+    for_each_descendant(this, [](Named *named) {
+        if (Channel *channel = dynamic_cast<Channel *>(named))
+            channel->clear_stats();
+        else if (Device *device = dynamic_cast<Device *>(named))
+            device->clear_stats();
+    });
+}
+
+const Named *Core::_link_owner(Node *node, const std::string & path)
+{
+    // the target may not exist yet: its closest existing parent gives the owner
+    std::string target = path;
+    Named *named = node->find(target);
+    while (named == nullptr)
+    {
+        auto [parent_path, child_name] = Node::parent_path(target);
+        if (child_name.empty())
+            return nullptr;
+        target = std::move(parent_path);
+        named = node->find(target);
+    }
+    while (named != nullptr && named->parent() != this)
+        named = named->parent();
+    return named;
+}
+
+void Core::_add_links_owners(Node *node, std::vector<const Named *> & owners)
+{
+    for (const auto & [link, path] : node->links())
+    {
+        const Named *owner = this->_link_owner(node, path);
+        if (owner != nullptr)
+            owners.push_back(owner);
+    }
+    for (const std::string & child_name : node->children_keys())
+    {
+        Node *child = dynamic_cast<Node *>(node->get_child(child_name));
+        // resolved links are children of other nodes
+        if (child != nullptr && child->parent() == node)
+            this->_add_links_owners(child, owners);
+    }
+}
+
+bool Core::_make_graph(std::vector<GraphNode> & graph)
+{
+    std::unordered_map<const Named *, size_t> indexes;
+    std::vector<const Named *> children;
+    for (const std::string & child_name : this->children_keys())
+    {
+        Named *child = this->get_child(child_name);
+        AService *service = dynamic_cast<AService *>(child);
+        if (service != nullptr && child->parent() == this)
+        {
+            indexes[child] = graph.size();
+            children.push_back(child);
+            graph.emplace_back(GraphNode {service, child_name, 0, {}});
+        }
+    }
+
+    std::vector<std::set<size_t>> dependencies(graph.size());
+    for (size_t i = 0; i < graph.size(); ++i)
+    {
+        Node *node = dynamic_cast<Node *>(const_cast<Named *>(children[i]));
+        if (node == nullptr)
+            continue;
+        std::vector<const Named *> owners;
+        this->_add_links_owners(node, owners);
+        for (const Named *owner : owners)
+        {
+            auto it = indexes.find(owner);
+            if (it != indexes.end() && it->second != i)
+                dependencies[i].insert(it->second);
+        }
+    }
+    for (const auto & [child_name, dependency_name] : _dependencies)
+    {
+        auto child_it = indexes.find(this->get_child(child_name));
+        auto dependency_it = indexes.find(this->get_child(dependency_name));
+        if (child_it == indexes.end() || dependency_it == indexes.end())
+        {
+            SIHD_LOG(error, "Core: {} no such service in dependency: {}={}", this->name(), child_name, dependency_name);
+            return false;
+        }
+        dependencies[child_it->second].insert(dependency_it->second);
+    }
+
+    for (size_t i = 0; i < graph.size(); ++i)
+    {
+        graph[i].dependencies = dependencies[i].size();
+        for (size_t dependency : dependencies[i])
+            graph[dependency].dependents.push_back(i);
+    }
+
+    // every service must be reachable from the ones without dependents
+    if (_dependents_first(graph).size() != graph.size())
+    {
+        SIHD_LOG(error, "Core: {} services have circular dependencies", this->name());
+        return false;
+    }
+    return true;
+}
+
+bool Core::_run_graph(const char *action,
+                      const std::vector<GraphNode> & graph,
+                      const ServiceAction & fn,
+                      std::vector<AService *> & done)
+{
+    if (graph.empty())
+        return true;
+
+    struct Run
+    {
+            const std::vector<GraphNode> & graph;
+            const ServiceAction & fn;
+            std::vector<AService *> & done;
+            std::vector<size_t> waiting;
+            Waitable waitable;
+            ThreadPool pool;
+            size_t running = 0;
+            bool failed = false;
+
+            // called with the waitable locked
+            void launch(size_t idx, Core *core, const char *action)
+            {
+                ++running;
+                pool.post_job([this, idx, core, action] {
+                    const bool success = fn(graph[idx].service);
+                    if (success == false)
+                        SIHD_LOG(error, "Core: {} could not {} service: {}", core->name(), action, graph[idx].name);
+                    auto l = waitable.guard();
+                    --running;
+                    if (success)
+                    {
+                        done.push_back(graph[idx].service);
+                        for (size_t dependent : graph[idx].dependents)
+                        {
+                            if (--waiting[dependent] == 0 && failed == false)
+                                this->launch(dependent, core, action);
+                        }
+                    }
+                    else
+                        failed = true;
+                    waitable.notify_all();
+                });
+            }
+    };
+
+    Run run {.graph = graph,
+             .fn = fn,
+             .done = done,
+             .waiting = std::vector<size_t>(graph.size()),
+             .waitable = {},
+             .pool = ThreadPool(fmt::format("{}-{}", this->name(), action), std::min(_startup_threads, graph.size()))};
+    {
+        auto l = run.waitable.guard();
+        for (size_t i = 0; i < graph.size(); ++i)
+        {
+            run.waiting[i] = graph[i].dependencies;
+            if (run.waiting[i] == 0)
+                run.launch(i, this, action);
+        }
+    }
+    run.waitable.wait([&run] { return run.running == 0; });
+    return run.failed == false && done.size() == graph.size();
+}
+
+bool Core::_make_executors()
+{
+    _executors.clear();
+    _executors_map.clear();
+
+    std::vector<GraphNode> graph;
+    if (this->_make_graph(graph) == false)
+        return false;
+    for (const std::vector<std::string> & pipeline : _pipelines(graph))
+    {
+        auto & executor = _executors.emplace_back(
+            std::make_unique<ThreadPool>(fmt::format("{}-{}", this->name(), pipeline.front()), 1));
+        for (const std::string & child_name : pipeline)
+            _executors_map[this->get_child(child_name)] = executor.get();
+    }
+    return true;
+}
+
+std::vector<std::vector<std::string>> Core::pipelines()
+{
+    std::vector<GraphNode> graph;
+    if (this->_make_graph(graph) == false)
+        return {};
+    return _pipelines(graph);
+}
+
+std::vector<std::vector<std::string>> Core::_pipelines(const std::vector<GraphNode> & graph)
+{
+    // union find of the dependencies in both directions
+    std::vector<size_t> roots(graph.size());
+    std::iota(roots.begin(), roots.end(), 0);
+    auto root = [&roots](size_t idx) {
+        while (roots[idx] != idx)
+            idx = roots[idx] = roots[roots[idx]];
+        return idx;
+    };
+    for (size_t i = 0; i < graph.size(); ++i)
+    {
+        for (size_t dependent : graph[i].dependents)
+            roots[root(dependent)] = root(i);
+    }
+
+    std::vector<std::vector<std::string>> pipelines;
+    std::unordered_map<size_t, size_t> pipeline_of_root;
+    for (size_t i = 0; i < graph.size(); ++i)
+    {
+        auto [it, inserted] = pipeline_of_root.try_emplace(root(i), pipelines.size());
+        if (inserted)
+            pipelines.emplace_back();
+        pipelines[it->second].push_back(graph[i].name);
+    }
+    return pipelines;
+}
+
+ThreadPool *Core::executor(const Named *descendant) const
+{
+    while (descendant != nullptr && descendant->cparent() != this)
+        descendant = descendant->cparent();
+    auto it = _executors_map.find(descendant);
+    return it != _executors_map.end() ? it->second : nullptr;
+}
+
+bool Core::do_setup()
+{
+    if (_startup_threads == 0)
+        return Device::do_setup();
+
+    std::vector<GraphNode> graph;
+    std::vector<AService *> done;
+    const bool ret = this->_make_graph(graph)
+                     && this->_run_graph("setup", graph, [](AService *service) { return service->setup(); }, done);
+    return ret && this->on_setup();
+}
+
+bool Core::do_init()
+{
+    if (_startup_threads == 0)
+        return Device::do_init();
+
+    std::vector<GraphNode> graph;
+    std::vector<AService *> done;
+    const bool ret = this->_make_graph(graph)
+                     && this->_run_graph("init", graph, [](AService *service) { return service->init(); }, done);
+    return ret && this->on_init();
+}
+
+bool Core::do_start()
+{
+    // devices can get their executor while starting
+    if (_pipeline_executors && this->_make_executors() == false)
+        return false;
+    if (_runtime_stats)
+        this->_apply_runtime_stats();
+
+    bool ret;
+    if (_startup_threads == 0)
+        ret = Device::do_start();
+    else
+    {
+        std::vector<GraphNode> graph;
+        std::vector<AService *> started;
+        ret = this->_make_graph(graph)
+              && this->_run_graph("start", graph, [](AService *service) { return service->start(); }, started);
+        ret = ret && this->resolve_links();
+        if (ret)
+            ret = this->on_start();
+        if (ret == false)
+        {
+            // dependents first
+            for (auto it = started.rbegin(); it != started.rend(); ++it)
+                (*it)->stop();
+        }
+    }
+    if (ret == false)
+    {
+        _executors_map.clear();
+        _executors.clear();
+    }
+    return ret;
+}
+
+std::vector<size_t> Core::_dependents_first(const std::vector<GraphNode> & graph)
+{
+    std::vector<size_t> order;
+    std::vector<size_t> waiting(graph.size());
+    std::set<size_t> ready;
+    for (size_t i = 0; i < graph.size(); ++i)
+    {
+        waiting[i] = graph[i].dependents.size();
+        if (waiting[i] == 0)
+            ready.insert(i);
+    }
+    std::vector<std::vector<size_t>> dependencies(graph.size());
+    for (size_t i = 0; i < graph.size(); ++i)
+    {
+        for (size_t dependent : graph[i].dependents)
+            dependencies[dependent].push_back(i);
+    }
+    while (!ready.empty())
+    {
+        const size_t idx = *ready.begin();
+        ready.erase(ready.begin());
+        order.push_back(idx);
+        for (size_t dependency : dependencies[idx])
+        {
+            if (--waiting[dependency] == 0)
+                ready.insert(dependency);
+        }
+    }
+    return order;
+}
+
+bool Core::do_stop()
+{
+    std::vector<GraphNode> graph;
+    if (this->_make_graph(graph) == false)
+        return Device::do_stop();
+
+    this->remove_channels_observation();
+    bool ret = true;
+    for (size_t idx : _dependents_first(graph))
+    {
+        if (graph[idx].service->stop() == false)
+        {
+            SIHD_LOG(error, "Core: {} could not stop service: {}", this->name(), graph[idx].name);
+            ret = false;
+        }
+    }
+    // services linked to the core are not part of the graph: after its children, as a device does
+    ret = for_each_linked_service(this, [this](AService *service, const std::string & child_name) {
+        if (service->stop() == false)
+        {
+            SIHD_LOG(error, "Core: {} could not stop service: {}", this->name(), child_name);
+            return false;
+        }
+        return true;
+    }) && ret;
+    _executors_map.clear();
+    _executors.clear();
+    return this->on_stop() && ret;
+}
+
+bool Core::do_reset()
+{
+    std::vector<GraphNode> graph;
+    if (this->_make_graph(graph) == false)
+        return Device::do_reset();
+
+    // dependents hold links to the channels of their dependencies
+    bool ret = true;
+    for (size_t idx : _dependents_first(graph))
+    {
+        if (graph[idx].service->reset() == false)
+        {
+            SIHD_LOG(error, "Core: {} could not reset service: {}", this->name(), graph[idx].name);
+            ret = false;
+        }
+    }
+    // services linked to the core are not part of the graph: after its children, as a device does
+    ret = for_each_linked_service(this, [this](AService *service, const std::string & child_name) {
+        if (service->reset() == false)
+        {
+            SIHD_LOG(error, "Core: {} could not reset service: {}", this->name(), child_name);
+            return false;
+        }
+        return true;
+    }) && ret;
+    this->remove_children();
+    return this->on_reset() && ret;
+}
+
 bool Core::on_init()
 {
     _is_reset = false;
@@ -47,4 +540,4 @@ bool Core::on_reset()
     return true;
 }
 
-} // namespace sihd::core
\ No newline at end of file
+} // namespace sihd::core
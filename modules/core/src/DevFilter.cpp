@@ -1,3 +1,9 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+
 #include <sihd/core/DevFilter.hpp>
 #include <sihd/sys/NamedFactory.hpp>
 #include <sihd/util/Logger.hpp>
@@ -14,6 +20,8 @@
 #define CONF_KEY_WRITE "write"
 #define CONF_KEY_MATCH "match"
 #define CONF_KEY_DELAY "delay"
+#define CONF_KEY_COMPARE "compare"
+#define CONF_KEY_SLICE "slice"
 
 namespace sihd::core
 {
@@ -180,6 +188,135 @@ bool parse_write_config(DevFilter::Rule & rule, const util::StrConfiguration & c
     return true;
 }
 
+bool parse_compare_config(DevFilter::ArrayRule & rule, const util::StrConfiguration & conf)
+{
+    auto key_compare = conf.find(CONF_KEY_COMPARE);
+
+    if (key_compare.has_value() == false)
+    {
+        // only needed by operations comparing elements
+        if (rule.operation == DevFilter::Any || rule.operation == DevFilter::All || rule.operation == DevFilter::Count
+            || rule.operation == DevFilter::First)
+        {
+            SIHD_LOG_ERROR("DevFilter: no comparison '{}' in array configuration", CONF_KEY_COMPARE);
+            return false;
+        }
+        return true;
+    }
+
+    // conf -> compare=type:value
+    sihd::util::Splitter splitter(":");
+    std::vector<std::string> split_compare = splitter.split(*key_compare);
+    if (split_compare.size() != 2)
+    {
+        SIHD_LOG_ERROR("DevFilter: compare conf error: '{}' - expected TYPE:VALUE", *key_compare);
+        return false;
+    }
+
+    static const std::map<std::string, util::array_reduce::Compare, std::less<>> compare_types = {
+        {"equal", util::array_reduce::Equal},
+        {"not_equal", util::array_reduce::NotEqual},
+        {"superior", util::array_reduce::Superior},
+        {"superior_equal", util::array_reduce::SuperiorEqual},
+        {"inferior", util::array_reduce::Inferior},
+        {"inferior_equal", util::array_reduce::InferiorEqual},
+    };
+    const auto it = compare_types.find(split_compare[0]);
+    if (it == compare_types.end())
+    {
+        SIHD_LOG_ERROR("DevFilter: unknown comparison: {}", split_compare[0]);
+        return false;
+    }
+    rule.compare_type = it->second;
+    rule.compare_value = util::Value::from_any_string(split_compare[1]);
+    if (rule.compare_value.empty())
+    {
+        SIHD_LOG_ERROR("DevFilter: cannot convert compare value: {}", split_compare[1]);
+        return false;
+    }
+    return true;
+}
+
+bool parse_slice_config(DevFilter::ArrayRule & rule, const util::StrConfiguration & conf)
+{
+    auto [key_slice, key_write] = conf.find_all(CONF_KEY_SLICE, CONF_KEY_WRITE);
+
+    if (key_slice.has_value())
+    {
+        // conf -> slice=from:to - both can be empty
+        const size_t delimiter = key_slice->find(':');
+        if (delimiter == std::string::npos)
+        {
+            SIHD_LOG_ERROR("DevFilter: slice conf error: '{}' - expected FROM:TO", *key_slice);
+            return false;
+        }
+        const std::string_view slice = *key_slice;
+        const std::string_view bounds[2] = {slice.substr(0, delimiter), slice.substr(delimiter + 1)};
+        for (size_t i = 0; i < 2; ++i)
+        {
+            if (bounds[i].empty())
+                continue;
+            const auto idx = util::str::convert_from_string<size_t>(bounds[i]);
+            if (idx.has_value() == false)
+            {
+                SIHD_LOG_ERROR("DevFilter: cannot convert slice idx: {}", bounds[i]);
+                return false;
+            }
+            (i == 0 ? rule.slice_from : rule.slice_to) = *idx;
+        }
+    }
+    if (key_write.has_value())
+    {
+        // conf -> write=index
+        const auto write_idx = util::str::convert_from_string<size_t>(*key_write);
+        if (write_idx.has_value() == false)
+        {
+            SIHD_LOG_ERROR("DevFilter: cannot convert write idx: {}", *key_write);
+            return false;
+        }
+        rule.write_idx = *write_idx;
+    }
+    return true;
+}
+
+template <typename T>
+bool integer_fits(int64_t value)
+{
+    if constexpr (std::is_same_v<T, uint64_t>)
+        return value >= 0;
+    else if constexpr (std::is_same_v<T, int64_t>)
+        return true;
+    else
+        return value >= (int64_t)std::numeric_limits<T>::min() && value <= (int64_t)std::numeric_limits<T>::max();
+}
+
+// array comparisons are done in the type of the channel
+bool integer_fits(int64_t value, util::Type type)
+{
+    switch (type)
+    {
+        case util::TYPE_BOOL:
+        case util::TYPE_UBYTE:
+            return integer_fits<uint8_t>(value);
+        case util::TYPE_CHAR:
+            return integer_fits<char>(value);
+        case util::TYPE_BYTE:
+            return integer_fits<int8_t>(value);
+        case util::TYPE_SHORT:
+            return integer_fits<int16_t>(value);
+        case util::TYPE_USHORT:
+            return integer_fits<uint16_t>(value);
+        case util::TYPE_INT:
+            return integer_fits<int32_t>(value);
+        case util::TYPE_UINT:
+            return integer_fits<uint32_t>(value);
+        case util::TYPE_ULONG:
+            return integer_fits<uint64_t>(value);
+        default:
+            return true;
+    }
+}
+
 } // namespace
 
 SIHD_REGISTER_FACTORY(DevFilter)
@@ -198,6 +335,13 @@ DevFilter::DevFilter(const std::string & name, sihd::util::Node *parent):
     this->add_conf("filter_byte_and", &DevFilter::set_filter_byte_and);
     this->add_conf("filter_byte_or", &DevFilter::set_filter_byte_or);
     this->add_conf("filter_byte_xor", &DevFilter::set_filter_byte_xor);
+    this->add_conf("filter_any", &DevFilter::set_filter_any);
+    this->add_conf("filter_all", &DevFilter::set_filter_all);
+    this->add_conf("filter_count", &DevFilter::set_filter_count);
+    this->add_conf("filter_min", &DevFilter::set_filter_min);
+    this->add_conf("filter_max", &DevFilter::set_filter_max);
+    this->add_conf("filter_mean", &DevFilter::set_filter_mean);
+    this->add_conf("filter_first", &DevFilter::set_filter_first);
 }
 
 DevFilter::~DevFilter() = default;
@@ -212,6 +356,16 @@ bool DevFilter::_parse_conf(std::string_view rule_str, RuleType type)
     return ret;
 }
 
+bool DevFilter::_parse_array_conf(std::string_view rule_str, ArrayOperation operation)
+{
+    // in=channel_path_in;out=channel_path_out;compare=type:val;slice=from:to;write=idx
+    ArrayRule rule(operation);
+    bool ret = rule.parse(rule_str);
+    if (ret)
+        this->set_array_filter(rule);
+    return ret;
+}
+
 void DevFilter::set_filter(const Rule & rule)
 {
     if (rule.nano_delay > 0)
@@ -219,6 +373,11 @@ void DevFilter::set_filter(const Rule & rule)
     _rules_lst.push_back(rule);
 }
 
+void DevFilter::set_array_filter(const ArrayRule & rule)
+{
+    _array_rules_lst.push_back(rule);
+}
+
 bool DevFilter::set_filter_equal(std::string_view rule_str)
 {
     return this->_parse_conf(rule_str, Equal);
@@ -259,55 +418,286 @@ bool DevFilter::set_filter_byte_xor(std::string_view rule_str)
     return this->_parse_conf(rule_str, ByteXor);
 }
 
-void DevFilter::_rule_match(Channel *channel_out, const Rule *rule_ptr, int64_t out_val)
+bool DevFilter::set_filter_any(std::string_view rule_str)
+{
+    return this->_parse_array_conf(rule_str, Any);
+}
+
+bool DevFilter::set_filter_all(std::string_view rule_str)
+{
+    return this->_parse_array_conf(rule_str, All);
+}
+
+bool DevFilter::set_filter_count(std::string_view rule_str)
+{
+    return this->_parse_array_conf(rule_str, Count);
+}
+
+bool DevFilter::set_filter_min(std::string_view rule_str)
+{
+    return this->_parse_array_conf(rule_str, Min);
+}
+
+bool DevFilter::set_filter_max(std::string_view rule_str)
+{
+    return this->_parse_array_conf(rule_str, Max);
+}
+
+bool DevFilter::set_filter_mean(std::string_view rule_str)
+{
+    return this->_parse_array_conf(rule_str, Mean);
+}
+
+bool DevFilter::set_filter_first(std::string_view rule_str)
 {
-    const sihd::util::IArray *array_out = channel_out->array();
-    channel_out->write({(const int8_t *)&out_val, array_out->data_size()}, array_out->byte_index(rule_ptr->write_idx));
+    return this->_parse_array_conf(rule_str, First);
+}
+
+template <typename T, DevFilter::RuleType R>
+bool DevFilter::_evaluate(const uint8_t *element, const CompiledRule & rule)
+{
+    if constexpr (R == ByteAnd || R == ByteOr || R == ByteXor)
+    {
+        uint64_t bits = 0;
+        memcpy(&bits, element, sizeof(T));
+        if constexpr (R == ByteAnd)
+            return (bits & rule.trigger_bits) != 0;
+        else if constexpr (R == ByteOr)
+            return (bits | rule.trigger_bits) != 0;
+        else
+            return (bits ^ rule.trigger_bits) != 0;
+    }
+    else
+    {
+        T value;
+        memcpy(&value, element, sizeof(T));
+        bool equal;
+        bool inferior;
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            const T trigger = (T)rule.trigger_float;
+            const T epsilon = (T)rule.epsilon;
+            equal = epsilon > 0 ? std::abs(value - trigger) < epsilon : value == trigger;
+            inferior = !equal && value + epsilon < trigger;
+        }
+        else
+        {
+            const int64_t integer = (int64_t)value;
+            equal = integer == rule.trigger_integer;
+            inferior = integer < rule.trigger_integer;
+        }
+        if constexpr (R == Equal)
+            return equal;
+        else if constexpr (R == Superior)
+            return !equal && !inferior;
+        else if constexpr (R == SuperiorEqual)
+            return !inferior;
+        else if constexpr (R == Inferior)
+            return inferior;
+        else if constexpr (R == InferiorEqual)
+            return equal || inferior;
+        else
+            return false;
+    }
 }
 
-void DevFilter::_apply_rule(const sihd::core::Channel *channel_in,
-                            sihd::core::Channel *channel_out,
-                            const Rule *rule_ptr)
+template <typename T>
+DevFilter::Predicate DevFilter::_predicate(RuleType type)
 {
-    const sihd::util::IArray *array_in = channel_in->array();
-    sihd::util::Value in_value(array_in->buf_at(rule_ptr->trigger_idx), array_in->data_type());
-    bool matched = false;
-    switch (rule_ptr->type)
+    switch (type)
     {
         case Equal:
-            matched = in_value == rule_ptr->trigger_value;
-            break;
+            return &DevFilter::_evaluate<T, Equal>;
         case Superior:
-            matched = in_value > rule_ptr->trigger_value;
-            break;
+            return &DevFilter::_evaluate<T, Superior>;
         case SuperiorEqual:
-            matched = in_value >= rule_ptr->trigger_value;
-            break;
+            return &DevFilter::_evaluate<T, SuperiorEqual>;
         case Inferior:
-            matched = in_value < rule_ptr->trigger_value;
-            break;
+            return &DevFilter::_evaluate<T, Inferior>;
         case InferiorEqual:
-            matched = in_value <= rule_ptr->trigger_value;
-            break;
+            return &DevFilter::_evaluate<T, InferiorEqual>;
         case ByteAnd:
-            matched = (in_value.data.n & rule_ptr->trigger_value.data.n) != 0;
-            break;
+            return &DevFilter::_evaluate<T, ByteAnd>;
         case ByteOr:
-            matched = (in_value.data.n | rule_ptr->trigger_value.data.n) != 0;
-            break;
+            return &DevFilter::_evaluate<T, ByteOr>;
         case ByteXor:
-            matched = (in_value.data.n ^ rule_ptr->trigger_value.data.n) != 0;
-            break;
+            return &DevFilter::_evaluate<T, ByteXor>;
         default:
-            break;
+            return nullptr;
+    }
+}
+
+DevFilter::Predicate DevFilter::_predicate(sihd::util::Type data_type, RuleType type)
+{
+    switch (data_type)
+    {
+        case sihd::util::TYPE_BOOL:
+            return _predicate<bool>(type);
+        case sihd::util::TYPE_CHAR:
+            return _predicate<char>(type);
+        case sihd::util::TYPE_BYTE:
+            return _predicate<int8_t>(type);
+        case sihd::util::TYPE_UBYTE:
+            return _predicate<uint8_t>(type);
+        case sihd::util::TYPE_SHORT:
+            return _predicate<int16_t>(type);
+        case sihd::util::TYPE_USHORT:
+            return _predicate<uint16_t>(type);
+        case sihd::util::TYPE_INT:
+            return _predicate<int32_t>(type);
+        case sihd::util::TYPE_UINT:
+            return _predicate<uint32_t>(type);
+        case sihd::util::TYPE_LONG:
+            return _predicate<int64_t>(type);
+        case sihd::util::TYPE_ULONG:
+            return _predicate<uint64_t>(type);
+        case sihd::util::TYPE_FLOAT:
+            return _predicate<float>(type);
+        case sihd::util::TYPE_DOUBLE:
+            return _predicate<double>(type);
+        default:
+            return nullptr;
     }
-    if (rule_ptr->should_match == matched)
+}
+
+void DevFilter::_write(Channel *channel_out, size_t offset, size_t size, int64_t value)
+{
+    channel_out->write({(const int8_t *)&value, size}, offset);
+}
+
+template <typename T, DevFilter::ArrayOperation O>
+void DevFilter::_reduce(const uint8_t *buf, const CompiledArrayRule & rule)
+{
+    namespace array_reduce = sihd::util::array_reduce;
+
+    const T *data = reinterpret_cast<const T *>(buf + rule.offset);
+    const T value = std::is_floating_point_v<T> ? (T)rule.compare_float : (T)rule.compare_integer;
+    if constexpr (O == Any)
+        _write_result<int32_t>(rule.channel_out,
+                               rule.write_idx,
+                               array_reduce::any(data, rule.size, rule.compare_type, value));
+    else if constexpr (O == All)
+        _write_result<int32_t>(rule.channel_out,
+                               rule.write_idx,
+                               array_reduce::all(data, rule.size, rule.compare_type, value));
+    else if constexpr (O == Count)
+        _write_result<uint64_t>(rule.channel_out,
+                                rule.write_idx,
+                                array_reduce::count(data, rule.size, rule.compare_type, value));
+    else if constexpr (O == Min)
+        _write_result<T>(rule.channel_out, rule.write_idx, array_reduce::min(data, rule.size));
+    else if constexpr (O == Max)
+        _write_result<T>(rule.channel_out, rule.write_idx, array_reduce::max(data, rule.size));
+    else if constexpr (O == Mean)
+        _write_result<double>(rule.channel_out, rule.write_idx, array_reduce::mean(data, rule.size));
+    else
     {
-        int64_t out_val = rule_ptr->write_same_value ? in_value.data.n : rule_ptr->write_value.data.n;
-        if (rule_ptr->nano_delay > 0 && _scheduler_ptr != nullptr)
-            _scheduler_ptr->add_task(new DelayWriter(this, channel_out, rule_ptr, out_val));
-        else
-            this->_rule_match(channel_out, rule_ptr, out_val);
+        const size_t idx = array_reduce::first(data, rule.size, rule.compare_type, value);
+        _write_result<int64_t>(rule.channel_out, rule.write_idx, idx < rule.size ? (int64_t)idx : -1);
+    }
+}
+
+template <typename T>
+DevFilter::Reducer DevFilter::_reducer(ArrayOperation operation)
+{
+    switch (operation)
+    {
+        case Any:
+            return &DevFilter::_reduce<T, Any>;
+        case All:
+            return &DevFilter::_reduce<T, All>;
+        case Count:
+            return &DevFilter::_reduce<T, Count>;
+        case Min:
+            return &DevFilter::_reduce<T, Min>;
+        case Max:
+            return &DevFilter::_reduce<T, Max>;
+        case Mean:
+            return &DevFilter::_reduce<T, Mean>;
+        case First:
+            return &DevFilter::_reduce<T, First>;
+        default:
+            return nullptr;
+    }
+}
+
+DevFilter::Reducer DevFilter::_reducer(sihd::util::Type data_type, ArrayOperation operation)
+{
+    switch (data_type)
+    {
+        // reduced as their byte representation
+        case sihd::util::TYPE_BOOL:
+            return _reducer<uint8_t>(operation);
+        case sihd::util::TYPE_CHAR:
+            return _reducer<char>(operation);
+        case sihd::util::TYPE_BYTE:
+            return _reducer<int8_t>(operation);
+        case sihd::util::TYPE_UBYTE:
+            return _reducer<uint8_t>(operation);
+        case sihd::util::TYPE_SHORT:
+            return _reducer<int16_t>(operation);
+        case sihd::util::TYPE_USHORT:
+            return _reducer<uint16_t>(operation);
+        case sihd::util::TYPE_INT:
+            return _reducer<int32_t>(operation);
+        case sihd::util::TYPE_UINT:
+            return _reducer<uint32_t>(operation);
+        case sihd::util::TYPE_LONG:
+            return _reducer<int64_t>(operation);
+        case sihd::util::TYPE_ULONG:
+            return _reducer<uint64_t>(operation);
+        case sihd::util::TYPE_FLOAT:
+            return _reducer<float>(operation);
+        case sihd::util::TYPE_DOUBLE:
+            return _reducer<double>(operation);
+        default:
+            return nullptr;
+    }
+}
+
+template <typename T>
+void DevFilter::_write_result(Channel *channel_out, size_t idx, T result)
+{
+    switch (channel_out->array()->data_type())
+    {
+        case sihd::util::TYPE_BOOL:
+            channel_out->write<bool>(idx, result != 0);
+            break;
+        case sihd::util::TYPE_CHAR:
+            channel_out->write<char>(idx, (char)result);
+            break;
+        case sihd::util::TYPE_BYTE:
+            channel_out->write<int8_t>(idx, (int8_t)result);
+            break;
+        case sihd::util::TYPE_UBYTE:
+            channel_out->write<uint8_t>(idx, (uint8_t)result);
+            break;
+        case sihd::util::TYPE_SHORT:
+            channel_out->write<int16_t>(idx, (int16_t)result);
+            break;
+        case sihd::util::TYPE_USHORT:
+            channel_out->write<uint16_t>(idx, (uint16_t)result);
+            break;
+        case sihd::util::TYPE_INT:
+            channel_out->write<int32_t>(idx, (int32_t)result);
+            break;
+        case sihd::util::TYPE_UINT:
+            channel_out->write<uint32_t>(idx, (uint32_t)result);
+            break;
+        case sihd::util::TYPE_LONG:
+            channel_out->write<int64_t>(idx, (int64_t)result);
+            break;
+        case sihd::util::TYPE_ULONG:
+            channel_out->write<uint64_t>(idx, (uint64_t)result);
+            break;
+        case sihd::util::TYPE_FLOAT:
+            channel_out->write<float>(idx, (float)result);
+            break;
+        case sihd::util::TYPE_DOUBLE:
+            channel_out->write<double>(idx, (double)result);
+            break;
+        default:
+            break;
     }
 }
 
@@ -316,12 +706,39 @@ void DevFilter::handle(sihd::core::Channel *channel)
     std::lock_guard l(_run_mutex);
     if (_running == false)
         return;
-    auto it = _rules_map.find(channel);
-    if (it == _rules_map.end())
+    auto it = std::lower_bound(_channel_rules.begin(),
+                               _channel_rules.end(),
+                               channel,
+                               [](const ChannelRules & rules, const Channel *c) { return rules.channel_in < c; });
+    if (it == _channel_rules.end() || it->channel_in != channel)
         return;
-    for (const std::unique_ptr<InternalRule> & rule_uptr : it->second)
+
+    const uint8_t *buf = channel->array()->buf();
+    for (size_t i = it->begin; i < it->end; ++i)
+    {
+        const CompiledRule & rule = _compiled_rules[i];
+        const uint8_t *element = buf + rule.trigger_offset;
+        if (rule.predicate(element, rule) != rule.should_match)
+            continue;
+
+        int64_t value = rule.write_value;
+        if (rule.write_same_value)
+        {
+            value = 0;
+            memcpy(&value, element, rule.trigger_size);
+        }
+        if (rule.nano_delay > 0 && _scheduler_ptr != nullptr)
+        {
+            _scheduler_ptr->add_task(
+                new DelayWriter(rule.channel_out, rule.write_offset, rule.write_size, value, rule.nano_delay));
+        }
+        else
+            _write(rule.channel_out, rule.write_offset, rule.write_size, value);
+    }
+    for (size_t i = it->array_begin; i < it->array_end; ++i)
     {
-        this->_apply_rule(channel, rule_uptr.get()->channel_out_ptr, rule_uptr.get()->rule_ptr);
+        const CompiledArrayRule & rule = _compiled_array_rules[i];
+        rule.reducer(buf, rule);
     }
 }
 
@@ -352,15 +769,17 @@ bool DevFilter::on_start()
     bool ret;
     Channel *channel_in;
     Channel *channel_out;
+    std::vector<std::pair<Channel *, CompiledRule>> compiled_rules;
+    std::vector<std::pair<Channel *, CompiledArrayRule>> compiled_array_rules;
 
     ret = true;
     for (const Rule & conf : _rules_lst)
     {
         if (this->find_channel(conf.channel_in, &channel_in) && this->find_channel(conf.channel_out, &channel_out))
         {
-            std::unique_ptr<InternalRule> rule(new InternalRule());
-            if (rule.get()->set(&conf, channel_in, channel_out))
-                _rules_map[channel_in].push_back(std::move(rule));
+            CompiledRule compiled;
+            if (_compile(conf, channel_in, channel_out, compiled))
+                compiled_rules.emplace_back(channel_in, compiled);
             else
                 ret = false;
             ret = ret && this->observe_channel(channel_in);
@@ -368,8 +787,54 @@ bool DevFilter::on_start()
         else
             ret = false;
     }
+    for (const ArrayRule & conf : _array_rules_lst)
+    {
+        if (this->find_channel(conf.channel_in, &channel_in) && this->find_channel(conf.channel_out, &channel_out))
+        {
+            CompiledArrayRule compiled;
+            if (_compile(conf, channel_in, channel_out, compiled))
+                compiled_array_rules.emplace_back(channel_in, compiled);
+            else
+                ret = false;
+            ret = ret && this->observe_channel(channel_in);
+        }
+        else
+            ret = false;
+    }
+
+    // groups the rules of an input channel keeping their configuration order
+    const auto by_channel = [](const auto & a, const auto & b) { return a.first < b.first; };
+    std::stable_sort(compiled_rules.begin(), compiled_rules.end(), by_channel);
+    std::stable_sort(compiled_array_rules.begin(), compiled_array_rules.end(), by_channel);
     {
         std::lock_guard l(_run_mutex);
+        _compiled_rules.clear();
+        _compiled_array_rules.clear();
+        _channel_rules.clear();
+        auto channel_rules = [this](Channel *channel) -> ChannelRules & {
+            auto it = std::lower_bound(
+                _channel_rules.begin(),
+                _channel_rules.end(),
+                channel,
+                [](const ChannelRules & rules, const Channel *c) { return rules.channel_in < c; });
+            if (it == _channel_rules.end() || it->channel_in != channel)
+            {
+                const size_t begin = _compiled_rules.size();
+                const size_t array_begin = _compiled_array_rules.size();
+                it = _channel_rules.insert(it, ChannelRules {channel, begin, begin, array_begin, array_begin});
+            }
+            return *it;
+        };
+        for (const auto & [channel, compiled] : compiled_rules)
+        {
+            ++channel_rules(channel).end;
+            _compiled_rules.emplace_back(compiled);
+        }
+        for (const auto & [channel, compiled] : compiled_array_rules)
+        {
+            ++channel_rules(channel).array_end;
+            _compiled_array_rules.emplace_back(compiled);
+        }
         _running = ret;
     }
     return ret;
@@ -380,7 +845,9 @@ bool DevFilter::on_stop()
     {
         std::lock_guard l(_run_mutex);
         _running = false;
-        _rules_map.clear();
+        _compiled_rules.clear();
+        _compiled_array_rules.clear();
+        _channel_rules.clear();
     }
     return true;
 }
@@ -388,6 +855,7 @@ bool DevFilter::on_stop()
 bool DevFilter::on_reset()
 {
     _rules_lst.clear();
+    _array_rules_lst.clear();
     _rule_with_delay = false;
     _scheduler_ptr = nullptr;
     return true;
@@ -479,16 +947,80 @@ bool DevFilter::Rule::parse(std::string_view conf_str)
     return parse_trigger_config(*this, conf) && parse_write_config(*this, conf) && parse_options_config(*this, conf);
 }
 
+/* ************************************************************************* */
+/* DevFilter::ArrayRule */
+/* ************************************************************************* */
+
+DevFilter::ArrayRule::ArrayRule(ArrayOperation operation):
+    operation(operation),
+    compare_type(sihd::util::array_reduce::Equal),
+    compare_value(0),
+    slice_from(0),
+    slice_to(0),
+    write_idx(0)
+{
+}
+
+DevFilter::ArrayRule::~ArrayRule() = default;
+
+DevFilter::ArrayRule & DevFilter::ArrayRule::in(std::string_view channel_name)
+{
+    this->channel_in = channel_name;
+    return *this;
+}
+
+DevFilter::ArrayRule & DevFilter::ArrayRule::out(std::string_view channel_name)
+{
+    this->channel_out = channel_name;
+    return *this;
+}
+
+DevFilter::ArrayRule & DevFilter::ArrayRule::slice(size_t from, size_t to)
+{
+    this->slice_from = from;
+    this->slice_to = to;
+    return *this;
+}
+
+DevFilter::ArrayRule & DevFilter::ArrayRule::write(size_t idx)
+{
+    this->write_idx = idx;
+    return *this;
+}
+
+bool DevFilter::ArrayRule::parse(std::string_view conf_str)
+{
+    util::StrConfiguration conf(conf_str);
+
+    auto [channel_in_name, channel_out_name] = conf.find_all(CONF_KEY_CHANNEL_IN, CONF_KEY_CHANNEL_OUT);
+
+    if (channel_in_name.has_value() == false)
+        SIHD_LOG_ERROR("DevFilter: no channel input '{}' in configuration: {}", CONF_KEY_CHANNEL_IN, conf_str);
+    if (channel_out_name.has_value() == false)
+        SIHD_LOG_ERROR("DevFilter: no channel output '{}' in configuration: {}", CONF_KEY_CHANNEL_OUT, conf_str);
+
+    if (channel_in_name.has_value() == false || channel_out_name.has_value() == false)
+        return false;
+
+    this->channel_in = *channel_in_name;
+    this->channel_out = *channel_out_name;
+    return parse_compare_config(*this, conf) && parse_slice_config(*this, conf);
+}
+
 /* ************************************************************************* */
 /* DevFilter::DelayWriter */
 /* ************************************************************************* */
 
-DevFilter::DelayWriter::DelayWriter(DevFilter *dev, Channel *channel_out, const Rule *rule_ptr, int64_t out_val):
-    sihd::util::Task(this, {.run_in = rule_ptr->nano_delay}),
-    dev(dev),
+DevFilter::DelayWriter::DelayWriter(Channel *channel_out,
+                                    size_t offset,
+                                    size_t size,
+                                    int64_t value,
+                                    sihd::util::Duration delay):
+    sihd::util::Task(this, {.run_in = delay}),
     channel_out(channel_out),
-    rule_ptr(rule_ptr),
-    out_val(out_val)
+    offset(offset),
+    size(size),
+    value(value)
 {
 }
 
@@ -496,70 +1028,215 @@ DevFilter::DelayWriter::~DelayWriter() = default;
 
 bool DevFilter::DelayWriter::run()
 {
-    this->dev->_rule_match(this->channel_out, this->rule_ptr, this->out_val);
+    DevFilter::_write(this->channel_out, this->offset, this->size, this->value);
     return true;
 }
 
+sihd::util::ObjectPool<DevFilter::DelayWriter> & DevFilter::DelayWriter::_pool()
+{
+    // never destroyed: a scheduler may delete its tasks during static destruction
+    static auto *pool = new sihd::util::ObjectPool<DelayWriter>();
+    return *pool;
+}
+
+void *DevFilter::DelayWriter::operator new(size_t size)
+{
+    if (size != sizeof(DelayWriter))
+        return ::operator new(size);
+    return _pool().allocate();
+}
+
+void DevFilter::DelayWriter::operator delete(void *ptr, size_t size)
+{
+    if (size != sizeof(DelayWriter))
+        ::operator delete(ptr);
+    else
+        _pool().deallocate(ptr);
+}
+
 /* ************************************************************************* */
-/* DevFilter::InternalRule */
+/* DevFilter::CompiledRule */
 /* ************************************************************************* */
 
-DevFilter::InternalRule::InternalRule(): channel_in_ptr(nullptr), channel_out_ptr(nullptr), rule_ptr(nullptr) {}
+bool DevFilter::_compile(const Rule & rule, Channel *in, Channel *out, CompiledRule & compiled)
+{
+    if (_verify(rule, in, out) == false)
+        return false;
 
-DevFilter::InternalRule::~InternalRule() = default;
+    const sihd::util::IArray *array_in = in->array();
+    const sihd::util::IArray *array_out = out->array();
+    compiled.predicate = _predicate(array_in->data_type(), rule.type);
+    if (compiled.predicate == nullptr)
+    {
+        SIHD_LOG_ERROR("DevFilter: cannot filter channel input '{}' of type {}",
+                       rule.channel_in,
+                       sihd::util::type::str(array_in->data_type()));
+        return false;
+    }
+    compiled.trigger_offset = array_in->byte_index(rule.trigger_idx);
+    compiled.trigger_size = array_in->data_size();
+    compiled.trigger_bits = rule.trigger_value.data.un;
+    if (rule.trigger_value.is_float())
+    {
+        compiled.trigger_integer = 0;
+        compiled.trigger_float = rule.trigger_value.type == sihd::util::TYPE_FLOAT ? rule.trigger_value.data.f
+                                                                                   : rule.trigger_value.data.d;
+        // a float trigger or channel only holds a float precision
+        const bool float_precision = rule.trigger_value.type == sihd::util::TYPE_FLOAT
+                                     || array_in->data_type() == sihd::util::TYPE_FLOAT;
+        compiled.epsilon = float_precision ? std::numeric_limits<float>::epsilon()
+                                           : std::numeric_limits<double>::epsilon();
+    }
+    else
+    {
+        compiled.trigger_integer = rule.trigger_value.data.n;
+        compiled.trigger_float = (double)rule.trigger_value.data.n;
+        compiled.epsilon = 0;
+    }
+    compiled.should_match = rule.should_match;
+    compiled.channel_out = out;
+    compiled.write_offset = array_out->byte_index(rule.write_idx);
+    compiled.write_size = array_out->data_size();
+    compiled.write_same_value = rule.write_same_value;
+    compiled.write_value = rule.write_same_value ? 0 : rule.write_value.data.n;
+    compiled.nano_delay = rule.nano_delay;
+    return true;
+}
 
-bool DevFilter::InternalRule::set(const DevFilter::Rule *conf, Channel *in, Channel *out)
+bool DevFilter::_verify(const Rule & rule, const Channel *in, const Channel *out)
 {
     if (in == out)
     {
         SIHD_LOG_ERROR("DevFilter: config error, channel input '{}' and output '{}' are the same",
-                       conf->channel_in,
-                       conf->channel_out);
+                       rule.channel_in,
+                       rule.channel_out);
         return false;
     }
-    this->channel_in_ptr = in;
-    this->channel_out_ptr = out;
-    this->rule_ptr = conf;
-    return this->verify();
-}
-
-bool DevFilter::InternalRule::verify()
-{
     // check if index will be good
-    if (rule_ptr->trigger_idx >= this->channel_in_ptr->array()->size())
+    if (rule.trigger_idx >= in->array()->size())
     {
         SIHD_LOG_ERROR("DevFilter: trigger index {} is higher or equal than channel input '{}' size {}",
-                       rule_ptr->trigger_idx,
-                       rule_ptr->channel_in,
-                       this->channel_in_ptr->array()->size());
+                       rule.trigger_idx,
+                       rule.channel_in,
+                       in->array()->size());
         return false;
     }
-    if (rule_ptr->write_idx >= this->channel_out_ptr->array()->size())
+    if (rule.write_idx >= out->array()->size())
     {
         SIHD_LOG_ERROR("DevFilter: write index {} is higher or equal than channel output '{}' size {}",
-                       rule_ptr->write_idx,
-                       rule_ptr->channel_out,
-                       this->channel_out_ptr->array()->size());
+                       rule.write_idx,
+                       rule.channel_out,
+                       out->array()->size());
         return false;
     }
-    bool in_array_is_float = this->channel_in_ptr->array()->data_type() == sihd::util::TYPE_FLOAT
-                             || this->channel_in_ptr->array()->data_type() == sihd::util::TYPE_DOUBLE;
+    bool in_array_is_float = in->array()->data_type() == sihd::util::TYPE_FLOAT
+                             || in->array()->data_type() == sihd::util::TYPE_DOUBLE;
     // check if trigger value type against channel
-    if (rule_ptr->trigger_value.is_float() && in_array_is_float == false)
+    if (rule.trigger_value.is_float() && in_array_is_float == false)
     {
         SIHD_LOG_ERROR("DevFilter: type error, trigger value is float and channel input '{}' is not a floating type",
-                       this->channel_in_ptr->name());
+                       in->name());
         return false;
     }
     // check write value type against channel
-    bool out_array_is_float = this->channel_out_ptr->array()->data_type() == sihd::util::TYPE_FLOAT
-                              || this->channel_out_ptr->array()->data_type() == sihd::util::TYPE_DOUBLE;
+    bool out_array_is_float = out->array()->data_type() == sihd::util::TYPE_FLOAT
+                              || out->array()->data_type() == sihd::util::TYPE_DOUBLE;
     if (out_array_is_float == false
-        && ((rule_ptr->write_same_value && rule_ptr->trigger_value.is_float())
-            || (rule_ptr->write_same_value == false && rule_ptr->write_value.is_float())))
+        && ((rule.write_same_value && rule.trigger_value.is_float())
+            || (rule.write_same_value == false && rule.write_value.is_float())))
     {
         SIHD_LOG_ERROR("DevFilter: type error, write value is float and channel output '{}' is not a floating type",
-                       this->channel_out_ptr->name());
+                       out->name());
+        return false;
+    }
+    return true;
+}
+
+/* ************************************************************************* */
+/* DevFilter::CompiledArrayRule */
+/* ************************************************************************* */
+
+bool DevFilter::_compile(const ArrayRule & rule, Channel *in, Channel *out, CompiledArrayRule & compiled)
+{
+    if (_verify(rule, in, out) == false)
+        return false;
+
+    const sihd::util::IArray *array_in = in->array();
+    compiled.reducer = _reducer(array_in->data_type(), rule.operation);
+    if (compiled.reducer == nullptr)
+    {
+        SIHD_LOG_ERROR("DevFilter: cannot reduce channel input '{}' of type {}",
+                       rule.channel_in,
+                       sihd::util::type::str(array_in->data_type()));
+        return false;
+    }
+    const size_t slice_to = rule.slice_to == 0 ? array_in->size() : rule.slice_to;
+    compiled.offset = array_in->byte_index(rule.slice_from);
+    compiled.size = slice_to - rule.slice_from;
+    compiled.compare_type = rule.compare_type;
+    if (rule.compare_value.is_float())
+    {
+        compiled.compare_float = rule.compare_value.type == sihd::util::TYPE_FLOAT ? rule.compare_value.data.f
+                                                                                   : rule.compare_value.data.d;
+        compiled.compare_integer = (int64_t)compiled.compare_float;
+    }
+    else
+    {
+        compiled.compare_integer = rule.compare_value.data.n;
+        compiled.compare_float = (double)rule.compare_value.data.n;
+    }
+    compiled.channel_out = out;
+    compiled.write_idx = rule.write_idx;
+    return true;
+}
+
+bool DevFilter::_verify(const ArrayRule & rule, const Channel *in, const Channel *out)
+{
+    if (in == out)
+    {
+        SIHD_LOG_ERROR("DevFilter: config error, channel input '{}' and output '{}' are the same",
+                       rule.channel_in,
+                       rule.channel_out);
+        return false;
+    }
+    const size_t slice_to = rule.slice_to == 0 ? in->array()->size() : rule.slice_to;
+    if (rule.slice_from >= slice_to || slice_to > in->array()->size())
+    {
+        SIHD_LOG_ERROR("DevFilter: slice {}:{} is out of channel input '{}' size {}",
+                       rule.slice_from,
+                       rule.slice_to,
+                       rule.channel_in,
+                       in->array()->size());
+        return false;
+    }
+    if (rule.write_idx >= out->array()->size())
+    {
+        SIHD_LOG_ERROR("DevFilter: write index {} is higher or equal than channel output '{}' size {}",
+                       rule.write_idx,
+                       rule.channel_out,
+                       out->array()->size());
+        return false;
+    }
+    bool in_array_is_float = in->array()->data_type() == sihd::util::TYPE_FLOAT
+                             || in->array()->data_type() == sihd::util::TYPE_DOUBLE;
+    if (rule.compare_value.is_float() && in_array_is_float == false)
+    {
+        SIHD_LOG_ERROR("DevFilter: type error, compare value is float and channel input '{}' is not a floating type",
+                       in->name());
+        return false;
+    }
+    if (rule.compare_value.is_float() == false
+        && integer_fits(rule.compare_value.data.n, in->array()->data_type()) == false)
+    {
+        SIHD_LOG_ERROR("DevFilter: type error, compare value {} does not fit channel input '{}' of type {}",
+                       rule.compare_value.data.n,
+                       in->name(),
+                       sihd::util::type::str(in->array()->data_type()));
+        return false;
+    }
+    if (out->array()->data_type() == sihd::util::TYPE_NONE || out->array()->data_type() == sihd::util::TYPE_OBJECT)
+    {
+        SIHD_LOG_ERROR("DevFilter: type error, cannot write result into channel output '{}'", out->name());
         return false;
     }
     return true;
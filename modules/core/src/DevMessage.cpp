@@ -45,27 +45,46 @@ bool DevMessage::is_running() const
     return _running;
 }
 
-void DevMessage::_compute_output()
+bool DevMessage::_compute_output()
 {
-    if (_msg_ptr->field_write_to(_channel_msg_out->data(), _channel_msg_out->byte_size()) == false)
+    const size_t byte_size = _channel_msg_out->byte_size();
+    void *buf = _transaction.stage(_channel_msg_out, byte_size);
+    if (buf == nullptr || _msg_ptr->field_write_to(buf, byte_size) == false)
     {
         SIHD_LOG(error, "DevMessage: cannot write message {}", _channel_msg_out->name());
-        return;
+        return false;
+    }
+    return true;
+}
+
+bool DevMessage::_fill_channel_out(IMessageField *field, Channel *ch_out)
+{
+    const size_t byte_size = ch_out->byte_size();
+    void *buf = _transaction.stage(ch_out, byte_size);
+    if (buf == nullptr || field->field_write_to(buf, byte_size) == false)
+    {
+        SIHD_LOG(error, "DevMessage: cannot write into channel {}", ch_out->name());
+        return false;
     }
-    _channel_msg_out->notify();
+    return true;
 }
 
-void DevMessage::_fill_channels_out()
+bool DevMessage::_fill_channels_out()
 {
     for (const auto & [field, ch_out] : _fields_to_channel_out)
     {
-        if (field->field_write_to(ch_out->data(), ch_out->byte_size()) == false)
-        {
-            SIHD_LOG(error, "DevMessage: cannot write into channel {}", ch_out->name());
-            return;
-        }
-        ch_out->notify();
+        if (this->_fill_channel_out(field, ch_out) == false)
+            return false;
     }
+    return true;
+}
+
+void DevMessage::_commit(bool staged)
+{
+    // outputs are published together with one notification each
+    if (staged && _transaction.commit() == false)
+        SIHD_LOG(error, "DevMessage: cannot write output channels");
+    _transaction.clear();
 }
 
 void DevMessage::handle(sihd::core::Channel *channel)
@@ -73,10 +92,7 @@ void DevMessage::handle(sihd::core::Channel *channel)
     if (channel == _channel_trigger)
     {
         if (_trigger_mode)
-        {
-            this->_fill_channels_out();
-            this->_compute_output();
-        }
+            this->_commit(this->_fill_channels_out() && this->_compute_output());
         _channel_msg_out->notify();
         return;
     }
@@ -88,10 +104,7 @@ void DevMessage::handle(sihd::core::Channel *channel)
             return;
         }
         if (_trigger_mode == false)
-        {
-            this->_fill_channels_out();
-            this->_compute_output();
-        }
+            this->_commit(this->_fill_channels_out() && this->_compute_output());
         return;
     }
     const auto it = _channels_in_to_field.find(channel);
@@ -106,13 +119,7 @@ void DevMessage::handle(sihd::core::Channel *channel)
         if (_trigger_mode == false)
         {
             Channel *ch_out = _fields_to_channel_out.at(field);
-            if (field->field_write_to(ch_out->data(), ch_out->byte_size()) == false)
-            {
-                SIHD_LOG(error, "DevMessage: cannot write into channel {}", ch_out->name());
-                return;
-            }
-            ch_out->notify();
-            this->_compute_output();
+            this->_commit(this->_fill_channel_out(field, ch_out) && this->_compute_output());
         }
     }
 }
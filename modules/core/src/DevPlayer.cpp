@@ -1,8 +1,8 @@
 #include <sihd/core/DevPlayer.hpp>
+#include <sihd/core/FileRecordReader.hpp>
 #include <sihd/sys/NamedFactory.hpp>
 #include <sihd/util/Logger.hpp>
 #include <sihd/util/Splitter.hpp>
-#include <sihd/util/Task.hpp>
 
 #define CHANNEL_PLAY "play"
 #define CHANNEL_END "end"
@@ -19,18 +19,32 @@ using namespace sihd::util;
 DevPlayer::DevPlayer(const std::string & name, sihd::util::Node *parent):
     sihd::core::Device(name, parent),
     _running(false),
-    _end_notified(false),
+    _playing(false),
+    _speed(1.0),
+    _reanchor(true),
     _channel_play_ptr(nullptr),
-    _channel_end_ptr(nullptr)
+    _channel_end_ptr(nullptr),
+    _provider_ptr(nullptr),
+    _reader_ptr(nullptr),
+    _queue_pos(0),
+    _anchor_record(0),
+    _anchor_time(0),
+    _anchor_speed(1.0),
+    _played(0),
+    _late(0),
+    _skipped(0),
+    _max_lateness(0),
+    _total_lateness(0)
 {
-    _runnable.set_method(this, &DevPlayer::_main_loop);
-    _worker.set_runnable(&_runnable);
-    _collector.add_observer(this);
+    _worker.set_method([this] { return this->_main_loop(); });
     this->set_provider_wait_time(10);
-    this->set_scheduler_queue_size(200);
+    this->set_queue_size(200);
+    this->set_late_threshold(1);
     this->add_conf("provider", &DevPlayer::set_provider);
     this->add_conf("provider_wait_time", &DevPlayer::set_provider_wait_time);
-    this->add_conf("queue_size", &DevPlayer::set_scheduler_queue_size);
+    this->add_conf("queue_size", &DevPlayer::set_queue_size);
+    this->add_conf("speed", &DevPlayer::set_speed);
+    this->add_conf("late_threshold", &DevPlayer::set_late_threshold);
     this->add_conf("alias", &DevPlayer::add_alias);
 }
 
@@ -41,9 +55,14 @@ bool DevPlayer::is_running() const
     return _running;
 }
 
-bool DevPlayer::set_scheduler_queue_size(size_t limit)
+bool DevPlayer::set_queue_size(size_t limit)
 {
-    _records_queue_limit = limit;
+    if (limit == 0)
+    {
+        SIHD_LOG(error, "DevPlayer: cannot read ahead 0 records");
+        return false;
+    }
+    _queue_limit = limit;
     return true;
 }
 
@@ -60,7 +79,31 @@ bool DevPlayer::set_provider_wait_time(sihd::util::time::UnixTime milliseconds)
         SIHD_LOG(error, "DevPlayer: cannot wait for {} milliseconds", milliseconds);
         return false;
     }
-    _collector.set_timeout(sihd::util::time::milliseconds(milliseconds));
+    _provider_wait_time = time::milli(milliseconds);
+    return true;
+}
+
+bool DevPlayer::set_speed(double speed)
+{
+    if (speed < 0)
+    {
+        SIHD_LOG(error, "DevPlayer: cannot play at speed {}", speed);
+        return false;
+    }
+    auto l = _waitable.guard();
+    _speed = speed;
+    _waitable.notify();
+    return true;
+}
+
+bool DevPlayer::set_late_threshold(sihd::util::time::UnixTime milliseconds)
+{
+    if (milliseconds < 0)
+    {
+        SIHD_LOG(error, "DevPlayer: cannot have a late threshold of {} milliseconds", milliseconds);
+        return false;
+    }
+    _late_threshold = time::milli(milliseconds);
     return true;
 }
 
@@ -82,14 +125,33 @@ bool DevPlayer::add_alias(std::string_view alias_conf)
     return true;
 }
 
+void DevPlayer::seek(sihd::util::Timestamp timestamp)
+{
+    auto l = _waitable.guard();
+    _seek_timestamp = timestamp;
+    _waitable.notify();
+}
+
+DevPlayer::Stats DevPlayer::stats() const
+{
+    return Stats {
+        .played = _played.load(std::memory_order_relaxed),
+        .late = _late.load(std::memory_order_relaxed),
+        .skipped = _skipped.load(std::memory_order_relaxed),
+        .max_lateness = Duration(_max_lateness.load(std::memory_order_relaxed)),
+        .total_lateness = Duration(_total_lateness.load(std::memory_order_relaxed)),
+    };
+}
+
 void DevPlayer::handle(sihd::core::Channel *c)
 {
     if (c == _channel_play_ptr)
     {
-        if (_channel_play_ptr->read<bool>(0) == false)
-            _scheduler_ptr->pause();
-        else
-            _scheduler_ptr->resume();
+        auto l = _waitable.guard();
+        _playing = _channel_play_ptr->read<bool>(0);
+        // time between records is not counted while paused
+        _reanchor = true;
+        _waitable.notify();
     }
 }
 
@@ -97,26 +159,19 @@ bool DevPlayer::on_init()
 {
     this->add_unlinked_channel(CHANNEL_PLAY, TYPE_BOOL, 1);
     this->add_unlinked_channel(CHANNEL_END, TYPE_BOOL, 1);
-
-    _scheduler_ptr = this->add_child<sihd::util::Scheduler>(fmt::format("{}-scheduler", this->name()));
-    if (_scheduler_ptr != nullptr)
-    {
-        _scheduler_ptr->set_start_synchronised(true);
-        _scheduler_ptr->pause();
-    }
-    return _scheduler_ptr != nullptr;
+    return true;
 }
 
 bool DevPlayer::on_start()
 {
     // provider
-    IProvider<PlayableRecord> *provider = this->find<IProvider<PlayableRecord>>(_provider_path);
-    if (provider == nullptr)
+    _provider_ptr = this->find<IProvider<PlayableRecord>>(_provider_path);
+    if (_provider_ptr == nullptr)
     {
         SIHD_LOG(error, "DevPlayer: could not find provider: {}", _provider_path);
         return false;
     }
-    _collector.set_provider(provider);
+    _reader_ptr = dynamic_cast<FileRecordReader *>(_provider_ptr);
 
     // channel play
     if (this->get_channel(CHANNEL_PLAY, &_channel_play_ptr) == false)
@@ -142,79 +197,192 @@ bool DevPlayer::on_start()
     }
 
     // check if must play
-    if (_channel_play_ptr->read<bool>(0) == true)
-        _scheduler_ptr->resume();
+    _playing = _channel_play_ptr->read<bool>(0);
 
     // start thread
     _running = true;
     if (_worker.start_worker(this->name()) == false)
     {
         _running = false;
-        _scheduler_ptr->stop();
         SIHD_LOG(error, "DevPlayer: could not start worker");
     }
     return _running;
 }
 
-bool DevPlayer::run()
+bool DevPlayer::_interrupted() const
 {
-    if (_running == false)
-        return false;
+    return _running == false || _playing == false || _reanchor || _seek_timestamp.has_value()
+           || _speed != _anchor_speed;
+}
+
+bool DevPlayer::_main_loop()
+{
+    _queue.clear();
+    _queue_pos = 0;
+    _skip_until.reset();
+    _reanchor = true;
+    _played = 0;
+    _late = 0;
+    _skipped = 0;
+    _max_lateness = 0;
+    _total_lateness = 0;
+
+    bool ended = false;
+    while (_running)
+    {
+        std::optional<Timestamp> seek_timestamp;
+        {
+            auto l = _waitable.guard();
+            seek_timestamp.swap(_seek_timestamp);
+        }
+        if (seek_timestamp.has_value())
+        {
+            this->_apply_seek(*seek_timestamp);
+            if (ended)
+            {
+                _channel_end_ptr->write<bool>(0, false);
+                ended = false;
+            }
+        }
+
+        if (_playing == false)
+        {
+            _waitable.wait([this] { return _running == false || _playing || _seek_timestamp.has_value(); });
+            continue;
+        }
 
-    PlayableRecord record = _safe_queue.front();
-    _safe_queue.pop();
+        if (_queue_pos == _queue.size())
+        {
+            const bool providing = this->_fill_queue();
+            if (_queue.empty())
+            {
+                if (providing)
+                {
+                    _waitable.wait_for(_provider_wait_time, [this] {
+                        return _running == false || _playing == false || _seek_timestamp.has_value();
+                    });
+                }
+                else
+                {
+                    if (!ended)
+                    {
+                        _channel_end_ptr->write<bool>(0, true);
+                        ended = true;
+                    }
+                    // a seek can play again
+                    _waitable.wait([this] { return _running == false || _seek_timestamp.has_value(); });
+                }
+                continue;
+            }
+        }
 
-    auto it = _map_channels.find(record.name);
-    if (it != _map_channels.end())
-        it->second->write(*record.value.get());
-    else
-        SIHD_LOG(error, "DevPlayer: channel '{}' not found", record.name);
+        this->_play_next_timestamp();
+    }
+    return true;
+}
 
+bool DevPlayer::_fill_queue()
+{
+    _queue.clear();
+    _queue_pos = 0;
+    PlayableRecord record;
+    while (_queue.size() < _queue_limit)
     {
-        auto l = _waitable.guard();
-        _waitable.notify();
+        if (_provider_ptr->providing() == false)
+            return false;
+        if (_provider_ptr->provide(&record) == false)
+            break;
+        if (_skip_until.has_value())
+        {
+            if (record.timestamp < *_skip_until)
+            {
+                _skipped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            _skip_until.reset();
+        }
+        auto it = _map_channels.find(record.name);
+        if (it == _map_channels.end())
+        {
+            SIHD_LOG(error, "DevPlayer: channel '{}' not found", record.name);
+            continue;
+        }
+        _queue.emplace_back(Playable {it->second, record.timestamp, std::move(record.value)});
     }
-    if (_last_record)
-        this->_provider_ended();
     return true;
 }
 
-void DevPlayer::handle(Collector<PlayableRecord> *collector)
+void DevPlayer::_play_next_timestamp()
 {
-    if (_last_record)
-        return;
-
-    PlayableRecord record = collector->data();
-    _safe_queue.push(record);
-
-    if (_first_timestamp.has_value() == false)
-        _first_timestamp = record.timestamp;
+    const int64_t timestamp = _queue[_queue_pos].timestamp.nanoseconds();
+    const double speed = _speed;
 
-    _waitable.wait([this] { return _running == false || _safe_queue.size() <= _records_queue_limit; });
-    if (_running == false)
-        return;
+    if (_reanchor.exchange(false) || _anchor_speed == 0.0)
+    {
+        // the next record plays now
+        _anchor_record = timestamp;
+        _anchor_time = _clock.now().nanoseconds();
+    }
+    else if (speed != _anchor_speed)
+    {
+        // keeps the current position of the playback
+        const int64_t now = _clock.now().nanoseconds();
+        _anchor_record += (int64_t)((now - _anchor_time) * _anchor_speed);
+        _anchor_time = now;
+    }
+    _anchor_speed = speed;
 
-    // calls DevPlayer::run to execute record at setted time
-    _scheduler_ptr->add_task(new Task(this, {.run_in = record.timestamp - _first_timestamp.value()}));
-}
+    if (speed > 0.0)
+    {
+        const int64_t deadline = _anchor_time + (int64_t)((timestamp - _anchor_record) / speed);
+        int64_t now = _clock.now().nanoseconds();
+        if (now < deadline)
+        {
+            _waitable.wait_for(Duration(deadline - now), [this] { return this->_interrupted(); });
+            now = _clock.now().nanoseconds();
+            // pause, seek, stop or speed change before the deadline
+            if (now < deadline)
+                return;
+        }
+        const int64_t lateness = now - deadline;
+        _total_lateness.fetch_add(lateness, std::memory_order_relaxed);
+        if (lateness > _max_lateness.load(std::memory_order_relaxed))
+            _max_lateness.store(lateness, std::memory_order_relaxed);
+        if (lateness > _late_threshold.nanoseconds())
+            _late.fetch_add(1, std::memory_order_relaxed);
+    }
 
-bool DevPlayer::_main_loop()
-{
-    _first_timestamp.reset();
-    _last_record = false;
-    _end_notified = false;
-    // run collector loop which calls DevPlayer::handle for each record
-    const bool collector_started = _collector.start();
-    // last record to be played in scheduler thread can have no next record
-    _last_record = true;
-    this->_provider_ended();
-    return collector_started;
+    // every record of the same timestamp
+    const size_t begin = _queue_pos;
+    while (_queue_pos < _queue.size() && _queue[_queue_pos].timestamp == timestamp)
+    {
+        Playable & playable = _queue[_queue_pos++];
+        playable.channel->write(*playable.value);
+        playable.value.reset();
+    }
+    _played.fetch_add(_queue_pos - begin, std::memory_order_relaxed);
 }
 
-void DevPlayer::_provider_ended()
+void DevPlayer::_apply_seek(sihd::util::Timestamp timestamp)
 {
-    if (_safe_queue.empty() && !_end_notified.exchange(true))
-        _channel_end_ptr->write<bool>(0, true);
+    _reanchor = true;
+    if (_reader_ptr != nullptr)
+    {
+        _queue.clear();
+        _queue_pos = 0;
+        _skip_until.reset();
+        if (_reader_ptr->seek(timestamp) == false)
+            SIHD_LOG(error, "DevPlayer: could not seek provider to {}", timestamp.str());
+        return;
+    }
+    // other providers can only go forward
+    while (_queue_pos < _queue.size() && _queue[_queue_pos].timestamp < timestamp)
+    {
+        _queue[_queue_pos++].value.reset();
+        _skipped.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (_queue_pos == _queue.size())
+        _skip_until = timestamp;
 }
 
 bool DevPlayer::on_stop()
@@ -228,19 +396,23 @@ bool DevPlayer::on_stop()
         SIHD_LOG(error, "DevPlayer: could not stop worker");
     _channel_play_ptr = nullptr;
     _channel_end_ptr = nullptr;
-    _collector.stop();
-    _collector.set_provider(nullptr);
+    _provider_ptr = nullptr;
+    _reader_ptr = nullptr;
     _map_channels.clear();
     return true;
 }
 
 bool DevPlayer::on_reset()
 {
-    _safe_queue.clear();
+    _queue.clear();
+    _queue_pos = 0;
     _channel_play_ptr = nullptr;
     _channel_end_ptr = nullptr;
-    _scheduler_ptr = nullptr;
     _map_channels_alias.clear();
+    {
+        auto l = _waitable.guard();
+        _seek_timestamp.reset();
+    }
     return true;
 }
 
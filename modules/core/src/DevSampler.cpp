@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 #include <sihd/sys/NamedFactory.hpp>
 #include <sihd/util/Logger.hpp>
 #include <sihd/util/Splitter.hpp>
@@ -13,6 +17,26 @@ SIHD_REGISTER_FACTORY(DevSampler)
 
 SIHD_LOGGER;
 
+namespace
+{
+
+bool is_numeric(sihd::util::Type type)
+{
+    return type != sihd::util::TYPE_NONE && type != sihd::util::TYPE_OBJECT;
+}
+
+template <typename T>
+void store_values(const std::vector<double> & values, uint8_t *buf)
+{
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        const T value = (T)values[i];
+        memcpy(buf + i * sizeof(T), &value, sizeof(T));
+    }
+}
+
+} // namespace
+
 DevSampler::DevSampler(const std::string & name, sihd::util::Node *parent):
     sihd::core::Device(name, parent),
     _channel_sample(nullptr)
@@ -20,6 +44,11 @@ DevSampler::DevSampler(const std::string & name, sihd::util::Node *parent):
     _step_worker.set_runnable(this);
     this->add_conf("frequency", &DevSampler::set_frequency);
     this->add_conf("sample", &DevSampler::set_sample);
+    this->add_conf("sample_mean", &DevSampler::set_sample_mean);
+    this->add_conf("sample_min", &DevSampler::set_sample_min);
+    this->add_conf("sample_max", &DevSampler::set_sample_max);
+    this->add_conf("sample_sum", &DevSampler::set_sample_sum);
+    this->add_conf("sample_count", &DevSampler::set_sample_count);
 }
 
 DevSampler::~DevSampler() = default;
@@ -32,7 +61,7 @@ bool DevSampler::set_frequency(double freq)
     return ret;
 }
 
-bool DevSampler::set_sample(std::string_view conf)
+bool DevSampler::_parse_conf(std::string_view conf, Mode mode)
 {
     sihd::util::Splitter splitter("=");
     std::vector<std::string> splitted = splitter.split(conf);
@@ -47,21 +76,199 @@ bool DevSampler::set_sample(std::string_view conf)
     }
     // splitted[0] = channel_path_out
     // splitted[1] = channel_path_in
-    _conf_map[splitted[0]] = splitted[1];
+    return this->add_sample(splitted[0], splitted[1], mode);
+}
+
+bool DevSampler::add_sample(std::string_view channel_out, std::string_view channel_in, Mode mode)
+{
+    auto it = std::find_if(_confs.begin(), _confs.end(), [&channel_out](const SampleConf & conf) {
+        return conf.channel_out == channel_out;
+    });
+    if (it == _confs.end())
+        _confs.emplace_back(SampleConf {std::string(channel_out), std::string(channel_in), mode});
+    else
+        *it = SampleConf {std::string(channel_out), std::string(channel_in), mode};
     return true;
 }
 
+bool DevSampler::set_sample(std::string_view conf)
+{
+    return this->_parse_conf(conf, Last);
+}
+
+bool DevSampler::set_sample_mean(std::string_view conf)
+{
+    return this->_parse_conf(conf, Mean);
+}
+
+bool DevSampler::set_sample_min(std::string_view conf)
+{
+    return this->_parse_conf(conf, Min);
+}
+
+bool DevSampler::set_sample_max(std::string_view conf)
+{
+    return this->_parse_conf(conf, Max);
+}
+
+bool DevSampler::set_sample_sum(std::string_view conf)
+{
+    return this->_parse_conf(conf, Sum);
+}
+
+bool DevSampler::set_sample_count(std::string_view conf)
+{
+    return this->_parse_conf(conf, Count);
+}
+
 bool DevSampler::is_running() const
 {
     return _step_worker.is_worker_running();
 }
 
+template <typename T, DevSampler::Mode M>
+void DevSampler::_accumulate(const uint8_t *buf, Sample & sample)
+{
+    const T *data = reinterpret_cast<const T *>(buf);
+    double *values = sample.values.data();
+    const size_t size = sample.values.size();
+    for (size_t i = 0; i < size; ++i)
+    {
+        const double value = (double)data[i];
+        if constexpr (M == Min)
+            values[i] = value < values[i] ? value : values[i];
+        else if constexpr (M == Max)
+            values[i] = value > values[i] ? value : values[i];
+        else
+            values[i] += value;
+    }
+}
+
+template <typename T>
+DevSampler::Accumulator DevSampler::_accumulator(Mode mode)
+{
+    switch (mode)
+    {
+        case Mean:
+            return &DevSampler::_accumulate<T, Mean>;
+        case Min:
+            return &DevSampler::_accumulate<T, Min>;
+        case Max:
+            return &DevSampler::_accumulate<T, Max>;
+        case Sum:
+            return &DevSampler::_accumulate<T, Sum>;
+        default:
+            return nullptr;
+    }
+}
+
+DevSampler::Accumulator DevSampler::_accumulator(sihd::util::Type data_type, Mode mode)
+{
+    switch (data_type)
+    {
+        case sihd::util::TYPE_BOOL:
+            return _accumulator<bool>(mode);
+        case sihd::util::TYPE_CHAR:
+            return _accumulator<char>(mode);
+        case sihd::util::TYPE_BYTE:
+            return _accumulator<int8_t>(mode);
+        case sihd::util::TYPE_UBYTE:
+            return _accumulator<uint8_t>(mode);
+        case sihd::util::TYPE_SHORT:
+            return _accumulator<int16_t>(mode);
+        case sihd::util::TYPE_USHORT:
+            return _accumulator<uint16_t>(mode);
+        case sihd::util::TYPE_INT:
+            return _accumulator<int32_t>(mode);
+        case sihd::util::TYPE_UINT:
+            return _accumulator<uint32_t>(mode);
+        case sihd::util::TYPE_LONG:
+            return _accumulator<int64_t>(mode);
+        case sihd::util::TYPE_ULONG:
+            return _accumulator<uint64_t>(mode);
+        case sihd::util::TYPE_FLOAT:
+            return _accumulator<float>(mode);
+        case sihd::util::TYPE_DOUBLE:
+            return _accumulator<double>(mode);
+        default:
+            return nullptr;
+    }
+}
+
+void DevSampler::_clear_window(Sample & sample)
+{
+    sample.writes = 0;
+    double identity = 0.0;
+    if (sample.mode == Min)
+        identity = std::numeric_limits<double>::infinity();
+    else if (sample.mode == Max)
+        identity = -std::numeric_limits<double>::infinity();
+    std::fill(sample.values.begin(), sample.values.end(), identity);
+}
+
+void DevSampler::_store(const std::vector<double> & values, sihd::util::IArray *array)
+{
+    uint8_t *buf = array->buf();
+    switch (array->data_type())
+    {
+        case sihd::util::TYPE_BOOL:
+            store_values<bool>(values, buf);
+            break;
+        case sihd::util::TYPE_CHAR:
+            store_values<char>(values, buf);
+            break;
+        case sihd::util::TYPE_BYTE:
+            store_values<int8_t>(values, buf);
+            break;
+        case sihd::util::TYPE_UBYTE:
+            store_values<uint8_t>(values, buf);
+            break;
+        case sihd::util::TYPE_SHORT:
+            store_values<int16_t>(values, buf);
+            break;
+        case sihd::util::TYPE_USHORT:
+            store_values<uint16_t>(values, buf);
+            break;
+        case sihd::util::TYPE_INT:
+            store_values<int32_t>(values, buf);
+            break;
+        case sihd::util::TYPE_UINT:
+            store_values<uint32_t>(values, buf);
+            break;
+        case sihd::util::TYPE_LONG:
+            store_values<int64_t>(values, buf);
+            break;
+        case sihd::util::TYPE_ULONG:
+            store_values<uint64_t>(values, buf);
+            break;
+        case sihd::util::TYPE_FLOAT:
+            store_values<float>(values, buf);
+            break;
+        case sihd::util::TYPE_DOUBLE:
+            store_values<double>(values, buf);
+            break;
+        default:
+            break;
+    }
+}
+
 void DevSampler::handle(sihd::core::Channel *channel)
 {
-    std::lock_guard l(_set_mutex);
-    if (_channels_map.find(channel) != _channels_map.end())
+    std::lock_guard l(_window_mutex);
+    auto it = std::lower_bound(_inputs.begin(), _inputs.end(), channel, [](const Input & input, const Channel *c) {
+        return input.channel < c;
+    });
+    if (it == _inputs.end() || it->channel != channel)
+        return;
+
+    const uint8_t *buf = channel->array()->buf();
+    for (size_t i = it->begin; i < it->end; ++i)
     {
-        _channels_sample_set.emplace(channel);
+        Sample & sample = _samples[i];
+        ++sample.writes;
+        if (sample.accumulator != nullptr)
+            sample.accumulator(buf, sample);
+        _written[i / 64] |= (uint64_t)1 << (i % 64);
     }
 }
 
@@ -78,27 +285,97 @@ bool DevSampler::on_init()
     return true;
 }
 
-bool DevSampler::on_start()
+bool DevSampler::_make_sample(const SampleConf & conf, Sample & sample)
 {
-    bool ret;
-    Channel *channel_in;
-    Channel *channel_out;
+    const sihd::util::IArray *array_in = sample.channel_in->array();
+    const sihd::util::IArray *array_out = sample.channel_out->array();
+    sample.mode = conf.mode;
+    sample.accumulator = nullptr;
+    if (conf.mode == Last)
+    {
+        sample.buffer.reset(array_in->clone_array());
+        return true;
+    }
+    if (is_numeric(array_out->data_type()) == false)
+    {
+        SIHD_LOG(error,
+                 "DevSampler: cannot aggregate into channel '{}' of type {}",
+                 conf.channel_out,
+                 array_out->data_type_str());
+        return false;
+    }
+    sample.buffer.reset(array_out->clone_array());
+    if (conf.mode == Count)
+        return true;
+    sample.accumulator = _accumulator(array_in->data_type(), conf.mode);
+    if (sample.accumulator == nullptr)
+    {
+        SIHD_LOG(error,
+                 "DevSampler: cannot aggregate channel '{}' of type {}",
+                 conf.channel_in,
+                 array_in->data_type_str());
+        return false;
+    }
+    if (array_in->size() != array_out->size() || sample.channel_in->resizable())
+    {
+        SIHD_LOG(error,
+                 "DevSampler: cannot aggregate channel '{}' of size {} into channel '{}' of size {}",
+                 conf.channel_in,
+                 array_in->size(),
+                 conf.channel_out,
+                 array_out->size());
+        return false;
+    }
+    sample.values.resize(array_in->size());
+    sample.tick_values.resize(array_in->size());
+    return true;
+}
 
-    ret = true;
+bool DevSampler::on_start()
+{
+    bool ret = true;
     if (!this->get_channel(CHANNEL_SAMPLE, &_channel_sample))
         return false;
-    for (const auto & [channel_out_path, channel_in_path] : _conf_map)
+
+    std::vector<Sample> samples;
+    for (const SampleConf & conf : _confs)
     {
-        if (this->find_channel(channel_in_path, &channel_in)
-            && this->find_channel(channel_out_path, &channel_out))
+        Sample sample {};
+        if (this->find_channel(conf.channel_in, &sample.channel_in)
+            && this->find_channel(conf.channel_out, &sample.channel_out))
         {
-            if (this->observe_channel(channel_in) == false)
+            if (this->_make_sample(conf, sample) == false)
+            {
+                ret = false;
+                continue;
+            }
+            _clear_window(sample);
+            if (this->observe_channel(sample.channel_in) == false)
                 ret = false;
-            _channels_map[channel_in] = channel_out;
+            samples.emplace_back(std::move(sample));
         }
         else
             ret = false;
     }
+
+    // groups the samples of an input channel
+    std::stable_sort(samples.begin(), samples.end(), [](const Sample & a, const Sample & b) {
+        return a.channel_in < b.channel_in;
+    });
+    {
+        std::lock_guard l(_window_mutex);
+        _samples = std::move(samples);
+        _inputs.clear();
+        for (size_t i = 0; i < _samples.size(); ++i)
+        {
+            if (_inputs.empty() || _inputs.back().channel != _samples[i].channel_in)
+                _inputs.emplace_back(Input {_samples[i].channel_in, i, i});
+            ++_inputs.back().end;
+        }
+        _written.assign((_samples.size() + 63) / 64, 0);
+        _tick_written.assign(_written.size(), 0);
+    }
+
     if (ret && _step_worker.start_sync_worker(this->name()) == false)
     {
         SIHD_LOG(error, "DevSampler: could not start worker");
@@ -107,29 +384,79 @@ bool DevSampler::on_start()
     return ret;
 }
 
+void DevSampler::_write_sample(Sample & sample)
+{
+    bool ret = true;
+    switch (sample.mode)
+    {
+        case Last:
+        {
+            const Channel *channel_in = sample.channel_in;
+            // publishes a reference to the input's buffer
+            if (channel_in->shared_buffers())
+            {
+                ret = sample.channel_out->write(*channel_in);
+                break;
+            }
+            if (sample.buffer->size() != channel_in->size())
+                ret = sample.buffer->reserve(channel_in->capacity()) && sample.buffer->resize(channel_in->size());
+            // input channel may be written meanwhile: the copy is still consistent
+            ret = ret && channel_in->copy_to(*sample.buffer) && sample.channel_out->write(*sample.buffer);
+            break;
+        }
+        case Count:
+        {
+            _store({(double)sample.tick_writes}, sample.buffer.get());
+            ret = sample.channel_out->write({sample.buffer->buf(), sample.buffer->data_size()});
+            break;
+        }
+        case Mean:
+        {
+            for (double & value : sample.tick_values)
+                value /= sample.tick_writes;
+            [[fallthrough]];
+        }
+        default:
+        {
+            _store(sample.tick_values, sample.buffer.get());
+            ret = sample.channel_out->write(*sample.buffer);
+            break;
+        }
+    }
+    if (ret == false)
+        SIHD_LOG(error, "DevSampler: Could not sample into: {}", sample.channel_out->name());
+}
+
 bool DevSampler::run()
 {
     /*
-        copying set so we can get new notifications while processing the old ones
+        swapping windows so we can get new notifications while processing the old ones
         channels to sample to may have long processing of time and taking mutex ownership
         means missing notifications
     */
-    std::set<Channel *> channels_set;
-    {
-        std::lock_guard l(_set_mutex);
-        channels_set = _channels_sample_set;
-        _channels_sample_set.clear();
-    }
-    Channel *channel_out;
-    for (Channel *channel_in : channels_set)
     {
-        channel_out = _channels_map[channel_in];
-        if (channel_out->write(*channel_in) == false)
+        std::lock_guard l(_window_mutex);
+        _written.swap(_tick_written);
+        for (size_t word = 0; word < _tick_written.size(); ++word)
         {
-            SIHD_LOG(error, "DevSampler: Could not sample into: {}", channel_out->name());
+            for (uint64_t bits = _tick_written[word]; bits != 0; bits &= bits - 1)
+            {
+                Sample & sample = _samples[word * 64 + __builtin_ctzll(bits)];
+                sample.tick_writes = sample.writes;
+                sample.values.swap(sample.tick_values);
+                _clear_window(sample);
+            }
         }
     }
-    if (channels_set.size() > 0)
+    bool sampled = false;
+    for (size_t word = 0; word < _tick_written.size(); ++word)
+    {
+        for (uint64_t bits = _tick_written[word]; bits != 0; bits &= bits - 1)
+            this->_write_sample(_samples[word * 64 + __builtin_ctzll(bits)]);
+        sampled = sampled || _tick_written[word] != 0;
+        _tick_written[word] = 0;
+    }
+    if (sampled)
         _channel_sample->write(0, true);
     return true;
 }
@@ -138,17 +465,19 @@ bool DevSampler::on_stop()
 {
     if (_step_worker.stop_worker() == false)
         SIHD_LOG(error, "DevSampler: could not stop worker");
-    _channels_map.clear();
     {
-        std::lock_guard l(_set_mutex);
-        _channels_sample_set.clear();
+        std::lock_guard l(_window_mutex);
+        _samples.clear();
+        _inputs.clear();
+        _written.clear();
+        _tick_written.clear();
     }
     return true;
 }
 
 bool DevSampler::on_reset()
 {
-    _conf_map.clear();
+    _confs.clear();
     return true;
 }
 
@@ -36,7 +36,8 @@ sihd::util::ServiceController & default_service_controller()
 
 Device::Device(const std::string & name, Node *parent):
     AChannelContainer(name, parent),
-    _service_controller(default_service_controller().statemachine)
+    _service_controller(default_service_controller().statemachine),
+    _stats_ptr(nullptr)
 {
     _service_controller.optional_setup();
 }
@@ -62,6 +63,30 @@ const char *Device::device_state_str() const
     return ServiceController::state_str(this->device_state());
 }
 
+void Device::set_stats(bool activate)
+{
+    if (activate && _counters == nullptr)
+        _counters = std::make_unique<DeviceCounters>();
+    _stats_ptr.store(activate ? _counters.get() : nullptr, std::memory_order_release);
+}
+
+DeviceStats Device::stats() const
+{
+    DeviceStats stats {};
+    stats.path = this->full_name();
+    if (_counters == nullptr)
+        return stats;
+    stats.handled = _counters->handled.load(std::memory_order_relaxed);
+    stats.handle = _counters->handle.snapshot();
+    return stats;
+}
+
+void Device::clear_stats()
+{
+    if (_counters != nullptr)
+        _counters->clear();
+}
+
 bool Device::do_setup()
 {
     bool ret = for_each_child_service(this, [this](AService *service, const std::string & child_name) {
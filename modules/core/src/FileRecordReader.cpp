@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <cstring>
+
+#include <sihd/sys/NamedFactory.hpp>
+#include <sihd/sys/fs.hpp>
+#include <sihd/util/Logger.hpp>
+#include <sihd/util/array_utils.hpp>
+
+#include <sihd/core/FileRecordReader.hpp>
+
+namespace sihd::core
+{
+
+SIHD_REGISTER_FACTORY(FileRecordReader)
+
+SIHD_LOGGER;
+
+using namespace sihd::util;
+using namespace sihd::core::record_file;
+
+FileRecordReader::FileRecordReader(const std::string & name, sihd::util::Node *parent):
+    ACoreObject(name, parent),
+    _stop_providing_when_empty(false),
+    _providing(false),
+    _running(false),
+    _next_segment_index(0),
+    _offset(0)
+{
+    this->add_conf("path", &FileRecordReader::set_path);
+    this->add_conf("stop_providing_when_empty", &FileRecordReader::set_stop_providing_when_empty);
+}
+
+FileRecordReader::~FileRecordReader() = default;
+
+bool FileRecordReader::set_path(std::string_view path)
+{
+    _path = path;
+    return true;
+}
+
+bool FileRecordReader::set_stop_providing_when_empty(bool active)
+{
+    _stop_providing_when_empty = active;
+    return true;
+}
+
+bool FileRecordReader::open()
+{
+    std::lock_guard l(_mutex);
+    _segments_path.clear();
+    _segment = Segment {};
+    _next_segment_index = 0;
+    _offset = 0;
+
+    if (!sihd::sys::fs::is_dir(_path))
+    {
+        SIHD_LOG(error, "FileRecordReader: no such directory: {}", _path);
+        return false;
+    }
+    for (size_t i = 0;; ++i)
+    {
+        std::string path = sihd::sys::fs::combine(_path, segment_name(i));
+        if (!sihd::sys::fs::exists(path))
+            break;
+        _segments_path.emplace_back(std::move(path));
+    }
+    return true;
+}
+
+void FileRecordReader::close()
+{
+    std::lock_guard l(_mutex);
+    _segments_path.clear();
+    _segment = Segment {};
+    _next_segment_index = 0;
+    _offset = 0;
+}
+
+bool FileRecordReader::is_open() const
+{
+    std::lock_guard l(_mutex);
+    return !_segments_path.empty();
+}
+
+size_t FileRecordReader::segments() const
+{
+    std::lock_guard l(_mutex);
+    return _segments_path.size();
+}
+
+bool FileRecordReader::do_start()
+{
+    if (!this->is_open() && !this->open())
+        return false;
+    _running = true;
+    _providing = true;
+    return true;
+}
+
+bool FileRecordReader::do_stop()
+{
+    _providing = false;
+    _running = false;
+    return true;
+}
+
+bool FileRecordReader::do_reset()
+{
+    this->close();
+    return true;
+}
+
+bool FileRecordReader::is_running() const
+{
+    return _running;
+}
+
+bool FileRecordReader::providing() const
+{
+    return _providing;
+}
+
+bool FileRecordReader::provide(PlayableRecord *record)
+{
+    std::lock_guard l(_mutex);
+    while (true)
+    {
+        const RecordHeader *header = _segment.file != nullptr ? this->_header_at(_offset) : nullptr;
+        if (header == nullptr)
+        {
+            if (this->_next_segment())
+                continue;
+            if (_stop_providing_when_empty)
+                _providing = false;
+            return false;
+        }
+
+        const size_t payload_offset = _offset + sizeof(RecordHeader);
+        _offset = this->_pass(_offset, header);
+        if (header->channel == definition_id)
+            continue;
+
+        auto it = _segment.channels.find(header->channel);
+        if (it == _segment.channels.end())
+        {
+            SIHD_LOG(warning, "FileRecordReader: record of unknown channel {}", header->channel);
+            continue;
+        }
+
+        IArray *array = array_utils::create_from_type(it->second.type);
+        if (array == nullptr)
+            continue;
+        try
+        {
+            array->assign_bytes(const_cast<uint8_t *>(_segment.file->data() + payload_offset), header->size);
+        }
+        catch (const std::invalid_argument & e)
+        {
+            SIHD_LOG(error, "FileRecordReader: record of channel '{}': {}", it->second.name, e.what());
+            delete array;
+            continue;
+        }
+
+        record->name = it->second.name;
+        record->timestamp = header->timestamp;
+        // the array does not own the mapped bytes: the mapping is released with the last array
+        record->value = IArrayShared(array, [file = _segment.file](IArray *ptr) { delete ptr; });
+        return true;
+    }
+}
+
+bool FileRecordReader::seek(sihd::util::Timestamp timestamp)
+{
+    std::lock_guard l(_mutex);
+
+    // last segment starting before timestamp
+    size_t found = 0;
+    for (size_t i = 0; i < _segments_path.size(); ++i)
+    {
+        if (!this->_map_segment(i))
+            continue;
+        const std::optional<Timestamp> first = this->_first_timestamp();
+        if (!first.has_value())
+            continue;
+        if (*first > timestamp)
+            break;
+        found = i;
+    }
+    if (!this->_map_segment(found))
+        return false;
+    _next_segment_index = found + 1;
+
+    // jumps to the last indexed record before timestamp
+    const IndexEntry *index_end = _segment.index + _segment.index_size;
+    const IndexEntry *entry = std::upper_bound(_segment.index,
+                                               index_end,
+                                               timestamp.nanoseconds(),
+                                               [](int64_t value, const IndexEntry & entry) {
+                                                   return value < entry.timestamp;
+                                               });
+    if (entry != _segment.index)
+    {
+        --entry;
+        if (entry->offset >= _segment.begin && entry->offset < _segment.end)
+        {
+            this->_define_until(entry->offset);
+            _offset = entry->offset;
+        }
+    }
+
+    const RecordHeader *header;
+    while ((header = this->_header_at(_offset)) != nullptr)
+    {
+        if (header->channel != definition_id && header->timestamp >= timestamp.nanoseconds())
+            break;
+        _offset = this->_pass(_offset, header);
+    }
+    // records to provide again
+    _providing = _running.load();
+    return true;
+}
+
+bool FileRecordReader::_map_segment(size_t index)
+{
+    const std::string & path = _segments_path[index];
+    auto file = std::make_shared<sihd::sys::MappedFile>();
+    if (!file->open(path))
+        return false;
+
+    const uint8_t *data = file->data();
+    const size_t size = file->size();
+    SegmentHeader header;
+    if (size < sizeof(SegmentHeader))
+    {
+        // not written yet
+        if (size > 0)
+            SIHD_LOG(error, "FileRecordReader: segment too small: {}", path);
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version)
+    {
+        SIHD_LOG(error, "FileRecordReader: not a segment of version {}: {}", version, path);
+        return false;
+    }
+
+    Segment segment;
+    segment.file = std::move(file);
+    segment.end = size;
+    size_t offset = sizeof(SegmentHeader);
+    for (uint32_t i = 0; i < header.channels; ++i)
+    {
+        if (offset + sizeof(ChannelEntry) > size)
+        {
+            SIHD_LOG(error, "FileRecordReader: truncated channels dictionary: {}", path);
+            return false;
+        }
+        const ChannelEntry *entry = reinterpret_cast<const ChannelEntry *>(data + offset);
+        if (offset + sizeof(ChannelEntry) + entry->name_size > size)
+        {
+            SIHD_LOG(error, "FileRecordReader: truncated channels dictionary: {}", path);
+            return false;
+        }
+        segment.channels[entry->id]
+            = ChannelDef {std::string((const char *)(entry + 1), entry->name_size), (Type)entry->type};
+        offset += align(sizeof(ChannelEntry) + entry->name_size);
+    }
+    segment.begin = offset;
+    segment.defined = offset;
+
+    // closed segment: the index ends the records
+    if (size >= offset + sizeof(SegmentFooter) + sizeof(RecordHeader))
+    {
+        const SegmentFooter *footer = reinterpret_cast<const SegmentFooter *>(data + size - sizeof(SegmentFooter));
+        const size_t index_offset = footer->index_offset;
+        if (footer->magic == footer_magic && index_offset >= offset
+            && index_offset + sizeof(RecordHeader) <= size - sizeof(SegmentFooter))
+        {
+            const RecordHeader *index_header = reinterpret_cast<const RecordHeader *>(data + index_offset);
+            if (index_header->channel == index_id
+                && index_offset + sizeof(RecordHeader) + index_header->size <= size - sizeof(SegmentFooter))
+            {
+                segment.index = reinterpret_cast<const IndexEntry *>(index_header + 1);
+                segment.index_size = index_header->size / sizeof(IndexEntry);
+                segment.end = index_offset;
+            }
+        }
+    }
+
+    _segment = std::move(segment);
+    _offset = _segment.begin;
+    return true;
+}
+
+bool FileRecordReader::_next_segment()
+{
+    while (_next_segment_index < _segments_path.size())
+    {
+        if (this->_map_segment(_next_segment_index++))
+            return true;
+    }
+    return false;
+}
+
+const RecordHeader *FileRecordReader::_header_at(size_t offset) const
+{
+    if (offset + sizeof(RecordHeader) > _segment.end)
+        return nullptr;
+    const RecordHeader *header = reinterpret_cast<const RecordHeader *>(_segment.file->data() + offset);
+    // interrupted recording
+    if (header->channel == index_id || offset + sizeof(RecordHeader) + align(header->size) > _segment.end)
+        return nullptr;
+    return header;
+}
+
+size_t FileRecordReader::_pass(size_t offset, const RecordHeader *header)
+{
+    const size_t next = offset + sizeof(RecordHeader) + align(header->size);
+    if (header->channel == definition_id && offset >= _segment.defined)
+    {
+        const ChannelEntry *entry = reinterpret_cast<const ChannelEntry *>(header + 1);
+        if (sizeof(ChannelEntry) + entry->name_size <= header->size)
+        {
+            _segment.channels[entry->id]
+                = ChannelDef {std::string((const char *)(entry + 1), entry->name_size), (Type)entry->type};
+        }
+    }
+    _segment.defined = std::max(_segment.defined, next);
+    return next;
+}
+
+void FileRecordReader::_define_until(size_t offset)
+{
+    size_t current = _segment.defined;
+    const RecordHeader *header;
+    while (current < offset && (header = this->_header_at(current)) != nullptr)
+        current = this->_pass(current, header);
+}
+
+std::optional<Timestamp> FileRecordReader::_first_timestamp() const
+{
+    if (_segment.index_size > 0)
+        return Timestamp(_segment.index[0].timestamp);
+
+    size_t offset = _segment.begin;
+    const RecordHeader *header;
+    while ((header = this->_header_at(offset)) != nullptr)
+    {
+        if (header->channel != definition_id)
+            return Timestamp(header->timestamp);
+        offset += sizeof(RecordHeader) + align(header->size);
+    }
+    return std::nullopt;
+}
+
+} // namespace sihd::core
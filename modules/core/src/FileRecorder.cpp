@@ -0,0 +1,279 @@
+#include <cstring>
+
+#include <sihd/sys/NamedFactory.hpp>
+#include <sihd/sys/fs.hpp>
+#include <sihd/util/Logger.hpp>
+
+#include <sihd/core/FileRecorder.hpp>
+
+namespace sihd::core
+{
+
+SIHD_REGISTER_FACTORY(FileRecorder)
+
+SIHD_LOGGER;
+
+using namespace sihd::util;
+using namespace sihd::core::record_file;
+
+FileRecorder::FileRecorder(const std::string & name, sihd::util::Node *parent):
+    ACoreObject(name, parent),
+    _segment_size(256 * 1024 * 1024),
+    _batch_size(64 * 1024),
+    _index_interval(time::sec(1)),
+    _running(false),
+    _segment_offset(0),
+    _segment_index(0),
+    _segments(0),
+    _records(0)
+{
+    this->add_conf("path", &FileRecorder::set_path);
+    this->add_conf("segment_size", &FileRecorder::set_segment_size);
+    this->add_conf("batch_size", &FileRecorder::set_batch_size);
+    this->add_conf("index_interval", &FileRecorder::set_index_interval);
+}
+
+FileRecorder::~FileRecorder()
+{
+    std::lock_guard l(_mutex);
+    this->_close_segment();
+}
+
+bool FileRecorder::set_path(std::string_view path)
+{
+    _path = path;
+    return true;
+}
+
+bool FileRecorder::set_segment_size(size_t bytes)
+{
+    if (bytes < 4096)
+    {
+        SIHD_LOG(error, "FileRecorder: segment size must be at least 4096 bytes");
+        return false;
+    }
+    _segment_size = bytes;
+    return true;
+}
+
+bool FileRecorder::set_batch_size(size_t bytes)
+{
+    _batch_size = bytes;
+    return true;
+}
+
+bool FileRecorder::set_index_interval(sihd::util::time::UnixTime milliseconds)
+{
+    if (milliseconds <= 0)
+    {
+        SIHD_LOG(error, "FileRecorder: cannot index every {} milliseconds", milliseconds);
+        return false;
+    }
+    _index_interval = time::milli(milliseconds);
+    return true;
+}
+
+bool FileRecorder::do_start()
+{
+    if (_path.empty())
+    {
+        SIHD_LOG(error, "FileRecorder: no path to record to");
+        return false;
+    }
+    if (!sihd::sys::fs::is_dir(_path) && !sihd::sys::fs::make_directories(_path))
+    {
+        SIHD_LOG(error, "FileRecorder: cannot create directory: {}", _path);
+        return false;
+    }
+
+    std::lock_guard l(_mutex);
+    // a recording goes on after the segments already in the directory
+    _segment_index = 0;
+    while (sihd::sys::fs::exists(sihd::sys::fs::combine(_path, segment_name(_segment_index))))
+        ++_segment_index;
+    _segments = 0;
+    _records = 0;
+    _channels.clear();
+    if (!this->_open_segment())
+        return false;
+    _running = true;
+    return true;
+}
+
+bool FileRecorder::do_stop()
+{
+    std::lock_guard l(_mutex);
+    _running = false;
+    return this->_close_segment();
+}
+
+bool FileRecorder::do_reset()
+{
+    std::lock_guard l(_mutex);
+    _channels.clear();
+    _segments = 0;
+    _records = 0;
+    return true;
+}
+
+bool FileRecorder::is_running() const
+{
+    return _running;
+}
+
+size_t FileRecorder::segments() const
+{
+    std::lock_guard l(_mutex);
+    return _segments;
+}
+
+size_t FileRecorder::records() const
+{
+    std::lock_guard l(_mutex);
+    return _records;
+}
+
+void FileRecorder::handle(const std::string & name, const Channel *channel)
+{
+    this->add_record(name, channel->timestamp(), channel->array());
+}
+
+void FileRecorder::add_record(const std::string & name,
+                              sihd::util::Timestamp timestamp,
+                              const sihd::util::IArray *array)
+{
+    std::lock_guard l(_mutex);
+    if (!_file.is_open())
+        return;
+
+    const size_t payload_size = array->byte_size();
+    const size_t record_size = sizeof(RecordHeader) + align(payload_size);
+    if (_segment_offset + record_size > _segment_size && !_index.empty())
+    {
+        if (!this->_close_segment() || !this->_open_segment())
+            return;
+    }
+
+    const ChannelDef *def = this->_channel(name, array->data_type());
+    if (def == nullptr)
+        return;
+
+    // the first record of a segment is always indexed
+    if (_index.empty() || timestamp.nanoseconds() - _index.back().timestamp >= _index_interval.nanoseconds())
+        _index.emplace_back(IndexEntry {timestamp.nanoseconds(), _segment_offset});
+
+    const RecordHeader header {def->id, (uint32_t)payload_size, timestamp.nanoseconds()};
+    this->_append(&header, sizeof(header));
+    this->_append(array->buf(), payload_size);
+    ++_records;
+
+    if (_batch.size() >= _batch_size)
+        this->_write_batch();
+}
+
+bool FileRecorder::flush()
+{
+    std::lock_guard l(_mutex);
+    if (!_file.is_open())
+        return false;
+    return this->_write_batch() && _file.flush();
+}
+
+const FileRecorder::ChannelDef *FileRecorder::_channel(const std::string & name, sihd::util::Type type)
+{
+    auto it = _channels.find(name);
+    if (it != _channels.end())
+    {
+        if (it->second.type != type)
+        {
+            SIHD_LOG(error,
+                     "FileRecorder: channel '{}' recorded as {} cannot record {}",
+                     name,
+                     sihd::util::type::str(it->second.type),
+                     sihd::util::type::str(type));
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    const uint32_t id = (uint32_t)_channels.size();
+    const ChannelDef & def = _channels.emplace(name, ChannelDef {id, type}).first->second;
+    const RecordHeader header {definition_id, (uint32_t)(sizeof(ChannelEntry) + name.size()), 0};
+    this->_append(&header, sizeof(header));
+    this->_append_entry(name, def);
+    return &def;
+}
+
+bool FileRecorder::_open_segment()
+{
+    const std::string path = sihd::sys::fs::combine(_path, segment_name(_segment_index));
+    if (!_file.open(path, "wb"))
+    {
+        SIHD_LOG(error, "FileRecorder: cannot open segment: {}", path);
+        return false;
+    }
+    ++_segment_index;
+    ++_segments;
+    _segment_offset = 0;
+    _batch.clear();
+    _index.clear();
+
+    SegmentHeader header {};
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.channels = (uint32_t)_channels.size();
+    this->_append(&header, sizeof(header));
+    for (const auto & [name, def] : _channels)
+        this->_append_entry(name, def);
+    return true;
+}
+
+bool FileRecorder::_close_segment()
+{
+    if (!_file.is_open())
+        return true;
+
+    const SegmentFooter footer {_segment_offset, footer_magic};
+    const RecordHeader header {index_id, (uint32_t)(_index.size() * sizeof(IndexEntry)), 0};
+    this->_append(&header, sizeof(header));
+    this->_append(_index.data(), _index.size() * sizeof(IndexEntry));
+    this->_append(&footer, sizeof(footer));
+
+    const bool ret = this->_write_batch();
+    _file.close();
+    return ret;
+}
+
+bool FileRecorder::_write_batch()
+{
+    if (_batch.empty())
+        return true;
+    const ssize_t ret = _file.write(_batch.data(), _batch.size());
+    const bool success = ret == (ssize_t)_batch.size();
+    if (!success)
+        SIHD_LOG(error, "FileRecorder: failed to write {} bytes into {}", _batch.size(), _file.path());
+    _batch.clear();
+    return success;
+}
+
+void FileRecorder::_append(const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    _batch.insert(_batch.end(), bytes, bytes + size);
+    // keeps the next structure aligned
+    _batch.resize(_batch.size() + align(size) - size, 0);
+    _segment_offset += align(size);
+}
+
+void FileRecorder::_append_entry(const std::string & name, const ChannelDef & def)
+{
+    const ChannelEntry entry {def.id, (uint32_t)def.type, (uint32_t)name.size(), 0};
+    // entry and name are a single aligned block
+    const size_t begin = _batch.size();
+    _batch.resize(begin + align(sizeof(entry) + name.size()), 0);
+    memcpy(_batch.data() + begin, &entry, sizeof(entry));
+    memcpy(_batch.data() + begin + sizeof(entry), name.data(), name.size());
+    _segment_offset += align(sizeof(entry) + name.size());
+}
+
+} // namespace sihd::core
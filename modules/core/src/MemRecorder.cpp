@@ -1,5 +1,9 @@
-#include <sihd/util/Logger.hpp>
+#include <algorithm>
+#include <cstring>
+
 #include <sihd/sys/NamedFactory.hpp>
+#include <sihd/util/Logger.hpp>
+#include <sihd/util/array_utils.hpp>
 
 #include <sihd/core/MemRecorder.hpp>
 
@@ -10,11 +14,14 @@ SIHD_REGISTER_FACTORY(MemRecorder)
 
 SIHD_LOGGER;
 
+using namespace sihd::util;
+
 MemRecorder::MemRecorder(const std::string & name, sihd::util::Node *parent): ACoreObject(name, parent)
 {
     _running = false;
     _providing = false;
     _stop_providing_when_empty = false;
+    _samples = 0;
     this->add_conf("stop_providing_when_empty", &MemRecorder::set_stop_providing_when_empty);
 }
 
@@ -29,12 +36,57 @@ bool MemRecorder::set_stop_providing_when_empty(bool active)
     return true;
 }
 
+size_t MemRecorder::_column(const std::string & name, const sihd::util::IArray *array)
+{
+    auto it = _ids.find(name);
+    if (it == _ids.end())
+    {
+        it = _ids.emplace(name, (uint32_t)_names.size()).first;
+        _names.emplace_back(name);
+        _id_columns.emplace_back(npos);
+    }
+    const uint32_t id = it->second;
+    const Type type = array->data_type();
+    const size_t stride = array->byte_size();
+
+    size_t index = _id_columns[id];
+    if (index != npos && _columns[index].type == type && _columns[index].stride == stride)
+        return index;
+    // the layout of the channel changed
+    index = 0;
+    while (index < _columns.size()
+           && (_columns[index].id != id || _columns[index].type != type || _columns[index].stride != stride))
+        ++index;
+    if (index == _columns.size())
+    {
+        _columns.emplace_back(Column {id, type, stride, {}, {}});
+        _cursors.emplace_back(0);
+    }
+    _id_columns[id] = index;
+    return index;
+}
+
 void MemRecorder::add_record(const std::string & name, sihd::util::Timestamp timestamp, const sihd::util::IArray *array)
 {
-    sihd::util::IArrayShared arr(array->clone_array());
     std::lock_guard l(_mutex);
-    _map_sorted_records.insert(
-        std::pair<sihd::util::Timestamp, PlayableRecord>(timestamp, {name, timestamp, arr}));
+    const size_t index = this->_column(name, array);
+    Column & column = _columns[index];
+    const uint8_t *buf = array->buf();
+
+    if (column.timestamps.size() == _cursors[index] || column.timestamps.back() <= timestamp)
+    {
+        column.timestamps.emplace_back(timestamp);
+        column.payloads.insert(column.payloads.end(), buf, buf + column.stride);
+    }
+    else
+    {
+        // out of order: kept sorted among the samples not provided yet
+        auto it = std::upper_bound(column.timestamps.begin() + _cursors[index], column.timestamps.end(), timestamp);
+        const size_t position = it - column.timestamps.begin();
+        column.timestamps.insert(it, timestamp);
+        column.payloads.insert(column.payloads.begin() + position * column.stride, buf, buf + column.stride);
+    }
+    ++_samples;
 }
 
 void MemRecorder::add_record(const PlayableRecord & record)
@@ -57,7 +109,24 @@ void MemRecorder::add_records(const std::list<PlayableRecord> & records)
 bool MemRecorder::empty() const
 {
     std::lock_guard l(_mutex);
-    return _map_sorted_records.empty();
+    return _samples == 0;
+}
+
+size_t MemRecorder::samples() const
+{
+    std::lock_guard l(_mutex);
+    return _samples;
+}
+
+size_t MemRecorder::memory_usage() const
+{
+    std::lock_guard l(_mutex);
+    size_t bytes = 0;
+    for (const Column & column : _columns)
+    {
+        bytes += sizeof(Column) + column.timestamps.capacity() * sizeof(Timestamp) + column.payloads.capacity();
+    }
+    return bytes;
 }
 
 bool MemRecorder::providing() const
@@ -65,14 +134,49 @@ bool MemRecorder::providing() const
     return _providing;
 }
 
+size_t MemRecorder::_earliest(const std::vector<size_t> & cursors) const
+{
+    size_t earliest = npos;
+    for (size_t i = 0; i < _columns.size(); ++i)
+    {
+        const std::vector<Timestamp> & timestamps = _columns[i].timestamps;
+        if (cursors[i] < timestamps.size()
+            && (earliest == npos || timestamps[cursors[i]] < _columns[earliest].timestamps[cursors[earliest]]))
+            earliest = i;
+    }
+    return earliest;
+}
+
+sihd::util::IArrayShared MemRecorder::_make_array(const Column & column, size_t index) const
+{
+    IArray *array = array_utils::create_from_type(column.type);
+    if (array == nullptr)
+        return nullptr;
+    array->from_bytes(column.payloads.data() + index * column.stride, column.stride);
+    return IArrayShared(array);
+}
+
 bool MemRecorder::provide(PlayableRecord *record)
 {
     std::lock_guard l(_mutex);
-    if (_map_sorted_records.empty())
+    const size_t index = this->_earliest(_cursors);
+    if (index == npos)
         return false;
-    *record = _map_sorted_records.begin()->second;
-    _map_sorted_records.erase(_map_sorted_records.begin());
-    if (_stop_providing_when_empty && _map_sorted_records.empty())
+    Column & column = _columns[index];
+    size_t & cursor = _cursors[index];
+    record->name = _names[column.id];
+    record->timestamp = column.timestamps[cursor];
+    record->value = this->_make_array(column, cursor);
+    ++cursor;
+    --_samples;
+    if (cursor == column.timestamps.size())
+    {
+        // keeps the capacity for the next samples
+        column.timestamps.clear();
+        column.payloads.clear();
+        cursor = 0;
+    }
+    if (_stop_providing_when_empty && _samples == 0)
         _providing = false;
     return true;
 }
@@ -82,13 +186,36 @@ void MemRecorder::handle(const std::string & name, const Channel *channel)
     this->add_record(name, channel->timestamp(), channel->array());
 }
 
+SortedRecordedValues MemRecorder::sorted_recorded_values() const
+{
+    std::lock_guard l(_mutex);
+    SortedRecordedValues sorted_records;
+    for (size_t i = 0; i < _columns.size(); ++i)
+    {
+        const Column & column = _columns[i];
+        for (size_t j = _cursors[i]; j < column.timestamps.size(); ++j)
+        {
+            sorted_records.emplace_hint(sorted_records.upper_bound(column.timestamps[j]),
+                                        column.timestamps[j],
+                                        PlayableRecord {_names[column.id],
+                                                        column.timestamps[j],
+                                                        this->_make_array(column, j)});
+        }
+    }
+    return sorted_records;
+}
+
 MapListRecordedValues MemRecorder::make_recorded_values() const
 {
     std::lock_guard l(_mutex);
     MapListRecordedValues map_record;
-    for (const auto & [_, playable_record] : _map_sorted_records)
+    std::vector<size_t> cursors = _cursors;
+    size_t index;
+    while ((index = this->_earliest(cursors)) != npos)
     {
-        map_record[playable_record.name].emplace_back(playable_record.timestamp, playable_record.value);
+        const Column & column = _columns[index];
+        const size_t cursor = cursors[index]++;
+        map_record[_names[column.id]].emplace_back(column.timestamps[cursor], this->_make_array(column, cursor));
     }
     return map_record;
 }
@@ -112,13 +239,17 @@ std::string MemRecorder::hexdump_records(std::string_view separation_cols, char
     std::string str;
     std::lock_guard l(_mutex);
 
-    for (const auto & [_, playable_record] : _map_sorted_records)
+    std::vector<size_t> cursors = _cursors;
+    size_t index;
+    while ((index = this->_earliest(cursors)) != npos)
     {
+        const Column & column = _columns[index];
+        const size_t cursor = cursors[index]++;
         str += fmt::format("{0}{1}{2}{1}{3}\n",
-                           playable_record.name,
+                           _names[column.id],
                            separation_cols,
-                           playable_record.timestamp.nanoseconds(),
-                           playable_record.value->hexdump(separation_data));
+                           column.timestamps[cursor].nanoseconds(),
+                           this->_make_array(column, cursor)->hexdump(separation_data));
     }
     return str;
 }
@@ -151,7 +282,12 @@ bool MemRecorder::is_running() const
 void MemRecorder::clear()
 {
     std::lock_guard l(_mutex);
-    _map_sorted_records.clear();
+    _ids.clear();
+    _names.clear();
+    _columns.clear();
+    _id_columns.clear();
+    _cursors.clear();
+    _samples = 0;
 }
 
-} // namespace sihd::core
\ No newline at end of file
+} // namespace sihd::core
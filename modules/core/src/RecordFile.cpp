@@ -0,0 +1,13 @@
+#include <fmt/format.h>
+
+#include <sihd/core/RecordFile.hpp>
+
+namespace sihd::core::record_file
+{
+
+std::string segment_name(size_t index)
+{
+    return fmt::format("{:06}{}", index, segment_extension);
+}
+
+} // namespace sihd::core::record_file
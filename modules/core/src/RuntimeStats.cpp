@@ -0,0 +1,105 @@
+#include <fmt/format.h>
+
+#include <sihd/core/Device.hpp>
+#include <sihd/core/RuntimeStats.hpp>
+
+namespace sihd::core
+{
+
+using namespace sihd::util;
+
+LatencyStat::LatencyStat() = default;
+
+LatencyStat::~LatencyStat() = default;
+
+void LatencyStat::add(int64_t nanoseconds)
+{
+    std::lock_guard l(_mutex);
+    _stat.add_sample(static_cast<double>(nanoseconds));
+}
+
+LatencyStats LatencyStat::snapshot() const
+{
+    std::lock_guard l(_mutex);
+    return LatencyStats {
+        .samples = _stat.samples,
+        .min = _stat.min,
+        .average = _stat.average(),
+        .max = _stat.max,
+        .median = _stat.median(),
+        .p95 = _stat.p95(),
+        .p99 = _stat.p99(),
+    };
+}
+
+void LatencyStat::clear()
+{
+    std::lock_guard l(_mutex);
+    _stat.clear();
+}
+
+void DeviceCounters::clear()
+{
+    handled.store(0, std::memory_order_relaxed);
+    handle.clear();
+}
+
+void ChannelCounters::add_observer_time(IHandler<Channel *> *handler, int64_t nanoseconds)
+{
+    Observer *observer = nullptr;
+    {
+        std::lock_guard l(_observers_mutex);
+        for (const auto & entry : _observers)
+        {
+            if (entry->handler == handler)
+            {
+                observer = entry.get();
+                break;
+            }
+        }
+        if (observer == nullptr)
+        {
+            Device *device = dynamic_cast<Device *>(handler);
+            auto & entry = _observers.emplace_back(std::make_unique<Observer>());
+            entry->handler = handler;
+            entry->device = device;
+            entry->name = device != nullptr ? device->full_name() : fmt::format("{}", fmt::ptr(handler));
+            observer = entry.get();
+        }
+    }
+    observer->handle.add(nanoseconds);
+    // the device is being notified: still alive
+    DeviceCounters *device_counters = observer->device != nullptr ? observer->device->stats_counters() : nullptr;
+    if (device_counters != nullptr)
+    {
+        device_counters->handled.fetch_add(1, std::memory_order_relaxed);
+        device_counters->handle.add(nanoseconds);
+    }
+}
+
+std::vector<ObserverStats> ChannelCounters::observers() const
+{
+    std::lock_guard l(_observers_mutex);
+    std::vector<ObserverStats> ret;
+    ret.reserve(_observers.size());
+    for (const auto & observer : _observers)
+        ret.emplace_back(ObserverStats {observer->name, observer->handle.snapshot()});
+    return ret;
+}
+
+void ChannelCounters::clear()
+{
+    writes.store(0, std::memory_order_relaxed);
+    bytes_written.store(0, std::memory_order_relaxed);
+    unchanged_writes.store(0, std::memory_order_relaxed);
+    rejected_writes.store(0, std::memory_order_relaxed);
+    notifications.store(0, std::memory_order_relaxed);
+    lock_wait.clear();
+    notify.clear();
+    // entries are kept: a notifying thread can be adding to one outside of the lock
+    std::lock_guard l(_observers_mutex);
+    for (const auto & observer : _observers)
+        observer->handle.clear();
+}
+
+} // namespace sihd::core
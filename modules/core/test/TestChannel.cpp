@@ -1,3 +1,7 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <sihd/util/Array.hpp>
@@ -260,4 +264,175 @@ TEST_F(TestChannel, test_channel_build_capacity)
     delete c;
 }
 
+TEST_F(TestChannel, test_channel_seqlock_conf)
+{
+    Channel *c = Channel::build("name=chan;type=int;size=4;seqlock=true");
+    ASSERT_NE(c, nullptr);
+    EXPECT_TRUE(c->seqlock());
+    c->set_resizable(true);
+    EXPECT_FALSE(c->resizable());
+    delete c;
+
+    EXPECT_EQ(Channel::build("name=chan;type=int;size=4;seqlock=toto"), nullptr);
+    EXPECT_EQ(Channel::build("name=chan;type=int;size=4;capacity=8;seqlock=true"), nullptr);
+
+    c = Channel::build("name=chan;type=int;size=4;seqlock=false");
+    ASSERT_NE(c, nullptr);
+    EXPECT_FALSE(c->seqlock());
+    delete c;
+}
+
+// timestamps the channel with the value being written
+class ValueClock: public IClock
+{
+    public:
+        Timestamp now() const { return Timestamp(value.load()); }
+        bool is_steady() const { return false; }
+        bool start() { return true; }
+        bool stop() { return true; }
+
+        std::atomic<time::UnixTime> value = 0;
+};
+
+TEST_F(TestChannel, test_channel_seqlock_concurrent)
+{
+    constexpr size_t size = 64;
+    constexpr int writes = 20000;
+
+    ValueClock clock;
+    Channel c("chan", "int", size);
+    c.set_clock(&clock);
+    ASSERT_TRUE(c.set_seqlock(true));
+
+    std::atomic<bool> stop = false;
+    std::atomic<size_t> torn = 0;
+    std::atomic<size_t> reads = 0;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i)
+    {
+        readers.emplace_back([&] {
+            ArrInt arr;
+            arr.resize(size);
+            Timestamp timestamp;
+            while (!stop.load())
+            {
+                if (!c.copy_to(arr, &timestamp))
+                    continue;
+                const int first = arr[0];
+                for (size_t j = 1; j < size; ++j)
+                {
+                    if (arr[j] != first)
+                        torn += 1;
+                }
+                if (timestamp.nanoseconds() != first)
+                    torn += 1;
+                if (c.read<int>(size - 1) < first)
+                    torn += 1;
+                reads += 1;
+            }
+        });
+    }
+
+    while (reads.load() == 0)
+        std::this_thread::yield();
+
+    ArrInt values;
+    values.resize(size);
+    for (int i = 1; i <= writes; ++i)
+    {
+        for (size_t j = 0; j < size; ++j)
+            values[j] = i;
+        clock.value = i;
+        ASSERT_TRUE(c.write(values));
+    }
+    stop = true;
+    for (auto & reader : readers)
+        reader.join();
+
+    SIHD_LOG(debug, "{} seqlock reads", reads.load());
+    EXPECT_GT(reads.load(), 0u);
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(c.read<int>(0), writes);
+    EXPECT_EQ(c.timestamp(), Timestamp(writes));
+}
+
+TEST_F(TestChannel, test_channel_shared_buffers)
+{
+    Channel src("src", "int", 4);
+    Channel dst("dst", "int", 4);
+    Channel copy("copy", "int", 4);
+    ASSERT_TRUE(src.write(ArrInt({1, 2, 3, 4})));
+    ASSERT_TRUE(src.set_shared_buffers(true, 2));
+    ASSERT_TRUE(dst.set_shared_buffers(true));
+    EXPECT_EQ(src.array()->str(','), "1,2,3,4");
+
+    // forwarding publishes the same buffer
+    ASSERT_TRUE(dst.write(src));
+    ChannelBuffer::Ref buffer = src.buffer();
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(dst.buffer().get(), buffer.get());
+    EXPECT_EQ(dst.array(), buffer->array());
+    EXPECT_EQ(buffer->writable_array(), nullptr);
+    // copied into channels without shared buffers
+    ASSERT_TRUE(copy.write(src));
+    EXPECT_EQ(copy.array()->str(','), "1,2,3,4");
+
+    // writes never modify a published buffer
+    ASSERT_TRUE(src.write<int>(1, 20));
+    EXPECT_NE(src.buffer().get(), buffer.get());
+    EXPECT_EQ(src.array()->str(','), "1,20,3,4");
+    EXPECT_EQ(dst.array()->str(','), "1,2,3,4");
+    EXPECT_EQ(buffer->array()->str(','), "1,2,3,4");
+    EXPECT_FALSE(dst.write(ArrInt({1, 2, 3, 4, 5})));
+
+    // writers fill a buffer of the pool before publishing it
+    ChannelBuffer::Ref fresh = src.acquire_buffer();
+    ASSERT_TRUE(fresh);
+    ASSERT_NE(fresh->writable_array(), nullptr);
+    ASSERT_TRUE(fresh->writable_array()->copy_from_bytes(ArrInt({5, 6, 7, 8})));
+    ASSERT_TRUE(src.publish(fresh));
+    EXPECT_EQ(src.read<int>(3), 8);
+    ASSERT_TRUE(dst.write(src));
+    EXPECT_EQ(dst.buffer().get(), fresh.get());
+    EXPECT_EQ(fresh->refs(), 3u);
+
+    // released buffers go back to the pool of their channel
+    fresh.reset();
+    buffer.reset();
+    ASSERT_TRUE(src.write(ArrInt({0, 0, 0, 0})));
+    ASSERT_TRUE(dst.write(src));
+    Channel other("other", "float", 4);
+    ASSERT_TRUE(other.set_shared_buffers(true));
+    EXPECT_FALSE(other.write(src));
+
+    ASSERT_TRUE(src.set_shared_buffers(false));
+    EXPECT_FALSE(src.buffer());
+    EXPECT_EQ(src.array()->str(','), "0,0,0,0");
+    ASSERT_TRUE(src.write<int>(0, 1));
+    EXPECT_EQ(dst.array()->str(','), "0,0,0,0");
+}
+
+TEST_F(TestChannel, test_channel_shared_buffers_pool)
+{
+    ChannelBuffer::Ref kept;
+    {
+        Channel c("chan", "double", 8);
+        ASSERT_TRUE(c.set_shared_buffers(true, 4));
+        for (int i = 0; i < 16; ++i)
+            ASSERT_TRUE(c.write<double>(0, i));
+        kept = c.buffer();
+    }
+    // buffers outlive their channel
+    ASSERT_TRUE(kept);
+    EXPECT_EQ(kept->array()->size(), 8u);
+    EXPECT_EQ(kept->refs(), 1u);
+
+    EXPECT_EQ(Channel::build("name=chan;type=int;size=4;capacity=8;shared=true"), nullptr);
+    Channel *c = Channel::build("name=chan;type=int;size=4;shared=true");
+    ASSERT_NE(c, nullptr);
+    EXPECT_TRUE(c->shared_buffers());
+    EXPECT_FALSE(c->set_seqlock(true));
+    delete c;
+}
+
 } // namespace test
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <sihd/util/Array.hpp>
+#include <sihd/util/Logger.hpp>
+#include <sihd/util/ThreadPool.hpp>
+#include <sihd/util/time.hpp>
+
+#include <sihd/core/Channel.hpp>
+
+namespace test
+{
+SIHD_NEW_LOGGER("sihd::test");
+using namespace sihd::util;
+using namespace sihd::core;
+
+// records delivered values, the first delivery waits for the gate to open
+class GatedHandler: public IHandler<const ChannelUpdate &>
+{
+    public:
+        void handle(const ChannelUpdate & update) override
+        {
+            entered = true;
+            entered.notify_all();
+            gate.wait(false);
+
+            std::lock_guard l(mutex);
+            values.emplace_back(dynamic_cast<const ArrInt *>(update.array)->at(0));
+            timestamps.emplace_back(update.timestamp);
+            channel = update.channel;
+        }
+
+        void wait_entered() { entered.wait(false); }
+
+        void open()
+        {
+            gate = true;
+            gate.notify_all();
+        }
+
+        std::vector<int> delivered()
+        {
+            std::lock_guard l(mutex);
+            return values;
+        }
+
+        std::atomic<bool> entered = false;
+        std::atomic<bool> gate = false;
+        std::mutex mutex;
+        std::vector<int> values;
+        std::vector<Timestamp> timestamps;
+        const Channel *channel = nullptr;
+};
+
+class TestChannelDelivery: public ::testing::Test
+{
+    protected:
+        TestChannelDelivery() { sihd::util::LoggerManager::stream(); }
+
+        virtual ~TestChannelDelivery() { sihd::util::LoggerManager::clear_loggers(); }
+
+        virtual void SetUp() {}
+
+        virtual void TearDown() {}
+
+        static void wait_delivered(const ChannelDelivery *delivery, size_t count)
+        {
+            for (int i = 0; i < 1000 && delivery->stats().delivered < count; ++i)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // one delivery in the handler then writes values while it is blocked
+        std::vector<int> run_overflow(ChannelDelivery::Overflow overflow, ChannelDelivery::Stats & stats)
+        {
+            ThreadPool executor("test", 1);
+            GatedHandler handler;
+            Channel c("chan", "int");
+            EXPECT_TRUE(c.add_async_observer(&handler, {.capacity = 2, .overflow = overflow, .executor = &executor}));
+
+            EXPECT_TRUE(c.write<int>(0, 1));
+            handler.wait_entered();
+            for (int i = 2; i <= 5; ++i)
+                EXPECT_TRUE(c.write<int>(0, i));
+            handler.open();
+
+            const ChannelDelivery *delivery = c.async_observer(&handler);
+            EXPECT_NE(delivery, nullptr);
+            wait_delivered(delivery, 3);
+            stats = delivery->stats();
+            return handler.delivered();
+        }
+};
+
+TEST_F(TestChannelDelivery, test_delivery_order)
+{
+    GatedHandler handler;
+    handler.open();
+    Channel c("chan", "int", 4);
+
+    EXPECT_TRUE(c.add_async_observer(&handler));
+    EXPECT_FALSE(c.add_async_observer(&handler));
+    for (int i = 1; i <= 50; ++i)
+        EXPECT_TRUE(c.write<int>(0, i));
+
+    const ChannelDelivery *delivery = c.async_observer(&handler);
+    ASSERT_NE(delivery, nullptr);
+    wait_delivered(delivery, 50);
+
+    const std::vector<int> values = handler.delivered();
+    ASSERT_EQ(values.size(), 50u);
+    for (int i = 0; i < 50; ++i)
+        EXPECT_EQ(values[i], i + 1);
+    EXPECT_TRUE(std::is_sorted(handler.timestamps.begin(), handler.timestamps.end()));
+    EXPECT_EQ(handler.timestamps.back(), c.timestamp());
+    EXPECT_EQ(handler.channel, &c);
+
+    const ChannelDelivery::Stats stats = delivery->stats();
+    EXPECT_EQ(stats.queued, 50u);
+    EXPECT_EQ(stats.delivered, 50u);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.coalesced, 0u);
+
+    EXPECT_TRUE(c.remove_async_observer(&handler));
+    EXPECT_FALSE(c.remove_async_observer(&handler));
+    EXPECT_EQ(c.async_observer(&handler), nullptr);
+    EXPECT_TRUE(c.write<int>(0, 1337));
+    EXPECT_EQ(handler.delivered().size(), 50u);
+}
+
+TEST_F(TestChannelDelivery, test_delivery_overflow)
+{
+    ChannelDelivery::Stats stats;
+
+    EXPECT_EQ(run_overflow(ChannelDelivery::Overflow::DropNewest, stats), std::vector<int>({1, 2, 3}));
+    EXPECT_EQ(stats.dropped, 2u);
+    EXPECT_EQ(stats.coalesced, 0u);
+
+    EXPECT_EQ(run_overflow(ChannelDelivery::Overflow::DropOldest, stats), std::vector<int>({1, 4, 5}));
+    EXPECT_EQ(stats.queued, 5u);
+    EXPECT_EQ(stats.dropped, 2u);
+
+    EXPECT_EQ(run_overflow(ChannelDelivery::Overflow::Coalesce, stats), std::vector<int>({1, 2, 5}));
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.coalesced, 2u);
+}
+
+TEST_F(TestChannelDelivery, test_delivery_block)
+{
+    ThreadPool executor("test", 1);
+    GatedHandler handler;
+    Channel c("chan", "int");
+    const ChannelDelivery::Options options {
+        .capacity = 1,
+        .overflow = ChannelDelivery::Overflow::Block,
+        .executor = &executor,
+    };
+    EXPECT_TRUE(c.add_async_observer(&handler, options));
+
+    EXPECT_TRUE(c.write<int>(0, 1));
+    handler.wait_entered();
+    EXPECT_TRUE(c.write<int>(0, 2));
+
+    std::atomic<bool> written = false;
+    std::thread writer([&] {
+        EXPECT_TRUE(c.write<int>(0, 3));
+        written = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(written.load());
+
+    handler.open();
+    writer.join();
+    const ChannelDelivery *delivery = c.async_observer(&handler);
+    wait_delivered(delivery, 3);
+    EXPECT_EQ(handler.delivered(), std::vector<int>({1, 2, 3}));
+    EXPECT_EQ(delivery->stats().dropped, 0u);
+}
+
+TEST_F(TestChannelDelivery, test_delivery_stopped_executor)
+{
+    // no worker: drain jobs stay queued until the executor is stopped
+    ThreadPool executor("test", 0);
+    GatedHandler handler;
+    handler.open();
+    Channel c("chan", "int");
+    EXPECT_TRUE(c.add_async_observer(&handler, {.executor = &executor}));
+
+    EXPECT_TRUE(c.write<int>(0, 1));
+    executor.stop();
+    EXPECT_TRUE(c.write<int>(0, 2));
+    EXPECT_TRUE(handler.delivered().empty());
+
+    // does not wait for drains discarded by the executor
+    EXPECT_TRUE(c.remove_async_observer(&handler));
+}
+
+TEST_F(TestChannelDelivery, test_delivery_concurrent_writers)
+{
+    GatedHandler handler;
+    handler.open();
+    Channel c("chan", "int");
+    c.set_write_on_change(false);
+    EXPECT_TRUE(c.add_async_observer(&handler, {.capacity = 4096}));
+
+    std::atomic<int> failed = 0;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t)
+    {
+        writers.emplace_back([&] {
+            for (int i = 0; i < 500; ++i)
+            {
+                if (!c.write<int>(0, i))
+                    failed += 1;
+            }
+        });
+    }
+    for (auto & writer : writers)
+        writer.join();
+
+    // writers wait for each other instead of failing
+    EXPECT_EQ(failed.load(), 0);
+    const ChannelDelivery *delivery = c.async_observer(&handler);
+    wait_delivered(delivery, 2000);
+    const ChannelDelivery::Stats stats = delivery->stats();
+    EXPECT_EQ(stats.queued + stats.dropped, 2000u);
+    EXPECT_EQ(stats.delivered, stats.queued);
+}
+
+} // namespace test
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <sihd/util/Array.hpp>
+#include <sihd/util/Handler.hpp>
+#include <sihd/util/Logger.hpp>
+
+#include <sihd/core/ChannelTransaction.hpp>
+
+namespace test
+{
+SIHD_LOGGER;
+using namespace sihd::util;
+using namespace sihd::core;
+class TestChannelTransaction: public ::testing::Test
+{
+    protected:
+        TestChannelTransaction() { sihd::util::LoggerManager::stream(); }
+
+        virtual ~TestChannelTransaction() { sihd::util::LoggerManager::clear_loggers(); }
+
+        virtual void SetUp() {}
+
+        virtual void TearDown() {}
+};
+
+TEST_F(TestChannelTransaction, test_channeltransaction_batch)
+{
+    Channel c("chan", "int", 4);
+    int notified = 0;
+    Handler<Channel *> counter([&notified](Channel *) { ++notified; });
+    c.add_observer(&counter);
+
+    const int one = 1;
+    const int three = 3;
+    const std::vector<Channel::Write> writes = {{one, c.byte_index(0)}, {three, c.byte_index(2)}};
+    EXPECT_TRUE(c.write_batch(writes));
+    EXPECT_EQ(notified, 1);
+    EXPECT_EQ(c.array()->str(','), "1,0,3,0");
+
+    // nothing changed
+    EXPECT_TRUE(c.write_batch(writes));
+    EXPECT_EQ(notified, 1);
+
+    // nothing written if one write does not fit
+    const int two = 2;
+    EXPECT_FALSE(c.write_batch(std::vector<Channel::Write> {{two, c.byte_index(1)}, {two, c.byte_index(4)}}));
+    EXPECT_EQ(notified, 1);
+    EXPECT_EQ(c.array()->str(','), "1,0,3,0");
+}
+
+TEST_F(TestChannelTransaction, test_channeltransaction_commit)
+{
+    Channel a("a", "int", 3);
+    Channel b("b", "double", 2);
+    Channel unchanged("unchanged", "int", 1);
+    ASSERT_TRUE(b.set_shared_buffers(true));
+
+    std::vector<std::string> notifications;
+    Handler<Channel *> observer([&](Channel *c) {
+        notifications.push_back(c->name());
+        // every change is visible from the first notification
+        EXPECT_EQ(a.read<int>(2), 30);
+        EXPECT_EQ(b.read<double>(1), 2.5);
+        EXPECT_EQ(a.timestamp(), b.timestamp());
+        // channels of the transaction cannot be written while it notifies
+        EXPECT_FALSE(a.write<int>(0, 0));
+    });
+    a.add_observer(&observer);
+    b.add_observer(&observer);
+    unchanged.add_observer(&observer);
+
+    ChannelTransaction transaction;
+    EXPECT_TRUE(transaction.commit());
+    ASSERT_TRUE(transaction.write<double>(&b, 0, 1.5));
+    ASSERT_TRUE(transaction.write<int>(&a, 0, 10));
+    ASSERT_TRUE(transaction.write<int>(&unchanged, 0, 0));
+    ASSERT_TRUE(transaction.write(&a, ArrInt({20, 30}), a.byte_index(1)));
+    double *staged = (double *)transaction.stage(&b, sizeof(double), b.byte_index(1));
+    ASSERT_NE(staged, nullptr);
+    *staged = 2.5;
+    EXPECT_EQ(a.read<int>(0), 0);
+
+    ASSERT_TRUE(transaction.commit());
+    EXPECT_TRUE(transaction.empty());
+    // once per channel changed in the order of the transaction
+    const std::vector<std::string> expected = {"b", "a"};
+    EXPECT_EQ(notifications, expected);
+    EXPECT_EQ(a.array()->str(','), "10,20,30");
+    EXPECT_EQ(b.read<double>(0), 1.5);
+    EXPECT_EQ(a.timestamp(), transaction.timestamp());
+
+    // nothing is written if one write does not fit
+    notifications.clear();
+    ASSERT_TRUE(transaction.write<int>(&a, 0, 1));
+    ASSERT_TRUE(transaction.write(&b, ArrDouble({1, 2, 3})));
+    EXPECT_FALSE(transaction.commit());
+    EXPECT_FALSE(transaction.empty());
+    EXPECT_TRUE(notifications.empty());
+    EXPECT_EQ(a.read<int>(0), 10);
+    transaction.clear();
+    EXPECT_TRUE(transaction.empty());
+}
+
+TEST_F(TestChannelTransaction, test_channeltransaction_timestamp)
+{
+    Channel a("a", "int", 2);
+    Channel b("b", "int", 1);
+
+    // time of the data instead of the clock
+    const Timestamp received = time::sec(42);
+    const int one = 1;
+    const Channel::Write write {one, a.byte_index(0)};
+    EXPECT_TRUE(a.write_batch({&write, 1}, received));
+    EXPECT_EQ(a.timestamp(), received);
+    EXPECT_TRUE(a.write<int>(1, 2));
+    EXPECT_GT(a.timestamp(), received);
+
+    ChannelTransaction transaction;
+    ASSERT_TRUE(transaction.write<int>(&a, 0, 3));
+    ASSERT_TRUE(transaction.write<int>(&b, 0, 4));
+    ASSERT_TRUE(transaction.commit(received + time::sec(1)));
+    EXPECT_EQ(transaction.timestamp(), received + time::sec(1));
+    EXPECT_EQ(a.timestamp(), transaction.timestamp());
+    EXPECT_EQ(b.timestamp(), transaction.timestamp());
+}
+
+} // namespace test
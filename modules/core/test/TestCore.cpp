@@ -0,0 +1,309 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <sihd/core/Core.hpp>
+#include <sihd/util/Logger.hpp>
+
+namespace test
+{
+SIHD_LOGGER;
+using namespace sihd::util;
+using namespace sihd::core;
+class TestCore: public ::testing::Test
+{
+    protected:
+        TestCore() { sihd::util::LoggerManager::stream(); }
+
+        virtual ~TestCore() { sihd::util::LoggerManager::clear_loggers(); }
+
+        virtual void SetUp() {}
+
+        virtual void TearDown() {}
+};
+
+// records the order in which devices are done starting
+class StartLog
+{
+    public:
+        void add(const std::string & name)
+        {
+            std::lock_guard l(_mutex);
+            _names.push_back(name);
+        }
+
+        std::vector<std::string> names()
+        {
+            std::lock_guard l(_mutex);
+            return _names;
+        }
+
+        size_t position(const std::string & name)
+        {
+            std::lock_guard l(_mutex);
+            return std::find(_names.begin(), _names.end(), name) - _names.begin();
+        }
+
+    private:
+        std::mutex _mutex;
+        std::vector<std::string> _names;
+};
+
+class SlowDevice: public Device
+{
+    public:
+        SlowDevice(const std::string & name, Node *parent = nullptr): Device(name, parent), _running(false) {}
+
+        ~SlowDevice() = default;
+
+        bool is_running() const { return _running; }
+
+        StartLog *log = nullptr;
+        std::chrono::milliseconds start_time {0};
+        bool fail = false;
+
+    protected:
+        bool on_init()
+        {
+            this->add_channel("out", "int");
+            this->add_unlinked_channel("in", "int");
+            return true;
+        }
+
+        bool on_start()
+        {
+            std::this_thread::sleep_for(start_time);
+            if (fail)
+                return false;
+            _running = true;
+            if (log != nullptr)
+                log->add(this->name());
+            return true;
+        }
+
+        bool on_stop()
+        {
+            _running = false;
+            return true;
+        }
+
+    private:
+        bool _running;
+};
+
+TEST_F(TestCore, test_core_pipelines)
+{
+    Core core;
+    core.add_child<SlowDevice>("a");
+    SlowDevice *b = core.add_child<SlowDevice>("b");
+    core.add_child<SlowDevice>("c");
+    core.add_child<SlowDevice>("d");
+    core.add_channel("shared", "int");
+
+    // links to a channel created at init
+    b->add_link("in", "..a.out");
+    // links to the core are not dependencies
+    core.get_child<SlowDevice>("c")->add_link("in", "..shared");
+    ASSERT_TRUE(core.set_conf_str("dependency", "d=c"));
+
+    const std::vector<std::vector<std::string>> expected = {{"a", "b"}, {"c", "d"}};
+    EXPECT_EQ(core.pipelines(), expected);
+    ASSERT_TRUE(core.init());
+    ASSERT_TRUE(core.start());
+    // resolved links are not dependencies
+    EXPECT_EQ(core.pipelines(), expected);
+    EXPECT_EQ(b->get_channel("in"), core.find_channel("a.out"));
+    EXPECT_TRUE(core.stop());
+}
+
+TEST_F(TestCore, test_core_parallel_startup)
+{
+    StartLog log;
+    Core core;
+    ASSERT_TRUE(core.set_conf_int("startup_threads", 4));
+    for (const char *name : {"a", "b", "c", "d"})
+    {
+        SlowDevice *device = core.add_child<SlowDevice>(name);
+        device->log = &log;
+        device->start_time = std::chrono::milliseconds(100);
+    }
+    core.get_child<SlowDevice>("b")->add_link("in", "..a.out");
+    core.get_child<SlowDevice>("c")->add_link("in", "..b.out");
+
+    ASSERT_TRUE(core.init());
+    const auto before = std::chrono::steady_clock::now();
+    ASSERT_TRUE(core.start());
+    const auto elapsed = std::chrono::steady_clock::now() - before;
+    EXPECT_TRUE(core.is_running());
+
+    // a, b and c one after the other while d starts alongside
+    EXPECT_EQ(log.names().size(), 4u);
+    EXPECT_LT(log.position("a"), log.position("b"));
+    EXPECT_LT(log.position("b"), log.position("c"));
+    EXPECT_LT(log.position("d"), log.position("c"));
+    EXPECT_GE(elapsed, std::chrono::milliseconds(300));
+    EXPECT_EQ(core.get_child<SlowDevice>("c")->get_channel("in"), core.find_channel("b.out"));
+    EXPECT_TRUE(core.stop());
+}
+
+TEST_F(TestCore, test_core_linked_service)
+{
+    Node root("root");
+    Core *core = root.add_child<Core>("core");
+    SlowDevice *a = core->add_child<SlowDevice>("a");
+    SlowDevice *linked = root.add_child<SlowDevice>("linked");
+    core->add_link("linked", "..linked");
+
+    ASSERT_TRUE(linked->init());
+    ASSERT_TRUE(linked->start());
+    ASSERT_TRUE(core->init());
+    ASSERT_TRUE(core->start());
+    EXPECT_EQ(core->get_child("linked"), linked);
+
+    // not a child of the core but cascaded by it
+    EXPECT_TRUE(core->stop());
+    EXPECT_FALSE(a->is_running());
+    EXPECT_FALSE(linked->is_running());
+    EXPECT_EQ(linked->device_state(), ServiceController::Stopped);
+    EXPECT_TRUE(core->reset());
+    EXPECT_EQ(linked->device_state(), ServiceController::None);
+}
+
+TEST_F(TestCore, test_core_parallel_startup_failure)
+{
+    Core core;
+    ASSERT_TRUE(core.set_conf_int("startup_threads", 2));
+    SlowDevice *a = core.add_child<SlowDevice>("a");
+    SlowDevice *b = core.add_child<SlowDevice>("b");
+    SlowDevice *c = core.add_child<SlowDevice>("c");
+    a->start_time = std::chrono::milliseconds(10);
+    b->fail = true;
+    c->add_link("in", "..b.out");
+
+    ASSERT_TRUE(core.init());
+    EXPECT_FALSE(core.start());
+    // started services are stopped and the dependents of the failure never started
+    EXPECT_FALSE(a->is_running());
+    EXPECT_FALSE(c->is_running());
+    EXPECT_EQ(c->get_channel("in"), nullptr);
+}
+
+TEST_F(TestCore, test_core_circular_dependency)
+{
+    Core core;
+    ASSERT_TRUE(core.set_conf_int("startup_threads", 2));
+    core.add_child<SlowDevice>("a")->add_link("in", "..b.out");
+    core.add_child<SlowDevice>("b");
+    ASSERT_TRUE(core.set_conf_str("dependency", "b=a"));
+    EXPECT_FALSE(core.set_conf_str("dependency", "b"));
+
+    EXPECT_TRUE(core.pipelines().empty());
+    EXPECT_FALSE(core.init());
+}
+
+TEST_F(TestCore, test_core_pipeline_executors)
+{
+    Core core;
+    ASSERT_TRUE(core.set_conf("pipeline_executors", true));
+    SlowDevice *a = core.add_child<SlowDevice>("a");
+    SlowDevice *b = core.add_child<SlowDevice>("b");
+    SlowDevice *c = core.add_child<SlowDevice>("c");
+    b->add_link("in", "..a.out");
+
+    EXPECT_EQ(core.executor(a), nullptr);
+    ASSERT_TRUE(core.init());
+    ASSERT_TRUE(core.start());
+    ThreadPool *executor = core.executor(a);
+    ASSERT_NE(executor, nullptr);
+    EXPECT_EQ(core.executor(b), executor);
+    EXPECT_EQ(core.executor(b->get_channel("out")), executor);
+    EXPECT_NE(core.executor(c), nullptr);
+    EXPECT_NE(core.executor(c), executor);
+    EXPECT_EQ(core.executor(&core), nullptr);
+
+    // a pipeline runs on a single thread
+    std::thread::id first = executor->add_job([] { return std::this_thread::get_id(); }).get();
+    std::thread::id second = core.executor(b)->add_job([] { return std::this_thread::get_id(); }).get();
+    EXPECT_EQ(first, second);
+
+    EXPECT_TRUE(core.stop());
+    EXPECT_EQ(core.executor(a), nullptr);
+}
+
+// observes its channel "in" and takes its time handling it
+class HandlingDevice: public SlowDevice
+{
+    public:
+        using SlowDevice::SlowDevice;
+
+    protected:
+        bool on_start()
+        {
+            return SlowDevice::on_start() && this->observe_channel("in");
+        }
+
+        void handle(Channel *) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+};
+
+TEST_F(TestCore, test_core_runtime_stats)
+{
+    Core core;
+    SlowDevice *a = core.add_child<SlowDevice>("a");
+    HandlingDevice *b = core.add_child<HandlingDevice>("b");
+    b->add_link("in", "..a.out");
+    ASSERT_TRUE(core.set_conf("runtime_stats", true));
+    EXPECT_TRUE(core.runtime_stats().channels.empty());
+
+    ASSERT_TRUE(core.init());
+    ASSERT_TRUE(core.start());
+    Channel *out = a->get_channel("out");
+    EXPECT_TRUE(out->stats_enabled());
+    EXPECT_TRUE(b->stats_enabled());
+
+    for (int i = 1; i <= 5; ++i)
+        ASSERT_TRUE(out->write<int>(0, i));
+    EXPECT_TRUE(out->write<int>(0, 5));
+    EXPECT_FALSE(out->write<int>(1, 5));
+
+    CoreStats stats = core.runtime_stats();
+    auto channel_it = std::find_if(stats.channels.begin(), stats.channels.end(), [out](const ChannelStats & s) {
+        return s.path == out->full_name();
+    });
+    ASSERT_NE(channel_it, stats.channels.end());
+    EXPECT_EQ(channel_it->writes, 5u);
+    EXPECT_EQ(channel_it->bytes_written, 5 * sizeof(int));
+    EXPECT_EQ(channel_it->unchanged_writes, 1u);
+    EXPECT_EQ(channel_it->rejected_writes, 1u);
+    EXPECT_EQ(channel_it->notifications, 5u);
+    EXPECT_EQ(channel_it->lock_wait.samples, 7u);
+    EXPECT_GE(channel_it->notify.median, 1e6);
+    ASSERT_EQ(channel_it->observers.size(), 1u);
+    EXPECT_EQ(channel_it->observers[0].name, b->full_name());
+    EXPECT_EQ(channel_it->observers[0].handle.samples, 5u);
+
+    auto device_it = std::find_if(stats.devices.begin(), stats.devices.end(), [b](const DeviceStats & s) {
+        return s.path == b->full_name();
+    });
+    ASSERT_NE(device_it, stats.devices.end());
+    EXPECT_EQ(device_it->handled, 5u);
+    EXPECT_GE(device_it->handle.min, 1e6);
+    EXPECT_LE(device_it->handle.min, device_it->handle.p99);
+
+    core.clear_runtime_stats();
+    EXPECT_EQ(out->stats().writes, 0u);
+    // observers are kept with their durations cleared
+    ASSERT_EQ(out->stats().observers.size(), 1u);
+    EXPECT_EQ(out->stats().observers[0].handle.samples, 0u);
+    EXPECT_EQ(b->stats().handled, 0u);
+
+    ASSERT_TRUE(core.set_runtime_stats(false));
+    ASSERT_TRUE(out->write<int>(0, 6));
+    EXPECT_EQ(out->stats().writes, 0u);
+    EXPECT_TRUE(core.runtime_stats().channels.empty());
+    EXPECT_TRUE(core.stop());
+}
+
+} // namespace test
@@ -5,6 +5,7 @@
 #include <sihd/core/DevFilter.hpp>
 #include <sihd/sys/fs.hpp>
 #include <sihd/sys/platform.hpp>
+#include <sihd/util/Array.hpp>
 #include <sihd/util/Logger.hpp>
 #include <sihd/util/term.hpp>
 
@@ -175,6 +176,29 @@ TEST_F(TestDevFilter, test_devfilter_float)
     EXPECT_EQ(out_channel->read<int>(0), 0b101);
 }
 
+TEST_F(TestDevFilter, test_devfilter_float_trigger_double_channel)
+{
+    Core core;
+
+    DevFilter *dev_ptr = core.add_child<DevFilter>("filter");
+    ASSERT_TRUE(dev_ptr->set_conf_str("filter_equal", "in=..in_channel;out=..out_channel;trigger=0.1f;write=1"));
+
+    core.add_channel("in_channel", "double");
+    core.add_channel("out_channel", "int");
+
+    ASSERT_TRUE(core.init());
+    ASSERT_TRUE(core.start());
+
+    Channel *in_channel = core.get_channel("in_channel");
+    Channel *out_channel = core.get_channel("out_channel");
+
+    // compared with the float epsilon: 0.1f is not exactly 0.1
+    in_channel->write<double>(0, 0.2);
+    EXPECT_EQ(out_channel->read<int>(0), 0);
+    in_channel->write<double>(0, 0.1);
+    EXPECT_EQ(out_channel->read<int>(0), 1);
+}
+
 TEST_F(TestDevFilter, test_devfilter_byte)
 {
     Core core;
@@ -217,4 +241,122 @@ TEST_F(TestDevFilter, test_devfilter_byte)
     in_channel->write<int>(1, 4);
     EXPECT_EQ(out_channel->read<int>(1), 4);
 }
+
+TEST_F(TestDevFilter, test_devfilter_types)
+{
+    Core core;
+
+    DevFilter *dev_ptr = core.add_child<DevFilter>("filter");
+    // rules of different input channels are interleaved
+    ASSERT_TRUE(dev_ptr->set_conf_str("filter_inferior", "in=..short_channel;out=..out_channel;trigger=-5;write=0:1"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("filter_superior_equal",
+                                      "in=..double_channel;out=..out_channel;trigger=1:2.5;write=1:2"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("filter_equal", "in=..short_channel;out=..out_channel;trigger=1:-1;write=2:3"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("filter_byte_xor", "in=..ubyte_channel;out=..out_channel;trigger=0xff;write=3:"));
+
+    core.add_channel("short_channel", "short", 2);
+    core.add_channel("double_channel", "double", 2);
+    core.add_channel("ubyte_channel", "ubyte", 1);
+    core.add_channel("out_channel", "int", 4);
+
+    ASSERT_TRUE(core.init());
+    ASSERT_TRUE(core.start());
+
+    Channel *short_channel = core.get_channel("short_channel");
+    Channel *double_channel = core.get_channel("double_channel");
+    Channel *ubyte_channel = core.get_channel("ubyte_channel");
+    Channel *out_channel = core.get_channel("out_channel");
+
+    SIHD_LOG(debug, "Testing signed values");
+    short_channel->write<int16_t>(0, -5);
+    EXPECT_EQ(out_channel->read<int>(0), 0);
+    short_channel->write<int16_t>(0, -6);
+    EXPECT_EQ(out_channel->read<int>(0), 1);
+    short_channel->write<int16_t>(1, -1);
+    EXPECT_EQ(out_channel->read<int>(2), 3);
+
+    SIHD_LOG(debug, "Testing double values");
+    double_channel->write<double>(1, 2.4);
+    EXPECT_EQ(out_channel->read<int>(1), 0);
+    double_channel->write<double>(1, 2.5);
+    EXPECT_EQ(out_channel->read<int>(1), 2);
+
+    SIHD_LOG(debug, "Testing unsigned values");
+    ubyte_channel->write<uint8_t>(0, 0xff);
+    EXPECT_EQ(out_channel->read<int>(3), 0);
+    ubyte_channel->write<uint8_t>(0, 0xfe);
+    EXPECT_EQ(out_channel->read<int>(3), 0xfe);
+
+    EXPECT_TRUE(core.stop());
+}
+
+TEST_F(TestDevFilter, test_devfilter_array)
+{
+    Core core;
+
+    DevFilter *dev_ptr = core.add_child<DevFilter>("filter");
+    ASSERT_TRUE(dev_ptr->set_conf_str("filter_any", "in=..frame;out=..result;compare=superior:1.5;write=0"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("filter_all", "in=..frame;out=..result;compare=superior_equal:0.0;write=1"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("filter_count", "in=..frame;out=..result;compare=not_equal:0;write=2"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("filter_first", "in=..frame;out=..result;compare=equal:2.0;write=3"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("filter_max", "in=..frame;out=..result;slice=0:100;write=4"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("filter_mean", "in=..frame;out=..result;slice=:4;write=5"));
+    dev_ptr->set_array_filter(DevFilter::ArrayRule(DevFilter::Min).in("..frame").out("..result").slice(100).write(6));
+    // bad configurations
+    EXPECT_FALSE(dev_ptr->set_conf_str("filter_count", "in=..frame;out=..result;write=0"));
+    EXPECT_FALSE(dev_ptr->set_conf_str("filter_any", "in=..frame;out=..result;compare=above:1"));
+    EXPECT_FALSE(dev_ptr->set_conf_str("filter_min", "in=..frame;out=..result;slice=1"));
+
+    core.add_channel("frame", "float", 1001);
+    core.add_channel("result", "double", 7);
+
+    ASSERT_TRUE(core.init());
+    ASSERT_TRUE(core.start());
+
+    Channel *frame = core.get_channel("frame");
+    Channel *result = core.get_channel("result");
+
+    ArrFloat samples;
+    samples.resize(1001);
+    samples[10] = 1.0f;
+    samples[500] = 2.0f;
+    samples[999] = -3.0f;
+    ASSERT_TRUE(frame->write(samples));
+    EXPECT_EQ(result->read<double>(0), 1.0);
+    EXPECT_EQ(result->read<double>(1), 0.0);
+    EXPECT_EQ(result->read<double>(2), 3.0);
+    EXPECT_EQ(result->read<double>(3), 500.0);
+    EXPECT_EQ(result->read<double>(4), 1.0);
+    EXPECT_EQ(result->read<double>(5), 0.0);
+    EXPECT_EQ(result->read<double>(6), -3.0);
+
+    samples[999] = 0.0f;
+    samples[500] = 0.0f;
+    samples[2] = 1.0f;
+    ASSERT_TRUE(frame->write(samples));
+    EXPECT_EQ(result->read<double>(0), 0.0);
+    EXPECT_EQ(result->read<double>(1), 1.0);
+    EXPECT_EQ(result->read<double>(2), 2.0);
+    EXPECT_EQ(result->read<double>(3), -1.0);
+    EXPECT_EQ(result->read<double>(5), 0.25);
+    EXPECT_EQ(result->read<double>(6), 0.0);
+
+    EXPECT_TRUE(core.stop());
+}
+
+TEST_F(TestDevFilter, test_devfilter_array_verify)
+{
+    Core core;
+
+    DevFilter *dev_ptr = core.add_child<DevFilter>("filter");
+    // does not fit in a byte
+    ASSERT_TRUE(dev_ptr->set_conf_str("filter_any", "in=..frame;out=..result;compare=superior:300"));
+    core.add_channel("frame", "ubyte", 16);
+    core.add_channel("result", "int", 1);
+
+    ASSERT_TRUE(core.init());
+    EXPECT_FALSE(core.start());
+    core.stop();
+}
+
 } // namespace test
@@ -96,4 +96,75 @@ TEST_F(TestDevSampler, test_devsampler)
     ASSERT_TRUE(core.stop());
 }
 
+TEST_F(TestDevSampler, test_devsampler_aggregation)
+{
+    Core core;
+
+    DevSampler *dev_ptr = core.add_child<DevSampler>("sampler");
+    ASSERT_TRUE(dev_ptr->set_conf("frequency", 100.0));
+    ASSERT_TRUE(dev_ptr->set_conf_str("sample_mean", "..mean=..in"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("sample_min", "..min=..in"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("sample_max", "..max=..in"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("sample_sum", "..sum=..in"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("sample_count", "..count=..in"));
+    ASSERT_TRUE(dev_ptr->set_conf_str("sample", "..last=..in"));
+
+    core.add_channel("in", "float", 3);
+    core.add_channel("mean", "double", 3);
+    core.add_channel("min", "int", 3);
+    core.add_channel("max", "int", 3);
+    core.add_channel("sum", "double", 3);
+    core.add_channel("count", "uint", 1);
+    core.add_channel("last", "float", 3);
+
+    ASSERT_TRUE(core.init());
+    ASSERT_TRUE(core.start());
+
+    Channel *in = core.get_channel("in");
+    ChannelWaiter waiter(dev_ptr->get_channel("sample"));
+
+    ASSERT_TRUE(in->write(ArrFloat({1.5, -2, 10})));
+    ASSERT_TRUE(in->write(ArrFloat({2.5, 4, 20})));
+    ASSERT_TRUE(in->write(ArrFloat({5, 1, 30})));
+    EXPECT_TRUE(waiter.prev_wait_for(time::sec(1)));
+    EXPECT_EQ(core.get_channel("mean")->read<double>(0), 3.0);
+    EXPECT_EQ(core.get_channel("mean")->read<double>(1), 1.0);
+    EXPECT_EQ(core.get_channel("mean")->read<double>(2), 20.0);
+    EXPECT_EQ(core.get_channel("min")->array()->str(','), "1,-2,10");
+    EXPECT_EQ(core.get_channel("max")->array()->str(','), "5,4,30");
+    EXPECT_EQ(core.get_channel("sum")->read<double>(0), 9.0);
+    EXPECT_EQ(core.get_channel("sum")->read<double>(2), 60.0);
+    EXPECT_EQ(core.get_channel("count")->read<uint32_t>(0), 3u);
+    EXPECT_EQ(core.get_channel("last")->read<float>(0), 5.0f);
+    EXPECT_EQ(core.get_channel("last")->read<float>(2), 30.0f);
+
+    // the window restarts at each tick
+    ASSERT_TRUE(in->write(ArrFloat({-1, 0, 1})));
+    EXPECT_TRUE(waiter.prev_wait_for(time::sec(1)));
+    EXPECT_EQ(core.get_channel("mean")->read<double>(0), -1.0);
+    EXPECT_EQ(core.get_channel("min")->array()->str(','), "-1,0,1");
+    EXPECT_EQ(core.get_channel("max")->array()->str(','), "-1,0,1");
+    EXPECT_EQ(core.get_channel("sum")->read<double>(2), 1.0);
+    EXPECT_EQ(core.get_channel("count")->read<uint32_t>(0), 1u);
+
+    ASSERT_TRUE(core.stop());
+}
+
+TEST_F(TestDevSampler, test_devsampler_aggregation_verify)
+{
+    Core core;
+
+    DevSampler *dev_ptr = core.add_child<DevSampler>("sampler");
+    ASSERT_TRUE(dev_ptr->set_conf("frequency", 100.0));
+    ASSERT_TRUE(dev_ptr->set_conf_str("sample_mean", "..mean=..in"));
+    EXPECT_FALSE(dev_ptr->set_conf_str("sample_min", "..min"));
+
+    core.add_channel("in", "float", 3);
+    core.add_channel("mean", "double", 2);
+
+    ASSERT_TRUE(core.init());
+    EXPECT_FALSE(core.start());
+    core.stop();
+}
+
 } // namespace test
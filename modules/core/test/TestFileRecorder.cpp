@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+
+#include <sihd/core/Core.hpp>
+#include <sihd/core/DevRecorder.hpp>
+#include <sihd/core/FileRecordReader.hpp>
+#include <sihd/core/FileRecorder.hpp>
+#include <sihd/sys/MappedFile.hpp>
+#include <sihd/sys/TmpDir.hpp>
+#include <sihd/sys/fs.hpp>
+#include <sihd/util/Array.hpp>
+#include <sihd/util/Logger.hpp>
+
+namespace test
+{
+SIHD_LOGGER;
+using namespace sihd::core;
+using namespace sihd::util;
+class TestFileRecorder: public ::testing::Test
+{
+    protected:
+        TestFileRecorder() { sihd::util::LoggerManager::stream(); }
+
+        virtual ~TestFileRecorder() { sihd::util::LoggerManager::clear_loggers(); }
+
+        virtual void SetUp()
+        {
+            if constexpr (!sihd::sys::MappedFile::supported)
+            {
+                GTEST_SKIP() << "MappedFile not supported on this platform";
+            }
+        }
+
+        virtual void TearDown() {}
+
+        // records 'count' int and double values alternately, one millisecond apart
+        static void record_values(FileRecorder & recorder, int count)
+        {
+            ArrInt arr_int = {0, 0, 0, 0};
+            ArrDouble arr_double = {0.0};
+            for (int i = 0; i < count; ++i)
+            {
+                if (i % 2 == 0)
+                {
+                    arr_int[0] = i;
+                    arr_int[3] = -i;
+                    recorder.add_record("int", time::milli(i), &arr_int);
+                }
+                else
+                {
+                    arr_double[0] = i / 2.0;
+                    recorder.add_record("double", time::milli(i), &arr_double);
+                }
+            }
+        }
+
+        // checks the records read from the timestamp of the first one
+        static void check_records(FileRecordReader & reader, int from, int count)
+        {
+            PlayableRecord record;
+            for (int i = from; i < count; ++i)
+            {
+                ASSERT_TRUE(reader.provide(&record)) << i;
+                EXPECT_EQ(record.timestamp, time::milli(i));
+                if (i % 2 == 0)
+                {
+                    EXPECT_EQ(record.name, "int");
+                    const ArrInt *arr = dynamic_cast<const ArrInt *>(record.value.get());
+                    ASSERT_NE(arr, nullptr);
+                    ASSERT_EQ(arr->size(), 4u);
+                    EXPECT_EQ(arr->at(0), i);
+                    EXPECT_EQ(arr->at(3), -i);
+                }
+                else
+                {
+                    EXPECT_EQ(record.name, "double");
+                    const ArrDouble *arr = dynamic_cast<const ArrDouble *>(record.value.get());
+                    ASSERT_NE(arr, nullptr);
+                    ASSERT_EQ(arr->size(), 1u);
+                    EXPECT_EQ(arr->at(0), i / 2.0);
+                }
+            }
+            EXPECT_FALSE(reader.provide(&record));
+        }
+};
+
+TEST_F(TestFileRecorder, test_filerecorder_segments)
+{
+    sihd::sys::TmpDir tmp_dir;
+    const std::string path = sihd::sys::fs::combine(tmp_dir.path(), "records");
+
+    FileRecorder recorder("recorder");
+    EXPECT_TRUE(recorder.set_conf_str("path", path));
+    EXPECT_TRUE(recorder.set_segment_size(4096));
+    EXPECT_TRUE(recorder.set_batch_size(512));
+    EXPECT_TRUE(recorder.set_index_interval(10));
+    ASSERT_TRUE(recorder.start());
+    record_values(recorder, 400);
+    EXPECT_TRUE(recorder.stop());
+    EXPECT_EQ(recorder.records(), 400u);
+    EXPECT_GT(recorder.segments(), 1u);
+
+    FileRecordReader reader("reader");
+    EXPECT_TRUE(reader.set_conf_str("path", path));
+    EXPECT_TRUE(reader.set_stop_providing_when_empty(true));
+    ASSERT_TRUE(reader.start());
+    EXPECT_EQ(reader.segments(), recorder.segments());
+    EXPECT_TRUE(reader.providing());
+    check_records(reader, 0, 400);
+    EXPECT_FALSE(reader.providing());
+
+    // through the index of a middle segment
+    ASSERT_TRUE(reader.seek(time::milli(251)));
+    EXPECT_TRUE(reader.providing());
+    check_records(reader, 251, 400);
+
+    ASSERT_TRUE(reader.seek(0));
+    check_records(reader, 0, 400);
+    EXPECT_TRUE(reader.stop());
+}
+
+TEST_F(TestFileRecorder, test_filerecorder_zero_copy)
+{
+    sihd::sys::TmpDir tmp_dir;
+
+    FileRecorder recorder("recorder");
+    EXPECT_TRUE(recorder.set_path(tmp_dir.path()));
+    ASSERT_TRUE(recorder.start());
+    record_values(recorder, 2);
+
+    // segment still being written: read up to the last flushed record
+    FileRecordReader reader("reader");
+    EXPECT_TRUE(reader.set_path(tmp_dir.path()));
+    ASSERT_TRUE(reader.open());
+    PlayableRecord record;
+    EXPECT_FALSE(reader.provide(&record));
+
+    EXPECT_TRUE(recorder.flush());
+    ASSERT_TRUE(reader.open());
+    ASSERT_TRUE(reader.provide(&record));
+    EXPECT_EQ(record.name, "int");
+    ASSERT_TRUE(reader.provide(&record));
+    EXPECT_EQ(record.name, "double");
+    EXPECT_FALSE(reader.provide(&record));
+
+    // the value points into the mapping which outlives the reader
+    reader.close();
+    EXPECT_EQ(record.value->data_type(), TYPE_DOUBLE);
+    EXPECT_EQ(dynamic_cast<const ArrDouble *>(record.value.get())->at(0), 0.5);
+    EXPECT_TRUE(recorder.stop());
+
+    // another recording continues in a new segment
+    ASSERT_TRUE(recorder.start());
+    record_values(recorder, 4);
+    EXPECT_TRUE(recorder.stop());
+    ASSERT_TRUE(reader.open());
+    EXPECT_EQ(reader.segments(), 2u);
+    for (int i = 0; i < 6; ++i)
+        EXPECT_TRUE(reader.provide(&record));
+    EXPECT_FALSE(reader.provide(&record));
+}
+
+TEST_F(TestFileRecorder, test_filerecorder_dev_recorder)
+{
+    sihd::sys::TmpDir tmp_dir;
+
+    Core core;
+    Channel *int_channel = core.add_channel("int_channel", TYPE_INT, 2);
+    Channel *char_channel = core.add_channel("char_channel", TYPE_CHAR, 5);
+
+    FileRecorder recorder("recorder", &core);
+    recorder.set_parent_ownership(false);
+    EXPECT_TRUE(recorder.set_path(tmp_dir.path()));
+
+    DevRecorder dev_recorder("dev_recorder", &core);
+    dev_recorder.set_parent_ownership(false);
+    EXPECT_TRUE(dev_recorder.set_conf_str("handler", "..recorder"));
+    EXPECT_TRUE(dev_recorder.set_conf_str("record", "int=..int_channel"));
+    EXPECT_TRUE(dev_recorder.set_conf_str("record", "char=..char_channel"));
+
+    ASSERT_TRUE(core.init());
+    ASSERT_TRUE(core.start());
+    int_channel->write(0, 10);
+    char_channel->write(ArrChar("hello"));
+    int_channel->write(1, 20);
+    ASSERT_TRUE(core.stop());
+
+    FileRecordReader reader("reader");
+    EXPECT_TRUE(reader.set_path(tmp_dir.path()));
+    ASSERT_TRUE(reader.open());
+
+    PlayableRecord record;
+    ASSERT_TRUE(reader.provide(&record));
+    EXPECT_EQ(record.name, "int");
+    EXPECT_EQ(record.value->str(','), "10,0");
+    ASSERT_TRUE(reader.provide(&record));
+    EXPECT_EQ(record.name, "char");
+    EXPECT_EQ(record.value->cpp_str_view(), "hello");
+    ASSERT_TRUE(reader.provide(&record));
+    EXPECT_EQ(record.name, "int");
+    EXPECT_EQ(record.value->str(','), "10,20");
+    EXPECT_EQ(record.timestamp, int_channel->timestamp());
+    EXPECT_FALSE(reader.provide(&record));
+}
+
+} // namespace test
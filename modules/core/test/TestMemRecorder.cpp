@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <sihd/core/MemRecorder.hpp>
+#include <sihd/util/Array.hpp>
+#include <sihd/util/Logger.hpp>
+
+namespace test
+{
+SIHD_LOGGER;
+using namespace sihd::core;
+using namespace sihd::util;
+class TestMemRecorder: public ::testing::Test
+{
+    protected:
+        TestMemRecorder() { sihd::util::LoggerManager::stream(); }
+
+        virtual ~TestMemRecorder() { sihd::util::LoggerManager::clear_loggers(); }
+
+        virtual void SetUp() {}
+
+        virtual void TearDown() {}
+};
+
+TEST_F(TestMemRecorder, test_memrecorder_merge)
+{
+    MemRecorder recorder("recorder");
+    EXPECT_TRUE(recorder.set_stop_providing_when_empty(true));
+    EXPECT_TRUE(recorder.empty());
+
+    ArrInt arr_int = {1, 2};
+    ArrDouble arr_double = {0.5};
+    recorder.add_record("int", 10, &arr_int);
+    recorder.add_record("double", 5, &arr_double);
+    arr_int[0] = 3;
+    recorder.add_record("int", 30, &arr_int);
+    // same timestamp: provided after the channel recorded first
+    arr_double[0] = 1.5;
+    recorder.add_record("double", 30, &arr_double);
+    // out of order
+    arr_int[0] = 2;
+    recorder.add_record("int", 20, &arr_int);
+    EXPECT_EQ(recorder.samples(), 5u);
+    EXPECT_FALSE(recorder.empty());
+
+    const MapListRecordedValues map = recorder.make_recorded_values();
+    ASSERT_EQ(map.at("int").size(), 3u);
+    EXPECT_EQ(map.at("int").back().first, 30);
+    EXPECT_EQ(map.at("int").back().second->str(','), "3,2");
+    EXPECT_EQ(recorder.sorted_recorded_values().size(), 5u);
+
+    ASSERT_TRUE(recorder.start());
+    EXPECT_TRUE(recorder.providing());
+    PlayableRecord record;
+    const std::vector<std::tuple<std::string, time_t, std::string>> expected = {
+        {"double", 5, "0.500000"},
+        {"int", 10, "1,2"},
+        {"int", 20, "2,2"},
+        {"int", 30, "3,2"},
+        {"double", 30, "1.500000"},
+    };
+    for (const auto & [name, timestamp, value] : expected)
+    {
+        ASSERT_TRUE(recorder.provide(&record));
+        EXPECT_EQ(record.name, name);
+        EXPECT_EQ(record.timestamp, timestamp);
+        EXPECT_EQ(record.value->str(','), value);
+    }
+    EXPECT_FALSE(recorder.provide(&record));
+    EXPECT_FALSE(recorder.providing());
+    EXPECT_TRUE(recorder.empty());
+    EXPECT_TRUE(recorder.stop());
+}
+
+TEST_F(TestMemRecorder, test_memrecorder_layout)
+{
+    MemRecorder recorder("recorder");
+
+    // a channel changing of type or size is stored into another column
+    ArrInt arr_int = {1, 2};
+    ArrChar arr_char("hello");
+    recorder.add_record("channel", 1, &arr_int);
+    recorder.add_record("channel", 2, &arr_char);
+    arr_char.from("hi");
+    recorder.add_record("channel", 3, &arr_char);
+    recorder.add_record("channel", 4, &arr_int);
+
+    PlayableRecord record;
+    ASSERT_TRUE(recorder.provide(&record));
+    EXPECT_EQ(record.value->data_type(), TYPE_INT);
+    ASSERT_TRUE(recorder.provide(&record));
+    EXPECT_EQ(record.value->cpp_str_view(), "hello");
+    ASSERT_TRUE(recorder.provide(&record));
+    EXPECT_EQ(record.value->cpp_str_view(), "hi");
+    ASSERT_TRUE(recorder.provide(&record));
+    EXPECT_EQ(record.name, "channel");
+    EXPECT_EQ(record.timestamp, 4);
+    EXPECT_EQ(record.value->str(','), "1,2");
+    EXPECT_FALSE(recorder.provide(&record));
+}
+
+TEST_F(TestMemRecorder, test_memrecorder_memory)
+{
+    MemRecorder recorder("recorder");
+
+    ArrInt arr_int = {0, 0, 0, 0};
+    for (int i = 0; i < 1000; ++i)
+    {
+        arr_int[0] = i;
+        recorder.add_record("int", i, &arr_int);
+    }
+    const size_t usage = recorder.memory_usage();
+    // timestamp and payload of each sample, without allocation per sample
+    EXPECT_GE(usage, 1000 * (sizeof(Timestamp) + arr_int.byte_size()));
+    EXPECT_LT(usage, 2 * 1000 * (sizeof(Timestamp) + arr_int.byte_size()) + 1024);
+    SIHD_LOG(debug, "{} bytes for {} samples", usage, recorder.samples());
+
+    // providing every sample keeps the memory for the next recording
+    PlayableRecord record;
+    while (recorder.provide(&record))
+        ;
+    EXPECT_EQ(record.value->str(','), "999,0,0,0");
+    EXPECT_EQ(recorder.memory_usage(), usage);
+    recorder.add_record("int", 0, &arr_int);
+    EXPECT_EQ(recorder.memory_usage(), usage);
+
+    recorder.clear();
+    EXPECT_TRUE(recorder.empty());
+    EXPECT_EQ(recorder.memory_usage(), 0u);
+}
+
+} // namespace test
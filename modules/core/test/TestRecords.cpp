@@ -10,6 +10,7 @@
 #include <sihd/core/MemRecorder.hpp>
 #include <sihd/json/Json.hpp>
 #include <sihd/util/Array.hpp>
+#include <sihd/util/Clocks.hpp>
 #include <sihd/util/Logger.hpp>
 #include <sihd/util/build.hpp>
 
@@ -96,6 +97,114 @@ TEST_F(TestRecords, test_records_dev_player)
     EXPECT_EQ(bool_channel->read<bool>(3), true);
 }
 
+TEST_F(TestRecords, test_records_dev_player_speed)
+{
+    Core core;
+    Channel *int_channel = core.add_channel("int_channel", sihd::util::TYPE_INT, 1);
+    Channel *double_channel = core.add_channel("double_channel", sihd::util::TYPE_DOUBLE, 1);
+
+    MemRecorder mem_recorder("mem_recorder", &core);
+    mem_recorder.set_parent_ownership(false);
+    EXPECT_TRUE(mem_recorder.set_stop_providing_when_empty(true));
+
+    DevPlayer dev_player("dev_player", &core);
+    dev_player.set_parent_ownership(false);
+    EXPECT_TRUE(dev_player.set_conf_str("provider", "..mem_recorder"));
+    EXPECT_TRUE(dev_player.add_alias("int=..int_channel"));
+    EXPECT_TRUE(dev_player.add_alias("double=..double_channel"));
+    EXPECT_TRUE(dev_player.set_queue_size(16));
+    EXPECT_FALSE(dev_player.set_speed(-1));
+
+    // 100 seconds of records played as fast as possible
+    sihd::util::ArrInt arr_int = {0};
+    sihd::util::ArrDouble arr_double = {0.0};
+    for (int i = 0; i < 1000; ++i)
+    {
+        arr_int[0] = i;
+        arr_double[0] = i;
+        mem_recorder.add_record("int", sihd::util::time::milli(i * 100), &arr_int);
+        mem_recorder.add_record("double", sihd::util::time::milli(i * 100), &arr_double);
+    }
+    EXPECT_TRUE(dev_player.set_speed(0));
+
+    ASSERT_TRUE(core.init());
+    Channel *end = dev_player.get_channel("end");
+    ASSERT_NE(end, nullptr);
+    ChannelWaiter waiter(end);
+    ASSERT_TRUE(core.start());
+    dev_player.get_channel("play")->write(0, true);
+    EXPECT_TRUE(waiter.wait_for_nb(sihd::util::time::sec(5), 1));
+
+    DevPlayer::Stats stats = dev_player.stats();
+    EXPECT_EQ(stats.played, 2000u);
+    EXPECT_EQ(stats.late, 0u);
+    EXPECT_EQ(int_channel->read<int>(0), 999);
+    EXPECT_EQ(double_channel->read<double>(0), 999.0);
+    EXPECT_TRUE(core.stop());
+
+    // half speed: 20 milliseconds of records take at least 40 milliseconds
+    arr_int[0] = 1;
+    mem_recorder.add_record("int", sihd::util::time::milli(0), &arr_int);
+    arr_int[0] = 2;
+    mem_recorder.add_record("int", sihd::util::time::milli(10), &arr_int);
+    arr_int[0] = 3;
+    mem_recorder.add_record("int", sihd::util::time::milli(20), &arr_int);
+    EXPECT_TRUE(dev_player.set_speed(0.5));
+    EXPECT_DOUBLE_EQ(dev_player.speed(), 0.5);
+
+    // end is written false at start then true
+    ChannelWaiter restart_waiter(end);
+    sihd::util::Timestamp begin = sihd::util::Clock::default_clock.now();
+    ASSERT_TRUE(core.start());
+    EXPECT_TRUE(restart_waiter.wait_for_nb(sihd::util::time::sec(5), 2));
+    EXPECT_TRUE(end->read<bool>(0));
+    EXPECT_GE(sihd::util::Clock::default_clock.now() - begin, sihd::util::time::milli(40));
+    EXPECT_TRUE(core.stop());
+
+    stats = dev_player.stats();
+    EXPECT_EQ(stats.played, 3u);
+    EXPECT_EQ(int_channel->read<int>(0), 3);
+}
+
+TEST_F(TestRecords, test_records_dev_player_seek)
+{
+    Core core;
+    Channel *int_channel = core.add_channel("int_channel", sihd::util::TYPE_INT, 1);
+
+    MemRecorder mem_recorder("mem_recorder", &core);
+    mem_recorder.set_parent_ownership(false);
+    EXPECT_TRUE(mem_recorder.set_stop_providing_when_empty(true));
+
+    DevPlayer dev_player("dev_player", &core);
+    dev_player.set_parent_ownership(false);
+    EXPECT_TRUE(dev_player.set_conf_str("provider", "..mem_recorder"));
+    EXPECT_TRUE(dev_player.add_alias("int=..int_channel"));
+    EXPECT_TRUE(dev_player.set_speed(0));
+
+    sihd::util::ArrInt arr_int = {0};
+    for (int i = 0; i < 10; ++i)
+    {
+        arr_int[0] = i;
+        mem_recorder.add_record("int", sihd::util::time::sec(i), &arr_int);
+    }
+
+    ASSERT_TRUE(core.init());
+    Channel *end = dev_player.get_channel("end");
+    ChannelWaiter waiter(end);
+    ASSERT_TRUE(core.start());
+
+    // seeking while paused: the first record played is at 7 seconds
+    dev_player.seek(sihd::util::time::sec(7));
+    dev_player.get_channel("play")->write(0, true);
+    EXPECT_TRUE(waiter.wait_for_nb(sihd::util::time::sec(5), 1));
+    EXPECT_TRUE(core.stop());
+
+    const DevPlayer::Stats stats = dev_player.stats();
+    EXPECT_EQ(stats.played, 3u);
+    EXPECT_EQ(stats.skipped, 7u);
+    EXPECT_EQ(int_channel->read<int>(0), 9);
+}
+
 TEST_F(TestRecords, test_records_dev_recorder)
 {
 #if defined(__SIHD_EMSCRIPTEN__)
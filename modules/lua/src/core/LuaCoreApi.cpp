@@ -27,6 +27,56 @@ SIHD_LOGGER;
 using namespace sihd::util;
 using namespace sihd::core;
 
+namespace
+{
+
+luabridge::LuaRef latency_to_lua(lua_State *state, const LatencyStats & latency)
+{
+    luabridge::LuaRef table = luabridge::newTable(state);
+    table["samples"] = latency.samples;
+    table["min"] = latency.min;
+    table["average"] = latency.average;
+    table["max"] = latency.max;
+    table["median"] = latency.median;
+    table["p95"] = latency.p95;
+    table["p99"] = latency.p99;
+    return table;
+}
+
+luabridge::LuaRef channel_stats_to_lua(lua_State *state, const ChannelStats & stats)
+{
+    luabridge::LuaRef table = luabridge::newTable(state);
+    table["path"] = stats.path;
+    table["writes"] = stats.writes;
+    table["bytes_written"] = stats.bytes_written;
+    table["unchanged_writes"] = stats.unchanged_writes;
+    table["rejected_writes"] = stats.rejected_writes;
+    table["notifications"] = stats.notifications;
+    table["lock_wait"] = latency_to_lua(state, stats.lock_wait);
+    table["notify"] = latency_to_lua(state, stats.notify);
+    luabridge::LuaRef observers = luabridge::newTable(state);
+    for (size_t i = 0; i < stats.observers.size(); ++i)
+    {
+        luabridge::LuaRef observer = luabridge::newTable(state);
+        observer["name"] = stats.observers[i].name;
+        observer["handle"] = latency_to_lua(state, stats.observers[i].handle);
+        observers[static_cast<int>(i + 1)] = observer;
+    }
+    table["observers"] = observers;
+    return table;
+}
+
+luabridge::LuaRef device_stats_to_lua(lua_State *state, const DeviceStats & stats)
+{
+    luabridge::LuaRef table = luabridge::newTable(state);
+    table["path"] = stats.path;
+    table["handled"] = stats.handled;
+    table["handle"] = latency_to_lua(state, stats.handle);
+    return table;
+}
+
+} // namespace
+
 std::mutex LuaCoreApi::_handler_map_mutex;
 std::map<lua_State *, std::unique_ptr<LuaCoreApi::LuaChannelHandler>> LuaCoreApi::_handler_map;
 
@@ -84,11 +134,30 @@ void LuaCoreApi::load(Vm & vm)
         .endClass()
         .deriveClass<Core, Device>("Core")
         .addConstructorFrom<SmartNodePtr<Core>, void(const std::string &, Node *)>()
+        .addFunction("set_runtime_stats", &Core::set_runtime_stats)
+        .addFunction("clear_runtime_stats", &Core::clear_runtime_stats)
+        .addFunction("runtime_stats",
+                     +[](Core *self, lua_State *state) {
+                         const CoreStats stats = self->runtime_stats();
+                         luabridge::LuaRef table = luabridge::newTable(state);
+                         luabridge::LuaRef channels = luabridge::newTable(state);
+                         for (size_t i = 0; i < stats.channels.size(); ++i)
+                             channels[static_cast<int>(i + 1)] = channel_stats_to_lua(state, stats.channels[i]);
+                         luabridge::LuaRef devices = luabridge::newTable(state);
+                         for (size_t i = 0; i < stats.devices.size(); ++i)
+                             devices[static_cast<int>(i + 1)] = device_stats_to_lua(state, stats.devices[i]);
+                         table["channels"] = channels;
+                         table["devices"] = devices;
+                         return table;
+                     })
         .endClass()
         .deriveClass<Channel, sihd::util::Named>("Channel")
         .addConstructorFrom<SmartNodePtr<Channel>,
                             void(const std::string &, const std::string &, size_t, Node *)>()
         .addFunction("set_write_on_change", &Channel::set_write_on_change)
+        .addFunction("set_stats", &Channel::set_stats)
+        .addFunction("stats",
+                     +[](const Channel *self, lua_State *state) { return channel_stats_to_lua(state, self->stats()); })
         .addFunction("notify", &Channel::notify)
         .addFunction("timestamp", &Channel::timestamp)
         .addFunction("size", &Channel::size)
@@ -96,6 +96,10 @@ void LuaNetApi::load_base(Vm & vm)
         .addFunction("set_port", &DeviceUdpReceiver::set_port)
         .addFunction("set_buffer_capacity", &DeviceUdpReceiver::set_buffer_capacity)
         .addFunction("set_poll_timeout", &DeviceUdpReceiver::set_poll_timeout)
+        .addFunction("set_batch_size", &DeviceUdpReceiver::set_batch_size)
+        .addFunction("set_gro", &DeviceUdpReceiver::set_gro)
+        .addFunction("set_kernel_timestamp", &DeviceUdpReceiver::set_kernel_timestamp)
+        .addFunction("set_busy_poll", &DeviceUdpReceiver::set_busy_poll)
         .endClass()
         .endNamespace()
         .endNamespace();
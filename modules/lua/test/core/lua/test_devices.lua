@@ -15,3 +15,18 @@ check_device(sihd.core.DevRecorder("recorder", core))
 local msg = sihd.core.DevMessage("message", core)
 check_device(msg)
 assert(msg:set_trigger_mode(true))
+
+-- runtime stats
+local stats_core = sihd.core.Core("stats_core", nil)
+local channel = stats_core:add_channel("value", "int", 1)
+assert(stats_core:set_runtime_stats(true))
+assert(channel:write(0, 42))
+local stats = stats_core:runtime_stats()
+assert(#stats.channels == 1)
+assert(stats.channels[1].writes == 1)
+assert(stats.channels[1].bytes_written == 4)
+assert(stats.channels[1].lock_wait.samples == 1)
+assert(#stats.devices == 1)
+assert(channel:stats().notifications == 1)
+stats_core:clear_runtime_stats()
+assert(channel:stats().writes == 0)
@@ -0,0 +1,148 @@
+#include <string>
+
+#include <fmt/format.h>
+
+#include <sihd/net/DatagramBatch.hpp>
+#include <sihd/net/UdpReceiver.hpp>
+#include <sihd/net/UdpSender.hpp>
+#include <sihd/util/Array.hpp>
+#include <sihd/util/Stopwatch.hpp>
+#include <sihd/util/time.hpp>
+
+#include <CLI/CLI.hpp>
+
+using namespace sihd::util;
+using namespace sihd::net;
+
+struct BenchResult
+{
+        size_t datagrams;
+        // per datagram sent and received
+        double datagram_ns;
+        double send_ns;
+        double receive_ns;
+};
+
+struct Sockets
+{
+        UdpSender sender {"sender"};
+        UdpReceiver receiver {"receiver"};
+
+        bool open(const IpAddr & addr, bool gro)
+        {
+            if (!receiver.open_and_bind(addr) || !sender.open_and_connect(addr))
+                return false;
+            // a whole round waits in the socket
+            receiver.socket().set_rcvbuf(16 * 1024 * 1024);
+            receiver.socket().set_blocking(false);
+            return !gro || receiver.socket().set_udp_gro(true);
+        }
+};
+
+BenchResult bench_syscalls(const IpAddr & addr, size_t batch_size, size_t datagram_size, size_t rounds)
+{
+    Sockets sockets;
+    if (!sockets.open(addr, false))
+        return {};
+    std::string payload(datagram_size, 'x');
+    ArrByte buffer(datagram_size);
+
+    size_t received = 0;
+    Stopwatch sw;
+    Duration sending = 0;
+    Duration receiving = 0;
+    for (size_t i = 0; i < rounds; ++i)
+    {
+        sw.reset();
+        for (size_t j = 0; j < batch_size; ++j)
+            sockets.sender.send(payload);
+        sending += sw.time();
+        sw.reset();
+        while (sockets.receiver.receive(buffer) > 0)
+            ++received;
+        receiving += sw.time();
+    }
+    return {
+        .datagrams = received,
+        .datagram_ns = (double)(sending + receiving).nanoseconds() / received,
+        .send_ns = (double)sending.nanoseconds() / received,
+        .receive_ns = (double)receiving.nanoseconds() / received,
+    };
+}
+
+BenchResult bench_batch(const IpAddr & addr, size_t batch_size, size_t datagram_size, size_t rounds, bool offload)
+{
+    Sockets sockets;
+    if (!sockets.open(addr, offload))
+        return {};
+    std::string payload(datagram_size, 'x');
+    DatagramBatch to_send(batch_size, datagram_size);
+    for (size_t j = 0; j < batch_size; ++j)
+        to_send.push(payload);
+    DatagramBatch batch(batch_size, offload ? DatagramBatch::max_datagram_size : datagram_size);
+
+    size_t received = 0;
+    Stopwatch sw;
+    Duration sending = 0;
+    Duration receiving = 0;
+    for (size_t i = 0; i < rounds; ++i)
+    {
+        sw.reset();
+        sockets.sender.send_batch(to_send, offload);
+        sending += sw.time();
+        sw.reset();
+        while (sockets.receiver.receive_batch(batch) > 0)
+            received += batch.size();
+        receiving += sw.time();
+    }
+    return {
+        .datagrams = received,
+        .datagram_ns = (double)(sending + receiving).nanoseconds() / received,
+        .send_ns = (double)sending.nanoseconds() / received,
+        .receive_ns = (double)receiving.nanoseconds() / received,
+    };
+}
+
+void print_row(const char *label, const BenchResult & r)
+{
+    fmt::print("{:<16s} {:>10d} {:>14.1f} {:>12.1f} {:>12.1f}\n",
+               label,
+               r.datagrams,
+               r.datagram_ns,
+               r.send_ns,
+               r.receive_ns);
+}
+
+int main(int argc, char **argv)
+{
+    int port = 4250;
+    size_t batch_size = 64;
+    size_t datagram_size = 512;
+    size_t rounds = 5000;
+
+    CLI::App app {"UDP datagrams sent and received one by one or in batches over loopback"};
+    app.add_option("-p,--port", port, "Loopback port")->default_val("4250");
+    app.add_option("-b,--batch", batch_size, "Datagrams per round")->default_val("64");
+    app.add_option("-s,--size", datagram_size, "Bytes per datagram")->default_val("512");
+    app.add_option("-r,--rounds", rounds, "Rounds of sending and receiving")->default_val("5000");
+
+    CLI11_PARSE(app, argc, argv);
+
+    const IpAddr addr("127.0.0.1", port);
+
+    fmt::print("{} datagrams of {} bytes per round, {} rounds\n\n", batch_size, datagram_size, rounds);
+
+    fmt::print("{:<16s} {:>10s} {:>14s} {:>12s} {:>12s}\n",
+               "Mode",
+               "Received",
+               "Datagram (ns)",
+               "Send (ns)",
+               "Receive (ns)");
+    fmt::print("{:-<16s}-{:-<10s}-{:-<14s}-{:-<12s}-{:-<12s}\n", "", "", "", "", "");
+
+    print_row("sendto/recvfrom", bench_syscalls(addr, batch_size, datagram_size, rounds));
+    print_row("batch", bench_batch(addr, batch_size, datagram_size, rounds, false));
+    print_row("batch (gso/gro)", bench_batch(addr, batch_size, datagram_size, rounds, true));
+
+    return 0;
+}
@@ -2,6 +2,7 @@
 #define __SIHD_NET_HPP__
 
 #include <sihd/net/BasicServerHandler.hpp>
+#include <sihd/net/DatagramBatch.hpp>
 #include <sihd/net/DeviceTcpClient.hpp>
 #include <sihd/net/DeviceTcpServer.hpp>
 #include <sihd/net/DeviceUdpReceiver.hpp>
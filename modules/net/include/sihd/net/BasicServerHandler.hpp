@@ -1,6 +1,8 @@
 #ifndef __SIHD_NET_BASICSERVERHANDLER_HPP__
 #define __SIHD_NET_BASICSERVERHANDLER_HPP__
 
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 
@@ -22,18 +24,61 @@ class BasicServerHandler: public INetServerHandler,
                           public sihd::util::Observable<BasicServerHandler>
 {
     public:
+        // data queued for a client - caller owned data is released once sent or dropped
+        class WriteBuffer
+        {
+            public:
+                WriteBuffer(sihd::util::ArrByte && data);
+                WriteBuffer(const void *data, size_t size, std::function<void()> release);
+                WriteBuffer(WriteBuffer && other) noexcept;
+                WriteBuffer & operator=(WriteBuffer && other) noexcept;
+                ~WriteBuffer();
+
+                WriteBuffer(const WriteBuffer &) = delete;
+                WriteBuffer & operator=(const WriteBuffer &) = delete;
+
+                // data not sent yet
+                const uint8_t *data() const;
+                size_t remaining() const { return _size - _sent; }
+                void consume(size_t size) { _sent += size; }
+
+            private:
+                void _release();
+
+                sihd::util::ArrByte _owned;
+                const uint8_t *_data;
+                size_t _size;
+                size_t _sent;
+                std::function<void()> _release_fun;
+        };
+
         class Client
         {
             public:
-                Client(int sock): socket(sock), time_connected(0), time_total(0), error(false), disconnected(false) {}
+                Client(int sock):
+                    socket(sock),
+                    write_queue_bytes(0),
+                    write_congested(false),
+                    time_connected(0),
+                    time_total(0),
+                    error(false),
+                    disconnected(false)
+                {
+                }
                 ~Client() = default;
 
                 int fd() { return socket.socket(); }
+                // bytes queued and not sent yet
+                size_t pending_write_bytes() const;
 
                 TlsSocket socket;
                 mutable std::mutex mutex;
                 sihd::util::ArrByte read_array;
-                sihd::util::ArrByte write_array;
+                // sent in order as the socket becomes writable
+                std::deque<WriteBuffer> write_queue;
+                size_t write_queue_bytes;
+                // above the high watermark until drained to the low watermark
+                bool write_congested;
                 IpAddr addr;
 
                 sihd::util::Timestamp time_connected;
@@ -51,7 +96,21 @@ class BasicServerHandler: public INetServerHandler,
 
         bool set_max_clients(size_t max);
 
+        /**
+         * Clients queuing more bytes than the high watermark are congested until their queue drains down to the low
+         * watermark - the callbacks are called from the thread sending or from the server thread.
+         * Sending to a congested client still queues the data: callbacks let the caller slow down.
+         */
+        bool set_write_high_watermark(size_t bytes);
+        bool set_write_low_watermark(size_t bytes);
+        void set_high_watermark_callback(std::function<void(const ClientPtr &)> callback);
+        void set_low_watermark_callback(std::function<void(const ClientPtr &)> callback);
+
+        // queues a copy of arr
         bool send_to_client(const ClientPtr & client, const sihd::util::IArray & arr);
+        // queues data without copying it: release is called once it is sent or dropped, even on failure
+        bool send_to_client(const ClientPtr & client, const void *data, size_t size, std::function<void()> release);
+        // drops the data not sent yet
         bool remove_client(const ClientPtr & client);
         bool send_to_client(int socket, const sihd::util::IArray & arr);
         bool remove_client(int socket);
@@ -76,6 +135,9 @@ class BasicServerHandler: public INetServerHandler,
     private:
         void _reset();
         void _add_time_to_clients();
+        bool _queue(const ClientPtr & client, WriteBuffer && buffer);
+        // false on error
+        bool _write_queue(Client & client);
 
         mutable std::recursive_mutex _mutex;
         std::map<int, ClientPtr> _client_map;
@@ -90,6 +152,10 @@ class BasicServerHandler: public INetServerHandler,
 
         std::optional<sihd::crypto::TlsContext> _tls_ctx;
         size_t _max_clients;
+        size_t _write_high_watermark;
+        size_t _write_low_watermark;
+        std::function<void(const ClientPtr &)> _high_watermark_callback;
+        std::function<void(const ClientPtr &)> _low_watermark_callback;
 };
 
 } // namespace sihd::net
@@ -0,0 +1,100 @@
+#ifndef __SIHD_NET_DATAGRAMBATCH_HPP__
+#define __SIHD_NET_DATAGRAMBATCH_HPP__
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <sihd/util/ArrayView.hpp>
+#include <sihd/util/Timestamp.hpp>
+
+#include <sihd/net/IpAddr.hpp>
+
+namespace sihd::net
+{
+
+/**
+ * Preallocated slots of datagrams received or sent by a socket with a single system call when available.
+ *
+ * A received slot coalesced by UDP GRO is split into datagrams of the segment size, a slot must then be able to
+ * hold a coalesced datagram (up to 65535 bytes). Receiving into the batch does not allocate once warm.
+ */
+class DatagramBatch
+{
+    public:
+        static constexpr size_t max_datagram_size = 65535;
+
+        DatagramBatch(size_t capacity, size_t datagram_size);
+        DatagramBatch(DatagramBatch && other);
+        ~DatagramBatch();
+
+        DatagramBatch(const DatagramBatch & other) = delete;
+        DatagramBatch & operator=(const DatagramBatch & other) = delete;
+        DatagramBatch & operator=(DatagramBatch && other);
+
+        // slots
+        size_t capacity() const { return _capacity; }
+        // bytes of a slot
+        size_t datagram_size() const { return _datagram_size; }
+
+        // datagrams received or pushed - can exceed the capacity when GRO coalesced datagrams
+        size_t size() const { return _datagrams.size(); }
+        bool empty() const { return _datagrams.empty(); }
+        bool full() const { return _used == _capacity; }
+        void clear();
+
+        sihd::util::ArrByteView data(size_t idx) const;
+        // received datagram has been cut to the slot size
+        bool truncated(size_t idx) const;
+        // source of a received datagram or destination of a pushed one - nullopt if none
+        std::optional<IpAddr> address(size_t idx) const;
+        // kernel receive time of a datagram with socket timestamping activated, 0 otherwise
+        sihd::util::Timestamp timestamp(size_t idx) const;
+
+        // copies a datagram in the next slot - false if full or bigger than a slot
+        bool push(sihd::util::ArrCharView data);
+        bool push(const IpAddr & addr, sihd::util::ArrCharView data);
+
+        // datagrams received - 0 if none was available on a non blocking socket, -1 on error
+        ssize_t receive(int socket, int flags = 0);
+        // datagrams sent in order - GSO sends consecutive datagrams of a destination as one, -1 on error
+        ssize_t send(int socket, bool gso = false, int flags = 0) const;
+
+    protected:
+
+    private:
+        struct Datagram
+        {
+                size_t slot;
+                size_t offset;
+                size_t size;
+        };
+
+        struct Slot
+        {
+                sockaddr_storage addr;
+                socklen_t addr_len;
+                bool truncated;
+                sihd::util::Timestamp timestamp;
+        };
+
+        // system calls headers
+        struct Messages;
+
+        uint8_t *_slot_data(size_t slot) const;
+        // datagrams from the received slots
+        void _split(size_t slot, size_t size, size_t segment_size);
+
+        size_t _capacity;
+        size_t _datagram_size;
+        // slots used
+        size_t _used;
+        std::unique_ptr<uint8_t[]> _buffer;
+        std::vector<Slot> _slots;
+        std::vector<Datagram> _datagrams;
+        std::unique_ptr<Messages> _messages;
+};
+
+} // namespace sihd::net
+
+#endif
@@ -1,9 +1,12 @@
 #ifndef __SIHD_NET_DEVICEUDPRECEIVER_HPP__
 #define __SIHD_NET_DEVICEUDPRECEIVER_HPP__
 
+#include <sihd/core/ChannelTransaction.hpp>
 #include <sihd/core/Device.hpp>
+#include <sihd/net/DatagramBatch.hpp>
 #include <sihd/net/INetReceiver.hpp>
 #include <sihd/net/UdpReceiver.hpp>
+#include <sihd/util/Array.hpp>
 #include <sihd/util/IRunnable.hpp>
 #include <sihd/util/Synchronizer.hpp>
 #include <sihd/util/Worker.hpp>
@@ -11,6 +14,16 @@
 namespace sihd::net
 {
 
+/**
+ * Writes each datagram received to the "rx" channel.
+ *
+ * With a batch size above 1, datagrams waiting are received with a single system call per wakeup and are also
+ * published together: "rx_batch" holds datagram i at byte offset i * buffer_capacity and "rx_sizes" its size,
+ * 0 for the slots unused by the batch.
+ *
+ * With kernel timestamps, channels take the time the kernel received the datagram instead of the time they are
+ * written - a batch takes the time of its first datagram. Kernel timestamps are from the system clock.
+ */
 class DeviceUdpReceiver: public sihd::core::Device,
                          public sihd::util::IHandler<INetReceiver *>,
                          protected sihd::util::IRunnable
@@ -25,6 +38,13 @@ class DeviceUdpReceiver: public sihd::core::Device,
         bool set_port(int port);
         bool set_buffer_capacity(size_t capacity);
         bool set_poll_timeout(int milliseconds);
+        bool set_batch_size(size_t size);
+        // UDP generic receive offload in batch mode - Linux only
+        bool set_gro(bool active);
+        // SO_TIMESTAMPNS receive time - Linux only
+        bool set_kernel_timestamp(bool active);
+        // see UdpReceiver::set_busy_poll
+        bool set_busy_poll(int microseconds);
 
     protected:
         using sihd::core::Device::handle;
@@ -40,6 +60,10 @@ class DeviceUdpReceiver: public sihd::core::Device,
         bool run() override;
 
     private:
+        // timestamp is 0 to use the channel's clock
+        void _write_rx(const sihd::util::ArrByteView & data, sihd::util::Timestamp timestamp);
+        void _publish_batch();
+
         UdpReceiver _udp_receiver;
         sihd::util::Worker _worker;
         sihd::util::Synchronizer _start_sync;
@@ -49,8 +73,18 @@ class DeviceUdpReceiver: public sihd::core::Device,
         std::string _host;
         int _port;
         size_t _buffer_capacity;
+        size_t _batch_size;
+        bool _gro;
+        bool _kernel_timestamp;
+
+        sihd::util::ArrByte _buffer;
+        std::unique_ptr<DatagramBatch> _batch_ptr;
+        sihd::util::ArrUInt _sizes;
+        sihd::core::ChannelTransaction _transaction;
 
         sihd::core::Channel *_channel_rx;
+        sihd::core::Channel *_channel_rx_batch;
+        sihd::core::Channel *_channel_rx_sizes;
 };
 
 } // namespace sihd::net
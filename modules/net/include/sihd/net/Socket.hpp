@@ -4,8 +4,10 @@
 #include <optional>
 
 #include <sihd/util/ArrayView.hpp>
+#include <sihd/util/Timestamp.hpp>
 #include <sihd/sys/platform.hpp>
 
+#include <sihd/net/DatagramBatch.hpp>
 #include <sihd/net/IpAddr.hpp>
 #include <sihd/net/ip.hpp>
 
@@ -62,6 +64,12 @@ class Socket
         static bool set_socket_reuseport(int socket, bool active);
         static bool is_socket_reuseport(int socket);
 #endif
+        // UDP generic receive offload: coalesced datagrams are received at once - Linux only
+        static bool set_socket_udp_gro(int socket, bool active);
+        // kernel software receive timestamps (SO_TIMESTAMPNS) from the system clock - Linux only
+        static bool set_socket_timestamping(int socket, bool active);
+        // kernel busy polls the device queue for up to microseconds on blocking reads (SO_BUSY_POLL) - Linux only
+        static bool set_socket_busy_poll(int socket, int microseconds);
         static bool set_socket_rcvbuf(int socket, int size);
         static bool set_socket_sndbuf(int socket, int size);
         static int get_socket_rcvbuf(int socket);
@@ -86,6 +94,9 @@ class Socket
         bool set_reuseport(bool active) const;
         bool is_reuseport() const;
 #endif
+        bool set_udp_gro(bool active) const;
+        bool set_timestamping(bool active) const;
+        bool set_busy_poll(int microseconds) const;
         bool set_rcvbuf(int size) const;
         bool set_sndbuf(int size) const;
         int get_rcvbuf() const;
@@ -107,6 +118,14 @@ class Socket
 
         virtual ssize_t receive(void *data, size_t size);
         ssize_t receive(sihd::util::IArray & arr);
+        // timestamp is the kernel receive time with timestamping activated, 0 otherwise
+        ssize_t receive_timestamped(void *data, size_t size, sihd::util::Timestamp & timestamp);
+        ssize_t receive_timestamped(sihd::util::IArray & arr, sihd::util::Timestamp & timestamp);
+
+        // receives up to the batch capacity with a single system call when available - waits for the first only
+        ssize_t receive_batch(DatagramBatch & batch);
+        // sends the batch with a single system call when available - GSO needs datagrams of the same size
+        ssize_t send_batch(const DatagramBatch & batch, bool gso = false);
 
         bool listen(uint16_t queue_size);
         int accept(sockaddr *addr, socklen_t *addr_len, int timeout_ms = blocking_timeout);
@@ -1,6 +1,10 @@
 #ifndef __SIHD_NET_TCPSERVER_HPP__
 #define __SIHD_NET_TCPSERVER_HPP__
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include <sihd/net/INetServer.hpp>
 #include <sihd/net/INetServerHandler.hpp>
 #include <sihd/net/Socket.hpp>
@@ -48,9 +52,26 @@ class TcpServer: public INetServer,
         bool set_queue_size(size_t size);
         bool set_poll_timeout(int milliseconds);
         bool set_poll_limit(int limit);
+        // "poll" or "epoll" - defaults to epoll where available
+        bool set_poll_backend(std::string_view backend);
 
         void set_server_handler(INetServerHandler *handler);
 
+        /**
+         * Multi reactor mode: each additional reactor polls in its own thread its own listening socket, bound to
+         * the server address with SO_REUSEPORT - the kernel spreads new connections between them and a client stays
+         * on the reactor which accepted it. Reactors share the poll configuration of the server, the poll limit applies
+         * to each of them.
+         * Must be set before binding, fails while running. Not available for unix sockets.
+         */
+        bool set_reactors(size_t count);
+        size_t reactors() const { return _reactor_handlers.size() + 1; }
+        /**
+         * Handler of a reactor, only called from the thread of the reactor: each reactor needs its own handler, which
+         * shards the clients state. Reactor 0 is the server handler, starting fails if a reactor has no handler.
+         */
+        bool set_reactor_handler(size_t reactor, INetServerHandler *handler);
+
         // to set blocking/broadcast
         const Socket & socket() const { return _socket; }
         size_t queue_size() const { return _queue_size; }
@@ -61,13 +82,23 @@ class TcpServer: public INetServer,
         bool on_stop() override;
 
     private:
+        class Reactor;
+
         void _setup_poll();
+        bool _start_reactors();
+        void _stop_reactors();
+        // called from a reactor whose listening socket closed
+        void _reactor_failed();
 
         Socket _socket;
         size_t _queue_size;
         std::mutex _poll_mutex;
         sihd::sys::Poll _poll;
         INetServerHandler *_server_handler_ptr;
+        // handlers of the reactors after the first one
+        std::vector<INetServerHandler *> _reactor_handlers;
+        std::vector<std::unique_ptr<Reactor>> _reactors;
+        std::atomic<bool> _reactor_error;
 };
 
 } // namespace sihd::net
@@ -1,6 +1,8 @@
 #ifndef __SIHD_NET_UDPRECEIVER_HPP__
 #define __SIHD_NET_UDPRECEIVER_HPP__
 
+#include <atomic>
+
 #include <sihd/net/INetReceiver.hpp>
 #include <sihd/net/Socket.hpp>
 
@@ -38,6 +40,10 @@ class UdpReceiver: public INetReceiver,
 
         ssize_t receive(void *buf, size_t len);
         ssize_t receive(IpAddr & addr, void *buf, size_t len);
+        // timestamp is the kernel receive time once socket().set_timestamping(true), 0 otherwise
+        ssize_t receive_timestamped(sihd::util::IArray & arr, sihd::util::Timestamp & timestamp);
+        // up to the batch capacity per system call - with UDP GRO, slots must hold coalesced datagrams
+        ssize_t receive_batch(DatagramBatch & batch);
 
         // INetReceiver
         bool close() override;
@@ -45,12 +51,21 @@ class UdpReceiver: public INetReceiver,
         ssize_t receive(IpAddr & addr, sihd::util::IArray & arr) override;
 
         bool set_poll_timeout(int milliseconds);
+
+        /**
+         * Busy poll mode when running, for latency critical feeds: checks the socket without blocking for up to
+         * microseconds since the last datagram, then waits with the poll timeout until the next one. Also sets
+         * SO_BUSY_POLL on the socket when it can. Spinning keeps a core busy - 0 to deactivate.
+         * Fails while running.
+         */
+        bool set_busy_poll(int microseconds);
+        int busy_poll() const { return _busy_poll_us; }
         // poll for x milliseconds - returns true if socket is read
         bool poll(int milliseconds);
         // poll once with configured timeout
         bool poll();
 
-        // to set blocking/broadcast
+        // to set blocking/broadcast/udp_gro
         const Socket & socket() const { return _socket; }
 
     protected:
@@ -60,10 +75,14 @@ class UdpReceiver: public INetReceiver,
 
     private:
         void _setup_poll();
+        void _setup_busy_poll();
+        bool _busy_poll_loop();
 
         Socket _socket;
         std::mutex _poll_mutex;
         sihd::sys::Poll _poll;
+        int _busy_poll_us;
+        std::atomic<bool> _busy_poll_stop;
 };
 
 } // namespace sihd::net
@@ -37,6 +37,10 @@ class UdpSender: public INetSender,
         ssize_t send_to(const IpAddr & addr, sihd::util::ArrCharView view);
         bool send_to_all(const IpAddr & addr, sihd::util::ArrCharView view);
 
+        // datagrams sent to their address or to the connected one - GSO sends consecutive datagrams of a
+        // destination and of the same size as one
+        ssize_t send_batch(const DatagramBatch & batch, bool gso = false);
+
         const Socket & socket() const { return _socket; }
 
     protected:
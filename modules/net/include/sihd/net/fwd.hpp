@@ -5,6 +5,7 @@ namespace sihd::net
 {
 
 class BasicServerHandler;
+class DatagramBatch;
 class DeviceTcpClient;
 class DeviceTcpServer;
 class DeviceUdpReceiver;
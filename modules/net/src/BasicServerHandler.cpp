@@ -1,7 +1,12 @@
+#include <algorithm>
+#include <cerrno>
+
 #include <sihd/net/BasicServerHandler.hpp>
 #include <sihd/util/Logger.hpp>
 
 #if !defined(__SIHD_WINDOWS__)
+# include <sys/socket.h>
+# include <sys/uio.h>
 # include <unistd.h>
 #endif
 
@@ -10,13 +15,104 @@ namespace sihd::net
 
 SIHD_LOGGER;
 
+namespace
+{
+
+#if !defined(__SIHD_WINDOWS__)
+// buffers gathered by a single send
+constexpr size_t g_max_iovecs = 64;
+// writing never blocks the server thread - a closed peer does not raise SIGPIPE
+# if defined(MSG_NOSIGNAL)
+constexpr int g_send_flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+# else
+constexpr int g_send_flags = MSG_DONTWAIT;
+# endif
+#endif
+
+} // namespace
+
+BasicServerHandler::WriteBuffer::WriteBuffer(sihd::util::ArrByte && data):
+    _owned(std::move(data)),
+    _data(nullptr),
+    _size(_owned.byte_size()),
+    _sent(0)
+{
+}
+
+BasicServerHandler::WriteBuffer::WriteBuffer(const void *data, size_t size, std::function<void()> release):
+    _data(static_cast<const uint8_t *>(data)),
+    _size(size),
+    _sent(0),
+    _release_fun(std::move(release))
+{
+}
+
+BasicServerHandler::WriteBuffer::WriteBuffer(WriteBuffer && other) noexcept:
+    _owned(std::move(other._owned)),
+    _data(other._data),
+    _size(other._size),
+    _sent(other._sent),
+    _release_fun(std::move(other._release_fun))
+{
+    other._release_fun = nullptr;
+    other._size = 0;
+    other._sent = 0;
+}
+
+BasicServerHandler::WriteBuffer & BasicServerHandler::WriteBuffer::operator=(WriteBuffer && other) noexcept
+{
+    if (this != &other)
+    {
+        this->_release();
+        _owned = std::move(other._owned);
+        _data = other._data;
+        _size = other._size;
+        _sent = other._sent;
+        _release_fun = std::move(other._release_fun);
+        other._release_fun = nullptr;
+        other._size = 0;
+        other._sent = 0;
+    }
+    return *this;
+}
+
+BasicServerHandler::WriteBuffer::~WriteBuffer()
+{
+    this->_release();
+}
+
+const uint8_t *BasicServerHandler::WriteBuffer::data() const
+{
+    return (_data != nullptr ? _data : _owned.buf()) + _sent;
+}
+
+void BasicServerHandler::WriteBuffer::_release()
+{
+    if (_release_fun)
+    {
+        std::function<void()> release = std::move(_release_fun);
+        _release_fun = nullptr;
+        release();
+    }
+}
+
+size_t BasicServerHandler::Client::pending_write_bytes() const
+{
+    std::lock_guard lock(mutex);
+    return write_queue_bytes;
+}
+
 BasicServerHandler::BasicServerHandler()
 {
     _last_time = 0;
     _poll_time = 0;
     _server = nullptr;
     this->set_max_clients(512);
+    this->set_write_high_watermark(256 * 1024);
+    this->set_write_low_watermark(64 * 1024);
     this->add_conf("max_clients", &BasicServerHandler::set_max_clients);
+    this->add_conf("write_high_watermark", &BasicServerHandler::set_write_high_watermark);
+    this->add_conf("write_low_watermark", &BasicServerHandler::set_write_low_watermark);
 }
 
 BasicServerHandler::~BasicServerHandler() = default;
@@ -51,6 +147,28 @@ bool BasicServerHandler::set_max_clients(size_t max)
     return true;
 }
 
+bool BasicServerHandler::set_write_high_watermark(size_t bytes)
+{
+    _write_high_watermark = bytes;
+    return true;
+}
+
+bool BasicServerHandler::set_write_low_watermark(size_t bytes)
+{
+    _write_low_watermark = bytes;
+    return true;
+}
+
+void BasicServerHandler::set_high_watermark_callback(std::function<void(const ClientPtr &)> callback)
+{
+    _high_watermark_callback = std::move(callback);
+}
+
+void BasicServerHandler::set_low_watermark_callback(std::function<void(const ClientPtr &)> callback)
+{
+    _low_watermark_callback = std::move(callback);
+}
+
 size_t BasicServerHandler::client_count() const
 {
     std::lock_guard lock(_mutex);
@@ -78,16 +196,129 @@ std::vector<BasicServerHandler::ClientPtr> BasicServerHandler::clients() const
 
 bool BasicServerHandler::send_to_client(const ClientPtr & client, const sihd::util::IArray & arr)
 {
-    if (!client)
+    sihd::util::ArrByte data;
+    if (!data.byte_resize(arr.byte_size()) || !data.copy_from_bytes(arr))
         return false;
-    std::lock_guard lock(_mutex);
-    auto it = _client_map.find(client->fd());
-    if (it == _client_map.end() || it->second != client)
+    return this->_queue(client, WriteBuffer(std::move(data)));
+}
+
+bool BasicServerHandler::send_to_client(const ClientPtr & client,
+                                        const void *data,
+                                        size_t size,
+                                        std::function<void()> release)
+{
+    return this->_queue(client, WriteBuffer(data, size, std::move(release)));
+}
+
+bool BasicServerHandler::_queue(const ClientPtr & client, WriteBuffer && buffer)
+{
+    if (!client)
         return false;
-    client->write_array.byte_resize(arr.byte_size());
-    if (client->write_array.copy_from_bytes(arr))
-        return this->server()->add_client_write(client->fd());
-    return false;
+    bool congested = false;
+    {
+        std::lock_guard lock(_mutex);
+        auto it = _client_map.find(client->fd());
+        if (it == _client_map.end() || it->second != client)
+            return false;
+        if (buffer.remaining() == 0)
+            return true;
+        bool was_empty;
+        {
+            std::lock_guard lk(client->mutex);
+            was_empty = client->write_queue.empty();
+            client->write_queue_bytes += buffer.remaining();
+            client->write_queue.emplace_back(std::move(buffer));
+            if (!client->write_congested && client->write_queue_bytes > _write_high_watermark)
+            {
+                client->write_congested = true;
+                congested = true;
+            }
+        }
+        // the server thread removes the write interest under the same lock once the queue is empty
+        if (was_empty && (_server == nullptr || !_server->add_client_write(client->fd())))
+        {
+            // nothing would send it: a queued buffer would stall every later write
+            std::lock_guard lk(client->mutex);
+            client->write_queue_bytes -= client->write_queue.back().remaining();
+            client->write_queue.pop_back();
+            if (congested)
+                client->write_congested = false;
+            return false;
+        }
+    }
+    if (congested && _high_watermark_callback)
+        _high_watermark_callback(client);
+    return true;
+}
+
+bool BasicServerHandler::_write_queue(Client & client)
+{
+    if (client.socket.tls_active())
+    {
+        // records are written whole on the blocking socket
+        while (!client.write_queue.empty())
+        {
+            WriteBuffer & buffer = client.write_queue.front();
+            if (!client.socket.send_all({(const char *)buffer.data(), buffer.remaining()}))
+                return false;
+            client.write_queue_bytes -= buffer.remaining();
+            client.write_queue.pop_front();
+        }
+        return true;
+    }
+#if !defined(__SIHD_WINDOWS__)
+    struct iovec iovecs[g_max_iovecs];
+    while (!client.write_queue.empty())
+    {
+        size_t count = 0;
+        size_t total = 0;
+        for (auto it = client.write_queue.begin(); it != client.write_queue.end() && count < g_max_iovecs; ++it)
+        {
+            iovecs[count].iov_base = (void *)it->data();
+            iovecs[count].iov_len = it->remaining();
+            total += it->remaining();
+            ++count;
+        }
+        struct msghdr msg = {};
+        msg.msg_iov = iovecs;
+        msg.msg_iovlen = count;
+        ssize_t ret = ::sendmsg(client.fd(), &msg, g_send_flags);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            // socket buffer full: continues on the next writable event
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        size_t written = ret;
+        client.write_queue_bytes -= written;
+        while (written > 0)
+        {
+            WriteBuffer & buffer = client.write_queue.front();
+            const size_t consumed = std::min(written, buffer.remaining());
+            buffer.consume(consumed);
+            written -= consumed;
+            if (buffer.remaining() == 0)
+                client.write_queue.pop_front();
+        }
+        if ((size_t)ret < total)
+            return true;
+    }
+    return true;
+#else
+    while (!client.write_queue.empty())
+    {
+        WriteBuffer & buffer = client.write_queue.front();
+        ssize_t ret = client.socket.send({(const char *)buffer.data(), buffer.remaining()});
+        if (ret < 0)
+            return false;
+        buffer.consume(ret);
+        client.write_queue_bytes -= ret;
+        if (buffer.remaining() == 0)
+            client.write_queue.pop_front();
+    }
+    return true;
+#endif
 }
 
 bool BasicServerHandler::remove_client(const ClientPtr & client)
@@ -100,6 +331,11 @@ bool BasicServerHandler::remove_client(const ClientPtr & client)
         return false;
     int fd = client->fd();
     client->disconnected = true;
+    {
+        std::lock_guard lk(client->mutex);
+        client->write_queue.clear();
+        client->write_queue_bytes = 0;
+    }
     this->server()->remove_client_read(fd);
     this->server()->remove_client_write(fd);
     _client_map.erase(it);
@@ -160,7 +396,6 @@ void BasicServerHandler::handle_new_client(INetServer *server)
         }
         auto client = std::make_shared<Client>(socket);
         client->read_array.reserve(4096);
-        client->write_array.reserve(4096);
         client->addr = addr;
         client->time_connected = _clock.now();
         if (_tls_ctx)
@@ -172,6 +407,7 @@ void BasicServerHandler::handle_new_client(INetServer *server)
                 return;
             }
         }
+        _server = server;
         server->add_client_read(socket);
         _client_map[socket] = client;
         _connect_event_lst.push_back(client);
@@ -200,16 +436,36 @@ void BasicServerHandler::handle_client_read(INetServer *server, int socket)
 
 void BasicServerHandler::handle_client_write(INetServer *server, int socket)
 {
-    std::lock_guard lock(_mutex);
-    auto it = _client_map.find(socket);
-    if (it != _client_map.end())
+    ClientPtr client;
+    bool decongested = false;
     {
-        auto & client = it->second;
-        bool success = client->socket.send_all(client->write_array);
-        client->error = !success;
+        std::lock_guard lock(_mutex);
+        auto it = _client_map.find(socket);
+        if (it == _client_map.end())
+            return;
+        client = it->second;
+        bool drained;
+        {
+            std::lock_guard lk(client->mutex);
+            client->error = !this->_write_queue(*client);
+            if (client->error)
+            {
+                client->write_queue.clear();
+                client->write_queue_bytes = 0;
+            }
+            drained = client->write_queue.empty();
+            if (client->write_congested && client->write_queue_bytes <= _write_low_watermark)
+            {
+                client->write_congested = false;
+                decongested = true;
+            }
+        }
         _write_event_lst.push_back(client);
-        server->remove_client_write(socket);
+        if (drained)
+            server->remove_client_write(socket);
     }
+    if (decongested && _low_watermark_callback)
+        _low_watermark_callback(client);
 }
 
 void BasicServerHandler::handle_after_activity(INetServer *server)
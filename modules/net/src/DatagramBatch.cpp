@@ -0,0 +1,335 @@
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+
+#include <sihd/net/DatagramBatch.hpp>
+
+#include "timestamping.hpp"
+
+// recvmmsg and sendmmsg are only available on Linux (not Cygwin, not Emscripten)
+#if defined(__SIHD_LINUX__) && !defined(__SIHD_EMSCRIPTEN__) && !defined(__CYGWIN__)
+# define SIHD_HAS_MMSG 1
+#endif
+
+#if defined(SIHD_HAS_MMSG)
+# include <netinet/udp.h>
+# include <sys/socket.h>
+// missing from older libc headers
+# ifndef UDP_SEGMENT
+#  define UDP_SEGMENT 103
+# endif
+# ifndef UDP_GRO
+#  define UDP_GRO 104
+# endif
+#elif !defined(__SIHD_WINDOWS__)
+# include <sys/socket.h>
+#else
+# include <ws2tcpip.h>
+#endif
+
+namespace sihd::net
+{
+
+namespace
+{
+
+// payload of an IPv4 UDP datagram
+constexpr size_t max_gso_bytes = 65507;
+// segments the kernel accepts in a GSO datagram
+constexpr size_t max_gso_segments = 64;
+
+} // namespace
+
+struct DatagramBatch::Messages
+{
+#if defined(SIHD_HAS_MMSG)
+        // segment size of GRO on receive and of GSO on send, receive timestamp
+        union Control
+        {
+                char buf[CMSG_SPACE(sizeof(int)) + timestamping::control_size];
+                cmsghdr align;
+        };
+
+        std::vector<mmsghdr> headers;
+        std::vector<iovec> iovecs;
+        std::vector<Control> controls;
+        // datagrams of each message sent
+        std::vector<size_t> segments;
+
+        void resize(size_t size)
+        {
+            if (headers.size() >= size)
+                return;
+            headers.resize(size);
+            iovecs.resize(size);
+            controls.resize(size);
+            segments.resize(size);
+        }
+#endif
+};
+
+DatagramBatch::DatagramBatch(size_t capacity, size_t datagram_size):
+    _capacity(std::max<size_t>(capacity, 1)),
+    _datagram_size(std::clamp<size_t>(datagram_size, 1, max_datagram_size)),
+    _used(0),
+    _buffer(std::make_unique<uint8_t[]>(_capacity * _datagram_size)),
+    _slots(_capacity),
+    _messages(std::make_unique<Messages>())
+{
+    _datagrams.reserve(_capacity);
+#if defined(SIHD_HAS_MMSG)
+    _messages->resize(_capacity);
+#endif
+}
+
+DatagramBatch::DatagramBatch(DatagramBatch && other) = default;
+
+DatagramBatch::~DatagramBatch() = default;
+
+DatagramBatch & DatagramBatch::operator=(DatagramBatch && other) = default;
+
+uint8_t *DatagramBatch::_slot_data(size_t slot) const
+{
+    return _buffer.get() + slot * _datagram_size;
+}
+
+void DatagramBatch::clear()
+{
+    _used = 0;
+    _datagrams.clear();
+}
+
+sihd::util::ArrByteView DatagramBatch::data(size_t idx) const
+{
+    const Datagram & datagram = _datagrams.at(idx);
+    return {this->_slot_data(datagram.slot) + datagram.offset, datagram.size};
+}
+
+sihd::util::Timestamp DatagramBatch::timestamp(size_t idx) const
+{
+    return _slots[_datagrams.at(idx).slot].timestamp;
+}
+
+bool DatagramBatch::truncated(size_t idx) const
+{
+    return _slots[_datagrams.at(idx).slot].truncated;
+}
+
+std::optional<IpAddr> DatagramBatch::address(size_t idx) const
+{
+    const Slot & slot = _slots[_datagrams.at(idx).slot];
+    if (slot.addr_len == 0 || (slot.addr.ss_family != AF_INET && slot.addr.ss_family != AF_INET6))
+        return std::nullopt;
+    return IpAddr(*(const sockaddr *)&slot.addr, slot.addr_len);
+}
+
+bool DatagramBatch::push(sihd::util::ArrCharView data)
+{
+    if (this->full() || data.size() > _datagram_size)
+        return false;
+    Slot & slot = _slots[_used];
+    slot.addr_len = 0;
+    slot.truncated = false;
+    slot.timestamp = 0;
+    memcpy(this->_slot_data(_used), data.data(), data.size());
+    _datagrams.push_back({_used, 0, data.size()});
+    ++_used;
+    return true;
+}
+
+bool DatagramBatch::push(const IpAddr & addr, sihd::util::ArrCharView data)
+{
+    if (!this->push(data))
+        return false;
+    Slot & slot = _slots[_used - 1];
+    slot.addr_len = addr.addr_len();
+    memcpy(&slot.addr, &addr.addr(), slot.addr_len);
+    return true;
+}
+
+void DatagramBatch::_split(size_t slot, size_t size, size_t segment_size)
+{
+    if (segment_size == 0 || segment_size >= size)
+    {
+        _datagrams.push_back({slot, 0, size});
+        return;
+    }
+    for (size_t offset = 0; offset < size; offset += segment_size)
+        _datagrams.push_back({slot, offset, std::min(segment_size, size - offset)});
+}
+
+ssize_t DatagramBatch::receive(int socket, int flags)
+{
+    this->clear();
+#if defined(SIHD_HAS_MMSG)
+    Messages & messages = *_messages;
+    for (size_t i = 0; i < _capacity; ++i)
+    {
+        messages.iovecs[i] = {this->_slot_data(i), _datagram_size};
+        msghdr & hdr = messages.headers[i].msg_hdr;
+        hdr.msg_name = &_slots[i].addr;
+        hdr.msg_namelen = sizeof(sockaddr_storage);
+        hdr.msg_iov = &messages.iovecs[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = messages.controls[i].buf;
+        hdr.msg_controllen = sizeof(Messages::Control);
+        hdr.msg_flags = 0;
+        messages.headers[i].msg_len = 0;
+    }
+    int received;
+    // waits for the first datagram only
+    do
+    {
+        received = ::recvmmsg(socket, messages.headers.data(), _capacity, flags | MSG_WAITFORONE, nullptr);
+    } while (received < 0 && errno == EINTR);
+    if (received < 0)
+        return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    for (size_t i = 0; i < (size_t)received; ++i)
+    {
+        msghdr & hdr = messages.headers[i].msg_hdr;
+        size_t segment_size = 0;
+        _slots[i].timestamp = 0;
+        for (cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg))
+        {
+            if (timestamping::read(cmsg, _slots[i].timestamp))
+                continue;
+            if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+            {
+                int gro_size;
+                memcpy(&gro_size, CMSG_DATA(cmsg), sizeof(int));
+                segment_size = gro_size > 0 ? gro_size : 0;
+            }
+        }
+        _slots[i].addr_len = hdr.msg_namelen;
+        _slots[i].truncated = (hdr.msg_flags & MSG_TRUNC) != 0;
+        this->_split(i, messages.headers[i].msg_len, segment_size);
+    }
+    _used = received;
+#else
+    for (size_t i = 0; i < _capacity; ++i)
+    {
+        Slot & slot = _slots[i];
+        slot.addr_len = sizeof(sockaddr_storage);
+        slot.truncated = false;
+        slot.timestamp = 0;
+        sockaddr *addr = (sockaddr *)&slot.addr;
+# if !defined(__SIHD_WINDOWS__)
+        // waits for the first datagram only
+        const int slot_flags = i > 0 ? flags | MSG_DONTWAIT : flags;
+        ssize_t ret = ::recvfrom(socket, this->_slot_data(i), _datagram_size, slot_flags, addr, &slot.addr_len);
+# else
+        ssize_t ret = ::recvfrom(socket, (char *)this->_slot_data(i), _datagram_size, flags, addr, &slot.addr_len);
+# endif
+        if (ret < 0)
+        {
+            if (i > 0 || errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            return -1;
+        }
+        this->_split(i, ret, 0);
+        _used = i + 1;
+# if defined(__SIHD_WINDOWS__)
+        // cannot tell if another datagram is waiting without blocking
+        break;
+# endif
+    }
+#endif
+    return _datagrams.size();
+}
+
+ssize_t DatagramBatch::send(int socket, bool gso, int flags) const
+{
+    const size_t count = _datagrams.size();
+#if defined(SIHD_HAS_MMSG)
+    Messages & messages = *_messages;
+    // datagrams split from a received batch can exceed the capacity
+    messages.resize(count);
+    size_t msgs = 0;
+    size_t i = 0;
+    while (i < count)
+    {
+        const Datagram & first = _datagrams[i];
+        const Slot & slot = _slots[first.slot];
+        size_t segments = 1;
+        size_t total = first.size;
+        // consecutive datagrams of a destination are segments of the first size, only the last can be smaller
+        while (gso && first.size > 0 && i + segments < count && segments < max_gso_segments)
+        {
+            const Datagram & next = _datagrams[i + segments];
+            const Slot & next_slot = _slots[next.slot];
+            if (next.size == 0 || next.size > first.size || total + next.size > max_gso_bytes
+                || next_slot.addr_len != slot.addr_len || memcmp(&next_slot.addr, &slot.addr, slot.addr_len) != 0)
+                break;
+            total += next.size;
+            ++segments;
+            if (next.size < first.size)
+                break;
+        }
+        for (size_t j = i; j < i + segments; ++j)
+        {
+            const Datagram & datagram = _datagrams[j];
+            messages.iovecs[j] = {this->_slot_data(datagram.slot) + datagram.offset, datagram.size};
+        }
+        msghdr & hdr = messages.headers[msgs].msg_hdr;
+        hdr.msg_name = slot.addr_len > 0 ? (void *)&slot.addr : nullptr;
+        hdr.msg_namelen = slot.addr_len;
+        hdr.msg_iov = &messages.iovecs[i];
+        hdr.msg_iovlen = segments;
+        hdr.msg_control = nullptr;
+        hdr.msg_controllen = 0;
+        hdr.msg_flags = 0;
+        if (segments > 1)
+        {
+            hdr.msg_control = messages.controls[msgs].buf;
+            hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+            cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            const uint16_t segment_size = first.size;
+            memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(uint16_t));
+        }
+        messages.segments[msgs] = segments;
+        ++msgs;
+        i += segments;
+    }
+    size_t sent_msgs = 0;
+    ssize_t sent = 0;
+    while (sent_msgs < msgs)
+    {
+        int ret = ::sendmmsg(socket, messages.headers.data() + sent_msgs, msgs - sent_msgs, flags);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (sent_msgs == 0)
+                return -1;
+            break;
+        }
+        for (size_t j = sent_msgs; j < sent_msgs + ret; ++j)
+            sent += messages.segments[j];
+        sent_msgs += ret;
+    }
+    return sent;
+#else
+    (void)gso;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Datagram & datagram = _datagrams[i];
+        const Slot & slot = _slots[datagram.slot];
+        const sockaddr *addr = slot.addr_len > 0 ? (const sockaddr *)&slot.addr : nullptr;
+        const uint8_t *data = this->_slot_data(datagram.slot) + datagram.offset;
+# if !defined(__SIHD_WINDOWS__)
+        ssize_t ret = ::sendto(socket, data, datagram.size, flags, addr, slot.addr_len);
+# else
+        ssize_t ret = ::sendto(socket, (const char *)data, datagram.size, flags, addr, slot.addr_len);
+# endif
+        if (ret < 0)
+            return i > 0 ? (ssize_t)i : -1;
+    }
+    return count;
+#endif
+}
+
+} // namespace sihd::net
@@ -1,6 +1,7 @@
+#include <algorithm>
+
 #include <sihd/net/DeviceUdpReceiver.hpp>
 #include <sihd/sys/NamedFactory.hpp>
-#include <sihd/util/Array.hpp>
 #include <sihd/util/Logger.hpp>
 
 namespace sihd::net
@@ -18,13 +19,22 @@ DeviceUdpReceiver::DeviceUdpReceiver(const std::string & name, sihd::util::Node
     _start_ok(false),
     _port(0),
     _buffer_capacity(4096),
-    _channel_rx(nullptr)
+    _batch_size(1),
+    _gro(false),
+    _kernel_timestamp(false),
+    _channel_rx(nullptr),
+    _channel_rx_batch(nullptr),
+    _channel_rx_sizes(nullptr)
 {
     _worker.set_runnable(this);
     this->add_conf("host", &DeviceUdpReceiver::set_host);
     this->add_conf("port", &DeviceUdpReceiver::set_port);
     this->add_conf("buffer_capacity", &DeviceUdpReceiver::set_buffer_capacity);
     this->add_conf("poll_timeout", &DeviceUdpReceiver::set_poll_timeout);
+    this->add_conf("batch_size", &DeviceUdpReceiver::set_batch_size);
+    this->add_conf("gro", &DeviceUdpReceiver::set_gro);
+    this->add_conf("kernel_timestamp", &DeviceUdpReceiver::set_kernel_timestamp);
+    this->add_conf("busy_poll", &DeviceUdpReceiver::set_busy_poll);
 }
 
 DeviceUdpReceiver::~DeviceUdpReceiver()
@@ -61,9 +71,48 @@ bool DeviceUdpReceiver::set_poll_timeout(int milliseconds)
     return _udp_receiver.set_poll_timeout(milliseconds);
 }
 
+bool DeviceUdpReceiver::set_batch_size(size_t size)
+{
+    if (size == 0)
+    {
+        SIHD_LOG(error, "DeviceUdpReceiver: batch size cannot be 0");
+        return false;
+    }
+    _batch_size = size;
+    return true;
+}
+
+bool DeviceUdpReceiver::set_gro(bool active)
+{
+    _gro = active;
+    return true;
+}
+
+bool DeviceUdpReceiver::set_kernel_timestamp(bool active)
+{
+    _kernel_timestamp = active;
+    return true;
+}
+
+bool DeviceUdpReceiver::set_busy_poll(int microseconds)
+{
+    return _udp_receiver.set_busy_poll(microseconds);
+}
+
 bool DeviceUdpReceiver::on_init()
 {
     this->add_unlinked_channel_resizable("rx", sihd::util::Type::TYPE_BYTE, 1, _buffer_capacity);
+    if (_batch_size > 1)
+    {
+        sihd::core::Channel *rx_batch
+            = this->add_unlinked_channel("rx_batch", sihd::util::Type::TYPE_BYTE, _batch_size * _buffer_capacity);
+        sihd::core::Channel *rx_sizes = this->add_unlinked_channel("rx_sizes", sihd::util::Type::TYPE_UINT, _batch_size);
+        if (rx_batch == nullptr || rx_sizes == nullptr)
+            return false;
+        // every batch is notified even if identical to the previous one
+        rx_batch->set_write_on_change(false);
+        rx_sizes->set_write_on_change(false);
+    }
     return true;
 }
 
@@ -72,6 +121,21 @@ bool DeviceUdpReceiver::on_start()
     _channel_rx = this->get_channel("rx");
     if (_channel_rx == nullptr)
         return false;
+    if (_batch_size > 1)
+    {
+        _channel_rx_batch = this->get_channel("rx_batch");
+        _channel_rx_sizes = this->get_channel("rx_sizes");
+        if (_channel_rx_batch == nullptr || _channel_rx_sizes == nullptr)
+            return false;
+        // coalesced datagrams are split after being received whole
+        _batch_ptr = std::make_unique<DatagramBatch>(_batch_size,
+                                                     _gro ? DatagramBatch::max_datagram_size : _buffer_capacity);
+        _sizes.resize(_batch_size);
+    }
+    else
+    {
+        _buffer.reserve(_buffer_capacity);
+    }
 
     if (_port <= 0)
     {
@@ -102,6 +166,10 @@ bool DeviceUdpReceiver::on_stop()
 bool DeviceUdpReceiver::on_reset()
 {
     _channel_rx = nullptr;
+    _channel_rx_batch = nullptr;
+    _channel_rx_sizes = nullptr;
+    _batch_ptr.reset();
+    _transaction.clear();
     return true;
 }
 
@@ -118,6 +186,11 @@ bool DeviceUdpReceiver::run()
         return false;
     }
 
+    if (_gro && _batch_ptr && !_udp_receiver.socket().set_udp_gro(true))
+        SIHD_LOG(warning, "DeviceUdpReceiver: cannot activate UDP GRO");
+    if (_kernel_timestamp && !_udp_receiver.socket().set_timestamping(true))
+        SIHD_LOG(warning, "DeviceUdpReceiver: cannot activate kernel timestamps");
+
     _udp_receiver.add_observer(this);
 
     _start_ok = true;
@@ -132,12 +205,57 @@ void DeviceUdpReceiver::handle([[maybe_unused]] sihd::core::Channel *c) {}
 
 void DeviceUdpReceiver::handle(INetReceiver *receiver)
 {
-    sihd::util::ArrByte buf(_buffer_capacity);
-    ssize_t received = receiver->receive(buf);
+    if (_batch_ptr)
+    {
+        if (_udp_receiver.receive_batch(*_batch_ptr) > 0)
+            this->_publish_batch();
+        return;
+    }
+    sihd::util::Timestamp timestamp = 0;
+    ssize_t received
+        = _kernel_timestamp ? _udp_receiver.receive_timestamped(_buffer, timestamp) : receiver->receive(_buffer);
     if (received > 0)
     {
-        buf.resize(static_cast<size_t>(received));
-        _channel_rx->write(buf);
+        _buffer.resize(static_cast<size_t>(received));
+        this->_write_rx(_buffer, timestamp);
+    }
+}
+
+void DeviceUdpReceiver::_write_rx(const sihd::util::ArrByteView & data, sihd::util::Timestamp timestamp)
+{
+    if (timestamp.get() == 0)
+    {
+        _channel_rx->write(data);
+        return;
+    }
+    const sihd::core::Channel::Write write {data, 0};
+    _channel_rx->write_batch({&write, 1}, timestamp);
+}
+
+void DeviceUdpReceiver::_publish_batch()
+{
+    const DatagramBatch & batch = *_batch_ptr;
+    const size_t count = batch.size();
+    // datagrams split by GRO can exceed a batch
+    for (size_t begin = 0; begin < count; begin += _batch_size)
+    {
+        const size_t end = std::min(count, begin + _batch_size);
+        std::fill(_sizes.begin(), _sizes.end(), 0);
+        for (size_t i = begin; i < end; ++i)
+        {
+            const sihd::util::ArrByteView received = batch.data(i);
+            const sihd::util::ArrByteView data(received.data(), std::min(received.size(), _buffer_capacity));
+            this->_write_rx(data, batch.timestamp(i));
+            _sizes[i - begin] = data.size();
+            _transaction.write(_channel_rx_batch, data, (i - begin) * _buffer_capacity);
+        }
+        _transaction.write(_channel_rx_sizes, _sizes);
+        const sihd::util::Timestamp timestamp = batch.timestamp(begin);
+        if (!(timestamp.get() == 0 ? _transaction.commit() : _transaction.commit(timestamp)))
+        {
+            SIHD_LOG(warning, "DeviceUdpReceiver: could not publish a batch of {} datagrams", end - begin);
+            _transaction.clear();
+        }
     }
 }
 
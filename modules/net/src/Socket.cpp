@@ -9,10 +9,13 @@
 #include <sihd/sys/os.hpp>
 #include <sihd/util/Logger.hpp>
 
+#include "timestamping.hpp"
+
 #if !defined(__SIHD_WINDOWS__)
 # include <fcntl.h>       // fcntl
 # include <net/if.h>      // IFNAMSIZ
 # include <netinet/tcp.h> // tcp nodelay
+# include <netinet/udp.h> // udp gro
 # include <sys/un.h>      // unix sockets
 #else
 # include <afunix.h>   // AF_UNIX
@@ -27,6 +30,10 @@
 
 #endif
 
+#if defined(__SIHD_LINUX__) && !defined(__SIHD_EMSCRIPTEN__) && !defined(__CYGWIN__) && !defined(UDP_GRO)
+# define UDP_GRO 104
+#endif
+
 namespace sihd::net
 {
 
@@ -222,6 +229,44 @@ bool Socket::is_socket_reuseport(int socket)
 }
 #endif
 
+bool Socket::set_socket_udp_gro(int socket, bool active)
+{
+#if defined(UDP_GRO)
+    int opt = active ? 1 : 0;
+    return sihd::sys::os::setsockopt(socket, SOL_UDP, UDP_GRO, &opt, sizeof(int));
+#else
+    (void)socket;
+    (void)active;
+    SIHD_LOG(error, "Socket: UDP GRO is not supported on this platform");
+    return false;
+#endif
+}
+
+bool Socket::set_socket_timestamping(int socket, bool active)
+{
+#if defined(SIHD_HAS_KERNEL_TIMESTAMPS)
+    int opt = active ? 1 : 0;
+    return sihd::sys::os::setsockopt(socket, SOL_SOCKET, SO_TIMESTAMPNS, &opt, sizeof(int));
+#else
+    (void)socket;
+    (void)active;
+    SIHD_LOG(error, "Socket: kernel timestamping is not supported on this platform");
+    return false;
+#endif
+}
+
+bool Socket::set_socket_busy_poll(int socket, int microseconds)
+{
+#if defined(SO_BUSY_POLL)
+    return sihd::sys::os::setsockopt(socket, SOL_SOCKET, SO_BUSY_POLL, &microseconds, sizeof(int));
+#else
+    (void)socket;
+    (void)microseconds;
+    SIHD_LOG(error, "Socket: busy polling is not supported on this platform");
+    return false;
+#endif
+}
+
 bool Socket::set_socket_rcvbuf(int socket, int size)
 {
     return sihd::sys::os::setsockopt(socket, SOL_SOCKET, SO_RCVBUF, &size, sizeof(int));
@@ -394,6 +439,18 @@ bool Socket::is_reuseport() const
     return Socket::is_socket_reuseport(_socket);
 }
 #endif
+bool Socket::set_udp_gro(bool active) const
+{
+    return Socket::set_socket_udp_gro(_socket, active);
+}
+bool Socket::set_timestamping(bool active) const
+{
+    return Socket::set_socket_timestamping(_socket, active);
+}
+bool Socket::set_busy_poll(int microseconds) const
+{
+    return Socket::set_socket_busy_poll(_socket, microseconds);
+}
 bool Socket::set_rcvbuf(int size) const
 {
     return Socket::set_socket_rcvbuf(_socket, size);
@@ -667,6 +724,58 @@ ssize_t Socket::receive(sihd::util::IArray & arr)
     return _adapt_array_size(arr, this->receive(arr.buf(), arr.byte_capacity()));
 }
 
+ssize_t Socket::receive_timestamped(void *data, size_t size, sihd::util::Timestamp & timestamp)
+{
+    timestamp = 0;
+#if defined(SIHD_HAS_KERNEL_TIMESTAMPS)
+    if (this->is_open() == false)
+        throw std::runtime_error("Socket: cannot receive on a closed socket");
+    alignas(cmsghdr) char control[timestamping::control_size];
+    iovec iov = {data, size};
+    msghdr hdr = {};
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+    hdr.msg_control = control;
+    hdr.msg_controllen = sizeof(control);
+    ssize_t rcv = ::recvmsg(_socket, &hdr, _rcv_flags);
+    if (rcv < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        SIHD_LOG(error, "Socket receive error: {}", sihd::sys::os::last_error_str());
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); rcv >= 0 && cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg))
+    {
+        if (timestamping::read(cmsg, timestamp))
+            break;
+    }
+    return rcv;
+#else
+    return this->receive(data, size);
+#endif
+}
+
+ssize_t Socket::receive_timestamped(sihd::util::IArray & arr, sihd::util::Timestamp & timestamp)
+{
+    return _adapt_array_size(arr, this->receive_timestamped(arr.buf(), arr.byte_capacity(), timestamp));
+}
+
+ssize_t Socket::receive_batch(DatagramBatch & batch)
+{
+    if (this->is_open() == false)
+        throw std::runtime_error("Socket: cannot receive_batch on a closed socket");
+    ssize_t rcv = batch.receive(_socket, _rcv_flags);
+    if (rcv < 0)
+        SIHD_LOG(error, "Socket receive_batch error: {}", sihd::sys::os::last_error_str());
+    return rcv;
+}
+
+ssize_t Socket::send_batch(const DatagramBatch & batch, bool gso)
+{
+    if (this->is_open() == false)
+        throw std::runtime_error("Socket: cannot send_batch on a closed socket");
+    ssize_t sent = batch.send(_socket, gso, _send_flags);
+    if (sent < 0 && _verbose)
+        SIHD_LOG(warning, "Socket send_batch error: {}", sihd::sys::os::last_error_str());
+    return sent;
+}
+
 ssize_t Socket::send_to(const sockaddr *addr, socklen_t addr_len, sihd::util::ArrCharView view)
 {
     if (this->is_open() == false)
@@ -1,6 +1,12 @@
+#include <thread>
+
+#include <fmt/format.h>
+
 #include <sihd/net/TcpServer.hpp>
 #include <sihd/sys/NamedFactory.hpp>
+#include <sihd/sys/os.hpp>
 #include <sihd/util/Logger.hpp>
+#include <sihd/util/thread.hpp>
 
 namespace sihd::net
 {
@@ -12,19 +18,99 @@ SIHD_REGISTER_FACTORY(TcpServer)
 
 SIHD_LOGGER;
 
+namespace
+{
+
+// false if the listening socket is closed
+bool dispatch_events(sihd::sys::Poll *poll, INetServer *server, INetServerHandler *handler, int listen_socket)
+{
+    if (poll->polling_timeout())
+        handler->handle_no_activity(server, poll->polling_time());
+    else
+        handler->handle_activity(server, poll->polling_time());
+    bool listening = true;
+    auto events = poll->events();
+    for (const auto & event : events)
+    {
+        if (event.fd == listen_socket)
+        {
+            if (event.readable)
+                handler->handle_new_client(server);
+            else if (event.closed || event.error)
+            {
+                listening = false;
+                break;
+            }
+        }
+        else if (event.readable)
+        {
+            handler->handle_client_read(server, event.fd);
+        }
+        else if (event.writable)
+        {
+            handler->handle_client_write(server, event.fd);
+        }
+    }
+    handler->handle_after_activity(server);
+    return listening;
+}
+
+} // namespace
+
+class TcpServer::Reactor: public INetServer,
+                          public sihd::util::IHandler<sihd::sys::Poll *>
+{
+    public:
+        Reactor(TcpServer *server, INetServerHandler *handler): server(server), handler(handler)
+        {
+            poll.set_service_wait_stop(true);
+            poll.add_observer(this);
+        }
+
+        // INetServer
+        int accept_client(IpAddr *client_ip, int timeout_ms) override
+        {
+            if (client_ip != nullptr)
+                return socket.accept(*client_ip, timeout_ms);
+            return socket.accept(timeout_ms);
+        }
+        bool add_client_read(int socket) override { return poll.set_read_fd(socket); }
+        bool add_client_write(int socket) override { return poll.set_write_fd(socket); }
+        bool remove_client_read(int socket) override { return poll.rm_read_fd(socket); }
+        bool remove_client_write(int socket) override { return poll.rm_write_fd(socket); }
+
+        void handle(sihd::sys::Poll *poll) override
+        {
+            // stopping the server would wait for its start, which joins this thread
+            if (!dispatch_events(poll, this, handler, socket.socket()))
+                server->_reactor_failed();
+        }
+
+        TcpServer *server;
+        INetServerHandler *handler;
+        Socket socket;
+        sihd::sys::Poll poll;
+        std::thread thread;
+};
+
 TcpServer::TcpServer(const std::string & name, sihd::util::Node *parent): sihd::util::Named(name, parent)
 {
     _server_handler_ptr = nullptr;
+    _reactor_error = false;
     _poll.set_service_wait_stop(true);
     _poll.add_observer(this);
 
     this->set_queue_size(50);
     this->set_poll_timeout(10);
     this->set_poll_limit(10);
+    if (sihd::sys::Poll::is_backend_available(sihd::sys::PollBackend::epoll))
+        _poll.set_backend(sihd::sys::PollBackend::epoll);
 
     this->add_conf("queue_size", &TcpServer::set_queue_size);
     this->add_conf("poll_timeout", &TcpServer::set_poll_timeout);
     this->add_conf("poll_limit", &TcpServer::set_poll_limit);
+    this->add_conf("poll_backend", &TcpServer::set_poll_backend);
+    this->add_conf("reactors", &TcpServer::set_reactors);
 }
 
 TcpServer::~TcpServer()
@@ -44,11 +130,47 @@ bool TcpServer::set_poll_limit(int limit)
     return _poll.set_limit(limit);
 }
 
+bool TcpServer::set_poll_backend(std::string_view backend)
+{
+    return _poll.set_backend(backend);
+}
+
 bool TcpServer::set_poll_timeout(int milliseconds)
 {
     return _poll.set_timeout(milliseconds);
 }
 
+bool TcpServer::set_reactors(size_t count)
+{
+    if (count == 0)
+        return false;
+    if (this->is_running())
+    {
+        SIHD_LOG(error, "TcpServer: cannot change reactors while running");
+        return false;
+    }
+    _reactor_handlers.resize(count - 1, nullptr);
+    if (count > 1 && _socket.is_open())
+        return _socket.set_reuseport(true);
+    return true;
+}
+
+bool TcpServer::set_reactor_handler(size_t reactor, INetServerHandler *handler)
+{
+    if (reactor == 0)
+    {
+        this->set_server_handler(handler);
+        return true;
+    }
+    if (reactor > _reactor_handlers.size())
+    {
+        SIHD_LOG(error, "TcpServer: no reactor {}", reactor);
+        return false;
+    }
+    _reactor_handlers[reactor - 1] = handler;
+    return true;
+}
+
 bool TcpServer::open_socket_unix()
 {
     if (_socket.is_open())
@@ -62,7 +184,11 @@ bool TcpServer::open_socket(bool ipv6)
         return false;
     bool ret = _socket.open(ipv6 ? AF_INET6 : AF_INET, SOCK_STREAM, IPPROTO_TCP);
     if (ret)
+    {
         _socket.set_reuseaddr(true);
+        if (!_reactor_handlers.empty())
+            ret = _socket.set_reuseport(true);
+    }
     return ret;
 }
 
@@ -131,6 +257,80 @@ bool TcpServer::remove_client_write(int socket)
     return _poll.rm_write_fd(socket);
 }
 
+bool TcpServer::_start_reactors()
+{
+    if (_reactor_handlers.empty())
+        return true;
+    if (_socket.domain() != AF_INET && _socket.domain() != AF_INET6)
+    {
+        SIHD_LOG(error, "TcpServer: reactors need an ip socket");
+        return false;
+    }
+    sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    if (::getsockname(_socket.socket(), (sockaddr *)&addr, &addr_len) != 0)
+    {
+        SIHD_LOG(error, "TcpServer: cannot get the address of the server: {}", sihd::sys::os::last_error_str());
+        return false;
+    }
+    // handlers are called concurrently by the reactors: they cannot be shared
+    for (size_t i = 0; i < _reactor_handlers.size(); ++i)
+    {
+        if (_reactor_handlers[i] == nullptr)
+        {
+            SIHD_LOG(error, "TcpServer: no handler for reactor {}", i + 1);
+            return false;
+        }
+    }
+    _reactors.reserve(_reactor_handlers.size());
+    for (size_t i = 0; i < _reactor_handlers.size(); ++i)
+    {
+        auto reactor = std::make_unique<Reactor>(this, _reactor_handlers[i]);
+        Socket & socket = reactor->socket;
+        if (!socket.open(_socket.domain(), SOCK_STREAM, IPPROTO_TCP) || !socket.set_reuseaddr(true)
+            || !socket.set_reuseport(true) || !socket.bind((sockaddr *)&addr, addr_len)
+            || !socket.listen(this->queue_size()))
+        {
+            SIHD_LOG(error, "TcpServer: cannot listen on reactor {}", i + 1);
+            return false;
+        }
+        sihd::sys::Poll & poll = reactor->poll;
+        poll.set_timeout(_poll.timeout());
+        poll.set_limit(_poll.max_fds());
+        poll.set_backend(_poll.backend());
+        poll.set_read_fd(socket.socket());
+        Reactor *reactor_ptr = reactor.get();
+        reactor->thread = std::thread([this, reactor_ptr, i] {
+            sihd::util::thread::set_name(fmt::format("{}[{}]", this->name(), i + 1));
+            reactor_ptr->poll.start();
+        });
+        _reactors.emplace_back(std::move(reactor));
+        // not stopped before it polls
+        reactor_ptr->poll.wait_ready(std::chrono::seconds(1));
+    }
+    return true;
+}
+
+void TcpServer::_reactor_failed()
+{
+    _reactor_error = true;
+    _poll.stop();
+}
+
+void TcpServer::_stop_reactors()
+{
+    for (auto & reactor : _reactors)
+        reactor->poll.stop();
+    for (auto & reactor : _reactors)
+    {
+        if (reactor->thread.joinable())
+            reactor->thread.join();
+        reactor->socket.shutdown();
+        reactor->socket.close();
+    }
+    _reactors.clear();
+}
+
 bool TcpServer::on_start()
 {
     bool ret = _poll.is_running();
@@ -139,10 +339,17 @@ bool TcpServer::on_start()
         this->_setup_poll();
         if ((ret = _server_handler_ptr != nullptr))
         {
-            if ((ret = _socket.listen(this->queue_size())))
+            _reactor_error = false;
+            if ((ret = _socket.listen(this->queue_size()) && this->_start_reactors()))
             {
                 this->service_set_ready();
-                ret = _poll.start();
+                ret = !_reactor_error && _poll.start();
+            }
+            this->_stop_reactors();
+            if (_reactor_error)
+            {
+                SIHD_LOG(error, "TcpServer: a reactor stopped listening");
+                ret = false;
             }
         }
         else
@@ -162,33 +369,8 @@ bool TcpServer::on_stop()
 
 void TcpServer::handle(sihd::sys::Poll *poll)
 {
-    if (poll->polling_timeout())
-        _server_handler_ptr->handle_no_activity(this, poll->polling_time());
-    else
-        _server_handler_ptr->handle_activity(this, poll->polling_time());
-    auto events = poll->events();
-    for (const auto & event : events)
-    {
-        if (event.fd == _socket.socket())
-        {
-            if (event.readable)
-                _server_handler_ptr->handle_new_client(this);
-            else if (event.closed || event.error)
-            {
-                this->stop();
-                break;
-            }
-        }
-        else if (event.readable)
-        {
-            _server_handler_ptr->handle_client_read(this, event.fd);
-        }
-        else if (event.writable)
-        {
-            _server_handler_ptr->handle_client_write(this, event.fd);
-        }
-    }
-    _server_handler_ptr->handle_after_activity(this);
+    if (!dispatch_events(poll, this, _server_handler_ptr, _socket.socket()))
+        this->stop();
 }
 
-} // namespace sihd::net
\ No newline at end of file
+} // namespace sihd::net
@@ -1,6 +1,8 @@
 #include <sihd/net/UdpReceiver.hpp>
 #include <sihd/sys/NamedFactory.hpp>
+#include <sihd/util/Clocks.hpp>
 #include <sihd/util/Logger.hpp>
+#include <sihd/util/time.hpp>
 
 namespace sihd::net
 {
@@ -9,13 +11,17 @@ SIHD_REGISTER_FACTORY(UdpReceiver)
 
 SIHD_LOGGER;
 
-UdpReceiver::UdpReceiver(const std::string & name, sihd::util::Node *parent): sihd::util::Named(name, parent)
+UdpReceiver::UdpReceiver(const std::string & name, sihd::util::Node *parent):
+    sihd::util::Named(name, parent),
+    _busy_poll_us(0),
+    _busy_poll_stop(false)
 {
     _poll.set_timeout(1);
     _poll.set_limit(1);
     _poll.add_observer(this);
     _poll.set_service_wait_stop(true);
     this->add_conf("poll_timeout", &UdpReceiver::set_poll_timeout);
+    this->add_conf("busy_poll", &UdpReceiver::set_busy_poll);
 }
 
 UdpReceiver::~UdpReceiver()
@@ -29,6 +35,31 @@ bool UdpReceiver::set_poll_timeout(int milliseconds)
     return _poll.set_timeout(milliseconds);
 }
 
+bool UdpReceiver::set_busy_poll(int microseconds)
+{
+    if (microseconds < 0)
+    {
+        SIHD_LOG(error, "UdpReceiver: busy poll cannot be negative");
+        return false;
+    }
+    if (this->is_running())
+    {
+        SIHD_LOG(error, "UdpReceiver: cannot change busy poll while running");
+        return false;
+    }
+    _busy_poll_us = microseconds;
+    if (_socket.is_open())
+        this->_setup_busy_poll();
+    return true;
+}
+
+void UdpReceiver::_setup_busy_poll()
+{
+    // the spin does not depend on it
+    if (_busy_poll_us > 0 && !_socket.is_unix() && !_socket.set_busy_poll(_busy_poll_us))
+        SIHD_LOG(warning, "UdpReceiver: cannot set the socket busy poll");
+}
+
 bool UdpReceiver::open_socket_unix()
 {
     if (_socket.is_open())
@@ -42,7 +73,10 @@ bool UdpReceiver::open_socket(bool ipv6)
         return false;
     bool ret = _socket.open(ipv6 ? AF_INET6 : AF_INET, SOCK_DGRAM, IPPROTO_UDP);
     if (ret)
+    {
         _socket.set_reuseaddr(true);
+        this->_setup_busy_poll();
+    }
     return ret;
 }
 
@@ -80,6 +114,7 @@ bool UdpReceiver::close()
 
 bool UdpReceiver::on_stop()
 {
+    _busy_poll_stop = true;
     _poll.stop();
     _poll.clear_fds();
     return true;
@@ -94,11 +129,39 @@ void UdpReceiver::_setup_poll()
 bool UdpReceiver::on_start()
 {
     this->_setup_poll();
+    if (_busy_poll_us > 0)
+        return this->_busy_poll_loop();
     this->service_set_ready();
     std::lock_guard lock(_poll_mutex);
     return _poll.start();
 }
 
+bool UdpReceiver::_busy_poll_loop()
+{
+    const sihd::util::Duration budget = sihd::util::time::microseconds(_busy_poll_us);
+    sihd::util::SteadyClock clock;
+    // a stop following wait_ready() is not missed
+    _busy_poll_stop = false;
+    this->service_set_ready();
+
+    sihd::util::Timestamp spin_until = clock.now() + budget;
+    while (_busy_poll_stop == false)
+    {
+        int ret = _poll.poll(0);
+        if (ret == 0 && clock.now() < spin_until)
+            continue;
+        // spun without datagram: gives the core back until the next one
+        if (ret == 0)
+            ret = _poll.poll(_poll.timeout());
+        if (ret < 0)
+            return false;
+        // an idle timeout does not spin again
+        if (ret > 0)
+            spin_until = clock.now() + budget;
+    }
+    return true;
+}
+
 bool UdpReceiver::poll(int milliseconds)
 {
     this->_setup_poll();
@@ -146,6 +209,16 @@ ssize_t UdpReceiver::receive(IpAddr & addr, void *buf, size_t len)
     return _socket.receive_from(addr, buf, len);
 }
 
+ssize_t UdpReceiver::receive_timestamped(sihd::util::IArray & arr, sihd::util::Timestamp & timestamp)
+{
+    return _socket.receive_timestamped(arr, timestamp);
+}
+
+ssize_t UdpReceiver::receive_batch(DatagramBatch & batch)
+{
+    return _socket.receive_batch(batch);
+}
+
 ssize_t UdpReceiver::receive(IpAddr & addr, sihd::util::IArray & arr)
 {
     return _socket.receive_from(addr, arr);
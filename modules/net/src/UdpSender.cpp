@@ -74,4 +74,9 @@ bool UdpSender::send_to_all(const IpAddr & addr, sihd::util::ArrCharView view)
     return _socket.send_all_to(addr, view);
 }
 
+ssize_t UdpSender::send_batch(const DatagramBatch & batch, bool gso)
+{
+    return _socket.send_batch(batch, gso);
+}
+
 } // namespace sihd::net
\ No newline at end of file
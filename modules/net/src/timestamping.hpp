@@ -0,0 +1,46 @@
+#ifndef __SIHD_NET_SRC_TIMESTAMPING_HPP__
+#define __SIHD_NET_SRC_TIMESTAMPING_HPP__
+
+// Internal header
+// Kernel software receive timestamps read from the control messages of SO_TIMESTAMPNS and SO_TIMESTAMPING
+
+#include <cstring>
+
+#include <sihd/sys/platform.hpp>
+#include <sihd/util/Timestamp.hpp>
+
+// only available on Linux (not Cygwin, not Emscripten)
+#if defined(__SIHD_LINUX__) && !defined(__SIHD_EMSCRIPTEN__) && !defined(__CYGWIN__)
+# include <sys/socket.h>
+# include <time.h>
+# define SIHD_HAS_KERNEL_TIMESTAMPS 1
+#endif
+
+namespace sihd::net::timestamping
+{
+
+#if defined(SIHD_HAS_KERNEL_TIMESTAMPS)
+
+// room for the largest timestamp control message: software, deprecated and hardware timestamps
+constexpr size_t control_size = CMSG_SPACE(sizeof(timespec) * 3);
+
+// false if the control message is not a software receive timestamp
+inline bool read(const cmsghdr *cmsg, sihd::util::Timestamp & timestamp)
+{
+    if (cmsg->cmsg_level != SOL_SOCKET
+        || (cmsg->cmsg_type != SCM_TIMESTAMPNS && cmsg->cmsg_type != SCM_TIMESTAMPING))
+        return false;
+    // first timespec of both messages
+    timespec ts;
+    memcpy(&ts, CMSG_DATA(cmsg), sizeof(timespec));
+    if (ts.tv_sec == 0 && ts.tv_nsec == 0)
+        return false;
+    timestamp = sihd::util::Timestamp(ts);
+    return true;
+}
+
+#endif
+
+} // namespace sihd::net::timestamping
+
+#endif
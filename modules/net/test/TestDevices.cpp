@@ -7,6 +7,8 @@
 #include <sihd/net/DeviceUdpReceiver.hpp>
 #include <sihd/net/DeviceUdpSender.hpp>
 #include <sihd/net/Socket.hpp>
+#include <sihd/net/UdpSender.hpp>
+#include <sihd/util/Clocks.hpp>
 #include <sihd/util/Logger.hpp>
 
 namespace test
@@ -65,6 +67,120 @@ TEST_F(TestDevices, test_udp_devices)
     EXPECT_FALSE(receiver->is_running());
 }
 
+TEST_F(TestDevices, test_udp_receiver_batch)
+{
+    Core core;
+
+    auto *receiver = core.add_child<DeviceUdpReceiver>("receiver");
+    receiver->set_host("127.0.0.1");
+    receiver->set_port(4302);
+    receiver->set_poll_timeout(1);
+    receiver->set_buffer_capacity(64);
+    EXPECT_FALSE(receiver->set_batch_size(0));
+    EXPECT_TRUE(receiver->set_batch_size(8));
+
+    ASSERT_TRUE(core.init());
+
+    Channel *rx = receiver->find_channel("rx");
+    Channel *rx_batch = receiver->find_channel("rx_batch");
+    Channel *rx_sizes = receiver->find_channel("rx_sizes");
+    ASSERT_NE(rx, nullptr);
+    ASSERT_NE(rx_batch, nullptr);
+    ASSERT_NE(rx_sizes, nullptr);
+    EXPECT_EQ(rx_batch->size(), 8u * 64u);
+    EXPECT_EQ(rx_sizes->size(), 8u);
+
+    std::vector<std::string> received;
+    size_t rx_writes = 0;
+    sihd::util::Handler<Channel *> rx_counter([&rx_writes](Channel *) { ++rx_writes; });
+    // batch channels are published together
+    sihd::util::Handler<Channel *> batch_reader([&received, rx_batch](Channel *sizes) {
+        EXPECT_EQ(sizes->timestamp(), rx_batch->timestamp());
+        for (size_t i = 0; i < sizes->size(); ++i)
+        {
+            const uint32_t size = sizes->read<uint32_t>(i);
+            if (size > 0)
+                received.emplace_back((const char *)rx_batch->data() + i * 64, size);
+        }
+    });
+    rx->add_observer(&rx_counter);
+    rx_sizes->add_observer(&batch_reader);
+
+    ASSERT_TRUE(core.start());
+
+    UdpSender sender("sender");
+    ASSERT_TRUE(sender.open_and_connect({"127.0.0.1", 4302}));
+    DatagramBatch batch(5, 64);
+    std::vector<std::string> sent;
+    for (int i = 0; i < 5; ++i)
+    {
+        sent.push_back(fmt::format("datagram-{}", i));
+        EXPECT_TRUE(batch.push(sent.back()));
+    }
+
+    ChannelWaiter waiter(rx);
+    EXPECT_EQ(sender.send_batch(batch), 5);
+    EXPECT_TRUE(waiter.wait_for_nb(std::chrono::milliseconds(500), 5));
+
+    // identical batches are published
+    ChannelWaiter sizes_waiter(rx_sizes);
+    EXPECT_EQ(sender.send(sent.back()), (ssize_t)sent.back().size());
+    ASSERT_TRUE(sizes_waiter.wait_for_nb(std::chrono::milliseconds(500), 1));
+    EXPECT_EQ(sender.send(sent.back()), (ssize_t)sent.back().size());
+    ASSERT_TRUE(sizes_waiter.wait_for_nb(std::chrono::milliseconds(500), 2));
+    sent.push_back(sent.back());
+    sent.push_back(sent.back());
+
+    ASSERT_TRUE(core.stop());
+
+    EXPECT_EQ(rx_writes, 5u);
+    EXPECT_EQ(received, sent);
+    EXPECT_EQ(rx->byte_size(), sent.back().size());
+}
+
+TEST_F(TestDevices, test_udp_receiver_kernel_timestamp)
+{
+    Core core;
+
+    auto *receiver = core.add_child<DeviceUdpReceiver>("receiver");
+    receiver->set_host("127.0.0.1");
+    receiver->set_port(4303);
+    receiver->set_poll_timeout(1);
+    receiver->set_kernel_timestamp(true);
+    EXPECT_TRUE(receiver->set_busy_poll(100));
+
+    ASSERT_TRUE(core.init());
+
+    Channel *rx = receiver->find_channel("rx");
+    ASSERT_NE(rx, nullptr);
+    // far from the system clock of kernel timestamps
+    sihd::util::SteadyClock steady_clock;
+    rx->set_clock(&steady_clock);
+
+    ASSERT_TRUE(core.start());
+
+    UdpSender sender("sender");
+    ASSERT_TRUE(sender.open_and_connect({"127.0.0.1", 4303}));
+
+    sihd::util::SystemClock system_clock;
+    ChannelWaiter waiter(rx);
+    const sihd::util::Timestamp before = system_clock.now();
+    const char hello[] = "hello timestamp";
+    EXPECT_EQ(sender.send(hello), (ssize_t)strlen(hello));
+    ASSERT_TRUE(waiter.wait_for(std::chrono::milliseconds(500)));
+
+    // kernel timestamps are not available on every platform
+    Socket probe(AF_INET, SOCK_DGRAM, 0);
+    if (probe.set_timestamping(true))
+    {
+        EXPECT_GE(rx->timestamp(), before);
+        EXPECT_LE(rx->timestamp(), system_clock.now());
+    }
+    EXPECT_EQ(rx->byte_size(), strlen(hello));
+
+    ASSERT_TRUE(core.stop());
+}
+
 TEST_F(TestDevices, test_tcp_client_device)
 {
     Socket server;
@@ -1,11 +1,20 @@
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <thread>
+#include <vector>
 
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
 #include <gtest/gtest.h>
 
 #include <sihd/net/BasicServerHandler.hpp>
 #include <sihd/net/TcpClient.hpp>
 #include <sihd/net/TcpServer.hpp>
+#include <sihd/util/Handler.hpp>
 #include <sihd/util/Logger.hpp>
 #include <sihd/util/ObserverWaiter.hpp>
 #include <sihd/util/Worker.hpp>
@@ -63,7 +72,7 @@ TEST_F(TestTcp, test_tcp_server)
         }
         for (auto & client : srv->write_activity())
         {
-            SIHD_LOG(info, "Server wrote to client: {}", client->write_array.str(','));
+            SIHD_LOG(info, "Server wrote to client: {}", client->fd());
         }
     });
     server_handler.add_observer(&handler);
@@ -249,4 +258,279 @@ TEST_F(TestTcp, test_tcp_reconnect)
     EXPECT_TRUE(server.close());
 }
 
+TEST_F(TestTcp, test_tcp_server_reactors)
+{
+    IpAddr localhost = IpAddr::localhost(4243);
+    constexpr size_t reactors = 4;
+    constexpr size_t clients = 40;
+
+    TcpServer server("tcp-server");
+    EXPECT_TRUE(server.set_reactors(reactors));
+    EXPECT_EQ(server.reactors(), reactors);
+
+    // one handler per reactor
+    std::vector<std::unique_ptr<BasicServerHandler>> handlers;
+    std::vector<std::unique_ptr<sihd::util::Handler<BasicServerHandler *>>> echoes;
+    for (size_t i = 0; i < reactors; ++i)
+    {
+        auto & handler = handlers.emplace_back(std::make_unique<BasicServerHandler>());
+        auto & echo = echoes.emplace_back(
+            std::make_unique<sihd::util::Handler<BasicServerHandler *>>([](BasicServerHandler *srv) {
+                for (auto & client : srv->read_activity())
+                {
+                    if (!client->disconnected && !client->error)
+                        srv->send_to_client(client, client->read_array);
+                }
+            }));
+        handler->add_observer(echo.get());
+        EXPECT_TRUE(server.set_reactor_handler(i, handler.get()));
+    }
+    EXPECT_FALSE(server.set_reactor_handler(reactors, handlers[0].get()));
+
+    ASSERT_TRUE(server.open_and_bind(localhost));
+    server.set_poll_timeout(1);
+    // limit of each reactor
+    server.set_poll_limit(clients + 1);
+    server.set_queue_size(clients);
+
+    Worker worker([&server] { return server.start(); });
+    EXPECT_TRUE(worker.start_sync_worker("tcp-server"));
+    ASSERT_TRUE(server.wait_ready(std::chrono::seconds(1)));
+
+    auto wait_for = [](auto pred) {
+        for (int i = 0; i < 200 && !pred(); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    };
+    auto total_clients = [&handlers] {
+        size_t total = 0;
+        for (auto & handler : handlers)
+            total += handler->client_count();
+        return total;
+    };
+
+    std::vector<std::unique_ptr<TcpClient>> tcp_clients;
+    for (size_t i = 0; i < clients; ++i)
+    {
+        auto & client = tcp_clients.emplace_back(std::make_unique<TcpClient>(fmt::format("tcp-client-{}", i)));
+        EXPECT_TRUE(client->open_and_connect(localhost, connect_timeout_ms));
+    }
+    wait_for([&] { return total_clients() == clients; });
+    EXPECT_EQ(total_clients(), clients);
+
+    // the kernel spread the connections between the reactors
+    size_t reactors_used = 0;
+    for (auto & handler : handlers)
+        reactors_used += handler->client_count() > 0;
+    EXPECT_GT(reactors_used, 1u);
+
+    // each reactor serves its clients
+    sihd::util::ArrChar hello("hello");
+    for (auto & client : tcp_clients)
+    {
+        EXPECT_TRUE(client->send_all(hello));
+        char response[16] = {0};
+        EXPECT_EQ(client->receive(response, sizeof(response)), (ssize_t)hello.size());
+        EXPECT_STREQ(response, "hello");
+    }
+
+    EXPECT_TRUE(server.stop());
+    EXPECT_TRUE(worker.stop_worker());
+    EXPECT_TRUE(server.set_reactors(1));
+}
+
+TEST_F(TestTcp, test_tcp_server_reactors_handlers)
+{
+    TcpServer server("tcp-server");
+    BasicServerHandler server_handler;
+    server.set_server_handler(&server_handler);
+    EXPECT_TRUE(server.set_reactors(2));
+    ASSERT_TRUE(server.open_and_bind(IpAddr::localhost(4246)));
+    // the server handler cannot be shared with another reactor
+    EXPECT_FALSE(server.start());
+    EXPECT_TRUE(server.close());
+}
+
+TEST_F(TestTcp, test_tcp_server_reactor_closed)
+{
+    constexpr int port = 4248;
+    TcpServer server("tcp-server");
+    BasicServerHandler server_handler;
+    BasicServerHandler reactor_handler;
+    server.set_server_handler(&server_handler);
+    EXPECT_TRUE(server.set_reactors(2));
+    EXPECT_TRUE(server.set_reactor_handler(1, &reactor_handler));
+    ASSERT_TRUE(server.open_and_bind(IpAddr::localhost(port)));
+    server.set_poll_timeout(1);
+
+    std::atomic<bool> done = false;
+    std::atomic<bool> started = true;
+    std::thread thread([&] {
+        started = server.start();
+        done = true;
+    });
+    ASSERT_TRUE(server.wait_ready(std::chrono::seconds(1)));
+
+    // the listening socket of the reactor is the other one bound to the port
+    int reactor_fd = -1;
+    for (int fd = 0; fd < 1024 && reactor_fd < 0; ++fd)
+    {
+        int listening = 0;
+        socklen_t len = sizeof(listening);
+        struct sockaddr_in addr = {};
+        socklen_t addr_len = sizeof(addr);
+        if (fd != server.socket().socket()
+            && getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &listening, &len) == 0 && listening
+            && getsockname(fd, (struct sockaddr *)&addr, &addr_len) == 0 && addr.sin_family == AF_INET
+            && ntohs(addr.sin_port) == port)
+            reactor_fd = fd;
+    }
+    ASSERT_GE(reactor_fd, 0);
+    EXPECT_EQ(shutdown(reactor_fd, SHUT_RDWR), 0);
+
+    // the reactor stops the server without waiting for the thread joining it
+    for (int i = 0; i < 200 && !done; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_TRUE(done);
+    thread.join();
+    EXPECT_FALSE(started);
+    EXPECT_TRUE(server.close());
+}
+
+TEST_F(TestTcp, test_tcp_server_write_queue)
+{
+    IpAddr localhost = IpAddr::localhost(4244);
+    // more than the socket buffers: the queue cannot be sent at once
+    constexpr size_t payload_size = 8 * 1024 * 1024;
+
+    TcpServer server("tcp-server");
+    BasicServerHandler server_handler;
+    TcpClient client("tcp-client");
+
+    std::atomic<int> high_watermarks = 0;
+    std::atomic<int> low_watermarks = 0;
+    EXPECT_TRUE(server_handler.set_write_high_watermark(payload_size / 2));
+    EXPECT_TRUE(server_handler.set_write_low_watermark(1024));
+    server_handler.set_high_watermark_callback([&](const BasicServerHandler::ClientPtr &) { ++high_watermarks; });
+    server_handler.set_low_watermark_callback([&](const BasicServerHandler::ClientPtr &) { ++low_watermarks; });
+
+    ASSERT_TRUE(server.open_and_bind(localhost));
+    server.set_server_handler(&server_handler);
+    server.set_poll_timeout(1);
+
+    Worker worker([&server] { return server.start(); });
+    EXPECT_TRUE(worker.start_sync_worker("tcp-server"));
+    ASSERT_TRUE(server.wait_ready(std::chrono::seconds(1)));
+
+    ASSERT_TRUE(client.open_and_connect(localhost, connect_timeout_ms));
+    for (int i = 0; i < 200 && server_handler.client_count() == 0; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(server_handler.client_count(), 1u);
+    BasicServerHandler::ClientPtr server_client = server_handler.clients()[0];
+
+    // sends are queued in order instead of replacing each other
+    sihd::util::ArrChar hello("hello ");
+    sihd::util::ArrChar world("world");
+    EXPECT_TRUE(server_handler.send_to_client(server_client, hello));
+    EXPECT_TRUE(server_handler.send_to_client(server_client, world));
+
+    // caller owned buffer released once sent
+    std::vector<uint8_t> payload(payload_size);
+    for (size_t i = 0; i < payload.size(); ++i)
+        payload[i] = i % 251;
+    std::atomic<bool> released = false;
+    EXPECT_TRUE(server_handler.send_to_client(server_client, payload.data(), payload.size(), [&released] {
+        released = true;
+    }));
+    EXPECT_EQ(high_watermarks, 1);
+    EXPECT_GT(server_client->pending_write_bytes(), 0u);
+
+    std::vector<uint8_t> received;
+    received.reserve(payload_size + 11);
+    std::vector<uint8_t> buffer(64 * 1024);
+    while (received.size() < payload_size + 11)
+    {
+        ssize_t ret = client.receive(buffer.data(), buffer.size());
+        ASSERT_GT(ret, 0);
+        received.insert(received.end(), buffer.begin(), buffer.begin() + ret);
+    }
+    EXPECT_EQ(std::string(received.begin(), received.begin() + 11), "hello world");
+    EXPECT_TRUE(std::equal(payload.begin(), payload.end(), received.begin() + 11));
+
+    for (int i = 0; i < 200 && !released; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_TRUE(released);
+    EXPECT_EQ(low_watermarks, 1);
+    EXPECT_EQ(server_client->pending_write_bytes(), 0u);
+
+    // unsent data is released when the client is removed
+    std::atomic<int> dropped = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(server_handler.send_to_client(server_client, payload.data(), payload.size(), [&dropped] {
+            ++dropped;
+        }));
+    }
+    EXPECT_TRUE(server_handler.remove_client(server_client));
+    EXPECT_EQ(dropped, 4);
+    // released on failure
+    EXPECT_FALSE(server_handler.send_to_client(server_client, payload.data(), payload.size(), [&dropped] {
+        ++dropped;
+    }));
+    EXPECT_EQ(dropped, 5);
+
+    client.close();
+    EXPECT_TRUE(server.stop());
+    EXPECT_TRUE(worker.stop_worker());
+}
+
+// accepts one end of a socket pair, registering write interest can fail
+class StubServer: public INetServer
+{
+    public:
+        int accept_client(IpAddr *, int) override { return accepted; }
+        bool add_client_read(int) override { return true; }
+        bool add_client_write(int) override
+        {
+            writes += can_write;
+            return can_write;
+        }
+        bool remove_client_read(int) override { return true; }
+        bool remove_client_write(int) override { return true; }
+
+        int accepted = -1;
+        bool can_write = false;
+        int writes = 0;
+};
+
+TEST_F(TestTcp, test_tcp_server_write_queue_interest_failure)
+{
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    StubServer server;
+    server.accepted = fds[0];
+    BasicServerHandler server_handler;
+    INetServerHandler & handler = server_handler;
+    handler.handle_new_client(&server);
+    ASSERT_EQ(server_handler.client_count(), 1u);
+    BasicServerHandler::ClientPtr server_client = server_handler.clients()[0];
+
+    // not queued when nothing would send it
+    bool released = false;
+    const char hello[] = "hello";
+    EXPECT_FALSE(server_handler.send_to_client(server_client, hello, sizeof(hello), [&released] {
+        released = true;
+    }));
+    EXPECT_TRUE(released);
+    EXPECT_EQ(server_client->pending_write_bytes(), 0u);
+
+    // the next send registers the write interest again
+    server.can_write = true;
+    EXPECT_TRUE(server_handler.send_to_client(server_client, sihd::util::ArrChar("world")));
+    EXPECT_EQ(server.writes, 1);
+    EXPECT_EQ(server_client->pending_write_bytes(), 5u);
+
+    EXPECT_TRUE(server_handler.remove_client(server_client));
+    ::close(fds[1]);
+}
+
 } // namespace test
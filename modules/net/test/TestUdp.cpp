@@ -1,9 +1,13 @@
+#include <ctime>
+
 #include <gtest/gtest.h>
 
+#include <sihd/net/DatagramBatch.hpp>
 #include <sihd/net/INetReceiver.hpp>
 #include <sihd/net/UdpReceiver.hpp>
 #include <sihd/net/UdpSender.hpp>
 #include <sihd/util/Array.hpp>
+#include <sihd/util/Clocks.hpp>
 #include <sihd/util/Logger.hpp>
 #include <sihd/util/Synchronizer.hpp>
 #include <sihd/util/Worker.hpp>
@@ -119,4 +123,152 @@ TEST_F(TestUdp, test_udp_sendrcv_broadcast)
     EXPECT_EQ(array_rcv.size(), strlen(helloworld));
 }
 
+TEST_F(TestUdp, test_udp_batch)
+{
+    UdpSender sender("udp-sender");
+    UdpReceiver receiver("udp-receiver");
+    IpAddr addr("127.0.0.1", 4245);
+
+    ASSERT_TRUE(sender.open_socket());
+    ASSERT_TRUE(receiver.open_and_bind(addr));
+    ASSERT_TRUE(receiver.socket().set_blocking(false));
+
+    auto datagram_str = [](const DatagramBatch & batch, size_t idx) {
+        sihd::util::ArrByteView view = batch.data(idx);
+        return std::string((const char *)view.data(), view.size());
+    };
+
+    DatagramBatch batch(16, 1500);
+    EXPECT_EQ(batch.receive(receiver.socket().socket()), 0);
+
+    DatagramBatch to_send(16, 1500);
+    for (int i = 0; i < 10; ++i)
+        EXPECT_TRUE(to_send.push(addr, fmt::format("datagram-{}", i)));
+    EXPECT_EQ(sender.send_batch(to_send), 10);
+
+    ASSERT_EQ(receiver.receive_batch(batch), 10);
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        EXPECT_EQ(datagram_str(batch, i), fmt::format("datagram-{}", i));
+        ASSERT_TRUE(batch.address(i).has_value());
+        EXPECT_EQ(batch.address(i)->str(), "127.0.0.1");
+        EXPECT_FALSE(batch.truncated(i));
+    }
+
+    // segments of 100 bytes and a smaller last one
+    to_send.clear();
+    std::vector<std::string> payloads;
+    for (int i = 0; i < 8; ++i)
+        payloads.push_back(std::string(100, 'a' + i));
+    payloads.push_back(std::string(50, 'z'));
+    for (const std::string & payload : payloads)
+        EXPECT_TRUE(to_send.push(addr, payload));
+    EXPECT_FALSE(to_send.push(addr, std::string(1501, 'x')));
+    EXPECT_EQ(sender.send_batch(to_send, true), (ssize_t)payloads.size());
+
+    ASSERT_EQ(receiver.receive_batch(batch), (ssize_t)payloads.size());
+    for (size_t i = 0; i < batch.size(); ++i)
+        EXPECT_EQ(datagram_str(batch, i), payloads[i]);
+
+    // segments coalesced by the kernel are split back into datagrams
+    if (!receiver.socket().set_udp_gro(true))
+        GTEST_SKIP() << "UDP GRO is not available";
+    DatagramBatch gro_batch(4, DatagramBatch::max_datagram_size);
+    EXPECT_EQ(sender.send_batch(to_send, true), (ssize_t)payloads.size());
+    std::vector<std::string> received;
+    while (received.size() < payloads.size() && receiver.poll(100))
+    {
+        ASSERT_GT(receiver.receive_batch(gro_batch), 0);
+        for (size_t i = 0; i < gro_batch.size(); ++i)
+            received.push_back(datagram_str(gro_batch, i));
+    }
+    EXPECT_EQ(received, payloads);
+}
+
+TEST_F(TestUdp, test_udp_kernel_timestamps)
+{
+    UdpSender sender("udp-sender");
+    UdpReceiver receiver("udp-receiver");
+
+    ASSERT_TRUE(sender.open_and_connect({"127.0.0.1", 4246}));
+    ASSERT_TRUE(receiver.open_and_bind({"127.0.0.1", 4246}));
+    if (!receiver.socket().set_timestamping(true))
+        GTEST_SKIP() << "kernel timestamping is not available";
+
+    sihd::util::SystemClock clock;
+    sihd::util::ArrChar array_rcv(40);
+    sihd::util::Timestamp timestamp;
+
+    const sihd::util::Timestamp before = clock.now();
+    EXPECT_EQ(sender.send("hello"), 5);
+    ASSERT_TRUE(receiver.poll(100));
+    EXPECT_EQ(receiver.receive_timestamped(array_rcv, timestamp), 5);
+    // the kernel stamps at the system call until its deferred timestamping is enabled
+    const sihd::util::Timestamp after = clock.now();
+    EXPECT_TRUE(array_rcv.is_equal("hello"));
+    EXPECT_GE(timestamp, before);
+    EXPECT_LE(timestamp, after);
+
+    DatagramBatch batch(4, 64);
+    EXPECT_EQ(sender.send("world"), 5);
+    ASSERT_TRUE(receiver.poll(100));
+    ASSERT_EQ(receiver.receive_batch(batch), 1);
+    EXPECT_GE(batch.timestamp(0), after);
+    EXPECT_LE(batch.timestamp(0), clock.now());
+
+    // no timestamp once deactivated
+    EXPECT_TRUE(receiver.socket().set_timestamping(false));
+    EXPECT_EQ(sender.send("hello"), 5);
+    ASSERT_TRUE(receiver.poll(100));
+    EXPECT_EQ(receiver.receive_timestamped(array_rcv, timestamp), 5);
+    EXPECT_EQ(timestamp.get(), 0);
+}
+
+TEST_F(TestUdp, test_udp_busy_poll)
+{
+    UdpSender sender("udp-sender");
+    UdpReceiver receiver("udp-receiver");
+
+    ASSERT_TRUE(sender.open_and_connect({"127.0.0.1", 4247}));
+    ASSERT_TRUE(receiver.open_and_bind({"127.0.0.1", 4247}));
+    EXPECT_FALSE(receiver.set_busy_poll(-1));
+    EXPECT_TRUE(receiver.set_busy_poll(2000));
+    EXPECT_EQ(receiver.busy_poll(), 2000);
+    receiver.set_poll_timeout(1);
+
+    sihd::util::ArrChar array_rcv(40);
+    sihd::util::Synchronizer sync(2);
+    size_t received = 0;
+    sihd::util::Handler<INetReceiver *> handler([&](INetReceiver *rcv) {
+        if (rcv->receive(array_rcv) > 0 && ++received == 3)
+            (void)sync.sync(std::chrono::milliseconds(500));
+    });
+    receiver.add_observer(&handler);
+    sihd::util::Worker worker([&receiver] { return receiver.start(); });
+    ASSERT_TRUE(worker.start_sync_worker("receiver"));
+    ASSERT_TRUE(receiver.wait_ready(std::chrono::milliseconds(500)));
+    EXPECT_FALSE(receiver.set_busy_poll(100));
+    EXPECT_EQ(receiver.busy_poll(), 2000);
+
+    // idle: spins only after a datagram, not after every poll timeout
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    const std::clock_t cpu_before = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const double idle_cpu_ms = (double)(std::clock() - cpu_before) * 1000 / CLOCKS_PER_SEC;
+    EXPECT_LT(idle_cpu_ms, 30.0);
+
+    // while spinning, then once it gave the core back
+    EXPECT_EQ(sender.send("one"), 3);
+    EXPECT_EQ(sender.send("two"), 3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(sender.send("three"), 5);
+
+    EXPECT_TRUE(sync.sync(std::chrono::milliseconds(500)));
+    EXPECT_TRUE(array_rcv.is_equal("three"));
+
+    receiver.stop();
+    EXPECT_TRUE(worker.stop_worker());
+    EXPECT_FALSE(receiver.is_running());
+}
+
 } // namespace test
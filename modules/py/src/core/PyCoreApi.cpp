@@ -36,6 +36,51 @@ std::mutex g_mutex_channel_handler_map;
 std::map<sihd::core::Channel *, PySingleChannelHandler> g_single_channel_handler_map;
 PyCoreApi::PyChannelHandler g_channel_handler;
 
+pybind11::dict latency_to_dict(const LatencyStats & latency)
+{
+    pybind11::dict dict;
+    dict["samples"] = latency.samples;
+    dict["min"] = latency.min;
+    dict["average"] = latency.average;
+    dict["max"] = latency.max;
+    dict["median"] = latency.median;
+    dict["p95"] = latency.p95;
+    dict["p99"] = latency.p99;
+    return dict;
+}
+
+pybind11::dict channel_stats_to_dict(const ChannelStats & stats)
+{
+    pybind11::dict dict;
+    dict["path"] = stats.path;
+    dict["writes"] = stats.writes;
+    dict["bytes_written"] = stats.bytes_written;
+    dict["unchanged_writes"] = stats.unchanged_writes;
+    dict["rejected_writes"] = stats.rejected_writes;
+    dict["notifications"] = stats.notifications;
+    dict["lock_wait"] = latency_to_dict(stats.lock_wait);
+    dict["notify"] = latency_to_dict(stats.notify);
+    pybind11::list observers;
+    for (const ObserverStats & observer : stats.observers)
+    {
+        pybind11::dict observer_dict;
+        observer_dict["name"] = observer.name;
+        observer_dict["handle"] = latency_to_dict(observer.handle);
+        observers.append(observer_dict);
+    }
+    dict["observers"] = observers;
+    return dict;
+}
+
+pybind11::dict device_stats_to_dict(const DeviceStats & stats)
+{
+    pybind11::dict dict;
+    dict["path"] = stats.path;
+    dict["handled"] = stats.handled;
+    dict["handle"] = latency_to_dict(stats.handle);
+    return dict;
+}
+
 } // namespace
 
 void PyCoreApi::add_core_api(PyApi::PyModule & pymodule)
@@ -54,6 +99,8 @@ void PyCoreApi::add_core_api(PyApi::PyModule & pymodule)
         .def(pybind11::init<const std::string &, const std::string &, Node *>(), pybind11::keep_alive<1, 3>())
         .def(pybind11::init<const std::string &, const std::string &>())
         .def("set_write_on_change", &Channel::set_write_on_change)
+        .def("set_stats", &Channel::set_stats)
+        .def("stats", +[](const Channel *self) { return channel_stats_to_dict(self->stats()); })
         .def("timestamp", &Channel::timestamp)
         .def("array",
              static_cast<const sihd::util::IArray *(Channel::*)() const>(&Channel::array),
@@ -220,7 +267,22 @@ void PyCoreApi::add_core_api(PyApi::PyModule & pymodule)
 
     pybind11::class_<Core, Device, SmartNodePtr<Core>>(m_core, "Core")
         .def(pybind11::init<const std::string &, Node *>(), pybind11::keep_alive<1, 3>())
-        .def(pybind11::init<const std::string &>());
+        .def(pybind11::init<const std::string &>())
+        .def("set_runtime_stats", &Core::set_runtime_stats)
+        .def("clear_runtime_stats", &Core::clear_runtime_stats)
+        .def("runtime_stats", +[](Core *self) {
+            const CoreStats stats = self->runtime_stats();
+            pybind11::list channels;
+            for (const ChannelStats & channel_stats : stats.channels)
+                channels.append(channel_stats_to_dict(channel_stats));
+            pybind11::list devices;
+            for (const DeviceStats & device_stats : stats.devices)
+                devices.append(device_stats_to_dict(device_stats));
+            pybind11::dict dict;
+            dict["channels"] = channels;
+            dict["devices"] = devices;
+            return dict;
+        });
 
     pybind11::class_<ACoreObject, Named, Configurable>(m_core, "ACoreObject")
         .def("setup",
@@ -89,7 +89,11 @@ void PyNetApi::add_net_api(PyApi::PyModule & pymodule)
         .def("set_host", &DeviceUdpReceiver::set_host)
         .def("set_port", &DeviceUdpReceiver::set_port)
         .def("set_buffer_capacity", &DeviceUdpReceiver::set_buffer_capacity)
-        .def("set_poll_timeout", &DeviceUdpReceiver::set_poll_timeout);
+        .def("set_poll_timeout", &DeviceUdpReceiver::set_poll_timeout)
+        .def("set_batch_size", &DeviceUdpReceiver::set_batch_size)
+        .def("set_gro", &DeviceUdpReceiver::set_gro)
+        .def("set_kernel_timestamp", &DeviceUdpReceiver::set_kernel_timestamp)
+        .def("set_busy_poll", &DeviceUdpReceiver::set_busy_poll);
 }
 
 static void __attribute__((constructor)) premain()
@@ -49,4 +49,11 @@ TEST_F(TestPyCoreApi, test_pycore_observer)
     pybind11::scoped_interpreter guard {};
     EXPECT_NO_THROW(pybind11::eval_file(d.old_cwd() + "/test/core/py/test_observer.py"));
 }
+
+TEST_F(TestPyCoreApi, test_pycore_runtimestats)
+{
+    DirectorySwitcher d(getenv("LIB_PATH"));
+    pybind11::scoped_interpreter guard {};
+    EXPECT_NO_THROW(pybind11::eval_file(d.old_cwd() + "/test/core/py/test_runtimestats.py"));
+}
 } // namespace test
@@ -0,0 +1,16 @@
+import sihd
+
+core = sihd.core.Core("core")
+channel = core.add_channel("value", "int", 1)
+
+assert(core.set_runtime_stats(True))
+assert(channel.write(0, 42))
+
+stats = core.runtime_stats()
+assert(len(stats["channels"]) == 1)
+assert(stats["channels"][0]["writes"] == 1)
+assert(stats["channels"][0]["bytes_written"] == 4)
+assert(len(stats["devices"]) == 1)
+
+core.clear_runtime_stats()
+assert(channel.stats()["writes"] == 0)
@@ -0,0 +1,187 @@
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <sihd/sys/Poll.hpp>
+#include <sihd/util/Handler.hpp>
+#include <sihd/util/Stopwatch.hpp>
+#include <sihd/util/time.hpp>
+
+#include <CLI/CLI.hpp>
+
+using namespace sihd::util;
+using namespace sihd::sys;
+
+// connections are socket pairs: the first socket is polled, the second one is the peer
+struct Connections
+{
+        std::vector<int> idle;
+        std::vector<int> active;
+        std::vector<int> peers;
+
+        ~Connections()
+        {
+            for (int fd : idle)
+                ::close(fd);
+            for (int fd : active)
+                ::close(fd);
+            for (int fd : peers)
+                ::close(fd);
+        }
+
+        bool add(std::vector<int> & lst)
+        {
+            int fds[2];
+            if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) < 0)
+                return false;
+            lst.push_back(fds[0]);
+            peers.push_back(fds[1]);
+            return true;
+        }
+};
+
+struct BenchResult
+{
+        size_t wakeups;
+        // per wakeup
+        double wakeup_us;
+        // per set and rm of a write interest
+        double update_us;
+        size_t events;
+};
+
+size_t raise_fd_limit()
+{
+    struct rlimit r;
+    if (getrlimit(RLIMIT_NOFILE, &r) < 0)
+        return 0;
+    r.rlim_cur = r.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &r);
+    getrlimit(RLIMIT_NOFILE, &r);
+    return r.rlim_cur;
+}
+
+BenchResult bench_poll(PollBackend backend, bool edge_triggered, const Connections & connections, size_t rounds)
+{
+    Poll poll(-1);
+    poll.set_backend(backend);
+    poll.set_edge_triggered(edge_triggered);
+    for (int fd : connections.idle)
+        poll.set_read_fd(fd);
+    for (int fd : connections.active)
+        poll.set_read_fd(fd);
+
+    size_t events = 0;
+    char buffer[64];
+    Handler<Poll *> handler([&events, &buffer](Poll *poll) {
+        for (const PollEvent & event : poll->events())
+        {
+            if (!event.readable)
+                continue;
+            // drained for edge triggered mode
+            while (::read(event.fd, buffer, sizeof(buffer)) > 0)
+                ;
+            ++events;
+        }
+    });
+    poll.add_observer(&handler);
+
+    const size_t active = connections.active.size();
+    Stopwatch sw;
+    sihd::util::Duration polling = 0;
+    for (size_t i = 0; i < rounds; ++i)
+    {
+        for (size_t j = 0; j < active; ++j)
+            (void)::write(connections.peers[connections.idle.size() + j], "x", 1);
+        sw.reset();
+        poll.poll(100);
+        polling += sw.time();
+    }
+
+    sw.reset();
+    for (size_t i = 0; i < rounds; ++i)
+    {
+        for (int fd : connections.active)
+        {
+            poll.set_write_fd(fd);
+            poll.rm_write_fd(fd);
+        }
+    }
+    sihd::util::Duration updates = sw.time();
+
+    return {
+        .wakeups = rounds,
+        .wakeup_us = (double)polling.nanoseconds() / 1e3 / rounds,
+        .update_us = (double)updates.nanoseconds() / 1e3 / (rounds * active),
+        .events = events,
+    };
+}
+
+void print_row(const char *label, const BenchResult & r)
+{
+    fmt::print("{:<16s} {:>9d} {:>14.2f} {:>14.3f} {:>10d}\n", label, r.wakeups, r.wakeup_us, r.update_us, r.events);
+}
+
+int main(int argc, char **argv)
+{
+    size_t idle = 10'000;
+    size_t active = 100;
+    size_t rounds = 1000;
+
+    CLI::App app {"Poll backends with idle and active connections"};
+    app.add_option("-i,--idle", idle, "Idle connections")->default_val("10000");
+    app.add_option("-a,--active", active, "Active connections written each round")->default_val("100");
+    app.add_option("-r,--rounds", rounds, "Rounds of writes and polling")->default_val("1000");
+
+    CLI11_PARSE(app, argc, argv);
+
+    const size_t fd_limit = raise_fd_limit();
+    // two sockets per connection and a margin for the process
+    if ((idle + active) * 2 + 64 > fd_limit)
+    {
+        const size_t max_idle = fd_limit > active * 2 + 64 ? (fd_limit - 64) / 2 - active : 0;
+        fmt::print("File descriptors limit is {}: using {} idle connections\n", fd_limit, max_idle);
+        idle = max_idle;
+    }
+
+    Connections connections;
+    for (size_t i = 0; i < idle; ++i)
+    {
+        if (!connections.add(connections.idle))
+        {
+            fmt::print(stderr, "Failed to create connections\n");
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < active; ++i)
+    {
+        if (!connections.add(connections.active))
+        {
+            fmt::print(stderr, "Failed to create connections\n");
+            return 1;
+        }
+    }
+
+    fmt::print("{} idle and {} active connections, {} rounds\n\n", idle, active, rounds);
+
+    fmt::print("{:<16s} {:>9s} {:>14s} {:>14s} {:>10s}\n",
+               "Backend",
+               "Wakeups",
+               "Wakeup (us)",
+               "Update (us)",
+               "Events");
+    fmt::print("{:-<16s}-{:-<9s}-{:-<14s}-{:-<14s}-{:-<10s}\n", "", "", "", "", "");
+
+    print_row("poll", bench_poll(PollBackend::poll, false, connections, rounds));
+    if (Poll::is_backend_available(PollBackend::epoll))
+    {
+        print_row("epoll", bench_poll(PollBackend::epoll, false, connections, rounds));
+        print_row("epoll (edge)", bench_poll(PollBackend::epoll, true, connections, rounds));
+    }
+
+    return 0;
+}
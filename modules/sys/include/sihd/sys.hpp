@@ -11,6 +11,7 @@
 #include <sihd/sys/FileWatcher.hpp>
 #include <sihd/sys/LineReader.hpp>
 #include <sihd/sys/LoggerFile.hpp>
+#include <sihd/sys/MappedFile.hpp>
 #include <sihd/sys/LoggerSystem.hpp>
 #include <sihd/sys/NamedFactory.hpp>
 #include <sihd/sys/PathManager.hpp>
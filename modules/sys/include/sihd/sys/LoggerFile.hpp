@@ -15,6 +15,9 @@ class LoggerFile: public sihd::util::ALogger
 
         virtual void log(const sihd::util::LogInfo & info, std::string_view msg) override;
 
+        int line_fd() const override;
+        void format_line(const sihd::util::LogInfo & info, std::string_view msg, std::string & line) const override;
+
         bool is_open() const { return _file.is_open(); }
         const std::string & path() const { return _file.path(); }
 
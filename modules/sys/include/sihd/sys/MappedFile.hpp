@@ -0,0 +1,46 @@
+#ifndef __SIHD_SYS_MAPPEDFILE_HPP__
+#define __SIHD_SYS_MAPPEDFILE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <sihd/util/build.hpp>
+
+namespace sihd::sys
+{
+
+// read only mapping of a whole file
+class MappedFile
+{
+    public:
+        static constexpr bool supported = !sihd::util::build::is_windows;
+
+        MappedFile();
+        MappedFile(std::string_view path);
+        virtual ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
+
+        bool open(std::string_view path);
+        bool close();
+
+        bool is_open() const { return !_path.empty(); }
+        // nullptr if the file is empty
+        const uint8_t *data() const { return _data; }
+        size_t size() const { return _size; }
+        const std::string & path() const { return _path; }
+
+    protected:
+
+    private:
+        const uint8_t *_data;
+        size_t _size;
+        std::string _path;
+};
+
+} // namespace sihd::sys
+
+#endif
@@ -2,7 +2,10 @@
 #define __SIHD_SYS_POLL_HPP__
 
 #include <atomic>
+#include <memory>
 #include <mutex>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include <sihd/sys/platform.hpp>
@@ -30,6 +33,14 @@ struct PollEvent
         bool closed = false;
 };
 
+enum class PollBackend
+{
+    // poll() or WSAPoll(): every file descriptor is scanned on each call
+    poll,
+    // linux only: only ready file descriptors are returned and interests are updated in constant time
+    epoll,
+};
+
 class Poll: public sihd::util::Observable<Poll>,
             public sihd::util::ABlockingService
 {
@@ -43,6 +54,23 @@ class Poll: public sihd::util::Observable<Poll>,
         // if limit is negative, look for the soft curr rlimit for RLIMIT_NOFILE
         bool set_limit(int limit);
 
+        /**
+         * Changing backend keeps the file descriptors polled. Fails while polling or if the backend is not
+         * available on this platform.
+         */
+        bool set_backend(PollBackend backend);
+        // "poll" or "epoll"
+        bool set_backend(std::string_view backend);
+        PollBackend backend() const { return _backend; }
+        static bool is_backend_available(PollBackend backend);
+
+        /**
+         * Epoll backend only: an event is reported once each time a file descriptor becomes ready instead of while
+         * it is ready - observers must read or write until EAGAIN. Fails while polling.
+         */
+        bool set_edge_triggered(bool active);
+        bool edge_triggered() const { return _edge_triggered; }
+
         void clear_fds();
         bool clear_fd(int fd);
         bool set_read_fd(int fd);
@@ -63,7 +91,7 @@ class Poll: public sihd::util::Observable<Poll>,
 
         size_t read_fds_size() const;
         size_t write_fds_size() const;
-        size_t fds_size() const { return _lst_fds.size(); }
+        size_t fds_size() const;
         rlim_t max_fds() const { return _max_fds; };
         // in ms
         sihd::util::time::UnixTime timeout() const { return _timeout_milliseconds; }
@@ -75,12 +103,29 @@ class Poll: public sihd::util::Observable<Poll>,
         void process_poll_results(int poll_return);
 
     private:
+        struct Epoll;
+
+        int _poll_fds(int milliseconds_timeout);
+        int _poll_epoll(int milliseconds_timeout);
+        // called locked - events are POLLIN and POLLOUT - removes the file descriptor when no events are left
+        bool _add_events(int fd, short events);
+        bool _rm_events(int fd, short events);
+        bool _epoll_update(int fd, short events, short new_events);
+
         std::atomic<bool> _stop;
         int _timeout_milliseconds;
 
         mutable std::mutex _fds_mutex;
         rlim_t _max_fds;
+        PollBackend _backend;
+        bool _edge_triggered;
+        // polled file descriptors and their events
+        std::unordered_map<int, short> _fd_events;
+        // poll backend - index of the file descriptors in the poll array and free entries
+        std::unordered_map<int, size_t> _fd_index;
+        std::vector<size_t> _free_index;
         std::vector<struct pollfd> _lst_fds;
+        std::unique_ptr<Epoll> _epoll_ptr;
         sihd::util::SteadyClock _clock;
 
         std::vector<PollEvent> _lst_events;
@@ -25,6 +25,9 @@ if builder.build_platform != "web":
     env.build_demo("demo/process_info.cpp", name = "process_info", libs = [sihd_sys_libname])
     env.build_demo("demo/fs_info.cpp", name = "fs_info", libs = [sihd_sys_libname])
 
+if builder.build_platform not in ("web", "windows"):
+    env.build_demo("demo/poll_bench.cpp", name = "poll_bench", libs = [sihd_sys_libname])
+
 test = env.build_test(Glob('test/*.cpp'), libs = [sihd_sys_libname])
 
 if builder.build_tests:
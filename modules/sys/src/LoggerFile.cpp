@@ -1,4 +1,6 @@
-#include <fmt/printf.h>
+#include <iterator>
+
+#include <fmt/format.h>
 
 #include <sihd/util/Logger.hpp>
 #include <sihd/sys/LoggerFile.hpp>
@@ -21,21 +23,26 @@ void LoggerFile::log(const LogInfo & info, std::string_view msg)
         return;
 
     std::string fmt_msg;
+    this->format_line(info, msg, fmt_msg);
+    _file.write_unlocked(fmt_msg);
+}
 
-// SEC.NANO [THREAD] LEVEL SRC MSG
-#if defined(__SIHD_WINDOWS__)
-    fmt_msg = fmt::sprintf("%lld.%09ld\t[%s]\t%s\t%s\t%s\n",
-#else
-    fmt_msg = fmt::sprintf("%ld.%09ld\t[%s]\t%s\t%s\t%s\n",
-#endif
-                           info.timespec.tv_sec,
-                           info.timespec.tv_nsec,
-                           info.thread_name.data(),
-                           info.strlevel,
-                           info.source.data(),
-                           msg);
+int LoggerFile::line_fd() const
+{
+    return _file.fd();
+}
 
-    _file.write_unlocked(fmt_msg);
+void LoggerFile::format_line(const LogInfo & info, std::string_view msg, std::string & line) const
+{
+// SEC.NANO [THREAD] LEVEL SRC MSG
+    fmt::format_to(std::back_inserter(line),
+                   "{}.{:09}\t[{}]\t{}\t{}\t{}\n",
+                   info.timespec.tv_sec,
+                   info.timespec.tv_nsec,
+                   info.thread_name.data(),
+                   info.strlevel,
+                   info.source.data(),
+                   msg);
 }
 
 } // namespace sihd::sys
@@ -0,0 +1,103 @@
+#include <sihd/sys/MappedFile.hpp>
+#include <sihd/sys/os.hpp>
+#include <sihd/util/Logger.hpp>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if !defined(__SIHD_WINDOWS__)
+# include <sys/mman.h>
+#endif
+
+namespace sihd::sys
+{
+
+SIHD_LOGGER;
+
+MappedFile::MappedFile(): _data(nullptr), _size(0) {}
+
+MappedFile::MappedFile(std::string_view path): MappedFile()
+{
+    this->open(path);
+}
+
+MappedFile::~MappedFile()
+{
+    this->close();
+}
+
+#if !defined(__SIHD_WINDOWS__)
+
+bool MappedFile::open(std::string_view path)
+{
+    this->close();
+
+    const std::string path_str(path);
+    int fd = ::open(path_str.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        SIHD_LOG(error, "MappedFile: open '{}': {}", path, os::last_error_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1)
+    {
+        SIHD_LOG(error, "MappedFile: fstat '{}': {}", path, os::last_error_str());
+        ::close(fd);
+        return false;
+    }
+
+    void *addr = nullptr;
+    if (st.st_size > 0)
+    {
+        addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            SIHD_LOG(error, "MappedFile: mmap '{}': {}", path, os::last_error_str());
+            ::close(fd);
+            return false;
+        }
+        // read in order
+        madvise(addr, st.st_size, MADV_SEQUENTIAL);
+    }
+    // the mapping stays valid once the descriptor is closed
+    ::close(fd);
+
+    _data = static_cast<const uint8_t *>(addr);
+    _size = st.st_size;
+    _path = path_str;
+    return true;
+}
+
+bool MappedFile::close()
+{
+    bool ret = true;
+    if (_data != nullptr && munmap(const_cast<uint8_t *>(_data), _size) == -1)
+    {
+        SIHD_LOG(error, "MappedFile: munmap '{}': {}", _path, os::last_error_str());
+        ret = false;
+    }
+    _data = nullptr;
+    _size = 0;
+    _path.clear();
+    return ret;
+}
+
+#else
+
+bool MappedFile::open(std::string_view path)
+{
+    SIHD_LOG(error, "MappedFile: cannot map '{}': not supported on this platform", path);
+    return false;
+}
+
+bool MappedFile::close()
+{
+    return true;
+}
+
+#endif
+
+} // namespace sihd::sys
@@ -2,6 +2,8 @@
 #include <cerrno>
 #include <cstring>
 
+#include <algorithm>
+
 #include <sihd/sys/Poll.hpp>
 #include <sihd/sys/os.hpp>
 #include <sihd/util/Logger.hpp>
@@ -12,6 +14,16 @@
 # include <sys/time.h>
 #endif
 
+// epoll is only available on Linux (not Cygwin, not Emscripten)
+#if defined(__SIHD_LINUX__) && !defined(__SIHD_EMSCRIPTEN__) && !defined(__CYGWIN__)
+# define SIHD_HAS_EPOLL 1
+#endif
+
+#if defined(SIHD_HAS_EPOLL)
+# include <sys/epoll.h>
+# include <unistd.h>
+#endif
+
 namespace sihd::sys
 {
 
@@ -19,64 +31,31 @@ using namespace sihd::util;
 
 SIHD_LOGGER;
 
-namespace
+struct Poll::Epoll
 {
+#if defined(SIHD_HAS_EPOLL)
+        // ready file descriptors beyond are returned by the next calls
+        static constexpr size_t max_events = 1024;
 
-int get_fd_index(const std::vector<struct pollfd> & lst_fds, int fd)
-{
-    if (fd < 0)
-        return -1;
-    size_t i = 0;
-    while (i < lst_fds.size())
-    {
-        if ((int)lst_fds[i].fd == fd)
-            return i;
-        ++i;
-    }
-    return -1;
-}
-
-int get_or_add_fd(std::vector<struct pollfd> & lst_fds, int fd, rlim_t max_fds)
-{
-    if (fd < 0)
-        return -1;
-    if (max_fds <= 0)
-        SIHD_LOG(warning, "Poll: no max file descriptors limit was set");
-    int idx = -1;
-    size_t i = 0;
-    while (i < lst_fds.size())
-    {
-        // take existing fd
-        if ((int)lst_fds[i].fd == fd)
+        Epoll() { fd = ::epoll_create1(EPOLL_CLOEXEC); }
+        ~Epoll()
         {
-            idx = i;
-            break;
+            if (fd >= 0)
+                ::close(fd);
         }
-        // take first free fd
-        if (idx < 0 && (int)lst_fds[i].fd == -1)
-            idx = i;
-        ++i;
-    }
-    if (idx < 0 && i < max_fds)
-    {
-        // add new entry
-        struct pollfd p;
-        p.fd = -1;
-        p.events = 0;
-        p.revents = 0;
-        lst_fds.push_back(p);
-        idx = i;
-    }
-    return idx;
-}
 
-} // namespace
+        int fd;
+        std::vector<struct epoll_event> events;
+#endif
+};
 
 Poll::Poll()
 {
     _stop = false;
     _timeout_milliseconds = -1; // infinite block
     _max_fds = 0;
+    _backend = PollBackend::poll;
+    _edge_triggered = false;
     _last_poll_time = 0;
     _timedout = false;
     _error = false;
@@ -100,15 +79,23 @@ void Poll::resize(int nfds)
 {
     if (nfds < 0)
         return;
+    this->clear_fds();
     std::lock_guard lock(_fds_mutex);
-    _lst_fds.resize(nfds);
+    _fd_events.reserve(nfds);
     _lst_events.reserve(nfds);
+    if (_backend != PollBackend::poll)
+        return;
+    _fd_index.reserve(nfds);
+    _lst_fds.resize(nfds);
+    _free_index.resize(nfds);
     int i = 0;
     while (i < nfds)
     {
         _lst_fds[i].events = 0;
         _lst_fds[i].revents = 0;
         _lst_fds[i].fd = -1;
+        // lowest entries are taken first
+        _free_index[i] = nfds - 1 - i;
         ++i;
     }
 }
@@ -122,35 +109,122 @@ bool Poll::set_limit(int limit)
     return true;
 }
 
-void Poll::clear_fds()
+bool Poll::is_backend_available(PollBackend backend)
 {
+    switch (backend)
+    {
+        case PollBackend::poll:
+            return true;
+        case PollBackend::epoll:
+#if defined(SIHD_HAS_EPOLL)
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+bool Poll::set_backend(std::string_view backend)
+{
+    if (backend == "poll")
+        return this->set_backend(PollBackend::poll);
+    if (backend == "epoll")
+        return this->set_backend(PollBackend::epoll);
+    SIHD_LOG(error, "Poll: unknown backend '{}'", backend);
+    return false;
+}
+
+bool Poll::set_backend(PollBackend backend)
+{
+    if (backend == _backend)
+        return true;
+    if (!Poll::is_backend_available(backend))
+    {
+        SIHD_LOG(error, "Poll: backend not available on this platform");
+        return false;
+    }
+    if (this->is_running())
+    {
+        SIHD_LOG(error, "Poll: cannot change backend while polling");
+        return false;
+    }
+    std::unique_ptr<Epoll> epoll_ptr;
+    if (backend == PollBackend::epoll)
+    {
+        epoll_ptr = std::make_unique<Epoll>();
+#if defined(SIHD_HAS_EPOLL)
+        if (epoll_ptr->fd < 0)
+        {
+            SIHD_LOG(error, "Poll: epoll_create: {}", os::last_error_str());
+            return false;
+        }
+#endif
+    }
     std::lock_guard lock(_fds_mutex);
+    std::unordered_map<int, short> fd_events = std::move(_fd_events);
+    _fd_events.clear();
+    _fd_index.clear();
+    _free_index.clear();
     _lst_fds.clear();
+    _epoll_ptr = std::move(epoll_ptr);
+    _backend = backend;
+    bool ret = true;
+    for (const auto & [fd, events] : fd_events)
+        ret = this->_add_events(fd, events) && ret;
+    return ret;
 }
 
-bool Poll::clear_fd(int fd)
+bool Poll::set_edge_triggered(bool active)
 {
+    if (this->is_running())
+    {
+        SIHD_LOG(error, "Poll: cannot change trigger mode while polling");
+        return false;
+    }
     std::lock_guard lock(_fds_mutex);
-    int idx = get_fd_index(_lst_fds, fd);
-    if (idx >= 0)
+    _edge_triggered = active;
+    bool ret = true;
+    if (_backend == PollBackend::epoll)
     {
-        _lst_fds[idx].events = 0;
-        _lst_fds[idx].revents = 0;
-        _lst_fds[idx].fd = -1;
+        for (const auto & [fd, events] : _fd_events)
+            ret = this->_epoll_update(fd, events, events) && ret;
     }
-    return idx >= 0;
+    return ret;
 }
 
-size_t Poll::read_fds_size() const
+void Poll::clear_fds()
 {
     std::lock_guard lock(_fds_mutex);
-    size_t ret = 0;
-    size_t i = 0;
-    while (i < _lst_fds.size())
+    if (_backend == PollBackend::epoll)
     {
-        ret += 1 * (_lst_fds[i].events & (POLLIN | POLLPRI));
-        ++i;
+        for (const auto & [fd, events] : _fd_events)
+            this->_epoll_update(fd, events, 0);
     }
+    _fd_events.clear();
+    _fd_index.clear();
+    _free_index.clear();
+    _lst_fds.clear();
+}
+
+bool Poll::clear_fd(int fd)
+{
+    std::lock_guard lock(_fds_mutex);
+    return _fd_events.find(fd) != _fd_events.end() && this->_rm_events(fd, POLLIN | POLLOUT);
+}
+
+size_t Poll::fds_size() const
+{
+    std::lock_guard lock(_fds_mutex);
+    return _backend == PollBackend::poll ? _lst_fds.size() : _fd_events.size();
+}
+
+size_t Poll::read_fds_size() const
+{
+    std::lock_guard lock(_fds_mutex);
+    size_t ret = 0;
+    for (const auto & [fd, events] : _fd_events)
+        ret += (events & POLLIN) != 0;
     return ret;
 }
 
@@ -158,59 +232,147 @@ size_t Poll::write_fds_size() const
 {
     std::lock_guard lock(_fds_mutex);
     size_t ret = 0;
-    size_t i = 0;
-    while (i < _lst_fds.size())
-    {
-        ret += 1 * (_lst_fds[i].events & POLLOUT);
-        ++i;
-    }
+    for (const auto & [fd, events] : _fd_events)
+        ret += (events & POLLOUT) != 0;
     return ret;
 }
 
 bool Poll::set_read_fd(int fd)
 {
     std::lock_guard lock(_fds_mutex);
-    int idx = get_or_add_fd(_lst_fds, fd, _max_fds);
-    if (idx >= 0)
-    {
-        _lst_fds[idx].fd = fd;
-        _lst_fds[idx].events |= POLLIN;
-    }
-    return idx >= 0;
+    return this->_add_events(fd, POLLIN);
 }
 
 bool Poll::set_write_fd(int fd)
 {
     std::lock_guard lock(_fds_mutex);
-    int idx = get_or_add_fd(_lst_fds, fd, _max_fds);
-    if (idx >= 0)
+    return this->_add_events(fd, POLLOUT);
+}
+
+bool Poll::rm_read_fd(int fd)
+{
+    std::lock_guard lock(_fds_mutex);
+    return this->_rm_events(fd, POLLIN);
+}
+
+bool Poll::rm_write_fd(int fd)
+{
+    std::lock_guard lock(_fds_mutex);
+    return this->_rm_events(fd, POLLOUT);
+}
+
+bool Poll::_add_events(int fd, short events)
+{
+    if (fd < 0)
+        return false;
+    auto it = _fd_events.find(fd);
+    const short old_events = it != _fd_events.end() ? it->second : 0;
+    if (it == _fd_events.end())
+    {
+        if (_max_fds <= 0)
+            SIHD_LOG(warning, "Poll: no max file descriptors limit was set");
+        if (_fd_events.size() >= _max_fds)
+            return false;
+    }
+    const short new_events = old_events | events;
+    if (_backend == PollBackend::epoll)
     {
+        if (!this->_epoll_update(fd, old_events, new_events))
+            return false;
+    }
+    else
+    {
+        auto index_it = _fd_index.find(fd);
+        size_t idx;
+        if (index_it != _fd_index.end())
+            idx = index_it->second;
+        else if (!_free_index.empty())
+        {
+            idx = _free_index.back();
+            _free_index.pop_back();
+            _fd_index.emplace(fd, idx);
+        }
+        else
+        {
+            idx = _lst_fds.size();
+            _lst_fds.push_back({});
+            _fd_index.emplace(fd, idx);
+        }
         _lst_fds[idx].fd = fd;
-        _lst_fds[idx].events |= POLLOUT;
+        _lst_fds[idx].events = new_events;
+        _lst_fds[idx].revents = 0;
     }
-    return idx >= 0;
+    _fd_events[fd] = new_events;
+    return true;
 }
 
-bool Poll::rm_read_fd(int fd)
+bool Poll::_rm_events(int fd, short events)
 {
-    std::lock_guard lock(_fds_mutex);
-    int idx = get_or_add_fd(_lst_fds, fd, _max_fds);
-    if (idx >= 0)
+    if (fd < 0)
+        return false;
+    auto it = _fd_events.find(fd);
+    // nothing to remove
+    if (it == _fd_events.end())
+        return true;
+    const short new_events = it->second & ~events;
+    if (_backend == PollBackend::epoll)
     {
-        _lst_fds[idx].events = (_lst_fds[idx].events & ~(POLLIN));
+        if (!this->_epoll_update(fd, it->second, new_events))
+            return false;
     }
-    return idx >= 0;
+    else
+    {
+        auto index_it = _fd_index.find(fd);
+        struct pollfd & entry = _lst_fds[index_it->second];
+        entry.events = new_events;
+        if (new_events == 0)
+        {
+            entry.fd = -1;
+            entry.revents = 0;
+            _free_index.push_back(index_it->second);
+            _fd_index.erase(index_it);
+        }
+    }
+    if (new_events == 0)
+        _fd_events.erase(it);
+    else
+        it->second = new_events;
+    return true;
 }
 
-bool Poll::rm_write_fd(int fd)
+bool Poll::_epoll_update([[maybe_unused]] int fd,
+                         [[maybe_unused]] short events,
+                         [[maybe_unused]] short new_events)
 {
-    std::lock_guard lock(_fds_mutex);
-    int idx = get_or_add_fd(_lst_fds, fd, _max_fds);
-    if (idx >= 0)
+#if defined(SIHD_HAS_EPOLL)
+    const int epoll_fd = _epoll_ptr->fd;
+    if (new_events == 0)
     {
-        _lst_fds[idx].events = (_lst_fds[idx].events & ~(POLLOUT));
+        // closed file descriptors are already out of the epoll set
+        return ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr) == 0 || errno == EBADF || errno == ENOENT;
     }
-    return idx >= 0;
+    struct epoll_event event = {};
+    event.data.fd = fd;
+    event.events = 0;
+    if (new_events & POLLIN)
+        event.events |= EPOLLIN;
+    if (new_events & POLLOUT)
+        event.events |= EPOLLOUT;
+    if (_edge_triggered)
+        event.events |= EPOLLET;
+    const int op = events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    int ret = ::epoll_ctl(epoll_fd, op, fd, &event);
+    // file descriptor closed and reused without being cleared, or registered by a duplicate
+    if (ret < 0 && op == EPOLL_CTL_MOD && errno == ENOENT)
+        ret = ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    else if (ret < 0 && op == EPOLL_CTL_ADD && errno == EEXIST)
+        ret = ::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+    if (ret < 0)
+        SIHD_LOG(error, "Poll: epoll_ctl fd {}: {}", fd, os::last_error_str());
+    return ret == 0;
+#else
+    return false;
+#endif
 }
 
 bool Poll::set_timeout(int milliseconds)
@@ -235,9 +397,10 @@ bool Poll::on_start()
         return false;
     }
 
+    // a stop following wait_ready() is not missed
+    _stop = false;
     this->service_set_ready();
 
-    _stop = false;
     int ret = 0;
     while (ret >= 0 && _stop == false)
         ret = this->poll(_timeout_milliseconds);
@@ -245,21 +408,61 @@ bool Poll::on_start()
 }
 
 int Poll::poll(int milliseconds_timeout)
+{
+    const int ret = _backend == PollBackend::epoll ? this->_poll_epoll(milliseconds_timeout)
+                                                   : this->_poll_fds(milliseconds_timeout);
+    this->notify_observers(this);
+    return ret;
+}
+
+int Poll::_poll_fds(int milliseconds_timeout)
 {
     Timestamp before = _clock.now();
-    int ret;
-    {
-        std::lock_guard lock(_fds_mutex);
+    std::lock_guard lock(_fds_mutex);
 #if !defined(__SIHD_WINDOWS__)
-        ret = ::poll(_lst_fds.data(), _lst_fds.size(), milliseconds_timeout);
+    int ret = ::poll(_lst_fds.data(), _lst_fds.size(), milliseconds_timeout);
 #else
-        ret = ::WSAPoll(_lst_fds.data(), _lst_fds.size(), milliseconds_timeout);
+    int ret = ::WSAPoll(_lst_fds.data(), _lst_fds.size(), milliseconds_timeout);
 #endif
-        _last_poll_time = _clock.now() - before;
-        this->process_poll_results(ret);
+    _last_poll_time = _clock.now() - before;
+    this->process_poll_results(ret);
+    return ret;
+}
+
+int Poll::_poll_epoll([[maybe_unused]] int milliseconds_timeout)
+{
+#if defined(SIHD_HAS_EPOLL)
+    Epoll & epoll = *_epoll_ptr;
+    {
+        std::lock_guard lock(_fds_mutex);
+        epoll.events.resize(std::clamp<size_t>(_fd_events.size(), 1, Epoll::max_events));
+    }
+    // interests can change while waiting
+    Timestamp before = _clock.now();
+    int ret = ::epoll_wait(epoll.fd, epoll.events.data(), epoll.events.size(), milliseconds_timeout);
+    _last_poll_time = _clock.now() - before;
+    _lst_events.clear();
+    _timedout = ret == 0;
+    _error = ret < 0;
+    if (ret < 0)
+        SIHD_LOG(error, "Poll: {}", os::last_error_str());
+    int i = 0;
+    while (i < ret)
+    {
+        const uint32_t revt = epoll.events[i].events;
+        PollEvent evt;
+        evt.fd = epoll.events[i].data.fd;
+        evt.closed = revt & (EPOLLHUP | EPOLLRDHUP);
+        evt.error = revt & EPOLLERR;
+        evt.readable = revt & (EPOLLIN | EPOLLPRI);
+        evt.writable = revt & EPOLLOUT;
+        _lst_events.push_back(evt);
+        ++i;
     }
-    this->notify_observers(this);
     return ret;
+#else
+    return -1;
+#endif
 }
 
 void Poll::process_poll_results(int poll_return)
@@ -4,6 +4,7 @@
 #include <sihd/sys/TmpDir.hpp>
 #include <sihd/sys/fs.hpp>
 #include <sihd/util/Logger.hpp>
+#include <sihd/util/LoggerAsync.hpp>
 
 SIHD_NEW_LOGGER("test::loggerfile");
 
@@ -42,4 +43,28 @@ TEST_F(TestLoggerFile, test_loggerfile_write)
     EXPECT_NE(content->find("test message for log file"), std::string::npos);
 }
 
+TEST_F(TestLoggerFile, test_loggerfile_async)
+{
+    TmpDir tmp;
+    ASSERT_TRUE(tmp);
+
+    std::string path = fs::combine(tmp.path(), "test.log");
+
+    {
+        auto *logger = new sihd::util::LoggerAsync(new LoggerFile(path));
+        sihd::util::LoggerManager::add(logger);
+
+        SIHD_LOG(info, "first async message");
+        SIHD_LOG(info, "second async message");
+        logger->flush();
+
+        auto content = fs::read_all(path);
+        ASSERT_TRUE(content.has_value());
+        EXPECT_LT(content->find("first async message"), content->find("second async message"));
+        EXPECT_NE(content->find("second async message"), std::string::npos);
+
+        sihd::util::LoggerManager::clear_loggers();
+    }
+}
+
 } // namespace test
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <sihd/sys/MappedFile.hpp>
+#include <sihd/sys/TmpDir.hpp>
+#include <sihd/sys/fs.hpp>
+#include <sihd/util/Logger.hpp>
+
+namespace test
+{
+SIHD_LOGGER;
+using namespace sihd::sys;
+using namespace sihd::util;
+class TestMappedFile: public ::testing::Test
+{
+    protected:
+        TestMappedFile() { sihd::util::LoggerManager::stream(); }
+
+        virtual ~TestMappedFile() { sihd::util::LoggerManager::clear_loggers(); }
+
+        virtual void SetUp()
+        {
+            if constexpr (!MappedFile::supported)
+            {
+                GTEST_SKIP() << "MappedFile not supported on this platform";
+            }
+        }
+
+        virtual void TearDown() {}
+};
+
+TEST_F(TestMappedFile, test_mappedfile_read)
+{
+    TmpDir tmp_dir;
+    const std::string path = fs::combine({tmp_dir.path(), "test.bin"});
+    const std::string content = "hello world";
+    ASSERT_TRUE(fs::write(path, content));
+
+    MappedFile file;
+    EXPECT_FALSE(file.is_open());
+    ASSERT_TRUE(file.open(path));
+    EXPECT_TRUE(file.is_open());
+    EXPECT_EQ(file.path(), path);
+    ASSERT_EQ(file.size(), content.size());
+    EXPECT_EQ(std::string_view((const char *)file.data(), file.size()), content);
+
+    EXPECT_TRUE(file.close());
+    EXPECT_FALSE(file.is_open());
+    EXPECT_EQ(file.data(), nullptr);
+    EXPECT_EQ(file.size(), 0u);
+}
+
+TEST_F(TestMappedFile, test_mappedfile_empty)
+{
+    TmpDir tmp_dir;
+    const std::string path = fs::combine({tmp_dir.path(), "empty.bin"});
+    ASSERT_TRUE(fs::write(path, ""));
+
+    MappedFile file(path);
+    EXPECT_TRUE(file.is_open());
+    EXPECT_EQ(file.data(), nullptr);
+    EXPECT_EQ(file.size(), 0u);
+
+    EXPECT_FALSE(file.open(fs::combine({tmp_dir.path(), "missing.bin"})));
+    EXPECT_FALSE(file.is_open());
+}
+
+} // namespace test
@@ -246,4 +246,128 @@ TEST_F(TestPoll, test_poll)
     EXPECT_EQ(_read_count, 2);
     EXPECT_EQ(_timedout, 1);
 }
+
+TEST_F(TestPoll, test_poll_backends)
+{
+    for (PollBackend backend : {PollBackend::poll, PollBackend::epoll})
+    {
+        if (!Poll::is_backend_available(backend))
+            continue;
+        Poll poll(2);
+        EXPECT_TRUE(poll.set_backend(backend));
+
+        int fd[2];
+        ASSERT_TRUE(make_fd_pair(fd));
+        _to_close.push_back(fd[0]);
+        _to_close.push_back(fd[1]);
+
+        EXPECT_TRUE(poll.set_read_fd(fd[0]));
+        EXPECT_TRUE(poll.set_write_fd(fd[1]));
+        EXPECT_EQ(poll.read_fds_size(), 1u);
+        EXPECT_EQ(poll.write_fds_size(), 1u);
+        // limit reached
+        EXPECT_FALSE(poll.set_read_fd(fd[1] + 1000));
+
+        EXPECT_EQ(poll.poll(10), 1);
+        ASSERT_EQ(poll.events().size(), 1u);
+        EXPECT_EQ(poll.events()[0].fd, fd[1]);
+        EXPECT_TRUE(poll.events()[0].writable);
+        EXPECT_FALSE(poll.events()[0].readable);
+
+        EXPECT_TRUE(poll.rm_write_fd(fd[1]));
+        EXPECT_EQ(poll.write_fds_size(), 0u);
+        EXPECT_EQ(poll.poll(10), 0);
+        EXPECT_TRUE(poll.polling_timeout());
+
+        EXPECT_EQ(write_fd(fd[1], "hello", 5), 5);
+        EXPECT_EQ(poll.poll(10), 1);
+        ASSERT_EQ(poll.events().size(), 1u);
+        EXPECT_EQ(poll.events()[0].fd, fd[0]);
+        EXPECT_TRUE(poll.events()[0].readable);
+
+        // level triggered: still readable
+        EXPECT_EQ(poll.poll(10), 1);
+
+        // switching backend keeps the file descriptors
+        PollBackend other = backend == PollBackend::poll ? PollBackend::epoll : PollBackend::poll;
+        if (Poll::is_backend_available(other))
+        {
+            EXPECT_TRUE(poll.set_backend(other));
+            EXPECT_EQ(poll.read_fds_size(), 1u);
+            EXPECT_EQ(poll.poll(10), 1);
+            EXPECT_TRUE(poll.set_backend(backend));
+        }
+
+        EXPECT_TRUE(poll.clear_fd(fd[0]));
+        EXPECT_FALSE(poll.clear_fd(fd[0]));
+        EXPECT_EQ(poll.read_fds_size(), 0u);
+        EXPECT_EQ(poll.poll(10), 0);
+
+        // freed entries are reused
+        EXPECT_TRUE(poll.set_read_fd(fd[0]));
+        EXPECT_TRUE(poll.set_read_fd(fd[1]));
+    }
+}
+
+TEST_F(TestPoll, test_poll_edge_triggered)
+{
+    if (!Poll::is_backend_available(PollBackend::epoll))
+        GTEST_SKIP() << "epoll is not available";
+
+    Poll poll(1);
+    EXPECT_TRUE(poll.set_backend("epoll"));
+    EXPECT_FALSE(poll.set_backend("kqueue"));
+    EXPECT_TRUE(poll.set_edge_triggered(true));
+
+    int fd[2];
+    ASSERT_TRUE(make_fd_pair(fd));
+    _to_close.push_back(fd[0]);
+    _to_close.push_back(fd[1]);
+
+    EXPECT_TRUE(poll.set_read_fd(fd[0]));
+    EXPECT_EQ(write_fd(fd[1], "hello", 5), 5);
+    EXPECT_EQ(poll.poll(10), 1);
+    // not drained but reported only once
+    EXPECT_EQ(poll.poll(10), 0);
+
+    EXPECT_EQ(write_fd(fd[1], "world", 5), 5);
+    EXPECT_EQ(poll.poll(10), 1);
+
+    char buffer[20];
+    EXPECT_EQ(read_fd(fd[0], buffer, sizeof(buffer)), 10);
+
+    // back to level triggered
+    EXPECT_TRUE(poll.set_edge_triggered(false));
+    EXPECT_EQ(write_fd(fd[1], "hello", 5), 5);
+    EXPECT_EQ(poll.poll(10), 1);
+    EXPECT_EQ(poll.poll(10), 1);
+}
+
+TEST_F(TestPoll, test_poll_closed_fd_reused)
+{
+    if (!Poll::is_backend_available(PollBackend::epoll))
+        GTEST_SKIP() << "epoll is not available";
+
+    Poll poll(2);
+    EXPECT_TRUE(poll.set_backend(PollBackend::epoll));
+
+    int fd[2];
+    ASSERT_TRUE(make_fd_pair(fd));
+    EXPECT_TRUE(poll.set_read_fd(fd[0]));
+    // closed without being cleared: leaves the epoll set
+    close_fd(fd[0]);
+    close_fd(fd[1]);
+
+    ASSERT_TRUE(make_fd_pair(fd));
+    _to_close.push_back(fd[0]);
+    _to_close.push_back(fd[1]);
+    EXPECT_TRUE(poll.set_read_fd(fd[0]));
+    EXPECT_TRUE(poll.set_write_fd(fd[0]));
+    EXPECT_TRUE(poll.rm_write_fd(fd[0]));
+    EXPECT_EQ(write_fd(fd[1], "hello", 5), 5);
+    EXPECT_EQ(poll.poll(10), 1);
+    ASSERT_EQ(poll.events().size(), 1u);
+    EXPECT_EQ(poll.events()[0].fd, fd[0]);
+}
+
 } // namespace test
@@ -0,0 +1,131 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <sihd/util/RingQueue.hpp>
+#include <sihd/util/SafeQueue.hpp>
+#include <sihd/util/Stopwatch.hpp>
+#include <sihd/util/time.hpp>
+
+using namespace sihd::util;
+
+constexpr size_t values_per_run = 2'000'000;
+constexpr size_t ring_capacity = 4096;
+// consumers stop when popping this value
+constexpr size_t stop_value = 0;
+
+template <typename Queue>
+bool queue_push(Queue & queue, size_t value)
+{
+    if constexpr (requires { queue.push_wait(value); })
+        return queue.push_wait(value);
+    else
+        return queue.push(value);
+}
+
+struct BenchResult
+{
+        sihd::util::Duration elapsed;
+        double mops;
+        bool valid;
+};
+
+template <typename Queue>
+BenchResult bench_queue(Queue & queue, size_t producers, size_t consumers)
+{
+    const size_t values_per_producer = values_per_run / producers;
+
+    std::atomic<size_t> popped {0};
+    std::vector<std::thread> consumer_threads;
+    std::vector<std::thread> producer_threads;
+
+    Stopwatch sw;
+
+    for (size_t i = 0; i < consumers; ++i)
+    {
+        consumer_threads.emplace_back([&queue, &popped] {
+            size_t count = 0;
+            while (queue.pop() != stop_value)
+                ++count;
+            popped.fetch_add(count, std::memory_order_relaxed);
+        });
+    }
+
+    for (size_t i = 0; i < producers; ++i)
+    {
+        producer_threads.emplace_back([&queue, values_per_producer] {
+            for (size_t j = 1; j <= values_per_producer; ++j)
+                queue_push(queue, j);
+        });
+    }
+
+    for (auto & thread : producer_threads)
+        thread.join();
+    for (size_t i = 0; i < consumers; ++i)
+        queue_push(queue, stop_value);
+    for (auto & thread : consumer_threads)
+        thread.join();
+
+    sihd::util::Duration elapsed = sw.time();
+    const size_t total = values_per_producer * producers;
+
+    return {
+        .elapsed = elapsed,
+        .mops = (double)total / ((double)elapsed.nanoseconds() / 1e9) / 1e6,
+        .valid = popped.load() == total,
+    };
+}
+
+void print_row(const char *label, size_t producers, size_t consumers, const BenchResult & r)
+{
+    fmt::print("{:<12s} {:>9d} {:>9d} {:>12d} {:>10.2f} {:>6s}\n",
+               label,
+               producers,
+               consumers,
+               time::to_milli(r.elapsed),
+               r.mops,
+               r.valid ? "OK" : "FAIL");
+}
+
+int main()
+{
+    fmt::print("Pushing {} values through each queue (ring capacity: {})\n\n", values_per_run, ring_capacity);
+
+    fmt::print("{:<12s} {:>9s} {:>9s} {:>12s} {:>10s} {:>6s}\n",
+               "Queue",
+               "Producers",
+               "Consumers",
+               "Time (ms)",
+               "Mops/s",
+               "Check");
+    fmt::print("{:-<12s}-{:-<9s}-{:-<9s}-{:-<12s}-{:-<10s}-{:-<6s}\n", "", "", "", "", "", "");
+
+    for (size_t consumers : {1, 4})
+    {
+        for (size_t producers : {1, 4, 16})
+        {
+            {
+                SafeQueue<size_t> queue;
+                print_row("SafeQueue", producers, consumers, bench_queue(queue, producers, consumers));
+            }
+            {
+                MpmcQueue<size_t> queue(ring_capacity);
+                print_row("MpmcQueue", producers, consumers, bench_queue(queue, producers, consumers));
+            }
+            if (consumers == 1)
+            {
+                MpscQueue<size_t> queue(ring_capacity);
+                print_row("MpscQueue", producers, consumers, bench_queue(queue, producers, consumers));
+            }
+            if (consumers == 1 && producers == 1)
+            {
+                SpscQueue<size_t> queue(ring_capacity);
+                print_row("SpscQueue", producers, consumers, bench_queue(queue, producers, consumers));
+            }
+        }
+    }
+
+    return 0;
+}
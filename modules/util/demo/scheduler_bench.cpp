@@ -2,6 +2,7 @@
 #include <cmath>
 #include <mutex>
 #include <numeric>
+#include <utility>
 #include <vector>
 
 #include <fmt/format.h>
@@ -48,9 +49,13 @@ struct LatencyResult
         PSquareStat<long long> jitter;
 };
 
-LatencyResult bench_latency(size_t task_count, sihd::util::Duration interval_ns, sihd::util::Duration run_duration_ns)
+LatencyResult bench_latency(size_t task_count,
+                            sihd::util::Duration interval_ns,
+                            sihd::util::Duration run_duration_ns,
+                            Scheduler::Backend backend = Scheduler::Backend::Map)
 {
     Scheduler scheduler("bench_latency");
+    scheduler.set_backend(backend);
     SteadyClock clock;
     scheduler.set_clock(&clock);
     scheduler.overrun_at = interval_ns / 2;
@@ -177,10 +182,13 @@ struct ThroughputResult
         size_t overruns;
 };
 
-ThroughputResult
-    bench_throughput(size_t task_count, sihd::util::Duration interval_ns, sihd::util::Duration run_duration_ns)
+ThroughputResult bench_throughput(size_t task_count,
+                                  sihd::util::Duration interval_ns,
+                                  sihd::util::Duration run_duration_ns,
+                                  Scheduler::Backend backend = Scheduler::Backend::Map)
 {
     Scheduler scheduler("bench_throughput");
+    scheduler.set_backend(backend);
     SteadyClock clock;
     scheduler.set_clock(&clock);
     scheduler.overrun_at = interval_ns / 2;
@@ -299,6 +307,25 @@ ResolutionResult find_resolution(sihd::util::Duration run_duration_ns)
     };
 }
 
+// --- Phase 4: Backends ---
+
+void compare_backends(sihd::util::Duration run_duration_ns)
+{
+    constexpr sihd::util::Duration interval = sihd::util::time::milli(100);
+
+    print_latency_header();
+    for (size_t tasks : {10'000, 100'000})
+    {
+        // tasks start at once: every task of a tick shares the same deadline
+        for (auto [backend, name] : {std::pair {Scheduler::Backend::Map, "map"},
+                                     std::pair {Scheduler::Backend::Wheel, "wheel"}})
+        {
+            auto r = bench_latency(tasks, interval, run_duration_ns, backend);
+            print_latency_row(fmt::format("{:<5s} {}kT @ 10 Hz", name, tasks / 1000).c_str(), r);
+        }
+    }
+}
+
 // --- Main ---
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
@@ -393,6 +420,14 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
 
     auto resolution = find_resolution(phase_duration);
 
+    // --- Phase 4: Backends comparison ---
+    fmt::print(
+        "\n── Phase 4: Backends ──────────────────────────────────────────────────────────────────────────────────\n");
+    fmt::print("  Map and timing wheel backends with many periodic tasks (duration: {} ms per test)\n\n",
+               time::to_milli(phase_duration * 2));
+
+    compare_backends(phase_duration * 2);
+
     // --- Summary ---
     fmt::print(
         "\n══════════════════════════════════════════════════════════════════════════════════════════════════════\n");
@@ -0,0 +1,198 @@
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <sihd/util/SafeQueue.hpp>
+#include <sihd/util/Stopwatch.hpp>
+#include <sihd/util/ThreadPool.hpp>
+#include <sihd/util/time.hpp>
+
+using namespace sihd::util;
+
+constexpr size_t jobs_per_run = 500'000;
+// futures are collected by windows to keep slots cycling through the pool
+constexpr size_t window = 1024;
+
+/* ************************************************************************* */
+/* Allocation counting */
+/* ************************************************************************* */
+
+std::atomic<size_t> g_allocations = 0;
+
+void *operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+/* ************************************************************************* */
+/* Previous job path: std::function queue + shared packaged_task */
+/* ************************************************************************* */
+
+class LegacyPool
+{
+    public:
+        LegacyPool(size_t number_of_threads)
+        {
+            for (size_t i = 0; i < number_of_threads; ++i)
+            {
+                _threads.emplace_back([this] {
+                    try
+                    {
+                        while (true)
+                            _jobs.pop()();
+                    }
+                    catch (const std::invalid_argument &)
+                    {
+                        // queue terminated
+                    }
+                });
+            }
+        }
+
+        ~LegacyPool()
+        {
+            _jobs.terminate();
+            for (auto & thread : _threads)
+                thread.join();
+        }
+
+        template <typename Function>
+        std::future<std::invoke_result_t<Function>> add_job(Function && function)
+        {
+            using PackagedTask = std::packaged_task<std::invoke_result_t<Function>()>;
+            auto packed_task = std::make_shared<PackagedTask>(std::forward<Function>(function));
+            auto future = packed_task->get_future();
+            _jobs.push([packed_task] { (*packed_task)(); });
+            return future;
+        }
+
+    private:
+        SafeQueue<std::function<void()>> _jobs;
+        std::vector<std::thread> _threads;
+};
+
+/* ************************************************************************* */
+/* Bench */
+/* ************************************************************************* */
+
+struct BenchResult
+{
+        sihd::util::Duration elapsed;
+        double kjobs;
+        double allocs_per_job;
+        bool valid;
+};
+
+// typical job capture: a few pointers and values
+struct Payload
+{
+        std::array<size_t, 4> values;
+};
+
+template <typename Submit>
+BenchResult bench(Submit && submit)
+{
+    std::atomic<size_t> sum = 0;
+    Payload payload {{1, 2, 3, 4}};
+
+    const size_t allocations_before = g_allocations.load();
+    Stopwatch sw;
+    submit([&sum, payload] { sum.fetch_add(payload.values[0], std::memory_order_relaxed); });
+    // posted jobs may still be running once taken
+    while (sum.load() < jobs_per_run)
+        std::this_thread::yield();
+    sihd::util::Duration elapsed = sw.time();
+    const size_t allocations = g_allocations.load() - allocations_before;
+
+    return {
+        .elapsed = elapsed,
+        .kjobs = (double)jobs_per_run / ((double)elapsed.nanoseconds() / 1e9) / 1e3,
+        .allocs_per_job = (double)allocations / (double)jobs_per_run,
+        .valid = sum.load() == jobs_per_run,
+    };
+}
+
+template <typename Pool, typename Future>
+void run_with_futures(Pool & pool, std::vector<Future> & futures, auto & job)
+{
+    for (size_t done = 0; done < jobs_per_run; done += window)
+    {
+        for (size_t i = 0; i < window && done + i < jobs_per_run; ++i)
+            futures.emplace_back(pool.add_job(job));
+        for (auto & future : futures)
+            future.get();
+        futures.clear();
+    }
+}
+
+void print_row(const char *label, size_t threads, const BenchResult & r)
+{
+    fmt::print("{:<20s} {:>7d} {:>12d} {:>12.1f} {:>12.2f} {:>6s}\n",
+               label,
+               threads,
+               time::to_milli(r.elapsed),
+               r.kjobs,
+               r.allocs_per_job,
+               r.valid ? "OK" : "FAIL");
+}
+
+int main()
+{
+    fmt::print("Submitting {} jobs of {} bytes captures\n\n", jobs_per_run, sizeof(Payload) + sizeof(void *));
+
+    fmt::print("{:<20s} {:>7s} {:>12s} {:>12s} {:>12s} {:>6s}\n",
+               "Pool",
+               "Threads",
+               "Time (ms)",
+               "Kjobs/s",
+               "Allocs/job",
+               "Check");
+    fmt::print("{:-<20s}-{:-<7s}-{:-<12s}-{:-<12s}-{:-<12s}-{:-<6s}\n", "", "", "", "", "", "");
+
+    for (size_t threads : {1, 4})
+    {
+        {
+            LegacyPool pool(threads);
+            std::vector<std::future<void>> futures;
+            futures.reserve(window);
+            print_row("legacy add_job", threads, bench([&](auto job) { run_with_futures(pool, futures, job); }));
+        }
+        {
+            ThreadPool pool("bench", threads);
+            std::vector<ThreadPool::Future<void>> futures;
+            futures.reserve(window);
+            // warm up the slot cache
+            auto noop = [] {};
+            run_with_futures(pool, futures, noop);
+            print_row("ThreadPool add_job", threads, bench([&](auto job) { run_with_futures(pool, futures, job); }));
+            print_row("ThreadPool post_job", threads, bench([&](auto job) {
+                          for (size_t i = 0; i < jobs_per_run; ++i)
+                              pool.post_job(job);
+                          pool.wait_all_jobs();
+                      }));
+        }
+    }
+
+    return 0;
+}
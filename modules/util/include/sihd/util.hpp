@@ -35,9 +35,11 @@
 #include <sihd/util/IRunnable.hpp>
 #include <sihd/util/ISteppable.hpp>
 #include <sihd/util/IWriter.hpp>
+#include <sihd/util/InplaceFunction.hpp>
 #include <sihd/util/LoadingBar.hpp>
 #include <sihd/util/LogInfo.hpp>
 #include <sihd/util/Logger.hpp>
+#include <sihd/util/LoggerAsync.hpp>
 #include <sihd/util/LoggerConsole.hpp>
 #include <sihd/util/LoggerFilter.hpp>
 #include <sihd/util/LoggerManager.hpp>
@@ -47,10 +49,12 @@
 #include <sihd/util/MessageField.hpp>
 #include <sihd/util/Named.hpp>
 #include <sihd/util/Node.hpp>
+#include <sihd/util/ObjectPool.hpp>
 #include <sihd/util/Observable.hpp>
 #include <sihd/util/ObservableDelegate.hpp>
 #include <sihd/util/ObserverWaiter.hpp>
 #include <sihd/util/Providers.hpp>
+#include <sihd/util/RingQueue.hpp>
 #include <sihd/util/Runnable.hpp>
 #include <sihd/util/SafeQueue.hpp>
 #include <sihd/util/Scheduler.hpp>
@@ -71,10 +75,13 @@
 #include <sihd/util/TimeBase.hpp>
 #include <sihd/util/Timer.hpp>
 #include <sihd/util/Timestamp.hpp>
+#include <sihd/util/TimingWheel.hpp>
 #include <sihd/util/Url.hpp>
 #include <sihd/util/Value.hpp>
 #include <sihd/util/Waitable.hpp>
+#include <sihd/util/WorkStealingDeque.hpp>
 #include <sihd/util/Worker.hpp>
+#include <sihd/util/array_reduce.hpp>
 #include <sihd/util/array_utils.hpp>
 #include <sihd/util/build.hpp>
 #include <sihd/util/container.hpp>
@@ -1,6 +1,9 @@
 #ifndef __SIHD_UTIL_ALOGGER_HPP__
 #define __SIHD_UTIL_ALOGGER_HPP__
 
+#include <string>
+#include <string_view>
+
 #include <sihd/util/ALogFilterer.hpp>
 #include <sihd/util/ILoggerFilter.hpp>
 #include <sihd/util/LogInfo.hpp>
@@ -16,6 +19,18 @@ class ALogger: public ALogFilterer
 
         virtual void log(const LogInfo & info, std::string_view msg) = 0;
 
+        /**
+         * Loggers writing lines to a file descriptor can have their lines formatted on the logging thread and
+         * written by batches (LoggerAsync): line_fd returns the descriptor or -1 if unsupported, format_line
+         * appends the line of a log and must be callable from several threads at once.
+         */
+        virtual int line_fd() const { return -1; }
+        virtual void format_line([[maybe_unused]] const LogInfo & info,
+                                 [[maybe_unused]] std::string_view msg,
+                                 [[maybe_unused]] std::string & line) const
+        {
+        }
+
     private:
 };
 
@@ -0,0 +1,187 @@
+#ifndef __SIHD_UTIL_INPLACEFUNCTION_HPP__
+#define __SIHD_UTIL_INPLACEFUNCTION_HPP__
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sihd::util
+{
+
+template <typename Signature, size_t Capacity = 64>
+class InplaceFunction;
+
+namespace detail
+{
+
+template <typename T>
+struct IsStdFunction: std::false_type
+{
+};
+
+template <typename Signature>
+struct IsStdFunction<std::function<Signature>>: std::true_type
+{
+};
+
+} // namespace detail
+
+/**
+ * Move-only callable holder storing the callable inside the object.
+ *
+ * Callables up to Capacity bytes (lambda captures, function pointers, std::function...) never allocate.
+ * Bigger callables are still accepted but are moved to the heap, check is_inline<F> to assert against it.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+    private:
+        template <typename Function>
+        using Decayed = std::decay_t<Function>;
+
+    public:
+        static constexpr size_t capacity = Capacity;
+
+        template <typename Function>
+        static constexpr bool is_inline = sizeof(Decayed<Function>) <= Capacity
+                                          && alignof(Decayed<Function>) <= alignof(std::max_align_t)
+                                          && std::is_nothrow_move_constructible_v<Decayed<Function>>;
+
+        InplaceFunction() noexcept: _ops(nullptr) {}
+        InplaceFunction(std::nullptr_t) noexcept: _ops(nullptr) {}
+
+        template <typename Function>
+            requires(!std::is_same_v<Decayed<Function>, InplaceFunction>
+                     && std::is_invocable_r_v<R, Decayed<Function> &, Args...>)
+        InplaceFunction(Function && function): _ops(nullptr)
+        {
+            using Callable = Decayed<Function>;
+            // function references decay to pointers that cannot be null
+            using Given = std::remove_cvref_t<Function>;
+
+            if constexpr (std::is_pointer_v<Given> || std::is_member_pointer_v<Given>
+                          || detail::IsStdFunction<Given>::value)
+            {
+                if (function == nullptr)
+                    return;
+            }
+
+            if constexpr (is_inline<Callable>)
+            {
+                new (&_storage) Callable(std::forward<Function>(function));
+                _ops = &Ops<Callable>::table;
+            }
+            else
+            {
+                using Boxed = std::unique_ptr<Callable>;
+                new (&_storage) Boxed(std::make_unique<Callable>(std::forward<Function>(function)));
+                _ops = &BoxedOps<Callable>::table;
+            }
+        }
+
+        InplaceFunction(InplaceFunction && other) noexcept: _ops(other._ops)
+        {
+            if (_ops != nullptr)
+            {
+                _ops->move(&_storage, &other._storage);
+                other._ops = nullptr;
+            }
+        }
+
+        InplaceFunction & operator=(InplaceFunction && other) noexcept
+        {
+            if (this != &other)
+            {
+                this->reset();
+                if (other._ops != nullptr)
+                {
+                    _ops = other._ops;
+                    _ops->move(&_storage, &other._storage);
+                    other._ops = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        InplaceFunction & operator=(std::nullptr_t) noexcept
+        {
+            this->reset();
+            return *this;
+        }
+
+        InplaceFunction(const InplaceFunction &) = delete;
+        InplaceFunction & operator=(const InplaceFunction &) = delete;
+
+        ~InplaceFunction() { this->reset(); }
+
+        R operator()(Args... args)
+        {
+            if (_ops == nullptr)
+                throw std::bad_function_call();
+            return _ops->invoke(&_storage, std::forward<Args>(args)...);
+        }
+
+        void reset() noexcept
+        {
+            if (_ops != nullptr)
+            {
+                _ops->destroy(&_storage);
+                _ops = nullptr;
+            }
+        }
+
+        explicit operator bool() const noexcept { return _ops != nullptr; }
+
+    protected:
+
+    private:
+        struct OpsTable
+        {
+                R (*invoke)(void *storage, Args &&...args);
+                void (*move)(void *dst, void *src) noexcept;
+                void (*destroy)(void *storage) noexcept;
+        };
+
+        template <typename Callable>
+        struct Ops
+        {
+                static R invoke(void *storage, Args &&...args)
+                {
+                    return std::invoke(*static_cast<Callable *>(storage), std::forward<Args>(args)...);
+                }
+
+                static void move(void *dst, void *src) noexcept
+                {
+                    Callable *src_callable = static_cast<Callable *>(src);
+                    new (dst) Callable(std::move(*src_callable));
+                    src_callable->~Callable();
+                }
+
+                static void destroy(void *storage) noexcept { static_cast<Callable *>(storage)->~Callable(); }
+
+                static constexpr OpsTable table = {&invoke, &move, &destroy};
+        };
+
+        template <typename Callable>
+        struct BoxedOps
+        {
+                using Boxed = std::unique_ptr<Callable>;
+
+                static R invoke(void *storage, Args &&...args)
+                {
+                    return std::invoke(**static_cast<Boxed *>(storage), std::forward<Args>(args)...);
+                }
+
+                static constexpr OpsTable table = {&invoke, &Ops<Boxed>::move, &Ops<Boxed>::destroy};
+        };
+
+        alignas(std::max_align_t) std::byte _storage[Capacity];
+        const OpsTable *_ops;
+};
+
+} // namespace sihd::util
+
+#endif
@@ -1,10 +1,13 @@
 #ifndef __SIHD_UTIL_LOGGER_HPP__
 #define __SIHD_UTIL_LOGGER_HPP__
 
+#include <atomic>
+#include <iterator>
 #include <string>
 #include <string_view>
 
 #include <fmt/core.h>
+#include <fmt/format.h>
 #include <fmt/printf.h>
 
 #include <sihd/util/LoggerManager.hpp>
@@ -32,12 +35,24 @@
 # define SIHD_COUTV(message, ...) fmt::print(#message " = {}\n", message)
 # define SIHD_CERR(message, ...) fmt::print(stderr, message, ##__VA_ARGS__)
 
-# define SIHD_LOG_LVL(level, message, ...) __sihd_logger__.log(level, fmt::format(message, ##__VA_ARGS__))
+// Levels less severe than this one are compiled out of SIHD_LOG (ex: -DSIHD_LOG_MIN_LEVEL=info)
+# ifndef SIHD_LOG_MIN_LEVEL
+#  define SIHD_LOG_MIN_LEVEL debug
+# endif
+
+# define __SIHD_LOG_COMPILED(level) (sihd::util::LogLevel::level <= sihd::util::LogLevel::SIHD_LOG_MIN_LEVEL)
+
+// Arguments are neither evaluated nor formatted if the level is disabled
+# define SIHD_LOG_LVL(level, message, ...)                                                                              \
+     (__sihd_logger__.is_enabled(level) ? __sihd_logger__.log_format(level, message, ##__VA_ARGS__) : void())
 // Log with printf like format
-# define SIHD_LOG_LVL_FORMAT(level, message, ...) __sihd_logger__.log(level, fmt::sprintf(message, ##__VA_ARGS__))
-# define SIHD_LOG(level, message, ...) SIHD_LOG_LVL(sihd::util::LogLevel::level, message, ##__VA_ARGS__)
+# define SIHD_LOG_LVL_FORMAT(level, message, ...)                                                                       \
+     (__sihd_logger__.is_enabled(level) ? __sihd_logger__.log(level, fmt::sprintf(message, ##__VA_ARGS__)) : void())
+# define SIHD_LOG(level, message, ...)                                                                                  \
+     (__SIHD_LOG_COMPILED(level) ? SIHD_LOG_LVL(sihd::util::LogLevel::level, message, ##__VA_ARGS__) : void())
 // Log with printf like format
-# define SIHD_LOG_FORMAT(level, message, ...) SIHD_LOG_LVL_FORMAT(sihd::util::LogLevel::level, message, ##__VA_ARGS__)
+# define SIHD_LOG_FORMAT(level, message, ...)                                                                           \
+     (__SIHD_LOG_COMPILED(level) ? SIHD_LOG_LVL_FORMAT(sihd::util::LogLevel::level, message, ##__VA_ARGS__) : void())
 
 # define SIHD_LOG_EMERG(message, ...) SIHD_LOG(emergency, message, ##__VA_ARGS__)
 # define SIHD_LOG_ALERT(message, ...) SIHD_LOG(alert, message, ##__VA_ARGS__)
@@ -91,7 +106,55 @@ class Logger
 
         void log(LogLevel level, std::string_view msg);
 
+        // formats into a buffer reused by the thread then logs
+        template <typename... Args>
+        void log_format(LogLevel level, fmt::format_string<Args...> format, Args &&...args)
+        {
+            ThreadBuffer & thread_buffer = Logger::_thread_buffer();
+            if (thread_buffer.used)
+            {
+                // logging from a formatter or a logger: the buffer is taken
+                this->log(level, fmt::format(format, std::forward<Args>(args)...));
+                return;
+            }
+            BufferGuard guard(thread_buffer);
+            fmt::format_to(std::back_inserter(thread_buffer.buffer), format, std::forward<Args>(args)...);
+            this->log(level, std::string_view(thread_buffer.buffer.data(), thread_buffer.buffer.size()));
+        }
+
+        // messages less severe than level are dropped before being formatted
+        void set_level(LogLevel level) { _level.store(level, std::memory_order_relaxed); }
+        LogLevel level() const { return _level.load(std::memory_order_relaxed); }
+
+        bool is_enabled(LogLevel level) const
+        {
+            return level <= _level.load(std::memory_order_relaxed) && LoggerManager::is_enabled(level);
+        }
+
         std::string name;
+
+    private:
+        struct ThreadBuffer
+        {
+                fmt::memory_buffer buffer;
+                bool used = false;
+        };
+
+        struct BufferGuard
+        {
+                BufferGuard(ThreadBuffer & thread_buffer): thread_buffer(thread_buffer)
+                {
+                    thread_buffer.buffer.clear();
+                    thread_buffer.used = true;
+                }
+                ~BufferGuard() { thread_buffer.used = false; }
+
+                ThreadBuffer & thread_buffer;
+        };
+
+        static ThreadBuffer & _thread_buffer();
+
+        std::atomic<LogLevel> _level;
 };
 
 } // namespace sihd::util
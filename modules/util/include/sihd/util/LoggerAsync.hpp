@@ -0,0 +1,120 @@
+#ifndef __SIHD_UTIL_LOGGERASYNC_HPP__
+#define __SIHD_UTIL_LOGGERASYNC_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sihd/util/ALogger.hpp>
+#include <sihd/util/Timestamp.hpp>
+
+struct iovec;
+
+namespace sihd::util
+{
+
+/**
+ * Writes the logs of a sink from a background thread.
+ *
+ * The sink must write lines to a file descriptor (see ALogger::line_fd), it is owned by this logger. Each
+ * logging thread formats its lines with the sink into its own single producer / single consumer ring of
+ * preallocated lines, the background thread merges the rings in time order and writes them with one writev
+ * per batch. Once the rings are warm, logging does not allocate.
+ *
+ * flush() writes every line logged before the call from the calling thread, use it before exiting or from
+ * crash handlers. The remaining lines are flushed on destruction.
+ */
+class LoggerAsync: public ALogger
+{
+    public:
+        // what to do with a log when the ring of its thread is full
+        enum class Overflow
+        {
+            // the log is dropped and counted
+            Drop,
+            // the logging thread waits for the background thread
+            Block
+        };
+
+        struct Options
+        {
+                // lines per logging thread
+                size_t capacity = 1024;
+                Overflow overflow = Overflow::Drop;
+                // write period, the background thread is woken up sooner when a ring is half full
+                Duration interval = time::milli(10);
+        };
+
+        struct Stats
+        {
+                size_t logged;
+                size_t written;
+                size_t dropped;
+                // writev calls
+                size_t batches;
+        };
+
+        LoggerAsync(ALogger *sink);
+        LoggerAsync(ALogger *sink, const Options & options);
+        virtual ~LoggerAsync();
+
+        // formats the line into the ring of the calling thread
+        void log(const LogInfo & info, std::string_view msg) override;
+
+        // writes the lines logged so far
+        void flush();
+
+        ALogger *sink() const { return _sink_ptr.get(); }
+        const Options & options() const { return _options; }
+        Stats stats() const;
+
+    protected:
+
+    private:
+        struct Ring;
+
+        Ring *_thread_ring();
+        std::shared_ptr<Ring> _attach_ring();
+        void _wake();
+        void _run();
+        // writes the batched lines then releases them to their rings
+        void _write_batch(size_t count);
+
+        std::unique_ptr<ALogger> _sink_ptr;
+        Options _options;
+        int _fd;
+        // identifies this logger in the rings cache of threads
+        uint64_t _id;
+
+        std::mutex _rings_mutex;
+        std::vector<std::shared_ptr<Ring>> _rings;
+
+        // single consumer of the rings
+        std::mutex _flush_mutex;
+        struct Cursor
+        {
+                Ring *ring;
+                size_t head;
+                size_t tail;
+        };
+        std::vector<Cursor> _cursors;
+        std::vector<struct iovec> _iovecs;
+
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        std::atomic<bool> _wakeup;
+        bool _stop;
+        std::thread _thread;
+
+        std::atomic<size_t> _logged;
+        std::atomic<size_t> _written;
+        std::atomic<size_t> _dropped;
+        std::atomic<size_t> _batches;
+};
+
+} // namespace sihd::util
+
+#endif
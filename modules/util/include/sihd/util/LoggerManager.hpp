@@ -1,6 +1,7 @@
 #ifndef __SIHD_UTIL_LOGGERMANAGER_HPP__
 #define __SIHD_UTIL_LOGGERMANAGER_HPP__
 
+#include <atomic>
 #include <cstdio>
 #include <mutex>
 #include <optional>
@@ -41,7 +42,10 @@ class LoggerManager: public ALogFilterer
                     it = _loggers_lst.erase(it);
                     found = true;
                 }
+                else
+                    ++it;
             }
+            _loggers_count = _loggers_lst.size();
             return found;
         }
 
@@ -49,6 +53,17 @@ class LoggerManager: public ALogFilterer
 
         static void log(const std::string & src, LogLevel level, std::string_view msg);
 
+        // messages less severe than level are dropped before being formatted
+        static void set_level(LogLevel level);
+        static LogLevel level();
+
+        // cheap check done before formatting a message: false if no logger would receive it
+        static bool is_enabled(LogLevel level)
+        {
+            return level <= _g_level.load(std::memory_order_relaxed)
+                   && _g_singleton._loggers_count.load(std::memory_order_relaxed) > 0;
+        }
+
         static void stream(FILE *output = stderr,
                            bool print_thread_id = false,
                            std::optional<LoggerFilter::Options> options = std::nullopt);
@@ -68,7 +83,9 @@ class LoggerManager: public ALogFilterer
 
     private:
         static LoggerManager _g_singleton;
+        static std::atomic<LogLevel> _g_level;
         std::vector<ALogger *> _loggers_lst;
+        std::atomic<size_t> _loggers_count {0};
         mutable std::mutex _mutex;
 };
 
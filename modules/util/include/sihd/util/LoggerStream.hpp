@@ -14,6 +14,9 @@ class LoggerStream: public ALogger
 
         void log(const LogInfo & info, std::string_view msg) override;
 
+        int line_fd() const override;
+        void format_line(const LogInfo & info, std::string_view msg, std::string & line) const override;
+
         bool print_thread_id;
 
     private:
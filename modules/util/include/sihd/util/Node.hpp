@@ -138,6 +138,8 @@ class Node: public Named
         bool remove_link(const std::string & link);
         Named *resolve_link(const std::string & path, size_t recursion = 0);
         bool resolve_links(size_t recursion = 0);
+        // link name to path
+        const std::unordered_map<std::string, std::string> & links() const;
 
         // Tree description
         std::string tree_str() const { return this->tree_str({}); };
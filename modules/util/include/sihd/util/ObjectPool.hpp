@@ -0,0 +1,86 @@
+#ifndef __SIHD_UTIL_OBJECTPOOL_HPP__
+#define __SIHD_UTIL_OBJECTPOOL_HPP__
+
+#include <new>
+#include <optional>
+#include <utility>
+
+#include <sihd/util/RingQueue.hpp>
+
+namespace sihd::util
+{
+
+/**
+ * Thread-safe cache of raw storage for objects of type T.
+ *
+ * Released storage is kept (up to max_cached blocks) for the next allocation so that objects constantly
+ * created and deleted from different threads stop hitting the allocator once the cache is warm.
+ * Useful as backend of a class specific operator new / operator delete.
+ */
+template <typename T>
+class ObjectPool
+{
+    public:
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "ObjectPool does not handle over-aligned types");
+
+        ObjectPool(size_t max_cached = 1024): _free_blocks(max_cached) {}
+
+        ~ObjectPool()
+        {
+            while (std::optional<void *> block = _free_blocks.try_pop())
+                ::operator delete(*block);
+        }
+
+        ObjectPool(const ObjectPool &) = delete;
+        ObjectPool & operator=(const ObjectPool &) = delete;
+
+        void *allocate()
+        {
+            std::optional<void *> block = _free_blocks.try_pop();
+            if (block.has_value())
+                return *block;
+            return ::operator new(sizeof(T));
+        }
+
+        void deallocate(void *block)
+        {
+            if (block == nullptr)
+                return;
+            if (!_free_blocks.push(block))
+                ::operator delete(block);
+        }
+
+        template <typename... Args>
+        T *create(Args &&...args)
+        {
+            void *block = this->allocate();
+            try
+            {
+                return new (block) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                this->deallocate(block);
+                throw;
+            }
+        }
+
+        void destroy(T *ptr)
+        {
+            if (ptr == nullptr)
+                return;
+            ptr->~T();
+            this->deallocate(ptr);
+        }
+
+        size_t cached() const { return _free_blocks.size(); }
+
+    protected:
+
+    private:
+        MpmcQueue<void *> _free_blocks;
+};
+
+} // namespace sihd::util
+
+#endif
@@ -2,8 +2,12 @@
 #define __SIHD_UTIL_OBSERVABLE_HPP__
 
 #include <algorithm>
-#include <list>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include <sihd/util/IHandler.hpp>
 #include <sihd/util/IObservable.hpp>
@@ -11,76 +15,207 @@
 namespace sihd::util
 {
 
+/**
+ * Observers are kept in an immutable array replaced on each add / remove (copy on write).
+ * Notifying walks the current array without locking, adding or removing observers pays the copy and waits
+ * for the notifications in progress to release the previous array - for as long as the slowest observer takes.
+ *
+ * Observers added during a notification are notified in the same pass if appended, removed observers are not
+ * notified anymore. Once remove_observer returned, no notification still uses the observer, unless it is called
+ * from a notification of this observable: the previous array is then freed by a later add / remove.
+ */
 template <typename T>
 class Observable: public IObservable<T>
 {
     public:
-        Observable() = default;
-        virtual ~Observable() = default;
+        Observable(): _current(new Observers()), _phase(0), _readers {0, 0} {}
 
-        bool add_observer(IHandler<T *> *obs, bool add_to_front = false)
+        virtual ~Observable()
         {
-            std::lock_guard l(_mutex);
+            delete _current.load();
+            for (const Observers *observers : _retired)
+                delete observers;
+        }
 
-            if (this->is_observer(obs))
-                return false;
+        bool add_observer(IHandler<T *> *obs, bool add_to_front = false)
+        {
+            {
+                std::lock_guard l(_mutex);
 
-            if (add_to_front)
-                _observers.emplace(_observers.begin(), obs);
-            else
-                _observers.emplace(_observers.end(), obs);
+                const Observers *observers = _current.load();
+                if (std::find(observers->begin(), observers->end(), obs) != observers->end())
+                    return false;
 
+                Observers *copy = new Observers();
+                copy->reserve(observers->size() + 1);
+                if (add_to_front)
+                    copy->emplace_back(obs);
+                copy->insert(copy->end(), observers->begin(), observers->end());
+                if (!add_to_front)
+                    copy->emplace_back(obs);
+                this->_publish(copy);
+            }
+            this->_reclaim();
             return true;
         }
 
         void remove_observer(IHandler<T *> *obs)
         {
-            std::lock_guard l(_mutex);
-            if (_current_observer == obs)
             {
-                _remove_current_observer = true;
-                return;
+                std::lock_guard l(_mutex);
+
+                const Observers *observers = _current.load();
+                auto it = std::find(observers->begin(), observers->end(), obs);
+                if (it == observers->end())
+                    return;
+
+                Observers *copy = new Observers();
+                copy->reserve(observers->size() - 1);
+                copy->insert(copy->end(), observers->begin(), it);
+                copy->insert(copy->end(), it + 1, observers->end());
+                this->_publish(copy);
             }
-            auto it = std::find(_observers.begin(), _observers.end(), obs);
-            if (it != _observers.end())
-                _observers.erase(it);
+            this->_reclaim();
         }
 
         bool is_observer(IHandler<T *> *obs) const
         {
-            std::lock_guard l(_mutex);
-            return std::find(_observers.cbegin(), _observers.cend(), obs) != _observers.cend();
+            const Reader reader(this);
+            const Observers *observers = _current.load();
+            return std::find(observers->begin(), observers->end(), obs) != observers->end();
         }
 
     protected:
         virtual void notify_observers(T *sender)
         {
-            std::lock_guard lock(_mutex);
-            auto it = _observers.begin();
-            while (it != _observers.end())
+            this->notify_observers_with([sender](IHandler<T *> *observer) { observer->handle(sender); });
+        }
+
+        // calls notify(observer) for each observer as notify_observers does
+        template <typename Function>
+        void notify_observers_with(Function && notify)
+        {
+            const Reader reader(this);
+
+            const Observers *observers = _current.load();
+            size_t i = 0;
+            while (true)
             {
-                _current_observer = (*it);
-                _current_observer->handle(sender);
-                if (_remove_current_observer)
+                const Observers *current = _current.load(std::memory_order_acquire);
+                if (current != observers)
                 {
-                    _remove_current_observer = false;
-                    it = _observers.erase(it);
+                    // observers changed during the notification
+                    i = this->_resume_index(*observers, i, *current);
+                    observers = current;
+                    continue;
                 }
-                else
+                if (i >= observers->size())
+                    break;
+                notify((*observers)[i]);
+                ++i;
+            }
+        }
+
+    private:
+        using Observers = std::vector<IHandler<T *> *>;
+
+        // holds the arrays of the observable until destroyed, stacked per thread
+        struct Reader
+        {
+                Reader(const Observable *observable): observable(observable), previous(_readers_stack)
+                {
+                    // a writer flipping the phase before the count is seen would not wait for this reader
+                    while (true)
+                    {
+                        phase = observable->_phase.load();
+                        observable->_readers[phase].fetch_add(1);
+                        if (observable->_phase.load() == phase)
+                            break;
+                        observable->_readers[phase].fetch_sub(1, std::memory_order_release);
+                    }
+                    _readers_stack = this;
+                }
+
+                ~Reader()
                 {
-                    ++it;
+                    _readers_stack = previous;
+                    observable->_readers[phase].fetch_sub(1, std::memory_order_release);
                 }
+
+                const Observable *observable;
+                const Reader *previous;
+                uint32_t phase;
+        };
+
+        static inline thread_local const Reader *_readers_stack = nullptr;
+
+        bool _is_reading() const
+        {
+            for (const Reader *reader = _readers_stack; reader != nullptr; reader = reader->previous)
+            {
+                if (reader->observable == this)
+                    return true;
             }
-            _current_observer = nullptr;
+            return false;
         }
 
-    private:
-        mutable std::recursive_mutex _mutex;
-        bool _remove_current_observer {false};
-        IHandler<T *> *_current_observer {nullptr};
-        std::list<IHandler<T *> *> _observers;
+        // called locked
+        void _publish(const Observers *observers) { _retired.emplace_back(_current.exchange(observers)); }
+
+        // waits for the readers which may still hold retired arrays then frees them
+        void _reclaim()
+        {
+            // this thread holds an array: left to the next writer
+            if (this->_is_reading())
+                return;
+
+            std::lock_guard sync(_sync_mutex);
+            std::vector<const Observers *> retired;
+            {
+                std::lock_guard l(_mutex);
+                retired.swap(_retired);
+            }
+            if (retired.empty())
+                return;
+
+            // readers entering after the flip can only load an array published after the retired ones
+            const uint32_t phase = _phase.load();
+            _phase.store(phase ^ 1);
+            // lasts as long as the notifications in progress: stops burning the core once they are not short
+            for (size_t spins = 0; _readers[phase].load() != 0; ++spins)
+            {
+                if (spins < 64)
+                    std::this_thread::yield();
+                else
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+
+            for (const Observers *observers : retired)
+                delete observers;
+        }
+
+        // position in changed after the last observer of previous already notified (those before index)
+        static size_t _resume_index(const Observers & previous, size_t index, const Observers & changed)
+        {
+            const auto begin = previous.begin();
+            for (size_t i = changed.size(); i > 0; --i)
+            {
+                if (std::find(begin, begin + index, changed[i - 1]) != begin + index)
+                    return i;
+            }
+            return 0;
+        }
+
+        // serializes writers
+        std::mutex _mutex;
+        // serializes reclamations
+        std::mutex _sync_mutex;
+        std::atomic<const Observers *> _current;
+        std::vector<const Observers *> _retired;
+        mutable std::atomic<uint32_t> _phase;
+        mutable std::array<std::atomic<uint32_t>, 2> _readers;
 };
 
 } // namespace sihd::util
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,293 @@
+#ifndef __SIHD_UTIL_RINGQUEUE_HPP__
+#define __SIHD_UTIL_RINGQUEUE_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <sihd/util/thread.hpp>
+
+namespace sihd::util
+{
+
+/**
+ * Bounded lock-free ring queue (D. Vyukov's sequenced slots algorithm).
+ *
+ * Each side only pays a compare-and-swap when it is shared by several threads, single producer or single
+ * consumer sides use plain stores. Blocking calls spin a little and then park on an atomic wait, they only
+ * park when the ring is really empty (pop) or full (push_wait).
+ *
+ * Unlike SafeQueue, terminate does not drain the ring because it may be called from a thread that is
+ * neither a producer nor a consumer: use clear from the consumer side for that.
+ */
+template <typename T, bool MultiProducer, bool MultiConsumer>
+class RingQueue
+{
+    public:
+        static_assert(std::is_move_constructible_v<T>, "RingQueue value type must be move constructible");
+
+        RingQueue(size_t capacity = 1024): _terminated(false)
+        {
+            _capacity = 2;
+            while (_capacity < capacity)
+                _capacity <<= 1;
+            _mask = _capacity - 1;
+
+            _slots = std::make_unique<Slot[]>(_capacity);
+            for (size_t i = 0; i < _capacity; ++i)
+                _slots[i].sequence.store(i, std::memory_order_relaxed);
+
+            _head.store(0, std::memory_order_relaxed);
+            _tail.store(0, std::memory_order_relaxed);
+            _pop_waiters.store(0, std::memory_order_relaxed);
+            _push_waiters.store(0, std::memory_order_relaxed);
+            _push_epoch.store(0, std::memory_order_relaxed);
+            _pop_epoch.store(0, std::memory_order_relaxed);
+        }
+
+        ~RingQueue()
+        {
+            this->terminate();
+            this->clear();
+        }
+
+        RingQueue(const RingQueue &) = delete;
+        RingQueue & operator=(const RingQueue &) = delete;
+
+        // returns false if the ring is full or terminated
+        bool push(const T & value)
+        {
+            T copy(value);
+            return this->push(std::move(copy));
+        }
+
+        bool push(T && value)
+        {
+            if (_terminated.load(std::memory_order_relaxed))
+                return false;
+            if (!this->_enqueue(value))
+                return false;
+            this->_wake(_pop_waiters, _push_epoch);
+            return true;
+        }
+
+        // waits for the ring to have room - returns false if terminated
+        bool push_wait(T && value)
+        {
+            while (true)
+            {
+                if (this->push(std::move(value)))
+                    return true;
+                if (_terminated.load(std::memory_order_relaxed))
+                    return false;
+                this->_park(_push_waiters, _pop_epoch, [this] { return this->full() == false; });
+            }
+        }
+
+        bool push_wait(const T & value)
+        {
+            T copy(value);
+            return this->push_wait(std::move(copy));
+        }
+
+        std::optional<T> try_pop()
+        {
+            if (_terminated.load(std::memory_order_relaxed))
+                return std::nullopt;
+            std::optional<T> ret = this->_dequeue();
+            if (ret.has_value())
+                this->_wake(_push_waiters, _pop_epoch);
+            return ret;
+        }
+
+        T pop()
+        {
+            while (true)
+            {
+                if (_terminated.load(std::memory_order_relaxed))
+                    throw std::invalid_argument("Queue is terminated");
+
+                std::optional<T> ret = this->try_pop();
+                if (ret.has_value())
+                    return std::move(*ret);
+
+                this->_park(_pop_waiters, _push_epoch, [this] { return this->empty() == false; });
+            }
+        }
+
+        void terminate()
+        {
+            _terminated.store(true, std::memory_order_seq_cst);
+
+            _push_epoch.fetch_add(1, std::memory_order_release);
+            _pop_epoch.fetch_add(1, std::memory_order_release);
+            _push_epoch.notify_all();
+            _pop_epoch.notify_all();
+        }
+
+        bool is_terminated() const { return _terminated.load(std::memory_order_relaxed); }
+
+        // destroys every remaining value - must be called from the consumer side
+        void clear()
+        {
+            while (this->_dequeue().has_value())
+                ;
+            this->_wake(_push_waiters, _pop_epoch);
+        }
+
+        // approximation when producers or consumers are running
+        size_t size() const
+        {
+            const size_t head = _head.load(std::memory_order_acquire);
+            const size_t tail = _tail.load(std::memory_order_acquire);
+            return tail > head ? std::min(tail - head, _capacity) : 0;
+        }
+
+        bool empty() const { return this->size() == 0; }
+        bool full() const { return this->size() >= _capacity; }
+        size_t capacity() const { return _capacity; }
+
+    protected:
+
+    private:
+        // number of retries before parking a blocking call
+        static constexpr int spin_before_park = 64;
+
+        struct Slot
+        {
+                std::atomic<size_t> sequence;
+                alignas(T) std::byte storage[sizeof(T)];
+
+                T *value() { return std::launder(reinterpret_cast<T *>(storage)); }
+        };
+
+        bool _enqueue(T & value)
+        {
+            Slot *slot;
+            size_t pos = _tail.load(std::memory_order_relaxed);
+            while (true)
+            {
+                slot = &_slots[pos & _mask];
+                const size_t seq = slot->sequence.load(std::memory_order_acquire);
+                const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if (diff == 0)
+                {
+                    if constexpr (MultiProducer)
+                    {
+                        if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    }
+                    else
+                    {
+                        _tail.store(pos + 1, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = _tail.load(std::memory_order_relaxed);
+            }
+            new (slot->storage) T(std::move(value));
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        std::optional<T> _dequeue()
+        {
+            Slot *slot;
+            size_t pos = _head.load(std::memory_order_relaxed);
+            while (true)
+            {
+                slot = &_slots[pos & _mask];
+                const size_t seq = slot->sequence.load(std::memory_order_acquire);
+                const intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+                if (diff == 0)
+                {
+                    if constexpr (MultiConsumer)
+                    {
+                        if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    }
+                    else
+                    {
+                        _head.store(pos + 1, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                    return std::nullopt;
+                else
+                    pos = _head.load(std::memory_order_relaxed);
+            }
+            T *ptr = slot->value();
+            std::optional<T> ret(std::move(*ptr));
+            ptr->~T();
+            slot->sequence.store(pos + _capacity, std::memory_order_release);
+            return ret;
+        }
+
+        // the fence pairs with the one in _park so either the waiter sees the new state or we see the waiter
+        // parked waiters are claimed all at once so a burst of pushes only pays one wake up
+        void _wake(std::atomic<uint32_t> & waiters, std::atomic<uint32_t> & epoch)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_relaxed) > 0 && waiters.exchange(0, std::memory_order_acq_rel) > 0)
+            {
+                epoch.fetch_add(1, std::memory_order_release);
+                epoch.notify_all();
+            }
+        }
+
+        // a waiter registers itself each time it parks, a stale registration only costs a spurious wake up
+        template <typename Predicate>
+        void _park(std::atomic<uint32_t> & waiters, std::atomic<uint32_t> & epoch, Predicate ready)
+        {
+            for (int i = 0; i < spin_before_park; ++i)
+            {
+                if (ready() || _terminated.load(std::memory_order_relaxed))
+                    return;
+            }
+
+            waiters.fetch_add(1, std::memory_order_acq_rel);
+            const uint32_t current_epoch = epoch.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!ready() && !_terminated.load(std::memory_order_relaxed))
+                epoch.wait(current_epoch, std::memory_order_acquire);
+        }
+
+        std::atomic<bool> _terminated;
+        size_t _capacity;
+        size_t _mask;
+        std::unique_ptr<Slot[]> _slots;
+
+        alignas(thread::cache_line_size) std::atomic<size_t> _head;
+        alignas(thread::cache_line_size) std::atomic<size_t> _tail;
+        alignas(thread::cache_line_size) std::atomic<uint32_t> _pop_waiters;
+        std::atomic<uint32_t> _push_epoch;
+        alignas(thread::cache_line_size) std::atomic<uint32_t> _push_waiters;
+        std::atomic<uint32_t> _pop_epoch;
+};
+
+// any thread can push and pop
+template <typename T>
+using MpmcQueue = RingQueue<T, true, true>;
+
+// any thread can push, only one thread pops
+template <typename T>
+using MpscQueue = RingQueue<T, true, false>;
+
+// one thread pushes, one thread pops
+template <typename T>
+using SpscQueue = RingQueue<T, false, false>;
+
+} // namespace sihd::util
+
+#endif
@@ -3,15 +3,19 @@
 
 #include <atomic>
 #include <list>
-// #include <map>
+#include <map>
+#include <memory>
 #include <queue>
+#include <string_view>
 #include <thread>
 
 #include <sihd/util/AWorkerService.hpp>
 #include <sihd/util/Clocks.hpp>
 #include <sihd/util/Configurable.hpp>
 #include <sihd/util/Named.hpp>
+#include <sihd/util/SafeQueue.hpp>
 #include <sihd/util/Task.hpp>
+#include <sihd/util/TimingWheel.hpp>
 #include <sihd/util/Waitable.hpp>
 
 namespace sihd::util
@@ -22,6 +26,14 @@ class Scheduler: public Named,
                  public Configurable
 {
     public:
+        enum class Backend
+        {
+            // ordered map - O(log n), best suited for a few sparse tasks
+            Map,
+            // hierarchical timing wheel - O(1), best suited for many periodic tasks
+            Wheel,
+        };
+
         Scheduler(const std::string & name, Node *parent = nullptr);
         ~Scheduler();
 
@@ -34,7 +46,9 @@ class Scheduler: public Named,
          * will be played relative to the scheduler's unpaused run time
          */
         void add_task(Task *t);
+        // with executors, waits for the runs already dispatched to be done unless called from an executor
         bool remove_task(Task *t);
+        // with executors, waits for the runs already dispatched to be done - refused from an executor
         void clear_tasks();
 
         Timestamp now() const;
@@ -44,6 +58,20 @@ class Scheduler: public Named,
 
         bool set_no_delay(bool active);
 
+        // tasks storage: "map" (default) or "wheel" - cannot be changed while running
+        bool set_backend(std::string_view backend);
+        bool set_backend(Backend backend);
+        Backend backend() const;
+
+        /**
+         * Number of threads running the tasks - cannot be changed while running.
+         * With 0 (default) tasks run on the scheduler thread, otherwise the scheduler thread only keeps time and
+         * hands due tasks to the executors: a slow task no longer delays the others. Runs of a task always stay on
+         * the same executor so it never runs concurrently with itself, see TaskOptions overrun_policy and affinity.
+         */
+        bool set_executors(size_t count);
+        size_t executors() const;
+
         // number of overruns that occured after started
         size_t overruns;
         // time after not running a task is considered an overrun
@@ -58,16 +86,46 @@ class Scheduler: public Named,
         Waitable _waitable_task;
         std::vector<Task *> _tasks_to_add;
         std::multimap<Timestamp, Task *> _task_map;
+        TimingWheel<Task *> _task_wheel;
 
     private:
+        struct Dispatch
+        {
+                Task *task;
+                // the scheduler no longer references it: the executor trashes it once played
+                bool one_shot;
+        };
+
+        struct Executor
+        {
+                SafeQueue<Dispatch> queue;
+                // runs dispatched and not done yet
+                std::atomic<size_t> load = 0;
+                std::thread thread;
+        };
+
         void _prepare_tasks();
         void _add_task_to_trash(Task *t);
         void _delete_trashed_tasks();
         void _unprotected_add_task_to_map(Task *task);
+        bool _unprotected_remove_task_from_map(Task *task);
+        // earliest task scheduled before or at until
+        Task *_unprotected_pop_expired_task(Timestamp until);
+        Task *_unprotected_pop_next_task();
+        void _unprotected_take_all_tasks(std::vector<Task *> & tasks);
+        bool _unprotected_has_tasks() const;
+        void _unprotected_update_next_run();
 
         void _wait_for_next_task();
         Task *_get_playable_task(Timestamp now);
         void _play_task(Task *task, Timestamp now);
+        void _reschedule_task(Task *task, Timestamp now);
+
+        void _start_executors();
+        void _stop_executors();
+        void _executor_loop(Executor & executor);
+        void _dispatch_task(Task *task, bool one_shot);
+        size_t _pick_executor(const Task *task) const;
 
         void _resume_tasks();
 
@@ -83,6 +141,13 @@ class Scheduler: public Named,
 
         SystemClock _default_clock;
         bool _no_delay;
+        Backend _backend;
+
+        size_t _executors_count;
+        std::vector<std::unique_ptr<Executor>> _executors;
+        // remove_task callers waiting for dispatched runs
+        std::atomic<size_t> _runs_waiters;
+        Waitable _waitable_runs;
 };
 
 } // namespace sihd::util
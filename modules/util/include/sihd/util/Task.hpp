@@ -1,10 +1,12 @@
 #ifndef __SIHD_UTIL_TASK_HPP__
 #define __SIHD_UTIL_TASK_HPP__
 
+#include <atomic>
+#include <cstdint>
 #include <ctime>
-#include <functional>
 
 #include <sihd/util/IRunnable.hpp>
+#include <sihd/util/InplaceFunction.hpp>
 #include <sihd/util/Timestamp.hpp>
 
 namespace sihd::util
@@ -12,6 +14,17 @@ namespace sihd::util
 
 struct TaskOptions
 {
+        // what a scheduler with executors does when a task is still running at its next period
+        enum class OverrunPolicy
+        {
+            // runs again once the current run is done
+            Queue,
+            // drops the period
+            Skip,
+            // at most one run waits behind the current one
+            Coalesce,
+        };
+
         static TaskOptions none() { return TaskOptions {}; }
         // MUTUALLY EXCLUSIVE WITH RUN_IN
         // precise timestamp to run task at
@@ -21,27 +34,50 @@ struct TaskOptions
         Duration run_in = 0;
         // reschedule task based on previous time
         Duration reschedule_time = 0;
+        // only with scheduler executors
+        OverrunPolicy overrun_policy = OverrunPolicy::Queue;
+        // only with scheduler executors - index of the executor to always run on, -1 for any
+        int affinity = -1;
 };
 
 class Task: public IRunnable
 {
     public:
+        // callables up to 64 bytes are stored inside the task without allocation
+        using Method = InplaceFunction<bool(void), 64>;
+
         Task(const TaskOptions & options = TaskOptions::none());
         Task(IRunnable *to_run, const TaskOptions & options = TaskOptions::none());
-        Task(std::function<bool(void)> fun, const TaskOptions & options = TaskOptions::none());
+        Task(Method fun, const TaskOptions & options = TaskOptions::none());
         virtual ~Task();
 
         virtual bool run();
-        void set_method(std::function<bool(void)> fun);
+        void set_method(Method fun);
         void set_runnable(IRunnable *to_run);
 
         Timestamp run_at;
         Duration run_in;
         Duration reschedule_time;
+        TaskOptions::OverrunPolicy overrun_policy;
+        int affinity;
+
+        // played later than the scheduler's overrun_at
+        std::atomic<size_t> overruns;
+        // periods dropped because the task was still running
+        std::atomic<size_t> skipped;
+        // periods merged into an already waiting run
+        std::atomic<size_t> coalesced;
 
     private:
+        friend class Scheduler;
+
         IRunnable *_runnable_ptr;
-        std::function<bool(void)> _run_method;
+        Method _run_method;
+        // position in the scheduler's timing wheel
+        uint32_t _wheel_handle;
+        // runs handed to an executor and not done yet
+        std::atomic<uint32_t> _pending_runs;
+        size_t _executor;
 };
 
 } // namespace sihd::util
@@ -1,27 +1,49 @@
 #ifndef __SIHD_UTIL_THREADPOOL_HPP__
 #define __SIHD_UTIL_THREADPOOL_HPP__
 
+#include <algorithm>
 #include <atomic>
-#include <functional>
+#include <deque>
+#include <exception>
 #include <future>
+#include <latch>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <thread>
 #include <vector>
 
-#include <sihd/util/SafeQueue.hpp>
+#include <sihd/util/InplaceFunction.hpp>
+#include <sihd/util/RingQueue.hpp>
 #include <sihd/util/Stat.hpp>
+#include <sihd/util/Stopwatch.hpp>
 #include <sihd/util/Timestamp.hpp>
-#include <sihd/util/Waitable.hpp>
+#include <sihd/util/WorkStealingDeque.hpp>
 #include <sihd/util/traits.hpp>
 
 namespace sihd::util
 {
 
+/**
+ * Work stealing thread pool.
+ *
+ * Each worker owns a deque: jobs submitted from inside a worker go to its own deque, jobs submitted from
+ * other threads go to a shared injection queue. Idle workers take from their deque, then from the injection
+ * queue, then steal from the other workers before parking.
+ *
+ * Jobs live in pooled slots holding the callable and the promise of its future: once slots are recycled,
+ * submitting callables up to job_capacity bytes does not allocate.
+ */
 class ThreadPool
 {
     public:
-        using Job = std::function<void()>;
+        // callables up to this size are stored inside the job slot
+        static constexpr size_t job_capacity = 64;
+        // results up to this size are stored inside the job slot
+        static constexpr size_t result_capacity = 64;
+
+        using Job = InplaceFunction<void(), job_capacity>;
 
         template <typename Function, typename... Args>
         using CallableReturnType = typename std::invoke_result_t<Function, Args...>;
@@ -32,22 +54,172 @@ class ThreadPool
         template <typename Function>
         using CompleteAllJobsReturnType = VoidOrVectorReturnType<CallableReturnType<Function, size_t>>;
 
+        struct Slot
+        {
+                enum State : uint32_t
+                {
+                    Pending,
+                    Ready,
+                    Broken
+                };
+
+                template <typename T>
+                static constexpr bool is_result_inline
+                    = sizeof(T) <= result_capacity && alignof(T) <= alignof(std::max_align_t);
+
+                template <typename T>
+                void set_result(T && value)
+                {
+                    using Value = std::decay_t<T>;
+                    if constexpr (is_result_inline<Value>)
+                    {
+                        new (&result) Value(std::forward<T>(value));
+                        destroy_result = [](void *ptr) { static_cast<Value *>(ptr)->~Value(); };
+                    }
+                    else
+                    {
+                        using Boxed = std::unique_ptr<Value>;
+                        new (&result) Boxed(std::make_unique<Value>(std::forward<T>(value)));
+                        destroy_result = [](void *ptr) { static_cast<Boxed *>(ptr)->~Boxed(); };
+                    }
+                }
+
+                template <typename T>
+                T & get_result()
+                {
+                    if constexpr (is_result_inline<T>)
+                        return *std::launder(reinterpret_cast<T *>(&result));
+                    else
+                        return **std::launder(reinterpret_cast<std::unique_ptr<T> *>(&result));
+                }
+
+                void finish(State end_state);
+                void wait() const;
+
+                InplaceFunction<void(Slot &), sizeof(Job)> function;
+                alignas(std::max_align_t) std::byte result[result_capacity];
+                void (*destroy_result)(void *) = nullptr;
+                std::exception_ptr exception;
+                std::atomic<uint32_t> state = Pending;
+                // the queue and the future each hold a reference
+                std::atomic<uint32_t> refs = 0;
+        };
+
+        // recycles job slots - kept alive by futures outliving their pool
+        class SlotPool
+        {
+            public:
+                SlotPool(size_t max_cached);
+                ~SlotPool();
+
+                Slot *acquire(uint32_t refs);
+                void release(Slot *slot);
+
+            private:
+                MpmcQueue<Slot *> _free_slots;
+        };
+
+        // future whose shared state lives inside the pooled job slot
+        template <typename T>
+        class Future
+        {
+            public:
+                Future(): _slot(nullptr) {}
+                Future(Slot *slot, std::shared_ptr<SlotPool> pool): _slot(slot), _pool(std::move(pool)) {}
+                ~Future() { this->_release(); }
+
+                Future(Future && other): _slot(other._slot), _pool(std::move(other._pool)) { other._slot = nullptr; }
+                Future & operator=(Future && other)
+                {
+                    if (this != &other)
+                    {
+                        this->_release();
+                        _slot = other._slot;
+                        _pool = std::move(other._pool);
+                        other._slot = nullptr;
+                    }
+                    return *this;
+                }
+
+                Future(const Future &) = delete;
+                Future & operator=(const Future &) = delete;
+
+                bool valid() const { return _slot != nullptr; }
+
+                bool is_ready() const { return _slot != nullptr && _slot->state.load() != Slot::Pending; }
+
+                void wait() const
+                {
+                    if (_slot == nullptr)
+                        throw std::future_error(std::future_errc::no_state);
+                    _slot->wait();
+                }
+
+                // like std::future, the future is no longer valid once get is called
+                T get()
+                {
+                    this->wait();
+
+                    std::shared_ptr<SlotPool> pool = std::move(_pool);
+                    // releases the slot whatever happens next
+                    std::unique_ptr<Slot, SlotReleaser> slot(_slot, SlotReleaser {pool.get()});
+                    _slot = nullptr;
+
+                    if (slot->state.load() == Slot::Broken)
+                        throw std::future_error(std::future_errc::broken_promise);
+                    if (slot->exception)
+                        std::rethrow_exception(slot->exception);
+                    if constexpr (!std::is_void_v<T>)
+                        return std::move(slot->template get_result<T>());
+                }
+
+            private:
+                struct SlotReleaser
+                {
+                        SlotPool *pool;
+                        void operator()(Slot *slot) const { pool->release(slot); }
+                };
+
+                void _release()
+                {
+                    if (_slot != nullptr)
+                    {
+                        _pool->release(_slot);
+                        _slot = nullptr;
+                        _pool.reset();
+                    }
+                }
+
+                Slot *_slot;
+                std::shared_ptr<SlotPool> _pool;
+        };
+
         struct Thread
         {
             public:
-                Thread(const std::string & name, SafeQueue<Job> & jobs);
+                Thread(const std::string & name, ThreadPool & pool, size_t index);
                 ~Thread();
 
                 void stop();
                 Stat<Duration> stats() const;
 
             private:
+                friend class ThreadPool;
+
+                void _start();
                 void _loop();
+                void _run(Slot *slot);
+                void _park();
 
-                SafeQueue<Job> & _jobs;
+                std::string _name;
+                ThreadPool & _pool;
+                size_t _index;
+                WorkStealingDeque<Slot *> _deque;
                 Stat<Duration> _jobs_stat;
                 Stopwatch _stopwatch;
                 std::atomic<bool> _stop;
+                // set by the worker before parking, cleared by whoever wakes it up
+                std::atomic<bool> _sleeping;
                 std::thread _thread;
                 mutable std::mutex _stat_mutex;
         };
@@ -56,28 +228,42 @@ class ThreadPool
         ~ThreadPool();
 
         template <typename Function>
-        std::future<CallableReturnType<Function>> add_job(Function && function)
+        Future<CallableReturnType<Function>> add_job(Function && function)
         {
-            // wrap a callable target with std::packaged_task
-            using PackagedTask = std::packaged_task<CallableReturnType<Function>()>;
+            Slot *slot = this->_make_slot(std::forward<Function>(function), 2);
+            Future<CallableReturnType<Function>> future(slot, _slot_pool);
+            this->_submit(slot);
+            return future;
+        }
 
-            auto packed_task = std::make_shared<PackagedTask>(std::forward<Function>(function));
-            _jobs.push([packed_task] { (*packed_task)(); });
-            return packed_task->get_future();
+        // fire and forget: no future, exceptions thrown by the job are dropped
+        template <typename Function>
+        void post_job(Function && function)
+        {
+            this->_submit(this->_make_slot(std::forward<Function>(function), 1));
         }
 
+        // enqueue every job in one operation
+        void add_jobs(std::vector<Job> && jobs);
+
         template <typename Function>
         CompleteAllJobsReturnType<Function> complete_all_jobs(size_t number_of_jobs, Function && function)
         {
             using ReturnType = CallableReturnType<Function, size_t>;
 
-            std::vector<std::future<ReturnType>> futures;
+            std::vector<Future<ReturnType>> futures;
             futures.reserve(number_of_jobs);
 
+            std::vector<Slot *> slots;
+            slots.reserve(number_of_jobs);
+
             for (size_t i = 0; i < number_of_jobs; ++i)
             {
-                futures.emplace_back(this->add_job([function, i] { return function(i); }));
+                Slot *slot = this->_make_slot([&function, i] { return function(i); }, 2);
+                futures.emplace_back(slot, _slot_pool);
+                slots.emplace_back(slot);
             }
+            this->_submit_batch(slots);
 
             for (auto & future : futures)
             {
@@ -98,7 +284,57 @@ class ThreadPool
             }
         }
 
-        // stop all jobs from being processed then kill all threads
+        /**
+         * Calls function(i) for every i in [begin, end) and waits for completion.
+         * The range is split in chunks of grain indexes (0 for automatic) submitted as a single batch.
+         * When called from one of the pool's workers, the caller runs jobs while it waits.
+         * The first exception thrown by function is rethrown once every chunk is done.
+         * The pool must not be stopped while a parallel_for is waiting.
+         */
+        template <typename Function>
+        void parallel_for(size_t begin, size_t end, Function && function, size_t grain = 0)
+        {
+            if (begin >= end)
+                return;
+
+            const size_t count = end - begin;
+            if (_stopping || _threads.empty())
+            {
+                // nobody would process the batch
+                for (size_t i = begin; i < end; ++i)
+                    function(i);
+                return;
+            }
+            if (grain == 0)
+                grain = std::max<size_t>(1, count / (std::max<size_t>(1, _threads.size()) * 4));
+            const size_t chunks = (count + grain - 1) / grain;
+
+            Batch batch(chunks);
+            std::vector<Slot *> slots;
+            slots.reserve(chunks);
+            for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += grain)
+            {
+                const size_t chunk_end = std::min(end, chunk_begin + grain);
+                slots.emplace_back(this->_make_slot(
+                    [&batch, &function, chunk_begin, chunk_end] {
+                        try
+                        {
+                            for (size_t i = chunk_begin; i < chunk_end; ++i)
+                                function(i);
+                        }
+                        catch (...)
+                        {
+                            batch.set_exception(std::current_exception());
+                        }
+                        batch.done();
+                    },
+                    1));
+            }
+            this->_submit_batch(slots);
+            this->_wait_batch(batch);
+        }
+
+        // stop all jobs from being processed then kill all threads - jobs submitted afterwards are discarded
         void stop();
         // wait for all jobs to be read by threads, does not ensure the job is done though
         // you have to use future.wait() from add_job
@@ -110,9 +346,55 @@ class ThreadPool
     protected:
 
     private:
+        // completion tracking of a parallel_for
+        struct Batch
+        {
+                Batch(size_t jobs): remaining((std::ptrdiff_t)jobs) {}
+
+                void done() { remaining.count_down(); }
+                void set_exception(std::exception_ptr ptr);
+
+                std::latch remaining;
+                std::exception_ptr exception;
+                std::mutex exception_mutex;
+        };
+
+        template <typename Function>
+        Slot *_make_slot(Function && function, uint32_t refs)
+        {
+            using ReturnType = CallableReturnType<Function>;
+
+            Slot *slot = _slot_pool->acquire(refs);
+            slot->function = [fun = std::forward<Function>(function)](Slot & slot) mutable {
+                if constexpr (std::is_void_v<ReturnType>)
+                    fun();
+                else
+                    slot.set_result(fun());
+            };
+            return slot;
+        }
+
+        void _submit(Slot *slot);
+        void _submit_batch(std::vector<Slot *> & slots);
+        void _wait_batch(Batch & batch);
+        void _wake_workers(size_t count);
+
+        Thread *_current_worker() const;
+        Slot *_find_job(Thread *self);
+        void _job_taken();
+        bool _has_work() const;
+        void _discard_jobs();
+        void _discard(Slot *slot);
+
         std::string _name;
+        std::shared_ptr<SlotPool> _slot_pool;
         std::vector<std::unique_ptr<Thread>> _threads;
-        SafeQueue<Job> _jobs;
+        std::atomic<bool> _stopping;
+        // jobs submitted and not yet taken by a worker
+        std::atomic<size_t> _pending;
+        std::atomic<size_t> _sleepers;
+        std::mutex _injector_mutex;
+        std::deque<Slot *> _injector;
 };
 
 } // namespace sihd::util
@@ -0,0 +1,337 @@
+#ifndef __SIHD_UTIL_TIMINGWHEEL_HPP__
+#define __SIHD_UTIL_TIMINGWHEEL_HPP__
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <sihd/util/Timestamp.hpp>
+
+namespace sihd::util
+{
+
+/**
+ * Hierarchical timing wheel: insert, cancel and expire in O(1).
+ *
+ * Deadlines are converted to ticks of 'resolution' nanoseconds. Each level holds 64 slots, a value is stored
+ * at the level of the highest 6 bits group differing between its tick and the wheel's current tick, 11 levels
+ * cover the whole 64 bits range. Values are moved to lower levels (cascaded) lazily while the wheel advances.
+ *
+ * Values sharing a tick are expired in insertion order, pop_expired still never returns a value whose deadline
+ * is after the given time. Nodes are recycled: once the wheel reached its working size, inserting does not
+ * allocate.
+ */
+template <typename T>
+class TimingWheel
+{
+    public:
+        using Handle = uint32_t;
+
+        static constexpr Handle npos = std::numeric_limits<Handle>::max();
+        static constexpr size_t slot_bits = 6;
+        static constexpr size_t slots = size_t(1) << slot_bits;
+        static constexpr size_t levels = (64 + slot_bits - 1) / slot_bits;
+
+        TimingWheel(Duration resolution = time::micro(1)):
+            _resolution(std::max<time::UnixTime>(1, resolution.nanoseconds())),
+            _current(0),
+            _size(0),
+            _free(npos)
+        {
+            for (auto & level : _heads)
+                level.fill(npos);
+            _bitmaps.fill(0);
+        }
+
+        ~TimingWheel() = default;
+
+        TimingWheel(const TimingWheel &) = delete;
+        TimingWheel & operator=(const TimingWheel &) = delete;
+
+        Handle insert(Timestamp deadline, T value)
+        {
+            const Handle handle = this->_new_node();
+            Node & node = _nodes[handle];
+            node.value = std::move(value);
+            node.deadline = deadline;
+            node.tick = this->_tick(deadline);
+            this->_link(handle);
+            ++_size;
+            return handle;
+        }
+
+        bool cancel(Handle handle)
+        {
+            if (this->get(handle) == nullptr)
+                return false;
+            this->_unlink(handle);
+            this->_free_node(handle);
+            return true;
+        }
+
+        // value of a handle or nullptr if expired / cancelled
+        T *get(Handle handle)
+        {
+            if (handle >= _nodes.size() || !_nodes[handle].used)
+                return nullptr;
+            return &_nodes[handle].value;
+        }
+
+        // removes a value whose deadline is before or at now
+        std::optional<T> pop_expired(Timestamp now)
+        {
+            if (_size == 0)
+                return std::nullopt;
+
+            const uint64_t now_tick = this->_tick(now);
+            this->_advance(now_tick);
+
+            const Handle head = _heads[0][_current & slot_mask];
+            if (head == npos)
+                return std::nullopt;
+            // the whole tick elapsed
+            if (_current < now_tick)
+                return this->_take(head);
+            Handle handle = head;
+            do
+            {
+                if (_nodes[handle].deadline <= now)
+                    return this->_take(handle);
+                handle = _nodes[handle].next;
+            } while (handle != head);
+            return std::nullopt;
+        }
+
+        // removes the first value of the earliest tick
+        std::optional<T> pop_next()
+        {
+            if (_size == 0)
+                return std::nullopt;
+            this->_advance(std::numeric_limits<uint64_t>::max());
+            return this->_take(_heads[0][_current & slot_mask]);
+        }
+
+        // lower bound of the earliest deadline: start of the earliest tick once cascaded to the first level
+        std::optional<Timestamp> next_expiry() const
+        {
+            for (size_t level = 0; level < levels; ++level)
+            {
+                if (_bitmaps[level] == 0)
+                    continue;
+
+                const size_t slot = std::countr_zero(_bitmaps[level]);
+                const uint64_t start = level == 0 ? (_current & ~slot_mask) | slot : this->_slot_start(level, slot);
+                return Timestamp((time::UnixTime)(start * _resolution));
+            }
+            return std::nullopt;
+        }
+
+        // calls function(value) for each value in no particular order
+        template <typename Function>
+        void for_each(Function && function)
+        {
+            for (Node & node : _nodes)
+            {
+                if (node.used)
+                    function(node.value);
+            }
+        }
+
+        // removes every value calling function(value) on it
+        template <typename Function>
+        void drain(Function && function)
+        {
+            for (Handle handle = 0; handle < _nodes.size(); ++handle)
+            {
+                if (_nodes[handle].used)
+                    function(this->_take(handle));
+            }
+        }
+
+        void clear()
+        {
+            this->drain([](T &&) {});
+        }
+
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        Duration resolution() const { return Duration(_resolution); }
+
+    protected:
+
+    private:
+        static constexpr uint64_t slot_mask = slots - 1;
+
+        struct Node
+        {
+                T value {};
+                Timestamp deadline = 0;
+                uint64_t tick = 0;
+                // circular list of the slot or next free node
+                Handle prev = npos;
+                Handle next = npos;
+                uint8_t level = 0;
+                uint8_t slot = 0;
+                bool used = false;
+        };
+
+        uint64_t _tick(Timestamp timestamp) const
+        {
+            const time::UnixTime nano = timestamp.nanoseconds();
+            return nano <= 0 ? 0 : (uint64_t)nano / (uint64_t)_resolution;
+        }
+
+        // first tick covered by a slot of a level above the first one
+        uint64_t _slot_start(size_t level, size_t slot) const
+        {
+            const size_t shift = level * slot_bits;
+            const uint64_t upper_mask = shift + slot_bits >= 64 ? 0 : ~uint64_t(0) << (shift + slot_bits);
+            return (_current & upper_mask) | ((uint64_t)slot << shift);
+        }
+
+        Handle _new_node()
+        {
+            Handle handle;
+            if (_free != npos)
+            {
+                handle = _free;
+                _free = _nodes[handle].next;
+            }
+            else
+            {
+                handle = (Handle)_nodes.size();
+                _nodes.emplace_back();
+            }
+            _nodes[handle].used = true;
+            return handle;
+        }
+
+        void _free_node(Handle handle)
+        {
+            Node & node = _nodes[handle];
+            node.value = T {};
+            node.used = false;
+            node.next = _free;
+            _free = handle;
+            --_size;
+        }
+
+        T _take(Handle handle)
+        {
+            this->_unlink(handle);
+            T value = std::move(_nodes[handle].value);
+            this->_free_node(handle);
+            return value;
+        }
+
+        void _link(Handle handle)
+        {
+            Node & node = _nodes[handle];
+            // late values expire as soon as possible
+            node.tick = std::max(node.tick, _current);
+
+            const uint64_t diff = node.tick ^ _current;
+            const size_t level = diff == 0 ? 0 : (std::bit_width(diff) - 1) / slot_bits;
+            const size_t slot = (node.tick >> (level * slot_bits)) & slot_mask;
+            node.level = (uint8_t)level;
+            node.slot = (uint8_t)slot;
+
+            Handle & head = _heads[level][slot];
+            if (head == npos)
+            {
+                node.prev = handle;
+                node.next = handle;
+                head = handle;
+                _bitmaps[level] |= uint64_t(1) << slot;
+            }
+            else
+            {
+                // append to keep insertion order
+                Node & first = _nodes[head];
+                node.prev = first.prev;
+                node.next = head;
+                _nodes[first.prev].next = handle;
+                first.prev = handle;
+            }
+        }
+
+        void _unlink(Handle handle)
+        {
+            Node & node = _nodes[handle];
+            Handle & head = _heads[node.level][node.slot];
+            if (node.next == handle)
+            {
+                head = npos;
+                _bitmaps[node.level] &= ~(uint64_t(1) << node.slot);
+            }
+            else
+            {
+                _nodes[node.prev].next = node.next;
+                _nodes[node.next].prev = node.prev;
+                if (head == handle)
+                    head = node.next;
+            }
+        }
+
+        /**
+         * Moves the current tick toward target, cascading the slots it enters.
+         * Stops at target or at the first tick holding values, whichever comes first.
+         */
+        void _advance(uint64_t target)
+        {
+            while (true)
+            {
+                size_t level = 0;
+                while (level < levels && _bitmaps[level] == 0)
+                    ++level;
+
+                if (level == levels)
+                {
+                    _current = std::max(_current, target);
+                    return;
+                }
+
+                const size_t slot = std::countr_zero(_bitmaps[level]);
+                const uint64_t start = level == 0 ? (_current & ~slot_mask) | slot : this->_slot_start(level, slot);
+                if (start > target)
+                {
+                    // every value is later than target: the levels stay valid
+                    _current = std::max(_current, target);
+                    return;
+                }
+
+                _current = start;
+                if (level == 0)
+                    return;
+
+                // redistribute the slot relative to the new current tick
+                const Handle head = _heads[level][slot];
+                _heads[level][slot] = npos;
+                _bitmaps[level] &= ~(uint64_t(1) << slot);
+                Handle handle = head;
+                do
+                {
+                    const Handle next = _nodes[handle].next;
+                    this->_link(handle);
+                    handle = next;
+                } while (handle != head);
+            }
+        }
+
+        time::UnixTime _resolution;
+        uint64_t _current;
+        size_t _size;
+        Handle _free;
+        std::vector<Node> _nodes;
+        std::array<std::array<Handle, slots>, levels> _heads;
+        std::array<uint64_t, levels> _bitmaps;
+};
+
+} // namespace sihd::util
+
+#endif
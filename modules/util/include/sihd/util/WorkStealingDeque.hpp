@@ -0,0 +1,147 @@
+#ifndef __SIHD_UTIL_WORKSTEALINGDEQUE_HPP__
+#define __SIHD_UTIL_WORKSTEALINGDEQUE_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include <sihd/util/thread.hpp>
+
+namespace sihd::util
+{
+
+/**
+ * Chase-Lev work stealing deque (Le, Pop, Cohen, Nardelli - 2013 weak memory model version).
+ *
+ * The owner thread pushes and pops at the bottom (LIFO), any other thread steals at the top (FIFO).
+ * The buffer grows when full, previous buffers are kept until destruction since a thief may still read them.
+ */
+template <typename T>
+class WorkStealingDeque
+{
+    public:
+        static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque value type must be trivially copyable");
+
+        WorkStealingDeque(size_t capacity = 256): _top(0), _bottom(0)
+        {
+            size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+            _buffers.emplace_back(std::make_unique<Buffer>(size));
+            _buffer.store(_buffers.back().get(), std::memory_order_relaxed);
+        }
+
+        ~WorkStealingDeque() = default;
+
+        WorkStealingDeque(const WorkStealingDeque &) = delete;
+        WorkStealingDeque & operator=(const WorkStealingDeque &) = delete;
+
+        // owner only
+        void push(T value)
+        {
+            const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+            const int64_t top = _top.load(std::memory_order_acquire);
+            Buffer *buffer = _buffer.load(std::memory_order_relaxed);
+
+            if (bottom - top > (int64_t)buffer->mask)
+                buffer = this->_grow(buffer, top, bottom);
+
+            buffer->put(bottom, value);
+            std::atomic_thread_fence(std::memory_order_release);
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        // owner only
+        std::optional<T> pop()
+        {
+            const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+            Buffer *buffer = _buffer.load(std::memory_order_relaxed);
+            _bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = _top.load(std::memory_order_relaxed);
+
+            std::optional<T> ret;
+            if (top <= bottom)
+            {
+                ret = buffer->get(bottom);
+                if (top == bottom)
+                {
+                    // last value: race against thieves
+                    if (!_top.compare_exchange_strong(top,
+                                                      top + 1,
+                                                      std::memory_order_seq_cst,
+                                                      std::memory_order_relaxed))
+                        ret.reset();
+                    _bottom.store(bottom + 1, std::memory_order_relaxed);
+                }
+            }
+            else
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return ret;
+        }
+
+        // any thread - may fail spuriously when racing with another thief or the owner
+        std::optional<T> steal()
+        {
+            int64_t top = _top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = _bottom.load(std::memory_order_acquire);
+
+            if (top < bottom)
+            {
+                Buffer *buffer = _buffer.load(std::memory_order_acquire);
+                T value = buffer->get(top);
+                if (_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    return value;
+            }
+            return std::nullopt;
+        }
+
+        // approximation when the owner or thieves are running
+        size_t size() const
+        {
+            const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+            const int64_t top = _top.load(std::memory_order_relaxed);
+            return bottom > top ? (size_t)(bottom - top) : 0;
+        }
+
+        bool empty() const { return this->size() == 0; }
+
+    protected:
+
+    private:
+        struct Buffer
+        {
+                Buffer(size_t size): mask(size - 1), values(std::make_unique<std::atomic<T>[]>(size)) {}
+
+                T get(int64_t index) const { return values[index & mask].load(std::memory_order_relaxed); }
+                void put(int64_t index, T value) { values[index & mask].store(value, std::memory_order_relaxed); }
+
+                size_t mask;
+                std::unique_ptr<std::atomic<T>[]> values;
+        };
+
+        Buffer *_grow(Buffer *buffer, int64_t top, int64_t bottom)
+        {
+            auto bigger = std::make_unique<Buffer>((buffer->mask + 1) * 2);
+            for (int64_t i = top; i < bottom; ++i)
+                bigger->put(i, buffer->get(i));
+            Buffer *ret = bigger.get();
+            _buffers.emplace_back(std::move(bigger));
+            _buffer.store(ret, std::memory_order_release);
+            return ret;
+        }
+
+        alignas(thread::cache_line_size) std::atomic<int64_t> _top;
+        alignas(thread::cache_line_size) std::atomic<int64_t> _bottom;
+        std::atomic<Buffer *> _buffer;
+        // owned by the owner thread
+        std::vector<std::unique_ptr<Buffer>> _buffers;
+};
+
+} // namespace sihd::util
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef __SIHD_UTIL_ARRAYREDUCE_HPP__
+#define __SIHD_UTIL_ARRAYREDUCE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sihd::util::array_reduce
+{
+
+/**
+ * Reductions over typed buffers, instantiated for every arithmetic element type.
+ *
+ * Float, double and int32 buffers run AVX2 kernels when the processor supports them (checked once at runtime),
+ * other types and processors run scalar loops the compiler is free to vectorize.
+ */
+
+enum Compare
+{
+    Equal,
+    NotEqual,
+    Superior,
+    SuperiorEqual,
+    Inferior,
+    InferiorEqual,
+};
+
+// the comparison matching elements the given one does not
+Compare negate(Compare cmp);
+
+// number of elements verifying 'element cmp value'
+template <typename T>
+size_t count(const T *data, size_t size, Compare cmp, T value);
+
+// index of the first element verifying 'element cmp value' - size if there is none
+template <typename T>
+size_t first(const T *data, size_t size, Compare cmp, T value);
+
+template <typename T>
+bool any(const T *data, size_t size, Compare cmp, T value)
+{
+    return first(data, size, cmp, value) < size;
+}
+
+template <typename T>
+bool all(const T *data, size_t size, Compare cmp, T value)
+{
+    return first(data, size, negate(cmp), value) == size;
+}
+
+// size must not be 0
+template <typename T>
+T min(const T *data, size_t size);
+
+// size must not be 0
+template <typename T>
+T max(const T *data, size_t size);
+
+// accumulated as double
+template <typename T>
+double sum(const T *data, size_t size);
+
+// 0 if size is 0
+template <typename T>
+double mean(const T *data, size_t size)
+{
+    return size > 0 ? sum(data, size) / size : 0.0;
+}
+
+// kernels used for float, double and int32: "avx2" or "scalar"
+const char *backend();
+
+} // namespace sihd::util::array_reduce
+
+#endif
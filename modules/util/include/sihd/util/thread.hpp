@@ -1,11 +1,15 @@
 #ifndef __SIHD_UTIL_THREAD_HPP__
 #define __SIHD_UTIL_THREAD_HPP__
 
+#include <cstddef>
 #include <thread>
 
 namespace sihd::util::thread
 {
 
+// size used to pad data written by different threads
+constexpr size_t cache_line_size = 64;
+
 pthread_t id();
 pthread_t main();
 std::string id_str(pthread_t id = thread::id());
@@ -5,7 +5,7 @@ namespace sihd::util
 
 SIHD_NEW_LOGGER("sihd::util");
 
-Logger::Logger(const std::string & name): name(name) {}
+Logger::Logger(const std::string & name): name(name), _level(LogLevel::debug) {}
 
 Logger::~Logger() = default;
 
@@ -49,8 +49,16 @@ void Logger::debug(std::string_view msg)
     this->log(LogLevel::debug, msg);
 }
 
+Logger::ThreadBuffer & Logger::_thread_buffer()
+{
+    thread_local ThreadBuffer thread_buffer;
+    return thread_buffer;
+}
+
 void Logger::log(LogLevel level, std::string_view msg)
 {
+    if (!this->is_enabled(level))
+        return;
     LoggerManager::log(name, level, msg);
 }
 
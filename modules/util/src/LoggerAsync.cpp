@@ -0,0 +1,327 @@
+#include <cerrno>
+#include <climits>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#if !defined(__SIHD_WINDOWS__)
+# include <sys/uio.h>
+#else
+struct iovec
+{
+        void *iov_base;
+        size_t iov_len;
+};
+#endif
+
+#include <sihd/util/LoggerAsync.hpp>
+#include <sihd/util/thread.hpp>
+
+namespace sihd::util
+{
+
+namespace
+{
+
+#if defined(IOV_MAX)
+constexpr size_t g_batch_max = IOV_MAX;
+#else
+constexpr size_t g_batch_max = 1024;
+#endif
+
+std::atomic<uint64_t> g_next_id = 1;
+
+// writes every buffer, false on error
+bool write_buffers(int fd, struct iovec *iovecs, size_t count)
+{
+    while (count > 0)
+    {
+#if !defined(__SIHD_WINDOWS__)
+        ssize_t ret = ::writev(fd, iovecs, (int)count);
+#else
+        ssize_t ret = ::write(fd, iovecs->iov_base, iovecs->iov_len);
+#endif
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        size_t written = (size_t)ret;
+        // partial write: skips the written buffers and moves into the first partially written one
+        while (count > 0 && written >= iovecs->iov_len)
+        {
+            written -= iovecs->iov_len;
+            ++iovecs;
+            --count;
+        }
+        if (count > 0)
+        {
+            iovecs->iov_base = (char *)iovecs->iov_base + written;
+            iovecs->iov_len -= written;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+struct LoggerAsync::Ring
+{
+        struct Line
+        {
+                Timestamp timestamp = 0;
+                std::string text;
+        };
+
+        Ring(size_t capacity): head(0), tail(0), blocked(false), attached(true), closed(false)
+        {
+            size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+            lines.resize(size);
+            mask = size - 1;
+        }
+
+        bool full(size_t tail) const { return tail - head.load() >= lines.size(); }
+
+        std::vector<Line> lines;
+        size_t mask;
+        // written by the consumer
+        alignas(64) std::atomic<size_t> head;
+        // written by the producer
+        alignas(64) std::atomic<size_t> tail;
+        // the producer waits for room
+        std::atomic<bool> blocked;
+        // a thread is producing into the ring
+        std::atomic<bool> attached;
+        // the logger is destroyed, the ring is only kept by thread caches
+        std::atomic<bool> closed;
+};
+
+LoggerAsync::LoggerAsync(ALogger *sink): LoggerAsync(sink, Options {}) {}
+
+LoggerAsync::LoggerAsync(ALogger *sink, const Options & options):
+    _sink_ptr(sink),
+    _options(options),
+    _fd(-1),
+    _id(g_next_id.fetch_add(1)),
+    _wakeup(false),
+    _stop(false),
+    _logged(0),
+    _written(0),
+    _dropped(0),
+    _batches(0)
+{
+    if (_sink_ptr == nullptr)
+        throw std::invalid_argument("LoggerAsync: no sink");
+    _fd = _sink_ptr->line_fd();
+    if (_fd < 0)
+        throw std::invalid_argument("LoggerAsync: sink does not write lines to a file descriptor");
+    if (_options.capacity == 0)
+        throw std::invalid_argument("LoggerAsync: capacity must not be 0");
+    _iovecs.resize(g_batch_max);
+    _thread = std::thread(&LoggerAsync::_run, this);
+}
+
+LoggerAsync::~LoggerAsync()
+{
+    {
+        std::lock_guard l(_mutex);
+        _stop = true;
+    }
+    _cv.notify_one();
+    _thread.join();
+    this->flush();
+
+    std::lock_guard l(_rings_mutex);
+    for (const auto & ring : _rings)
+        ring->closed.store(true, std::memory_order_relaxed);
+}
+
+void LoggerAsync::log(const LogInfo & info, std::string_view msg)
+{
+    if (_sink_ptr->should_filter(info, msg))
+        return;
+
+    Ring *ring = this->_thread_ring();
+    const size_t tail = ring->tail.load(std::memory_order_relaxed);
+    if (ring->full(tail))
+    {
+        if (_options.overflow == Overflow::Drop)
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        this->_wake();
+        while (true)
+        {
+            ring->blocked.store(true);
+            const size_t head = ring->head.load();
+            if (tail - head < ring->lines.size())
+                break;
+            ring->head.wait(head);
+        }
+    }
+
+    Ring::Line & line = ring->lines[tail & ring->mask];
+    line.timestamp = info.timestamp();
+    line.text.clear();
+    _sink_ptr->format_line(info, msg, line.text);
+    ring->tail.store(tail + 1, std::memory_order_release);
+    _logged.fetch_add(1, std::memory_order_relaxed);
+
+    if (tail + 1 - ring->head.load(std::memory_order_relaxed) == ring->lines.size() / 2)
+        this->_wake();
+}
+
+LoggerAsync::Ring *LoggerAsync::_thread_ring()
+{
+    struct Entry
+    {
+            uint64_t id;
+            std::shared_ptr<Ring> ring;
+    };
+
+    // gives back the rings of the thread when it exits
+    struct ThreadRings
+    {
+            ~ThreadRings()
+            {
+                for (const Entry & entry : entries)
+                    entry.ring->attached.store(false, std::memory_order_release);
+            }
+
+            std::vector<Entry> entries;
+    };
+
+    static thread_local ThreadRings thread_rings;
+
+    auto & entries = thread_rings.entries;
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (it->id == _id)
+            return it->ring.get();
+        // ring of a destroyed logger
+        if (it->ring->closed.load(std::memory_order_relaxed))
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+
+    return entries.emplace_back(Entry {_id, this->_attach_ring()}).ring.get();
+}
+
+std::shared_ptr<LoggerAsync::Ring> LoggerAsync::_attach_ring()
+{
+    std::lock_guard l(_rings_mutex);
+    // reuses the ring of an exited thread, its pending lines are kept
+    for (const auto & ring : _rings)
+    {
+        bool attached = false;
+        if (ring->attached.compare_exchange_strong(attached, true, std::memory_order_acq_rel))
+            return ring;
+    }
+    return _rings.emplace_back(std::make_shared<Ring>(_options.capacity));
+}
+
+void LoggerAsync::_wake()
+{
+    if (_wakeup.exchange(true) == false)
+    {
+        std::lock_guard l(_mutex);
+        _cv.notify_one();
+    }
+}
+
+void LoggerAsync::_run()
+{
+    thread::set_name("logger");
+    std::unique_lock l(_mutex);
+    while (!_stop)
+    {
+        _cv.wait_for(l, std::chrono::nanoseconds(_options.interval), [this] { return _stop || _wakeup.load(); });
+        _wakeup.store(false);
+        l.unlock();
+        this->flush();
+        l.lock();
+    }
+}
+
+void LoggerAsync::flush()
+{
+    std::lock_guard flush_lock(_flush_mutex);
+
+    _cursors.clear();
+    {
+        std::lock_guard l(_rings_mutex);
+        for (const auto & ring : _rings)
+        {
+            const size_t head = ring->head.load(std::memory_order_relaxed);
+            const size_t tail = ring->tail.load(std::memory_order_acquire);
+            if (head != tail)
+                _cursors.emplace_back(Cursor {ring.get(), head, tail});
+        }
+    }
+
+    size_t batched = 0;
+    while (true)
+    {
+        // merges the rings: earliest line first
+        Cursor *earliest = nullptr;
+        for (Cursor & cursor : _cursors)
+        {
+            if (cursor.head == cursor.tail)
+                continue;
+            if (earliest == nullptr
+                || cursor.ring->lines[cursor.head & cursor.ring->mask].timestamp
+                       < earliest->ring->lines[earliest->head & earliest->ring->mask].timestamp)
+                earliest = &cursor;
+        }
+        if (earliest == nullptr)
+            break;
+
+        std::string & text = earliest->ring->lines[earliest->head & earliest->ring->mask].text;
+        _iovecs[batched].iov_base = text.data();
+        _iovecs[batched].iov_len = text.size();
+        ++earliest->head;
+        ++batched;
+        if (batched == _iovecs.size())
+        {
+            this->_write_batch(batched);
+            batched = 0;
+        }
+    }
+    if (batched > 0)
+        this->_write_batch(batched);
+}
+
+void LoggerAsync::_write_batch(size_t count)
+{
+    if (write_buffers(_fd, _iovecs.data(), count))
+        _written.fetch_add(count, std::memory_order_relaxed);
+    else
+        _dropped.fetch_add(count, std::memory_order_relaxed);
+    _batches.fetch_add(1, std::memory_order_relaxed);
+
+    // written lines are given back to their producers
+    for (const Cursor & cursor : _cursors)
+    {
+        cursor.ring->head.store(cursor.head);
+        if (cursor.ring->blocked.exchange(false))
+            cursor.ring->head.notify_all();
+    }
+}
+
+LoggerAsync::Stats LoggerAsync::stats() const
+{
+    return {
+        .logged = _logged.load(std::memory_order_relaxed),
+        .written = _written.load(std::memory_order_relaxed),
+        .dropped = _dropped.load(std::memory_order_relaxed),
+        .batches = _batches.load(std::memory_order_relaxed),
+    };
+}
+
+} // namespace sihd::util
@@ -8,6 +8,7 @@ namespace sihd::util
 {
 
 LoggerManager LoggerManager::_g_singleton;
+std::atomic<LogLevel> LoggerManager::_g_level = LogLevel::debug;
 
 LoggerManager::LoggerManager() = default;
 
@@ -25,13 +26,17 @@ bool LoggerManager::has_logger(ALogger *logger) const
 bool LoggerManager::add_logger(ALogger *logger)
 {
     std::lock_guard<std::mutex> l(_mutex);
-    return container::emplace_back_unique(_loggers_lst, logger);
+    const bool added = container::emplace_back_unique(_loggers_lst, logger);
+    _loggers_count = _loggers_lst.size();
+    return added;
 }
 
 bool LoggerManager::remove_logger(ALogger *logger)
 {
     std::lock_guard<std::mutex> l(_mutex);
-    return container::erase(_loggers_lst, logger);
+    const bool removed = container::erase(_loggers_lst, logger);
+    _loggers_count = _loggers_lst.size();
+    return removed;
 }
 
 void LoggerManager::delete_loggers()
@@ -42,6 +47,7 @@ void LoggerManager::delete_loggers()
         delete logger;
     }
     _loggers_lst.clear();
+    _loggers_count = 0;
 }
 
 void LoggerManager::_filter_and_log(const std::string & src, LogLevel level, std::string_view msg)
@@ -69,6 +75,16 @@ void LoggerManager::log(const std::string & src, LogLevel level, std::string_vie
     return _g_singleton._filter_and_log(src, level, msg);
 }
 
+void LoggerManager::set_level(LogLevel level)
+{
+    _g_level.store(level, std::memory_order_relaxed);
+}
+
+LogLevel LoggerManager::level()
+{
+    return _g_level.load(std::memory_order_relaxed);
+}
+
 bool LoggerManager::add(ALogger *logger)
 {
     return _g_singleton.add_logger(logger);
@@ -1,3 +1,5 @@
+#include <iterator>
+
 #include <fmt/printf.h>
 
 #include <sihd/util/LoggerStream.hpp>
@@ -16,29 +18,42 @@ LoggerStream::~LoggerStream() = default;
 void LoggerStream::log(const LogInfo & info, std::string_view msg)
 {
     std::string fmt_msg;
+    this->format_line(info, msg, fmt_msg);
+    fwrite(fmt_msg.c_str(), sizeof(char), fmt_msg.size(), _output);
+}
+
+int LoggerStream::line_fd() const
+{
+    return fileno(_output);
+}
+
+void LoggerStream::format_line(const LogInfo & info, std::string_view msg, std::string & line) const
+{
+    auto out = std::back_inserter(line);
 
     if (print_thread_id)
     {
-        fmt_msg = fmt::format("{0}.{1}\t{2}\t[{3}]\t{4:<9} {5}\t{6}\n",
-                              info.timespec.tv_sec,
-                              info.timespec.tv_nsec,
-                              info.thread_id_str.c_str(),
-                              info.thread_name.data(),
-                              info.strlevel,
-                              info.source.data(),
-                              msg);
+        fmt::format_to(out,
+                       "{0}.{1}\t{2}\t[{3}]\t{4:<9} {5}\t{6}\n",
+                       info.timespec.tv_sec,
+                       info.timespec.tv_nsec,
+                       info.thread_id_str.c_str(),
+                       info.thread_name.data(),
+                       info.strlevel,
+                       info.source.data(),
+                       msg);
     }
     else
     {
-        fmt_msg = fmt::format("{0}.{1}\t[{2}]\t{3:<9} {4}\t{5}\n",
-                              info.timespec.tv_sec,
-                              info.timespec.tv_nsec,
-                              info.thread_name.data(),
-                              info.strlevel,
-                              info.source.data(),
-                              msg);
+        fmt::format_to(out,
+                       "{0}.{1}\t[{2}]\t{3:<9} {4}\t{5}\n",
+                       info.timespec.tv_sec,
+                       info.timespec.tv_nsec,
+                       info.thread_name.data(),
+                       info.strlevel,
+                       info.source.data(),
+                       msg);
     }
-    fwrite(fmt_msg.c_str(), sizeof(char), fmt_msg.size(), _output);
 }
 
 } // namespace sihd::util
@@ -306,6 +306,11 @@ bool Node::resolve_links(size_t recursion)
     return ret;
 }
 
+const std::unordered_map<std::string, std::string> & Node::links() const
+{
+    return _link_map;
+}
+
 const std::unordered_map<std::string, Node::ChildEntry *> & Node::children() const
 {
     return _children_map;
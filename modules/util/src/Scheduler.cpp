@@ -1,3 +1,7 @@
+#include <algorithm>
+
+#include <fmt/format.h>
+
 #include <sihd/util/Logger.hpp>
 #include <sihd/util/Scheduler.hpp>
 #include <sihd/util/Task.hpp>
@@ -10,6 +14,14 @@ namespace sihd::util
 
 SIHD_LOGGER;
 
+namespace
+{
+
+// set on the executors threads
+thread_local bool g_executor_thread = false;
+
+} // namespace
+
 Scheduler::Scheduler(const std::string & name, Node *parent): Named(name, parent), AWorkerService(name)
 {
     overrun_at = time::micro(300);
@@ -22,8 +34,14 @@ Scheduler::Scheduler(const std::string & name, Node *parent): Named(name, parent
     _paused = false;
     _no_delay = false;
     _tasks_prepared = false;
+    _backend = Backend::Map;
+    _executors_count = 0;
+    _runs_waiters = 0;
 
     this->add_conf("no_delay", &Scheduler::set_no_delay);
+    this->add_conf("executors", &Scheduler::set_executors);
+    this->add_conf<std::string_view>("backend",
+                                     [this](std::string_view backend) { return this->set_backend(backend); });
 }
 
 Scheduler::~Scheduler()
@@ -58,53 +76,221 @@ bool Scheduler::set_no_delay(bool active)
     return true;
 }
 
+bool Scheduler::set_backend(std::string_view backend)
+{
+    if (backend == "map")
+        return this->set_backend(Backend::Map);
+    if (backend == "wheel")
+        return this->set_backend(Backend::Wheel);
+    SIHD_LOG(error, "Scheduler: unknown backend '{}'", backend);
+    return false;
+}
+
+bool Scheduler::set_backend(Backend backend)
+{
+    if (this->is_running())
+        throw std::logic_error("Cannot change the scheduler backend while running");
+
+    auto l = _waitable_task.guard();
+    if (backend == _backend)
+        return true;
+
+    std::vector<Task *> tasks;
+    this->_unprotected_take_all_tasks(tasks);
+    _backend = backend;
+    for (Task *task : tasks)
+        this->_unprotected_add_task_to_map(task);
+    return true;
+}
+
+Scheduler::Backend Scheduler::backend() const
+{
+    return _backend;
+}
+
+bool Scheduler::set_executors(size_t count)
+{
+    if (this->is_running())
+        throw std::logic_error("Cannot change the number of executors while running");
+    _executors_count = count;
+    return true;
+}
+
+size_t Scheduler::executors() const
+{
+    return _executors_count;
+}
+
 void Scheduler::_wait_for_next_task()
 {
     // wait for resume if paused
     _waitable_pause.wait([this] { return this->stop_requested || _paused == false; });
-    // wait for new task if empty
-    _waitable_task.wait([this] { return this->stop_requested || _task_map.empty() == false; });
+    // wait for new task if empty - the predicate runs locked
+    Timestamp next_run;
+    _waitable_task.wait([this, &next_run] {
+        next_run = _next_run;
+        return this->stop_requested || this->_unprotected_has_tasks();
+    });
 
     if (_no_delay)
         return;
 
-    // wait until most recent task to play
-    _waitable_task.wait_for(_next_run - _clock_ptr->now(), [this] { return this->stop_requested.load(); });
+    // wait until most recent task to play - a late task does not go through the condition variable
+    const Duration wait_time = next_run - _clock_ptr->now();
+    if (wait_time > 0)
+        _waitable_task.wait_for(wait_time, [this] { return this->stop_requested.load(); });
 }
 
 Task *Scheduler::_get_playable_task(Timestamp now)
 {
     auto l = _waitable_task.guard();
-    Task *task = _task_map.begin()->second;
 
-    Duration diff = task->run_at - now;
-    if (task->run_at > 0 && -diff > this->overrun_at)
+    // play task if near the time to be played or if in no delay mode
+    Task *task = _no_delay ? this->_unprotected_pop_next_task()
+                           : this->_unprotected_pop_expired_task(now + this->acceptable_task_preplay_ns_time);
+
+    if (task != nullptr && task->run_at > 0 && now - task->run_at > this->overrun_at)
+    {
         this->overruns += 1;
+        task->overruns += 1;
+    }
 
-    // play task if near the time to be played or if in no delay mode
-    if (_no_delay || (diff - this->acceptable_task_preplay_ns_time) <= 0)
-        _task_map.erase(_task_map.begin());
-    else
-        task = nullptr;
+    this->_unprotected_update_next_run();
     return task;
 }
 
 void Scheduler::_play_task(Task *task, Timestamp now)
 {
-    task->run();
-    if (task->reschedule_time > 0)
+    if (_executors.empty())
+    {
+        task->run();
+        if (task->reschedule_time > 0)
+            this->_reschedule_task(task, now);
+        else
+            this->_add_task_to_trash(task);
+    }
+    else
+    {
+        const bool one_shot = task->reschedule_time <= 0;
+        this->_dispatch_task(task, one_shot);
+        if (!one_shot)
+            this->_reschedule_task(task, now);
+    }
+}
+
+void Scheduler::_reschedule_task(Task *task, Timestamp now)
+{
+    if (task->run_at == 0)
+        task->run_at = now;
+    task->run_at += task->reschedule_time;
+
+    auto l = _waitable_task.guard();
+    this->_unprotected_add_task_to_map(task);
+}
+
+/* ************************************************************************* */
+/* Executors */
+/* ************************************************************************* */
+
+void Scheduler::_start_executors()
+{
+    _executors.reserve(_executors_count);
+    for (size_t i = 0; i < _executors_count; ++i)
+    {
+        _executors.emplace_back(std::make_unique<Executor>());
+    }
+    for (size_t i = 0; i < _executors.size(); ++i)
+    {
+        Executor *executor = _executors[i].get();
+        executor->thread = std::thread([this, executor, i] {
+            thread::set_name(fmt::format("{}[{}]", this->name(), i + 1));
+            g_executor_thread = true;
+            this->_executor_loop(*executor);
+        });
+    }
+}
+
+void Scheduler::_stop_executors()
+{
+    // runs already dispatched are played before the executors exit
+    for (auto & executor : _executors)
+    {
+        executor->queue.push(Dispatch {nullptr, false});
+    }
+    for (auto & executor : _executors)
+    {
+        if (executor->thread.joinable())
+            executor->thread.join();
+    }
+    _executors.clear();
+    this->_delete_trashed_tasks();
+}
+
+void Scheduler::_executor_loop(Executor & executor)
+{
+    while (true)
     {
-        if (task->run_at == 0)
-            task->run_at = now;
-        task->run_at += task->reschedule_time;
+        const Dispatch dispatch = executor.queue.pop();
+        if (dispatch.task == nullptr)
+            break;
+
+        dispatch.task->run();
+        executor.load.fetch_sub(1);
 
+        if (dispatch.one_shot)
+            this->_add_task_to_trash(dispatch.task);
+        else if (dispatch.task->_pending_runs.fetch_sub(1) == 1 && _runs_waiters.load() > 0)
         {
-            auto l = _waitable_task.guard();
-            this->_unprotected_add_task_to_map(task);
+            // the task must not be touched anymore: a remove_task caller may delete it
+            auto l = _waitable_runs.guard();
+            _waitable_runs.notify_all();
+        }
+    }
+}
+
+void Scheduler::_dispatch_task(Task *task, bool one_shot)
+{
+    const uint32_t pending = task->_pending_runs.load();
+    if (pending > 0)
+    {
+        if (task->overrun_policy == TaskOptions::OverrunPolicy::Skip)
+        {
+            task->skipped += 1;
+            return;
+        }
+        if (task->overrun_policy == TaskOptions::OverrunPolicy::Coalesce && pending > 1)
+        {
+            task->coalesced += 1;
+            return;
         }
     }
     else
-        this->_add_task_to_trash(task);
+        task->_executor = this->_pick_executor(task);
+
+    // runs of a task stay on its executor until done so it never runs concurrently with itself
+    Executor & executor = *_executors[task->_executor];
+    task->_pending_runs.fetch_add(1);
+    executor.load.fetch_add(1);
+    executor.queue.push(Dispatch {task, one_shot});
+}
+
+size_t Scheduler::_pick_executor(const Task *task) const
+{
+    if (task->affinity >= 0)
+        return (size_t)task->affinity % _executors.size();
+
+    size_t best = 0;
+    size_t best_load = _executors[0]->load.load();
+    for (size_t i = 1; i < _executors.size() && best_load > 0; ++i)
+    {
+        const size_t load = _executors[i]->load.load();
+        if (load < best_load)
+        {
+            best = i;
+            best_load = load;
+        }
+    }
+    return best;
 }
 
 void Scheduler::_prepare_tasks()
@@ -116,12 +302,9 @@ void Scheduler::_prepare_tasks()
         {
             task->run_at = _begin_run + task->run_in;
         }
-        _task_map.emplace(task->run_at, task);
+        this->_unprotected_add_task_to_map(task);
     }
 
-    if (_task_map.empty() == false)
-        _next_run = _task_map.begin()->first;
-
     _tasks_to_add.clear();
     _tasks_prepared = true;
 }
@@ -136,6 +319,7 @@ bool Scheduler::on_work_start()
     _begin_run = _clock_ptr->now();
 
     this->_prepare_tasks();
+    this->_start_executors();
 
     Timestamp now = _begin_run;
 
@@ -156,6 +340,8 @@ bool Scheduler::on_work_start()
         }
     }
 
+    this->_stop_executors();
+
     return true;
 }
 
@@ -181,18 +367,16 @@ void Scheduler::_resume_tasks()
     const Duration paused_time = this->now() - std::max(_begin_run, _paused_time_at);
     _paused_time_at = 0;
 
-    std::multimap<Timestamp, Task *> new_task_map;
-    for (auto & [_, task] : _task_map)
+    std::vector<Task *> tasks;
+    this->_unprotected_take_all_tasks(tasks);
+    for (Task *task : tasks)
     {
         if (task->run_in > 0)
         {
             task->run_at += paused_time;
         }
-        new_task_map.emplace(task->run_at, task);
+        this->_unprotected_add_task_to_map(task);
     }
-    _task_map = std::move(new_task_map);
-    if (_task_map.empty() == false)
-        _next_run = _task_map.begin()->first;
 }
 
 void Scheduler::resume()
@@ -227,8 +411,97 @@ bool Scheduler::on_work_stop()
 
 void Scheduler::_unprotected_add_task_to_map(Task *task)
 {
-    _task_map.emplace(task->run_at, task);
-    _next_run = _task_map.begin()->first;
+    if (_backend == Backend::Wheel)
+        task->_wheel_handle = _task_wheel.insert(task->run_at, task);
+    else
+        _task_map.emplace(task->run_at, task);
+    this->_unprotected_update_next_run();
+}
+
+bool Scheduler::_unprotected_remove_task_from_map(Task *task)
+{
+    if (_backend == Backend::Wheel)
+    {
+        Task **wheel_task = _task_wheel.get(task->_wheel_handle);
+        if (wheel_task == nullptr || *wheel_task != task)
+            return false;
+        _task_wheel.cancel(task->_wheel_handle);
+        task->_wheel_handle = TimingWheel<Task *>::npos;
+        return true;
+    }
+
+    const auto map_it
+        = container::find_if(_task_map, [&task](const auto & pair) { return task == pair.second; });
+    if (map_it == _task_map.end())
+        return false;
+    _task_map.erase(map_it);
+    return true;
+}
+
+Task *Scheduler::_unprotected_pop_expired_task(Timestamp until)
+{
+    if (_backend == Backend::Wheel)
+    {
+        std::optional<Task *> task = _task_wheel.pop_expired(until);
+        if (!task.has_value())
+            return nullptr;
+        (*task)->_wheel_handle = TimingWheel<Task *>::npos;
+        return *task;
+    }
+
+    if (_task_map.empty() || _task_map.begin()->first > until)
+        return nullptr;
+    Task *task = _task_map.begin()->second;
+    _task_map.erase(_task_map.begin());
+    return task;
+}
+
+Task *Scheduler::_unprotected_pop_next_task()
+{
+    if (_backend == Backend::Wheel)
+    {
+        std::optional<Task *> task = _task_wheel.pop_next();
+        if (!task.has_value())
+            return nullptr;
+        (*task)->_wheel_handle = TimingWheel<Task *>::npos;
+        return *task;
+    }
+
+    if (_task_map.empty())
+        return nullptr;
+    Task *task = _task_map.begin()->second;
+    _task_map.erase(_task_map.begin());
+    return task;
+}
+
+void Scheduler::_unprotected_take_all_tasks(std::vector<Task *> & tasks)
+{
+    tasks.reserve(tasks.size() + _task_map.size() + _task_wheel.size());
+    for (auto & [_, task] : _task_map)
+        tasks.push_back(task);
+    _task_map.clear();
+    _task_wheel.drain([&tasks](Task *task) {
+        task->_wheel_handle = TimingWheel<Task *>::npos;
+        tasks.push_back(task);
+    });
+}
+
+bool Scheduler::_unprotected_has_tasks() const
+{
+    return !_task_map.empty() || !_task_wheel.empty();
+}
+
+void Scheduler::_unprotected_update_next_run()
+{
+    // the wheel gives a lower bound: waking up early cascades it toward the exact time
+    if (_backend == Backend::Wheel)
+    {
+        std::optional<Timestamp> next_run = _task_wheel.next_expiry();
+        if (next_run.has_value())
+            _next_run = *next_run;
+    }
+    else if (!_task_map.empty())
+        _next_run = _task_map.begin()->first;
 }
 
 void Scheduler::add_task(Task *task)
@@ -250,52 +523,71 @@ void Scheduler::add_task(Task *task)
 
 bool Scheduler::remove_task(Task *task)
 {
-    auto l = _waitable_task.guard();
-
     bool found = false;
-
-    const auto task_it = container::find(_tasks_to_add, task);
-    if (task_it != _tasks_to_add.end())
     {
-        _tasks_to_add.erase(task_it);
-        found = true;
+        auto l = _waitable_task.guard();
+
+        const auto task_it = container::find(_tasks_to_add, task);
+        if (task_it != _tasks_to_add.end())
+        {
+            _tasks_to_add.erase(task_it);
+            found = true;
+        }
+
+        if (this->_unprotected_remove_task_from_map(task))
+        {
+            found = true;
+            this->_unprotected_update_next_run();
+        }
+
+        _waitable_task.notify();
     }
 
-    const auto map_it
-        = container::find_if(_task_map, [&task](const auto & pair) { return task == pair.second; });
-    if (map_it != _task_map.end())
+    // an executor waiting for itself would never wake up
+    if (found && !g_executor_thread)
     {
-        _task_map.erase(map_it);
-        found = true;
-        if (!_task_map.empty())
-            _next_run = _task_map.begin()->first;
+        _runs_waiters.fetch_add(1);
+        _waitable_runs.wait([task] { return task->_pending_runs.load() == 0; });
+        _runs_waiters.fetch_sub(1);
     }
-
-    _waitable_task.notify();
     return found;
 }
 
 void Scheduler::clear_tasks()
 {
-    this->_delete_trashed_tasks();
+    // an executor waiting for its own runs would never wake up
+    if (g_executor_thread)
+    {
+        SIHD_LOG(error, "Scheduler: cannot clear tasks from an executor");
+        return;
+    }
 
-    auto l = _waitable_task.guard();
+    this->_delete_trashed_tasks();
 
-    for (Task *task : _tasks_to_add)
+    std::vector<Task *> tasks;
     {
-        if (task != nullptr)
-            delete task;
+        auto l = _waitable_task.guard();
+
+        tasks.swap(_tasks_to_add);
+        this->_unprotected_take_all_tasks(tasks);
+
+        _waitable_task.notify();
     }
-    _tasks_to_add.clear();
 
-    for (auto & [_, task] : _task_map)
+    // runs already dispatched to the executors must be done before deleting their tasks
+    _runs_waiters.fetch_add(1);
+    _waitable_runs.wait([&tasks] {
+        return std::all_of(tasks.begin(), tasks.end(), [](const Task *task) {
+            return task == nullptr || task->_pending_runs.load() == 0;
+        });
+    });
+    _runs_waiters.fetch_sub(1);
+
+    for (Task *task : tasks)
     {
         if (task != nullptr)
             delete task;
     }
-    _task_map.clear();
-
-    _waitable_task.notify();
 }
 
 void Scheduler::_add_task_to_trash(Task *task)
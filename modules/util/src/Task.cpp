@@ -1,6 +1,7 @@
 #include <stdexcept>
 
 #include <sihd/util/Task.hpp>
+#include <sihd/util/TimingWheel.hpp>
 
 namespace sihd::util
 {
@@ -9,7 +10,15 @@ Task::Task(const TaskOptions & options):
     run_at(options.run_at),
     run_in(options.run_in),
     reschedule_time(options.reschedule_time),
-    _runnable_ptr(nullptr)
+    overrun_policy(options.overrun_policy),
+    affinity(options.affinity),
+    overruns(0),
+    skipped(0),
+    coalesced(0),
+    _runnable_ptr(nullptr),
+    _wheel_handle(TimingWheel<Task *>::npos),
+    _pending_runs(0),
+    _executor(0)
 {
     if (run_at > 0 && run_in > 0)
         throw std::logic_error(
@@ -21,14 +30,14 @@ Task::Task(IRunnable *to_run, const TaskOptions & options): Task(options)
     _runnable_ptr = to_run;
 }
 
-Task::Task(std::function<bool(void)> fun, const TaskOptions & options): Task(options)
+Task::Task(Method fun, const TaskOptions & options): Task(options)
 {
     _run_method = std::move(fun);
 }
 
 Task::~Task() = default;
 
-void Task::set_method(std::function<bool(void)> fun)
+void Task::set_method(Method fun)
 {
     _run_method = std::move(fun);
 }
@@ -7,13 +7,93 @@
 namespace sihd::util
 {
 
-ThreadPool::ThreadPool(std::string_view name, size_t number_of_threads): _name(name)
+namespace
 {
-    // creating threads
+
+// worker running on the current thread, if any
+thread_local ThreadPool::Thread *g_current_worker = nullptr;
+
+// job slots kept for reuse by each pool
+constexpr size_t max_cached_slots = 4096;
+
+} // namespace
+
+/* ************************************************************************* */
+/* ThreadPool::Slot */
+/* ************************************************************************* */
+
+void ThreadPool::Slot::finish(State end_state)
+{
+    function.reset();
+    state.store(end_state);
+    state.notify_all();
+}
+
+void ThreadPool::Slot::wait() const
+{
+    uint32_t current;
+    while ((current = state.load()) == Pending)
+        state.wait(current);
+}
+
+/* ************************************************************************* */
+/* ThreadPool::SlotPool */
+/* ************************************************************************* */
+
+ThreadPool::SlotPool::SlotPool(size_t max_cached): _free_slots(max_cached) {}
+
+ThreadPool::SlotPool::~SlotPool()
+{
+    while (std::optional<Slot *> slot = _free_slots.try_pop())
+        delete *slot;
+}
+
+ThreadPool::Slot *ThreadPool::SlotPool::acquire(uint32_t refs)
+{
+    std::optional<Slot *> cached = _free_slots.try_pop();
+    Slot *slot = cached.has_value() ? *cached : new Slot();
+    slot->state.store(Slot::Pending, std::memory_order_relaxed);
+    slot->refs.store(refs, std::memory_order_relaxed);
+    return slot;
+}
+
+void ThreadPool::SlotPool::release(Slot *slot)
+{
+    if (slot->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    if (slot->destroy_result != nullptr)
+    {
+        slot->destroy_result(&slot->result);
+        slot->destroy_result = nullptr;
+    }
+    slot->exception = nullptr;
+    slot->function.reset();
+
+    if (!_free_slots.push(slot))
+        delete slot;
+}
+
+/* ************************************************************************* */
+/* ThreadPool */
+/* ************************************************************************* */
+
+ThreadPool::ThreadPool(std::string_view name, size_t number_of_threads):
+    _name(name),
+    _slot_pool(std::make_shared<SlotPool>(max_cached_slots)),
+    _stopping(false),
+    _pending(0),
+    _sleepers(0)
+{
+    // creating threads - workers steal from each other so they start once every one of them exists
     _threads.reserve(number_of_threads);
     for (size_t i = 0; i < number_of_threads; ++i)
     {
-        _threads.emplace_back(std::make_unique<Thread>(fmt::format("{}[{}]", name, i + 1), _jobs));
+        _threads.emplace_back(std::make_unique<Thread>(fmt::format("{}[{}]", name, i + 1), *this, i));
+    }
+    for (const auto & thread_ptr : _threads)
+    {
+        thread_ptr->_start();
     }
 }
 
@@ -24,21 +104,51 @@ ThreadPool::~ThreadPool()
 
 void ThreadPool::stop()
 {
-    _jobs.terminate();
+    _stopping = true;
     for (const auto & thread_ptr : _threads)
     {
         thread_ptr->stop();
     }
+    this->_discard_jobs();
+}
+
+void ThreadPool::_discard_jobs()
+{
+    std::vector<Slot *> discarded;
+
+    for (const auto & thread_ptr : _threads)
+    {
+        while (std::optional<Slot *> slot = thread_ptr->_deque.pop())
+            discarded.emplace_back(*slot);
+    }
+    {
+        std::lock_guard l(_injector_mutex);
+        discarded.insert(discarded.end(), _injector.begin(), _injector.end());
+        _injector.clear();
+    }
+
+    for (Slot *slot : discarded)
+        this->_discard(slot);
+}
+
+void ThreadPool::_discard(Slot *slot)
+{
+    // the job is destroyed without running which breaks its promise
+    slot->finish(Slot::Broken);
+    _slot_pool->release(slot);
+    this->_job_taken();
 }
 
 size_t ThreadPool::remaining_jobs() const
 {
-    return _jobs.size();
+    return _pending.load();
 }
 
 void ThreadPool::wait_all_jobs() const
 {
-    _jobs.wait_for_space(1);
+    size_t pending;
+    while ((pending = _pending.load()) > 0)
+        _pending.wait(pending);
 }
 
 std::vector<Stat<Duration>> ThreadPool::stats() const
@@ -53,46 +163,259 @@ std::vector<Stat<Duration>> ThreadPool::stats() const
     return threads_stats;
 }
 
-ThreadPool::Thread::Thread(const std::string & name, SafeQueue<Job> & jobs): _jobs(jobs), _stop(false)
+void ThreadPool::add_jobs(std::vector<Job> && jobs)
 {
-    _thread = std::thread([name, this] {
-        thread::set_name(name);
-        this->_loop();
-    });
+    std::vector<Slot *> slots;
+    slots.reserve(jobs.size());
+    for (Job & job : jobs)
+    {
+        slots.emplace_back(this->_make_slot(std::move(job), 1));
+    }
+    jobs.clear();
+    this->_submit_batch(slots);
 }
 
-ThreadPool::Thread::~Thread()
+ThreadPool::Thread *ThreadPool::_current_worker() const
 {
-    this->stop();
+    if (g_current_worker != nullptr && &g_current_worker->_pool == this)
+        return g_current_worker;
+    return nullptr;
 }
 
-void ThreadPool::Thread::_loop()
+void ThreadPool::_submit(Slot *slot)
 {
-    while (!_stop)
-    {
-        Job job;
+    _pending.fetch_add(1);
 
-        try
+    Thread *worker = this->_current_worker();
+    if (worker != nullptr)
+    {
+        worker->_deque.push(slot);
+    }
+    else
+    {
+        std::unique_lock l(_injector_mutex);
+        // stopped: no worker would ever take it
+        if (_stopping)
         {
-            job = _jobs.pop();
+            l.unlock();
+            this->_discard(slot);
+            return;
         }
-        catch (const std::invalid_argument & err)
+        _injector.push_back(slot);
+    }
+
+    this->_wake_workers(1);
+}
+
+void ThreadPool::_submit_batch(std::vector<Slot *> & slots)
+{
+    if (slots.empty())
+        return;
+
+    _pending.fetch_add(slots.size());
+
+    Thread *worker = this->_current_worker();
+    if (worker != nullptr)
+    {
+        for (Slot *slot : slots)
+            worker->_deque.push(slot);
+    }
+    else
+    {
+        std::unique_lock l(_injector_mutex);
+        // stopped: no worker would ever take them
+        if (_stopping)
         {
+            l.unlock();
+            for (Slot *slot : slots)
+                this->_discard(slot);
+            slots.clear();
+            return;
+        }
+        _injector.insert(_injector.end(), slots.begin(), slots.end());
+    }
+
+    this->_wake_workers(slots.size());
+    slots.clear();
+}
+
+void ThreadPool::_wake_workers(size_t count)
+{
+    // pairs with the fence in Thread::_park: either we see the sleeper or it sees the pending job
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleepers.load(std::memory_order_relaxed) == 0)
+        return;
+
+    for (const auto & thread_ptr : _threads)
+    {
+        if (count == 0)
             break;
+        if (thread_ptr->_sleeping.load(std::memory_order_relaxed) && thread_ptr->_sleeping.exchange(false))
+        {
+            _sleepers.fetch_sub(1);
+            thread_ptr->_sleeping.notify_one();
+            --count;
+        }
+    }
+}
+
+void ThreadPool::_job_taken()
+{
+    if (_pending.fetch_sub(1) == 1)
+        _pending.notify_all();
+}
+
+bool ThreadPool::_has_work() const
+{
+    return _pending.load() > 0;
+}
+
+ThreadPool::Slot *ThreadPool::_find_job(Thread *self)
+{
+    std::optional<Slot *> job;
+
+    if (self != nullptr)
+        job = self->_deque.pop();
+
+    if (!job.has_value())
+    {
+        std::lock_guard l(_injector_mutex);
+        if (!_injector.empty())
+        {
+            job = _injector.front();
+            _injector.pop_front();
         }
+    }
+
+    if (!job.has_value())
+    {
+        const size_t total = _threads.size();
+        const size_t start = self != nullptr ? self->_index + 1 : 0;
+        for (size_t i = 0; i < total && !job.has_value(); ++i)
+        {
+            Thread *victim = _threads[(start + i) % total].get();
+            if (victim != self)
+                job = victim->_deque.steal();
+        }
+    }
+
+    if (job.has_value())
+    {
+        this->_job_taken();
+        return *job;
+    }
+    return nullptr;
+}
 
-        _stopwatch.reset();
-        job();
+void ThreadPool::_wait_batch(Batch & batch)
+{
+    Thread *worker = this->_current_worker();
+    if (worker != nullptr)
+    {
+        // a worker waiting would starve the pool: help until the batch is done
+        while (!batch.remaining.try_wait())
         {
-            std::lock_guard l(_stat_mutex);
-            _jobs_stat.add_sample(_stopwatch.time());
+            Slot *job = this->_find_job(worker);
+            if (job != nullptr)
+                worker->_run(job);
+            else
+                std::this_thread::yield();
         }
     }
+    else
+    {
+        batch.remaining.wait();
+    }
+
+    if (batch.exception)
+        std::rethrow_exception(batch.exception);
+}
+
+void ThreadPool::Batch::set_exception(std::exception_ptr ptr)
+{
+    std::lock_guard l(exception_mutex);
+    if (!exception)
+        exception = std::move(ptr);
+}
+
+ThreadPool::Thread::Thread(const std::string & name, ThreadPool & pool, size_t index):
+    _name(name),
+    _pool(pool),
+    _index(index),
+    _stop(false),
+    _sleeping(false)
+{
+}
+
+void ThreadPool::Thread::_start()
+{
+    _thread = std::thread([this] {
+        thread::set_name(_name);
+        g_current_worker = this;
+        this->_loop();
+        g_current_worker = nullptr;
+    });
+}
+
+ThreadPool::Thread::~Thread()
+{
+    this->stop();
+}
+
+void ThreadPool::Thread::_run(Slot *slot)
+{
+    _stopwatch.reset();
+    try
+    {
+        slot->function(*slot);
+    }
+    catch (...)
+    {
+        slot->exception = std::current_exception();
+    }
+    {
+        std::lock_guard l(_stat_mutex);
+        _jobs_stat.add_sample(_stopwatch.time());
+    }
+    slot->finish(Slot::Ready);
+    _pool._slot_pool->release(slot);
+}
+
+void ThreadPool::Thread::_park()
+{
+    _sleeping.store(true);
+    _pool._sleepers.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (_stop || _pool._stopping || _pool._has_work())
+    {
+        // cancel parking unless someone already claimed this worker
+        if (_sleeping.exchange(false))
+            _pool._sleepers.fetch_sub(1);
+        return;
+    }
+
+    _sleeping.wait(true);
+}
+
+void ThreadPool::Thread::_loop()
+{
+    while (!_stop && !_pool._stopping)
+    {
+        Slot *job = _pool._find_job(this);
+        if (job != nullptr)
+            this->_run(job);
+        else
+            this->_park();
+    }
 }
 
 void ThreadPool::Thread::stop()
 {
     _stop = true;
+    if (_sleeping.exchange(false))
+        _pool._sleepers.fetch_sub(1);
+    _sleeping.notify_one();
     if (_thread.joinable())
     {
         _thread.join();
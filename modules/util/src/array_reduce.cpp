@@ -0,0 +1,413 @@
+#include <algorithm>
+#include <type_traits>
+
+#include <sihd/util/array_reduce.hpp>
+#include <sihd/util/build.hpp>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(__SIHD_EMSCRIPTEN__)
+# define SIHD_ARRAY_REDUCE_AVX2
+# include <immintrin.h>
+# define SIHD_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace sihd::util::array_reduce
+{
+
+namespace
+{
+
+template <Compare C, typename T>
+inline bool compare(T element, T value)
+{
+    if constexpr (C == Equal)
+        return element == value;
+    else if constexpr (C == NotEqual)
+        return element != value;
+    else if constexpr (C == Superior)
+        return element > value;
+    else if constexpr (C == SuperiorEqual)
+        return element >= value;
+    else if constexpr (C == Inferior)
+        return element < value;
+    else
+        return element <= value;
+}
+
+// calls fn with the comparison as a compile time constant
+template <typename Fn>
+auto dispatch(Compare cmp, Fn && fn)
+{
+    switch (cmp)
+    {
+        case NotEqual:
+            return fn(std::integral_constant<Compare, NotEqual> {});
+        case Superior:
+            return fn(std::integral_constant<Compare, Superior> {});
+        case SuperiorEqual:
+            return fn(std::integral_constant<Compare, SuperiorEqual> {});
+        case Inferior:
+            return fn(std::integral_constant<Compare, Inferior> {});
+        case InferiorEqual:
+            return fn(std::integral_constant<Compare, InferiorEqual> {});
+        default:
+            return fn(std::integral_constant<Compare, Equal> {});
+    }
+}
+
+template <Compare C, typename T>
+size_t count_scalar(const T *data, size_t size, T value)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < size; ++i)
+        n += compare<C>(data[i], value);
+    return n;
+}
+
+template <Compare C, typename T>
+size_t first_scalar(const T *data, size_t size, T value)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (compare<C>(data[i], value))
+            return i;
+    }
+    return size;
+}
+
+template <typename T>
+T min_scalar(const T *data, size_t size)
+{
+    T ret = data[0];
+    for (size_t i = 1; i < size; ++i)
+        ret = data[i] < ret ? data[i] : ret;
+    return ret;
+}
+
+template <typename T>
+T max_scalar(const T *data, size_t size)
+{
+    T ret = data[0];
+    for (size_t i = 1; i < size; ++i)
+        ret = data[i] > ret ? data[i] : ret;
+    return ret;
+}
+
+template <typename T>
+double sum_scalar(const T *data, size_t size)
+{
+    double ret = 0.0;
+    for (size_t i = 0; i < size; ++i)
+        ret += (double)data[i];
+    return ret;
+}
+
+#if defined(SIHD_ARRAY_REDUCE_AVX2)
+
+bool use_avx2()
+{
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+template <typename T>
+constexpr bool has_avx2_kernel = std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, int32_t>;
+
+template <typename T>
+struct Avx2;
+
+template <>
+struct Avx2<float>
+{
+        using Vector = __m256;
+        static constexpr size_t lanes = 8;
+
+        SIHD_AVX2 static Vector set1(float value) { return _mm256_set1_ps(value); }
+        SIHD_AVX2 static Vector load(const float *data) { return _mm256_loadu_ps(data); }
+        SIHD_AVX2 static Vector min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+        SIHD_AVX2 static Vector max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+        SIHD_AVX2 static void store(float *data, Vector v) { _mm256_storeu_ps(data, v); }
+
+        template <Compare C>
+        SIHD_AVX2 static uint32_t mask(Vector a, Vector b)
+        {
+            if constexpr (C == Equal)
+                return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+            else if constexpr (C == NotEqual)
+                return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_NEQ_UQ));
+            else if constexpr (C == Superior)
+                return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ));
+            else if constexpr (C == SuperiorEqual)
+                return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ));
+            else if constexpr (C == Inferior)
+                return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+            else
+                return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ));
+        }
+
+        SIHD_AVX2 static void accumulate(__m256d & low, __m256d & high, Vector v)
+        {
+            low = _mm256_add_pd(low, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+            high = _mm256_add_pd(high, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+        }
+};
+
+template <>
+struct Avx2<double>
+{
+        using Vector = __m256d;
+        static constexpr size_t lanes = 4;
+
+        SIHD_AVX2 static Vector set1(double value) { return _mm256_set1_pd(value); }
+        SIHD_AVX2 static Vector load(const double *data) { return _mm256_loadu_pd(data); }
+        SIHD_AVX2 static Vector min(Vector a, Vector b) { return _mm256_min_pd(a, b); }
+        SIHD_AVX2 static Vector max(Vector a, Vector b) { return _mm256_max_pd(a, b); }
+        SIHD_AVX2 static void store(double *data, Vector v) { _mm256_storeu_pd(data, v); }
+
+        template <Compare C>
+        SIHD_AVX2 static uint32_t mask(Vector a, Vector b)
+        {
+            if constexpr (C == Equal)
+                return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+            else if constexpr (C == NotEqual)
+                return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_NEQ_UQ));
+            else if constexpr (C == Superior)
+                return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ));
+            else if constexpr (C == SuperiorEqual)
+                return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ));
+            else if constexpr (C == Inferior)
+                return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ));
+            else
+                return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ));
+        }
+
+        SIHD_AVX2 static void accumulate(__m256d & low, [[maybe_unused]] __m256d & high, Vector v)
+        {
+            low = _mm256_add_pd(low, v);
+        }
+};
+
+template <>
+struct Avx2<int32_t>
+{
+        using Vector = __m256i;
+        static constexpr size_t lanes = 8;
+
+        SIHD_AVX2 static Vector set1(int32_t value) { return _mm256_set1_epi32(value); }
+        SIHD_AVX2 static Vector load(const int32_t *data) { return _mm256_loadu_si256((const __m256i *)data); }
+        SIHD_AVX2 static Vector min(Vector a, Vector b) { return _mm256_min_epi32(a, b); }
+        SIHD_AVX2 static Vector max(Vector a, Vector b) { return _mm256_max_epi32(a, b); }
+        SIHD_AVX2 static void store(int32_t *data, Vector v) { _mm256_storeu_si256((__m256i *)data, v); }
+
+        template <Compare C>
+        SIHD_AVX2 static uint32_t mask(Vector a, Vector b)
+        {
+            // only equality and greater than exist for integers
+            constexpr uint32_t all = 0xff;
+            if constexpr (C == Equal)
+                return movemask(_mm256_cmpeq_epi32(a, b));
+            else if constexpr (C == NotEqual)
+                return movemask(_mm256_cmpeq_epi32(a, b)) ^ all;
+            else if constexpr (C == Superior)
+                return movemask(_mm256_cmpgt_epi32(a, b));
+            else if constexpr (C == SuperiorEqual)
+                return movemask(_mm256_cmpgt_epi32(b, a)) ^ all;
+            else if constexpr (C == Inferior)
+                return movemask(_mm256_cmpgt_epi32(b, a));
+            else
+                return movemask(_mm256_cmpgt_epi32(a, b)) ^ all;
+        }
+
+        SIHD_AVX2 static uint32_t movemask(Vector v) { return _mm256_movemask_ps(_mm256_castsi256_ps(v)); }
+
+        SIHD_AVX2 static void accumulate(__m256d & low, __m256d & high, Vector v)
+        {
+            low = _mm256_add_pd(low, _mm256_cvtepi32_pd(_mm256_castsi256_si128(v)));
+            high = _mm256_add_pd(high, _mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1)));
+        }
+};
+
+template <Compare C, typename T>
+SIHD_AVX2 size_t count_avx2(const T *data, size_t size, T value)
+{
+    using V = Avx2<T>;
+    const typename V::Vector ref = V::set1(value);
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + V::lanes <= size; i += V::lanes)
+        n += __builtin_popcount(V::template mask<C>(V::load(data + i), ref));
+    return n + count_scalar<C>(data + i, size - i, value);
+}
+
+template <Compare C, typename T>
+SIHD_AVX2 size_t first_avx2(const T *data, size_t size, T value)
+{
+    using V = Avx2<T>;
+    const typename V::Vector ref = V::set1(value);
+    size_t i = 0;
+    for (; i + V::lanes <= size; i += V::lanes)
+    {
+        const uint32_t mask = V::template mask<C>(V::load(data + i), ref);
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    return i + first_scalar<C>(data + i, size - i, value);
+}
+
+template <bool Min, typename T>
+SIHD_AVX2 T minmax_avx2(const T *data, size_t size)
+{
+    using V = Avx2<T>;
+    typename V::Vector acc = V::load(data);
+    size_t i = V::lanes;
+    for (; i + V::lanes <= size; i += V::lanes)
+        acc = Min ? V::min(acc, V::load(data + i)) : V::max(acc, V::load(data + i));
+    T lanes[V::lanes];
+    V::store(lanes, acc);
+    T ret = Min ? min_scalar(lanes, V::lanes) : max_scalar(lanes, V::lanes);
+    for (; i < size; ++i)
+        ret = Min ? std::min(ret, data[i]) : std::max(ret, data[i]);
+    return ret;
+}
+
+template <typename T>
+SIHD_AVX2 double sum_avx2(const T *data, size_t size)
+{
+    using V = Avx2<T>;
+    __m256d low = _mm256_setzero_pd();
+    __m256d high = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + V::lanes <= size; i += V::lanes)
+        V::accumulate(low, high, V::load(data + i));
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(low, high));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sum_scalar(data + i, size - i);
+}
+
+#else
+
+template <typename T>
+constexpr bool has_avx2_kernel = false;
+
+#endif
+
+} // namespace
+
+Compare negate(Compare cmp)
+{
+    switch (cmp)
+    {
+        case Equal:
+            return NotEqual;
+        case NotEqual:
+            return Equal;
+        case Superior:
+            return InferiorEqual;
+        case SuperiorEqual:
+            return Inferior;
+        case Inferior:
+            return SuperiorEqual;
+        default:
+            return Superior;
+    }
+}
+
+template <typename T>
+size_t count(const T *data, size_t size, Compare cmp, T value)
+{
+    return dispatch(cmp, [&](auto c) {
+#if defined(SIHD_ARRAY_REDUCE_AVX2)
+        if constexpr (has_avx2_kernel<T>)
+        {
+            if (use_avx2())
+                return count_avx2<decltype(c)::value>(data, size, value);
+        }
+#endif
+        return count_scalar<decltype(c)::value>(data, size, value);
+    });
+}
+
+template <typename T>
+size_t first(const T *data, size_t size, Compare cmp, T value)
+{
+    return dispatch(cmp, [&](auto c) {
+#if defined(SIHD_ARRAY_REDUCE_AVX2)
+        if constexpr (has_avx2_kernel<T>)
+        {
+            if (use_avx2())
+                return first_avx2<decltype(c)::value>(data, size, value);
+        }
+#endif
+        return first_scalar<decltype(c)::value>(data, size, value);
+    });
+}
+
+template <typename T>
+T min(const T *data, size_t size)
+{
+#if defined(SIHD_ARRAY_REDUCE_AVX2)
+    if constexpr (has_avx2_kernel<T>)
+    {
+        if (size >= Avx2<T>::lanes && use_avx2())
+            return minmax_avx2<true>(data, size);
+    }
+#endif
+    return min_scalar(data, size);
+}
+
+template <typename T>
+T max(const T *data, size_t size)
+{
+#if defined(SIHD_ARRAY_REDUCE_AVX2)
+    if constexpr (has_avx2_kernel<T>)
+    {
+        if (size >= Avx2<T>::lanes && use_avx2())
+            return minmax_avx2<false>(data, size);
+    }
+#endif
+    return max_scalar(data, size);
+}
+
+template <typename T>
+double sum(const T *data, size_t size)
+{
+#if defined(SIHD_ARRAY_REDUCE_AVX2)
+    if constexpr (has_avx2_kernel<T>)
+    {
+        if (use_avx2())
+            return sum_avx2(data, size);
+    }
+#endif
+    return sum_scalar(data, size);
+}
+
+const char *backend()
+{
+#if defined(SIHD_ARRAY_REDUCE_AVX2)
+    if (use_avx2())
+        return "avx2";
+#endif
+    return "scalar";
+}
+
+#define SIHD_ARRAY_REDUCE_INSTANTIATE(T)                                                                               \
+    template size_t count<T>(const T *data, size_t size, Compare cmp, T value);                                       \
+    template size_t first<T>(const T *data, size_t size, Compare cmp, T value);                                       \
+    template T min<T>(const T *data, size_t size);                                                                     \
+    template T max<T>(const T *data, size_t size);                                                                     \
+    template double sum<T>(const T *data, size_t size);
+
+SIHD_ARRAY_REDUCE_INSTANTIATE(char)
+SIHD_ARRAY_REDUCE_INSTANTIATE(int8_t)
+SIHD_ARRAY_REDUCE_INSTANTIATE(uint8_t)
+SIHD_ARRAY_REDUCE_INSTANTIATE(int16_t)
+SIHD_ARRAY_REDUCE_INSTANTIATE(uint16_t)
+SIHD_ARRAY_REDUCE_INSTANTIATE(int32_t)
+SIHD_ARRAY_REDUCE_INSTANTIATE(uint32_t)
+SIHD_ARRAY_REDUCE_INSTANTIATE(int64_t)
+SIHD_ARRAY_REDUCE_INSTANTIATE(uint64_t)
+SIHD_ARRAY_REDUCE_INSTANTIATE(float)
+SIHD_ARRAY_REDUCE_INSTANTIATE(double)
+
+#undef SIHD_ARRAY_REDUCE_INSTANTIATE
+
+} // namespace sihd::util::array_reduce
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include <sihd/util/array_reduce.hpp>
+
+namespace test
+{
+using namespace sihd::util;
+
+class TestArrayReduce: public ::testing::Test
+{
+    protected:
+        TestArrayReduce() = default;
+        virtual ~TestArrayReduce() = default;
+        virtual void SetUp() {}
+        virtual void TearDown() {}
+};
+
+template <typename T>
+bool reference_compare(T element, array_reduce::Compare cmp, T value)
+{
+    switch (cmp)
+    {
+        case array_reduce::Equal:
+            return element == value;
+        case array_reduce::NotEqual:
+            return element != value;
+        case array_reduce::Superior:
+            return element > value;
+        case array_reduce::SuperiorEqual:
+            return element >= value;
+        case array_reduce::Inferior:
+            return element < value;
+        default:
+            return element <= value;
+    }
+}
+
+// sizes around every vector width to go through the kernels and their tails
+template <typename T>
+void check_reductions()
+{
+    const std::vector<array_reduce::Compare> comparisons = {array_reduce::Equal,
+                                                            array_reduce::NotEqual,
+                                                            array_reduce::Superior,
+                                                            array_reduce::SuperiorEqual,
+                                                            array_reduce::Inferior,
+                                                            array_reduce::InferiorEqual};
+    for (size_t size : {1, 3, 4, 7, 8, 9, 16, 31, 100})
+    {
+        std::vector<T> data(size);
+        for (size_t i = 0; i < size; ++i)
+            data[i] = (T)((i * 7) % 13) - (T)(std::is_signed_v<T> ? 5 : 0);
+
+        for (T value : {(T)0, (T)3, data.back(), (T)100})
+        {
+            for (auto cmp : comparisons)
+            {
+                const size_t expected_count = std::count_if(data.begin(), data.end(), [&](T element) {
+                    return reference_compare(element, cmp, value);
+                });
+                const size_t expected_first
+                    = std::find_if(data.begin(),
+                                   data.end(),
+                                   [&](T element) { return reference_compare(element, cmp, value); })
+                      - data.begin();
+                EXPECT_EQ(array_reduce::count(data.data(), size, cmp, value), expected_count) << size;
+                EXPECT_EQ(array_reduce::first(data.data(), size, cmp, value), expected_first) << size;
+                EXPECT_EQ(array_reduce::any(data.data(), size, cmp, value), expected_count > 0) << size;
+                EXPECT_EQ(array_reduce::all(data.data(), size, cmp, value), expected_count == size) << size;
+            }
+        }
+        EXPECT_EQ(array_reduce::min(data.data(), size), *std::min_element(data.begin(), data.end())) << size;
+        EXPECT_EQ(array_reduce::max(data.data(), size), *std::max_element(data.begin(), data.end())) << size;
+        const double expected_sum = std::accumulate(data.begin(), data.end(), 0.0);
+        EXPECT_DOUBLE_EQ(array_reduce::sum(data.data(), size), expected_sum) << size;
+        EXPECT_DOUBLE_EQ(array_reduce::mean(data.data(), size), expected_sum / size) << size;
+    }
+}
+
+TEST_F(TestArrayReduce, test_arrayreduce_types)
+{
+    check_reductions<int8_t>();
+    check_reductions<uint8_t>();
+    check_reductions<int16_t>();
+    check_reductions<uint16_t>();
+    check_reductions<int32_t>();
+    check_reductions<uint32_t>();
+    check_reductions<int64_t>();
+    check_reductions<uint64_t>();
+    check_reductions<float>();
+    check_reductions<double>();
+}
+
+TEST_F(TestArrayReduce, test_arrayreduce_edges)
+{
+    EXPECT_EQ(array_reduce::count<int>(nullptr, 0, array_reduce::Equal, 0), 0u);
+    EXPECT_EQ(array_reduce::first<int>(nullptr, 0, array_reduce::Equal, 0), 0u);
+    EXPECT_FALSE(array_reduce::any<int>(nullptr, 0, array_reduce::Equal, 0));
+    EXPECT_TRUE(array_reduce::all<int>(nullptr, 0, array_reduce::Equal, 0));
+    EXPECT_DOUBLE_EQ(array_reduce::mean<int>(nullptr, 0), 0.0);
+
+    // int32 extremes go through the lane-wise min and max
+    std::vector<int32_t> ints(20, 0);
+    ints[3] = INT32_MIN;
+    ints[17] = INT32_MAX;
+    EXPECT_EQ(array_reduce::min(ints.data(), ints.size()), INT32_MIN);
+    EXPECT_EQ(array_reduce::max(ints.data(), ints.size()), INT32_MAX);
+    EXPECT_DOUBLE_EQ(array_reduce::sum(ints.data(), ints.size()), -1.0);
+
+    // NaN is never equal, always not equal
+    std::vector<float> floats(10, 1.0f);
+    floats[9] = std::nanf("");
+    EXPECT_EQ(array_reduce::count(floats.data(), floats.size(), array_reduce::Equal, 1.0f), 9u);
+    EXPECT_EQ(array_reduce::first(floats.data(), floats.size(), array_reduce::NotEqual, 1.0f), 9u);
+    EXPECT_EQ(array_reduce::count(floats.data(), floats.size(), array_reduce::Superior, 0.0f), 9u);
+
+    const std::string backend = array_reduce::backend();
+    EXPECT_TRUE(backend == "avx2" || backend == "scalar");
+}
+
+} // namespace test
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <sihd/util/InplaceFunction.hpp>
+#include <sihd/util/Logger.hpp>
+
+namespace test
+{
+SIHD_LOGGER;
+using namespace sihd::util;
+class TestInplaceFunction: public ::testing::Test
+{
+    protected:
+        TestInplaceFunction() { sihd::util::LoggerManager::stream(); }
+
+        virtual ~TestInplaceFunction() { sihd::util::LoggerManager::clear_loggers(); }
+
+        virtual void SetUp() {}
+
+        virtual void TearDown() {}
+};
+
+namespace
+{
+
+int add(int a, int b)
+{
+    return a + b;
+}
+
+struct Counted
+{
+        Counted(int *alive): alive(alive) { ++(*alive); }
+        Counted(Counted && other) noexcept: alive(other.alive) { ++(*alive); }
+        ~Counted() { --(*alive); }
+
+        int operator()() const { return 7; }
+
+        int *alive;
+};
+
+} // namespace
+
+TEST_F(TestInplaceFunction, test_inplacefunction_call)
+{
+    InplaceFunction<int(int, int)> fun = add;
+    EXPECT_EQ(fun(1, 2), 3);
+
+    int offset = 10;
+    fun = [offset](int a, int b) { return a + b + offset; };
+    EXPECT_EQ(fun(1, 2), 13);
+
+    std::unique_ptr<int> ptr = std::make_unique<int>(5);
+    InplaceFunction<int()> move_only = [ptr = std::move(ptr)] { return *ptr; };
+    EXPECT_EQ(move_only(), 5);
+
+    InplaceFunction<int()> moved = std::move(move_only);
+    EXPECT_FALSE(move_only);
+    EXPECT_TRUE(moved);
+    EXPECT_EQ(moved(), 5);
+}
+
+TEST_F(TestInplaceFunction, test_inplacefunction_empty)
+{
+    InplaceFunction<void()> fun;
+    EXPECT_FALSE(fun);
+    EXPECT_THROW(fun(), std::bad_function_call);
+
+    void (*null_ptr)() = nullptr;
+    InplaceFunction<void()> from_null_ptr = null_ptr;
+    EXPECT_FALSE(from_null_ptr);
+
+    InplaceFunction<void()> from_null_function = std::function<void()>();
+    EXPECT_FALSE(from_null_function);
+
+    fun = [] {};
+    EXPECT_TRUE(fun);
+    fun = nullptr;
+    EXPECT_FALSE(fun);
+}
+
+TEST_F(TestInplaceFunction, test_inplacefunction_storage)
+{
+    struct Big
+    {
+            char data[128];
+    };
+    Big big {};
+    big.data[127] = 42;
+
+    auto small_lambda = [value = 1] { return value; };
+    auto big_lambda = [big] { return (int)big.data[127]; };
+
+    EXPECT_TRUE((InplaceFunction<int(), 64>::is_inline<decltype(small_lambda)>));
+    EXPECT_FALSE((InplaceFunction<int(), 64>::is_inline<decltype(big_lambda)>));
+    EXPECT_TRUE((InplaceFunction<int(), 256>::is_inline<decltype(big_lambda)>));
+
+    // too big for the buffer: still works from the heap
+    InplaceFunction<int(), 64> boxed = big_lambda;
+    EXPECT_EQ(boxed(), 42);
+    InplaceFunction<int(), 64> moved = std::move(boxed);
+    EXPECT_EQ(moved(), 42);
+}
+
+TEST_F(TestInplaceFunction, test_inplacefunction_lifetime)
+{
+    int alive = 0;
+    {
+        InplaceFunction<int()> fun = Counted(&alive);
+        EXPECT_EQ(alive, 1);
+        EXPECT_EQ(fun(), 7);
+
+        InplaceFunction<int()> other = std::move(fun);
+        EXPECT_EQ(alive, 1);
+
+        other.reset();
+        EXPECT_EQ(alive, 0);
+
+        fun = Counted(&alive);
+        EXPECT_EQ(alive, 1);
+    }
+    EXPECT_EQ(alive, 0);
+}
+
+} // namespace test
@@ -8,6 +8,26 @@ namespace test
 {
 SIHD_NEW_LOGGER("test");
 using namespace sihd::util;
+
+// counts how many times it was formatted
+struct FormatCounter
+{
+        int *count;
+};
+} // namespace test
+
+template <>
+struct fmt::formatter<test::FormatCounter>: fmt::formatter<int>
+{
+        auto format(const test::FormatCounter & counter, format_context & ctx) const
+        {
+            ++(*counter.count);
+            return fmt::formatter<int>::format(*counter.count, ctx);
+        }
+};
+
+namespace test
+{
 class LogCounter: public ALogger
 {
     public:
@@ -229,4 +249,74 @@ TEST_F(TestLogger, test_logger_filter_level)
     EXPECT_EQ(log_counter->error, 1);
 }
 
+TEST_F(TestLogger, test_logger_level)
+{
+    int formatted = 0;
+    int evaluated = 0;
+    auto evaluate = [&evaluated] { return ++evaluated; };
+
+    LoggerManager::set_level(LogLevel::warning);
+    EXPECT_EQ(LoggerManager::level(), LogLevel::warning);
+    SIHD_LOG(info, "Should not count {} {}", FormatCounter {&formatted}, evaluate());
+    SIHD_LOG_FORMAT(debug, "Should not count %d", evaluate());
+    EXPECT_EQ(log_counter->info, 0);
+    EXPECT_EQ(log_counter->debug, 0);
+    EXPECT_EQ(formatted, 0);
+    EXPECT_EQ(evaluated, 0);
+    SIHD_LOG(warning, "Should count {}", FormatCounter {&formatted});
+    EXPECT_EQ(log_counter->warning, 1);
+    EXPECT_EQ(log_counter->msg, "Should count 1");
+    LoggerManager::set_level(LogLevel::debug);
+
+    __sihd_logger__.set_level(LogLevel::error);
+    SIHD_LOG(warning, "Should not count {}", FormatCounter {&formatted});
+    EXPECT_EQ(log_counter->warning, 1);
+    EXPECT_EQ(formatted, 1);
+    SIHD_LOG(error, "Should count");
+    EXPECT_EQ(log_counter->error, 1);
+    __sihd_logger__.set_level(LogLevel::debug);
+
+    // nobody to log to
+    LoggerManager::clear_loggers();
+    this->log_counter = nullptr;
+    SIHD_LOG(error, "Nobody {}", FormatCounter {&formatted});
+    EXPECT_EQ(formatted, 1);
+}
+
+// logs while its message is formatted
+struct NestedLog
+{
+};
+
+} // namespace test
+
+template <>
+struct fmt::formatter<test::NestedLog>: fmt::formatter<std::string_view>
+{
+        auto format(const test::NestedLog &, format_context & ctx) const
+        {
+            using test::__sihd_logger__;
+            SIHD_LOG(info, "nested {}", 42);
+            return fmt::formatter<std::string_view>::format("outer", ctx);
+        }
+};
+
+namespace test
+{
+
+TEST_F(TestLogger, test_logger_nested_format)
+{
+    SIHD_LOG(warning, "{} message", NestedLog {});
+    EXPECT_EQ(log_counter->info, 1);
+    EXPECT_EQ(log_counter->warning, 1);
+    EXPECT_EQ(log_counter->msg, "outer message");
+
+    // the thread buffer is reused once grown
+    const std::string big(4096, 'x');
+    SIHD_LOG(info, "{}", big);
+    EXPECT_EQ(log_counter->msg, big);
+    SIHD_LOG(info, "{}", "small");
+    EXPECT_EQ(log_counter->msg, "small");
+}
+
 } // namespace test
@@ -0,0 +1,145 @@
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <sihd/util/Logger.hpp>
+#include <sihd/util/LoggerAsync.hpp>
+#include <sihd/util/LoggerStream.hpp>
+#include <sihd/util/LoggerThrow.hpp>
+#include <sihd/util/str.hpp>
+
+namespace test
+{
+SIHD_NEW_LOGGER("test");
+using namespace sihd::util;
+
+class TestLoggerAsync: public ::testing::Test
+{
+    protected:
+        TestLoggerAsync() { LoggerManager::stream(); }
+
+        virtual ~TestLoggerAsync() { LoggerManager::clear_loggers(); }
+
+        virtual void SetUp() { _file = tmpfile(); }
+
+        virtual void TearDown() { fclose(_file); }
+
+        std::vector<std::string> written_lines()
+        {
+            std::string content;
+            char buf[4096];
+            size_t ret;
+            fseek(_file, 0, SEEK_SET);
+            while ((ret = fread(buf, 1, sizeof(buf), _file)) > 0)
+                content.append(buf, ret);
+
+            return str::split(content, '\n');
+        }
+
+        FILE *_file;
+};
+
+TEST_F(TestLoggerAsync, test_loggerasync_threads)
+{
+    constexpr int threads = 4;
+    constexpr int logs = 100;
+
+    LoggerAsync logger(new LoggerStream(_file));
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&logger, t] {
+            for (int i = 0; i < logs; ++i)
+                logger.log(LogInfo("test", LogLevel::info), fmt::format("{} {}", t, i));
+        });
+    }
+    for (auto & worker : workers)
+        worker.join();
+    logger.flush();
+
+    const LoggerAsync::Stats stats = logger.stats();
+    EXPECT_EQ(stats.logged, (size_t)(threads * logs));
+    EXPECT_EQ(stats.written, stats.logged);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_GT(stats.batches, 0u);
+
+    // lines of a thread are written in order
+    const std::vector<std::string> lines = this->written_lines();
+    ASSERT_EQ(lines.size(), (size_t)(threads * logs));
+    std::vector<int> expected(threads, 0);
+    for (const std::string & line : lines)
+    {
+        const std::vector<std::string> words = str::split(line.substr(line.rfind('\t') + 1), ' ');
+        ASSERT_EQ(words.size(), 2u);
+        const int t = std::stoi(words[0]);
+        const int i = std::stoi(words[1]);
+        ASSERT_LT(t, threads);
+        EXPECT_EQ(i, expected[t]);
+        expected[t] = i + 1;
+    }
+}
+
+TEST_F(TestLoggerAsync, test_loggerasync_drop)
+{
+    LoggerAsync logger(new LoggerStream(_file), {.capacity = 2, .interval = time::sec(3600)});
+
+    // the background thread cannot keep up with a ring of 2 lines
+    for (int i = 0; i < 1000; ++i)
+        logger.log(LogInfo("test", LogLevel::info), fmt::format("{}", i));
+    logger.flush();
+
+    const LoggerAsync::Stats stats = logger.stats();
+    EXPECT_EQ(stats.logged + stats.dropped, 1000u);
+    EXPECT_GT(stats.dropped, 0u);
+    EXPECT_EQ(stats.written, stats.logged);
+    EXPECT_EQ(this->written_lines().size(), stats.logged);
+}
+
+TEST_F(TestLoggerAsync, test_loggerasync_block)
+{
+    const LoggerAsync::Options options {
+        .capacity = 2,
+        .overflow = LoggerAsync::Overflow::Block,
+        .interval = time::sec(3600),
+    };
+    LoggerAsync logger(new LoggerStream(_file), options);
+
+    // the full ring wakes the background thread up
+    std::thread worker([&logger] {
+        for (int i = 0; i < 20; ++i)
+            logger.log(LogInfo("test", LogLevel::info), fmt::format("{}", i));
+    });
+    worker.join();
+    logger.flush();
+
+    const LoggerAsync::Stats stats = logger.stats();
+    EXPECT_EQ(stats.logged, 20u);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.written, 20u);
+    EXPECT_EQ(this->written_lines().size(), 20u);
+}
+
+TEST_F(TestLoggerAsync, test_loggerasync_manager)
+{
+    {
+        LoggerAsync logger(new LoggerStream(_file));
+        TmpLoggerAdder adder(&logger);
+        SIHD_LOG(info, "hello {}", "world");
+    }
+    // flushed by the destructor
+    const std::vector<std::string> lines = this->written_lines();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines[0].find("hello world"), std::string::npos);
+}
+
+TEST_F(TestLoggerAsync, test_loggerasync_sink)
+{
+    EXPECT_THROW(LoggerAsync(nullptr), std::invalid_argument);
+    // does not write lines
+    EXPECT_THROW(LoggerAsync(new LoggerThrow()), std::invalid_argument);
+}
+
+} // namespace test
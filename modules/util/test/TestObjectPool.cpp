@@ -0,0 +1,78 @@
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <sihd/util/Logger.hpp>
+#include <sihd/util/ObjectPool.hpp>
+
+namespace test
+{
+SIHD_LOGGER;
+using namespace sihd::util;
+class TestObjectPool: public ::testing::Test
+{
+    protected:
+        TestObjectPool() { sihd::util::LoggerManager::stream(); }
+
+        virtual ~TestObjectPool() { sihd::util::LoggerManager::clear_loggers(); }
+
+        virtual void SetUp() {}
+
+        virtual void TearDown() {}
+};
+
+TEST_F(TestObjectPool, test_objectpool_reuse)
+{
+    ObjectPool<std::string> pool(2);
+
+    std::string *str = pool.create("hello");
+    EXPECT_EQ(*str, "hello");
+    EXPECT_EQ(pool.cached(), 0u);
+
+    void *block = str;
+    pool.destroy(str);
+    EXPECT_EQ(pool.cached(), 1u);
+
+    std::string *reused = pool.create("world");
+    EXPECT_EQ(reused, block);
+    EXPECT_EQ(*reused, "world");
+    EXPECT_EQ(pool.cached(), 0u);
+    pool.destroy(reused);
+
+    // over max_cached blocks are freed
+    std::vector<std::string *> strings;
+    for (int i = 0; i < 4; ++i)
+        strings.emplace_back(pool.create());
+    for (std::string *s : strings)
+        pool.destroy(s);
+    EXPECT_EQ(pool.cached(), 2u);
+
+    pool.destroy(nullptr);
+}
+
+TEST_F(TestObjectPool, test_objectpool_threads)
+{
+    constexpr size_t iterations = 10000;
+
+    ObjectPool<size_t> pool(64);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&pool, t] {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                size_t *value = pool.create(t * iterations + i);
+                ASSERT_EQ(*value, t * iterations + i);
+                pool.destroy(value);
+            }
+        });
+    }
+    for (auto & thread : threads)
+        thread.join();
+
+    EXPECT_LE(pool.cached(), 64u);
+}
+
+} // namespace test
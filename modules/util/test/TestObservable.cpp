@@ -1,4 +1,7 @@
+#include <atomic>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -189,4 +192,82 @@ TEST_F(TestObservable, test_obs_decorator)
     EXPECT_LE(ts_end, ts_handler);
 }
 
+TEST_F(TestObservable, test_obs_concurrent_remove)
+{
+    SomeObservable observable;
+    std::atomic<bool> stop = false;
+    std::atomic<bool> removed = false;
+    std::atomic<int> called_after_remove = 0;
+    std::atomic<int> notified = 0;
+
+    Handler<SomeObservable *> counter([&](SomeObservable *) { notified += 1; });
+    Handler<SomeObservable *> handler([&](SomeObservable *) {
+        if (removed.load())
+            called_after_remove += 1;
+    });
+    observable.add_observer(&counter);
+
+    std::thread notifier([&] {
+        while (!stop.load())
+            observable.notify();
+    });
+
+    for (int i = 0; i < 200; ++i)
+    {
+        removed = false;
+        EXPECT_TRUE(observable.add_observer(&handler, i % 2 == 0));
+        std::this_thread::yield();
+        observable.remove_observer(&handler);
+        removed = true;
+        std::this_thread::yield();
+    }
+    stop = true;
+    notifier.join();
+
+    EXPECT_GT(notified.load(), 0);
+    EXPECT_EQ(called_after_remove.load(), 0);
+    EXPECT_TRUE(observable.is_observer(&counter));
+    EXPECT_FALSE(observable.is_observer(&handler));
+}
+
+TEST_F(TestObservable, test_obs_concurrent_writers)
+{
+    SomeObservable observable;
+    std::atomic<bool> stop = false;
+    std::atomic<int> notified = 0;
+
+    Handler<SomeObservable *> counter([&](SomeObservable *) { notified += 1; });
+    observable.add_observer(&counter);
+
+    // readers entering while writers retire arrays back to back
+    std::vector<std::thread> notifiers;
+    for (int t = 0; t < 4; ++t)
+    {
+        notifiers.emplace_back([&] {
+            while (!stop.load())
+                observable.notify();
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; ++t)
+    {
+        writers.emplace_back([&] {
+            Handler<SomeObservable *> handler([](SomeObservable *) {});
+            for (int i = 0; i < 500; ++i)
+            {
+                EXPECT_TRUE(observable.add_observer(&handler));
+                observable.remove_observer(&handler);
+            }
+        });
+    }
+    for (auto & writer : writers)
+        writer.join();
+    stop = true;
+    for (auto & notifier : notifiers)
+        notifier.join();
+
+    EXPECT_GT(notified.load(), 0);
+    EXPECT_TRUE(observable.is_observer(&counter));
+}
+
 } // namespace test
@@ -0,0 +1,145 @@
+#include <thread>
+
+#include <fmt/printf.h>
+#include <gtest/gtest.h>
+
+#include <sihd/util/RingQueue.hpp>
+
+namespace test
+{
+using namespace sihd::util;
+class TestRingQueue: public ::testing::Test
+{
+    protected:
+        TestRingQueue() = default;
+
+        virtual ~TestRingQueue() = default;
+
+        virtual void SetUp() {}
+
+        virtual void TearDown() {}
+};
+
+TEST_F(TestRingQueue, test_ringqueue_capacity)
+{
+    MpmcQueue<int> queue(3);
+
+    EXPECT_EQ(queue.capacity(), 4u);
+    EXPECT_TRUE(queue.empty());
+
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_TRUE(queue.push(3));
+    EXPECT_TRUE(queue.push(4));
+    EXPECT_TRUE(queue.full());
+    EXPECT_FALSE(queue.push(5));
+    EXPECT_EQ(queue.size(), 4u);
+
+    EXPECT_EQ(queue.pop(), 1);
+    EXPECT_EQ(queue.try_pop().value(), 2);
+    EXPECT_TRUE(queue.push(5));
+    EXPECT_EQ(queue.pop(), 3);
+    EXPECT_EQ(queue.pop(), 4);
+    EXPECT_EQ(queue.pop(), 5);
+    EXPECT_FALSE(queue.try_pop().has_value());
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(TestRingQueue, test_ringqueue_terminate)
+{
+    MpmcQueue<int> queue(8);
+
+    std::thread t1([&] { EXPECT_THROW(queue.pop(), std::invalid_argument); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    fmt::print("Terminating queue\n");
+    queue.terminate();
+    t1.join();
+
+    EXPECT_FALSE(queue.push(1));
+    EXPECT_FALSE(queue.push_wait(1));
+    EXPECT_FALSE(queue.try_pop().has_value());
+}
+
+TEST_F(TestRingQueue, test_ringqueue_push_wait)
+{
+    SpscQueue<int> queue(2);
+
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+
+    std::thread t1([&] { EXPECT_TRUE(queue.push_wait(3)); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(queue.pop(), 1);
+    t1.join();
+
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_EQ(queue.pop(), 3);
+}
+
+TEST_F(TestRingQueue, test_ringqueue_move_only)
+{
+    MpscQueue<std::unique_ptr<int>> queue(4);
+
+    EXPECT_TRUE(queue.push(std::make_unique<int>(42)));
+    EXPECT_TRUE(queue.push(std::make_unique<int>(1337)));
+
+    EXPECT_EQ(*queue.pop(), 42);
+    // remaining value is destroyed by the queue
+    EXPECT_EQ(queue.size(), 1u);
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+}
+
+template <typename Queue>
+void spam(size_t producers, size_t consumers, size_t values_per_producer)
+{
+    Queue queue(64);
+
+    std::vector<std::thread> threads;
+    std::atomic<size_t> total = 0;
+    std::atomic<size_t> count = 0;
+
+    for (size_t i = 0; i < consumers; ++i)
+    {
+        threads.emplace_back([&] {
+            while (true)
+            {
+                size_t value = queue.pop();
+                if (value == 0)
+                    break;
+                total += value;
+                ++count;
+            }
+        });
+    }
+    for (size_t i = 0; i < producers; ++i)
+    {
+        threads.emplace_back([&] {
+            for (size_t j = 1; j <= values_per_producer; ++j)
+                EXPECT_TRUE(queue.push_wait(j));
+        });
+    }
+
+    for (size_t i = consumers; i < threads.size(); ++i)
+        threads[i].join();
+    // one stop value per consumer
+    for (size_t i = 0; i < consumers; ++i)
+        EXPECT_TRUE(queue.push_wait(0));
+    for (size_t i = 0; i < consumers; ++i)
+        threads[i].join();
+
+    EXPECT_EQ(count.load(), producers * values_per_producer);
+    EXPECT_EQ(total.load(), producers * (values_per_producer * (values_per_producer + 1) / 2));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(TestRingQueue, test_ringqueue_spam)
+{
+    spam<SpscQueue<size_t>>(1, 1, 100000);
+    spam<MpscQueue<size_t>>(4, 1, 20000);
+    spam<MpmcQueue<size_t>>(4, 4, 20000);
+}
+
+} // namespace test
@@ -1,5 +1,7 @@
 #include <condition_variable>
 #include <mutex>
+#include <set>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -283,6 +285,292 @@ TEST_F(TestScheduler, test_sched_as_fast)
     EXPECT_EQ(lambda_ran, 5);
 }
 
+TEST_F(TestScheduler, test_sched_wheel)
+{
+    if (test::is_run_by_valgrind())
+        GTEST_SKIP() << "Buggy with valgrind";
+    Scheduler sched("sched");
+
+    EXPECT_EQ(sched.backend(), Scheduler::Backend::Map);
+    EXPECT_FALSE(sched.set_conf_str("backend", "unknown"));
+
+    std::vector<int> order;
+    std::atomic<int> periodic_ran = 0;
+
+    // tasks added before the switch are moved to the wheel
+    sched.add_task(new Task(
+        [&order] {
+            order.push_back(3);
+            return true;
+        },
+        {.run_in = time::milli(3)}));
+    EXPECT_TRUE(sched.set_conf_str("backend", "wheel"));
+    EXPECT_EQ(sched.backend(), Scheduler::Backend::Wheel);
+
+    sched.add_task(new Task(
+        [&order] {
+            order.push_back(2);
+            return true;
+        },
+        {.run_in = time::milli(2)}));
+    sched.add_task(new Task(
+        [&order] {
+            order.push_back(1);
+            return true;
+        },
+        {.run_in = time::milli(1)}));
+    sched.add_task(new Task(
+        [&periodic_ran] {
+            ++periodic_ran;
+            return true;
+        },
+        {.reschedule_time = time::milli(1)}));
+
+    Task *removed = new Task(
+        [] {
+            SIHD_LOG_ERROR("Should not be played ever");
+            return false;
+        },
+        {.run_in = time::milli(2)});
+    sched.add_task(removed);
+    EXPECT_TRUE(sched.remove_task(removed));
+    EXPECT_FALSE(sched.remove_task(removed));
+    delete removed;
+
+    sched.set_start_synchronised(true);
+    sched.start();
+    EXPECT_THROW(sched.set_backend(Scheduler::Backend::Map), std::logic_error);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sched.stop();
+
+    EXPECT_EQ(order, (std::vector<int> {1, 2, 3}));
+    EXPECT_GE(periodic_ran.load(), 5);
+
+    // back to the map with the periodic task still scheduled
+    EXPECT_TRUE(sched.set_backend(Scheduler::Backend::Map));
+    const int ran_before = periodic_ran.load();
+    sched.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    sched.stop();
+    EXPECT_GT(periodic_ran.load(), ran_before);
+}
+
+TEST_F(TestScheduler, test_sched_wheel_as_fast)
+{
+    if (test::is_run_by_valgrind())
+        GTEST_SKIP() << "Buggy with valgrind";
+    Scheduler sched("sched");
+    sched.set_backend(Scheduler::Backend::Wheel);
+    std::vector<int> order;
+    for (int i = 5; i > 0; --i)
+    {
+        sched.add_task(new Task(
+            [&order, i] {
+                order.push_back(i);
+                return true;
+            },
+            {.run_in = time::milli(i * 10)}));
+    }
+    sched.set_no_delay(true);
+    sched.set_start_synchronised(true);
+    sched.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sched.stop();
+    EXPECT_EQ(order, (std::vector<int> {1, 2, 3, 4, 5}));
+}
+
+TEST_F(TestScheduler, test_sched_executors)
+{
+    if (test::is_run_by_valgrind())
+        GTEST_SKIP() << "Buggy with valgrind";
+    Scheduler sched("sched");
+    EXPECT_TRUE(sched.set_conf("executors", size_t(2)));
+    EXPECT_EQ(sched.executors(), 2u);
+
+    std::atomic<int> slow_ran = 0;
+    std::atomic<int> fast_ran = 0;
+    std::atomic<int> one_shot_ran = 0;
+
+    // a slow task does not delay the others anymore
+    Task *slow = new Task(
+        [&slow_ran] {
+            ++slow_ran;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return true;
+        },
+        {.reschedule_time = time::milli(5), .overrun_policy = TaskOptions::OverrunPolicy::Skip});
+    sched.add_task(slow);
+    sched.add_task(new Task(
+        [&fast_ran] {
+            ++fast_ran;
+            return true;
+        },
+        {.reschedule_time = time::milli(1)}));
+    for (int i = 0; i < 10; ++i)
+    {
+        sched.add_task(new Task(
+            [&one_shot_ran] {
+                ++one_shot_ran;
+                return true;
+            },
+            {.run_in = time::milli(i + 1)}));
+    }
+
+    sched.set_start_synchronised(true);
+    sched.start();
+    EXPECT_THROW(sched.set_executors(1), std::logic_error);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // waits for the current run of the task
+    EXPECT_TRUE(sched.remove_task(slow));
+    const int slow_ran_after_remove = slow_ran.load();
+    delete slow;
+
+    sched.stop();
+
+    EXPECT_EQ(slow_ran.load(), slow_ran_after_remove);
+    EXPECT_GE(slow_ran.load(), 2);
+    EXPECT_LE(slow_ran.load(), 4);
+    EXPECT_GE(fast_ran.load(), 25);
+    EXPECT_EQ(one_shot_ran.load(), 10);
+}
+
+TEST_F(TestScheduler, test_sched_executors_clear)
+{
+    if (test::is_run_by_valgrind())
+        GTEST_SKIP() << "Buggy with valgrind";
+    Scheduler sched("sched");
+    EXPECT_TRUE(sched.set_executors(2));
+
+    std::atomic<int> started = 0;
+    std::atomic<int> finished = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        sched.add_task(new Task(
+            [&started, &finished] {
+                ++started;
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                ++finished;
+                return true;
+            },
+            {.reschedule_time = time::milli(1), .affinity = i % 2}));
+    }
+
+    sched.set_start_synchronised(true);
+    sched.start();
+    for (int i = 0; i < 200 && started.load() == 0; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_GT(started.load(), 0);
+
+    // waits for the runs already dispatched before deleting the tasks
+    sched.clear_tasks();
+    const int finished_after_clear = finished.load();
+    EXPECT_EQ(started.load(), finished_after_clear);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    sched.stop();
+    EXPECT_EQ(finished.load(), finished_after_clear);
+}
+
+TEST_F(TestScheduler, test_sched_executors_policies)
+{
+    if (test::is_run_by_valgrind())
+        GTEST_SKIP() << "Buggy with valgrind";
+    Scheduler sched("sched");
+    sched.set_executors(3);
+
+    struct Counters
+    {
+            std::atomic<int> ran = 0;
+            std::atomic<int> running = 0;
+            std::atomic<bool> concurrent = false;
+    };
+    Counters queue, skip, coalesce;
+
+    auto add_slow_task = [&sched](Counters & counters, TaskOptions::OverrunPolicy policy) {
+        Task *task = new Task(
+            [&counters] {
+                if (counters.running.fetch_add(1) > 0)
+                    counters.concurrent = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(4));
+                counters.running.fetch_sub(1);
+                ++counters.ran;
+                return true;
+            },
+            {.reschedule_time = time::milli(1), .overrun_policy = policy});
+        sched.add_task(task);
+        return task;
+    };
+
+    Task *queue_task = add_slow_task(queue, TaskOptions::OverrunPolicy::Queue);
+    Task *skip_task = add_slow_task(skip, TaskOptions::OverrunPolicy::Skip);
+    Task *coalesce_task = add_slow_task(coalesce, TaskOptions::OverrunPolicy::Coalesce);
+
+    sched.set_start_synchronised(true);
+    sched.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    sched.stop();
+
+    // a task never runs concurrently with itself
+    EXPECT_FALSE(queue.concurrent);
+    EXPECT_FALSE(skip.concurrent);
+    EXPECT_FALSE(coalesce.concurrent);
+
+    // every period is played once the executors are stopped
+    EXPECT_EQ(queue_task->skipped, 0u);
+    EXPECT_EQ(queue_task->coalesced, 0u);
+    EXPECT_GT(queue.ran.load(), skip.ran.load());
+
+    EXPECT_GT(skip_task->skipped, 0u);
+    EXPECT_EQ(skip_task->coalesced, 0u);
+
+    EXPECT_EQ(coalesce_task->skipped, 0u);
+    EXPECT_GT(coalesce_task->coalesced, 0u);
+}
+
+TEST_F(TestScheduler, test_sched_executors_affinity)
+{
+    if (test::is_run_by_valgrind())
+        GTEST_SKIP() << "Buggy with valgrind";
+    Scheduler sched("sched");
+    sched.set_executors(4);
+
+    std::mutex mutex;
+    std::set<std::thread::id> first_threads;
+    std::set<std::thread::id> second_threads;
+    std::atomic<int> running = 0;
+    std::atomic<bool> concurrent = false;
+
+    // pinned to the same executor: never run at once
+    auto make_task = [&](std::set<std::thread::id> & threads) {
+        return new Task(
+            [&] {
+                if (running.fetch_add(1) > 0)
+                    concurrent = true;
+                {
+                    std::lock_guard l(mutex);
+                    threads.insert(std::this_thread::get_id());
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                running.fetch_sub(1);
+                return true;
+            },
+            {.reschedule_time = time::micro(500), .affinity = 5});
+    };
+    sched.add_task(make_task(first_threads));
+    sched.add_task(make_task(second_threads));
+
+    sched.set_start_synchronised(true);
+    sched.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sched.stop();
+
+    EXPECT_FALSE(concurrent);
+    EXPECT_EQ(first_threads.size(), 1u);
+    EXPECT_EQ(first_threads, second_threads);
+}
+
 TEST_F(TestScheduler, test_sched_burst)
 {
     if (test::is_run_by_valgrind())
@@ -1,4 +1,8 @@
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <thread>
 
 #include <gtest/gtest.h>
 
@@ -93,6 +97,142 @@ TEST_F(TestThreadPool, test_threadpool_error)
     pool.stop();
 
     ASSERT_THROW(future.get(), std::future_error);
+
+    // nothing runs once stopped
+    auto after_stop = pool.add_job([]() { return 42; });
+    ASSERT_THROW(after_stop.get(), std::future_error);
+    EXPECT_EQ(pool.remaining_jobs(), 0u);
+}
+
+TEST_F(TestThreadPool, test_threadpool_batch)
+{
+    constexpr size_t total_jobs = 200;
+
+    ThreadPool pool("thread_pool", 4);
+
+    std::atomic<size_t> count = 0;
+    std::vector<ThreadPool::Job> jobs;
+    for (size_t i = 0; i < total_jobs; ++i)
+    {
+        jobs.emplace_back([&count] { ++count; });
+    }
+    pool.add_jobs(std::move(jobs));
+    EXPECT_TRUE(jobs.empty());
+
+    pool.wait_all_jobs();
+    pool.stop();
+
+    EXPECT_EQ(count.load(), total_jobs);
+    EXPECT_EQ(pool.remaining_jobs(), 0u);
+}
+
+TEST_F(TestThreadPool, test_threadpool_parallel_for)
+{
+    constexpr size_t total = 10000;
+
+    ThreadPool pool("thread_pool", 4);
+
+    std::vector<size_t> values(total, 0);
+    pool.parallel_for(0, total, [&values](size_t i) { values[i] = i * 2; }, 64);
+    for (size_t i = 0; i < total; ++i)
+    {
+        ASSERT_EQ(values[i], i * 2);
+    }
+
+    // automatic grain
+    std::atomic<size_t> sum = 0;
+    pool.parallel_for(10, 20, [&sum](size_t i) { sum += i; });
+    EXPECT_EQ(sum.load(), 145u);
+
+    EXPECT_THROW(pool.parallel_for(0, 100,
+                                   [](size_t i) {
+                                       if (i == 50)
+                                           throw std::runtime_error("error");
+                                   }),
+                 std::runtime_error);
+}
+
+TEST_F(TestThreadPool, test_threadpool_nested)
+{
+    constexpr size_t outer = 16;
+    constexpr size_t inner = 100;
+
+    ThreadPool pool("thread_pool", 2);
+
+    std::atomic<size_t> count = 0;
+    // jobs submitted from inside a worker go to its own deque and are stolen by idle workers
+    pool.parallel_for(0, outer, [&](size_t) {
+        pool.parallel_for(0, inner, [&count](size_t) { ++count; }, 10);
+    }, 1);
+
+    EXPECT_EQ(count.load(), outer * inner);
+
+    auto future = pool.add_job([&pool] { return pool.add_job([] { return 42; }).get(); });
+    EXPECT_EQ(future.get(), 42);
+}
+
+TEST_F(TestThreadPool, test_threadpool_post)
+{
+    constexpr size_t total_jobs = 1000;
+
+    ThreadPool pool("thread_pool", 4);
+
+    std::atomic<size_t> count = 0;
+    for (size_t i = 0; i < total_jobs; ++i)
+    {
+        pool.post_job([&count] { ++count; });
+    }
+    // exceptions of posted jobs are dropped
+    pool.post_job([] { throw std::runtime_error("dropped"); });
+
+    pool.wait_all_jobs();
+    // jobs are taken before they run: waiting for the pending jobs does not wait for the last ones to finish
+    for (int i = 0; i < 500 && count.load() < total_jobs; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(count.load(), total_jobs);
+
+    // slots are recycled: futures still work after many jobs
+    EXPECT_EQ(pool.add_job([] { return 1; }).get(), 1);
+}
+
+TEST_F(TestThreadPool, test_threadpool_future_result)
+{
+    ThreadPool pool("thread_pool", 2);
+
+    auto error = pool.add_job([]() -> int { throw std::runtime_error("error"); });
+    EXPECT_THROW(error.get(), std::runtime_error);
+    EXPECT_FALSE(error.valid());
+
+    // bigger than the slot result storage
+    auto big = pool.add_job([] { return std::array<size_t, 32> {1, 2, 3}; });
+    auto small = pool.add_job([] { return std::string("hello"); });
+    EXPECT_EQ(big.get()[2], 3u);
+    EXPECT_EQ(small.get(), "hello");
+
+    // dropping a future before completion is fine
+    std::atomic<bool> done = false;
+    {
+        auto dropped = pool.add_job([&done] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            done = true;
+        });
+    }
+    for (int i = 0; i < 500 && !done.load(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_TRUE(done.load());
+
+    ThreadPool::Future<int> empty;
+    EXPECT_FALSE(empty.valid());
+    EXPECT_THROW(empty.wait(), std::future_error);
+
+    // a future may outlive its pool
+    ThreadPool::Future<int> outliving;
+    {
+        ThreadPool tmp("tmp_pool", 1);
+        outliving = tmp.add_job([] { return 3; });
+        outliving.wait();
+    }
+    EXPECT_EQ(outliving.get(), 3);
 }
 
 } // namespace test
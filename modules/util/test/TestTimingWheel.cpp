@@ -0,0 +1,156 @@
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <sihd/util/Logger.hpp>
+#include <sihd/util/TimingWheel.hpp>
+
+namespace test
+{
+SIHD_LOGGER;
+using namespace sihd::util;
+class TestTimingWheel: public ::testing::Test
+{
+    protected:
+        TestTimingWheel() { sihd::util::LoggerManager::stream(); }
+
+        virtual ~TestTimingWheel() { sihd::util::LoggerManager::clear_loggers(); }
+
+        virtual void SetUp() {}
+
+        virtual void TearDown() {}
+};
+
+TEST_F(TestTimingWheel, test_timingwheel_expire)
+{
+    TimingWheel<int> wheel(time::micro(1));
+
+    const Timestamp origin = time::seconds(1000);
+
+    EXPECT_FALSE(wheel.next_expiry().has_value());
+    EXPECT_FALSE(wheel.pop_expired(origin).has_value());
+
+    wheel.insert(origin + time::milli(10), 3);
+    wheel.insert(origin + time::micro(5), 1);
+    wheel.insert(origin + time::seconds(100), 4);
+    wheel.insert(origin + time::milli(1), 2);
+    EXPECT_EQ(wheel.size(), 4u);
+
+    // lower bound of the earliest deadline
+    ASSERT_TRUE(wheel.next_expiry().has_value());
+    EXPECT_LE(*wheel.next_expiry(), origin + time::micro(5));
+
+    EXPECT_FALSE(wheel.pop_expired(origin).has_value());
+    // start of the earliest tick once cascaded
+    EXPECT_EQ(wheel.next_expiry(), origin + time::micro(5));
+
+    EXPECT_EQ(wheel.pop_expired(origin + time::milli(5)), 1);
+    EXPECT_EQ(wheel.pop_expired(origin + time::milli(5)), 2);
+    EXPECT_FALSE(wheel.pop_expired(origin + time::milli(5)).has_value());
+
+    EXPECT_EQ(wheel.pop_next(), 3);
+    EXPECT_EQ(wheel.pop_next(), 4);
+    EXPECT_FALSE(wheel.pop_next().has_value());
+    EXPECT_TRUE(wheel.empty());
+
+    // late values are expired right away
+    wheel.insert(origin, 5);
+    EXPECT_EQ(wheel.pop_expired(origin + time::seconds(100)), 5);
+}
+
+TEST_F(TestTimingWheel, test_timingwheel_same_tick)
+{
+    TimingWheel<int> wheel(time::milli(1));
+
+    const Timestamp origin = time::seconds(10);
+
+    // same tick: insertion order, but deadline is still honored
+    wheel.insert(origin + time::micro(500), 1);
+    wheel.insert(origin + time::micro(100), 2);
+    wheel.insert(origin + time::micro(500), 3);
+
+    EXPECT_EQ(wheel.pop_expired(origin + time::micro(200)), 2);
+    EXPECT_FALSE(wheel.pop_expired(origin + time::micro(200)).has_value());
+    EXPECT_EQ(wheel.next_expiry(), origin);
+    EXPECT_EQ(wheel.pop_expired(origin + time::micro(500)), 1);
+    EXPECT_EQ(wheel.pop_expired(origin + time::micro(500)), 3);
+}
+
+TEST_F(TestTimingWheel, test_timingwheel_cancel)
+{
+    TimingWheel<int> wheel;
+
+    const Timestamp origin = time::seconds(1);
+
+    auto first = wheel.insert(origin + time::milli(1), 1);
+    auto second = wheel.insert(origin + time::milli(1), 2);
+    auto third = wheel.insert(origin + time::milli(2), 3);
+
+    ASSERT_NE(wheel.get(second), nullptr);
+    EXPECT_EQ(*wheel.get(second), 2);
+    EXPECT_TRUE(wheel.cancel(second));
+    EXPECT_FALSE(wheel.cancel(second));
+    EXPECT_EQ(wheel.get(second), nullptr);
+    EXPECT_FALSE(wheel.cancel(TimingWheel<int>::npos));
+
+    EXPECT_EQ(wheel.pop_next(), 1);
+    EXPECT_EQ(wheel.get(first), nullptr);
+    EXPECT_EQ(wheel.pop_next(), 3);
+    EXPECT_EQ(wheel.get(third), nullptr);
+
+    // nodes are reused
+    auto reused = wheel.insert(origin, 4);
+    EXPECT_LT(reused, 3u);
+
+    int drained = 0;
+    wheel.insert(origin, 5);
+    wheel.drain([&drained](int value) { drained += value; });
+    EXPECT_EQ(drained, 9);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST_F(TestTimingWheel, test_timingwheel_random)
+{
+    TimingWheel<size_t> wheel(time::micro(1));
+
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<int64_t> dist(0, time::seconds(10));
+
+    const Timestamp origin = time::seconds(1'700'000'000);
+    std::vector<Timestamp> deadlines;
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        deadlines.emplace_back(origin + dist(gen));
+        wheel.insert(deadlines.back(), i);
+    }
+
+    Timestamp last = 0;
+    size_t popped = 0;
+    while (std::optional<size_t> value = wheel.pop_next())
+    {
+        const Timestamp deadline = deadlines[*value];
+        // ordered up to the resolution
+        ASSERT_GE(deadline + time::micro(1), last);
+        last = deadline;
+        ++popped;
+    }
+    EXPECT_EQ(popped, deadlines.size());
+
+    // expire by advancing time
+    for (size_t i = 0; i < deadlines.size(); ++i)
+        wheel.insert(deadlines[i], i);
+    popped = 0;
+    for (Timestamp now = origin; now <= origin + time::seconds(10); now = now + time::milli(1))
+    {
+        while (std::optional<size_t> value = wheel.pop_expired(now))
+        {
+            ASSERT_LE(deadlines[*value], now);
+            ASSERT_GT(deadlines[*value] + time::milli(1), now);
+            ++popped;
+        }
+    }
+    EXPECT_EQ(popped, deadlines.size());
+}
+
+} // namespace test
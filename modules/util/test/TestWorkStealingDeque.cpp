@@ -0,0 +1,91 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <sihd/util/WorkStealingDeque.hpp>
+
+namespace test
+{
+using namespace sihd::util;
+class TestWorkStealingDeque: public ::testing::Test
+{
+    protected:
+        TestWorkStealingDeque() = default;
+
+        virtual ~TestWorkStealingDeque() = default;
+
+        virtual void SetUp() {}
+
+        virtual void TearDown() {}
+};
+
+TEST_F(TestWorkStealingDeque, test_workstealingdeque_order)
+{
+    WorkStealingDeque<int> deque(2);
+
+    EXPECT_TRUE(deque.empty());
+    EXPECT_FALSE(deque.pop().has_value());
+    EXPECT_FALSE(deque.steal().has_value());
+
+    // grows past the initial capacity
+    for (int i = 1; i <= 5; ++i)
+        deque.push(i);
+    EXPECT_EQ(deque.size(), 5u);
+
+    // owner pops newest, thieves steal oldest
+    EXPECT_EQ(deque.pop().value(), 5);
+    EXPECT_EQ(deque.steal().value(), 1);
+    EXPECT_EQ(deque.pop().value(), 4);
+    EXPECT_EQ(deque.steal().value(), 2);
+    EXPECT_EQ(deque.pop().value(), 3);
+    EXPECT_TRUE(deque.empty());
+}
+
+TEST_F(TestWorkStealingDeque, test_workstealingdeque_steal)
+{
+    constexpr size_t total = 100000;
+    constexpr size_t thieves = 3;
+
+    WorkStealingDeque<size_t> deque;
+    std::atomic<bool> done = false;
+    std::atomic<size_t> count = 0;
+    std::atomic<size_t> sum = 0;
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < thieves; ++i)
+    {
+        threads.emplace_back([&] {
+            while (!done || !deque.empty())
+            {
+                if (auto value = deque.steal())
+                {
+                    sum += *value;
+                    ++count;
+                }
+            }
+        });
+    }
+
+    for (size_t i = 1; i <= total; ++i)
+    {
+        deque.push(i);
+        if (i % 3 == 0)
+        {
+            if (auto value = deque.pop())
+            {
+                sum += *value;
+                ++count;
+            }
+        }
+    }
+    done = true;
+    for (auto & thread : threads)
+        thread.join();
+
+    EXPECT_EQ(count.load(), total);
+    EXPECT_EQ(sum.load(), total * (total + 1) / 2);
+}
+
+} // namespace test